@@ -2,6 +2,7 @@
 #include "ggdatetime/datetime_read.hpp"
 #include "nvarstr.hpp"
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <stdexcept>
 #ifdef DEBUG
@@ -10,6 +11,7 @@
 
 using ngpt::Antex;
 using ngpt::ReceiverAntenna;
+using ngpt::SatId;
 using ngpt::Satellite;
 using ngpt::SatelliteAntenna;
 
@@ -48,6 +50,7 @@ constexpr std::size_t MAX_GRID_CHARS{512};
 // Forward declerationof non Antex:: functions;
 int collect_pco(std::ifstream &, ngpt::AntennaPcoList &) noexcept;
 int resolve_satellite_antenna_line(const char *, Satellite &) noexcept;
+SatId satellite_antenna_id(const char *) noexcept;
 int check_time_interval(std::ifstream &,
                         const ngpt::datetime<ngpt::seconds> &) noexcept;
 
@@ -335,6 +338,7 @@ int Antex::find_closest_antenna_match(const ReceiverAntenna &ant_in,
 ///  @param[in] line  A satellite antenna line ("TYPE / SERIAL NO") as recorded
 ///                   in an antex line
 ///  @param[out] sat  The resolved satellite, possibly not containing SVN
+///  @see satellite_antenna_id
 int resolve_satellite_antenna_line(const char *line, Satellite &sat) noexcept {
   using ngpt::detail::COSPAR_ID_CHARS;
 
@@ -390,6 +394,31 @@ int resolve_satellite_antenna_line(const char *line, Satellite &sat) noexcept {
   return 0;
 }
 
+/// Resolve (only) the satellite system and PRN off from a satellite antenna
+/// line ("TYPE / SERIAL NO"). This is a cheap (allocation and exception free)
+/// test to use while searching an ANTEX file for a given satellite; the
+/// matching line should then be fully resolved via
+/// resolve_satellite_antenna_line.
+///  @param[in] line  A satellite antenna line ("TYPE / SERIAL NO") as recorded
+///                   in an antex line
+///  @return The satellite id; invalid if the line is not a satellite antenna
+///          line
+SatId satellite_antenna_id(const char *line) noexcept {
+  if (std::strlen(line) < 60 || line[20] == ' ')
+    return SatId();
+  for (int s = 0; s < SatId::num_systems; s++) {
+    const auto sys = static_cast<ngpt::SATELLITE_SYSTEM>(s);
+    if (ngpt::satsys_to_char(sys) == line[20]) {
+      char prn_str[6], *end;
+      std::memcpy(prn_str, line + 21, 5);
+      prn_str[5] = '\0';
+      const long prn = std::strtol(prn_str, &end, 10);
+      return (end == prn_str) ? SatId() : SatId(sys, static_cast<int>(prn));
+    }
+  }
+  return SatId();
+}
+
 /// @brief Check if a given epoch is between the "VALID FROM" and "VALID UNTIL"
 ///        fields.
 /// Satellite antennas are always described in ANTEX files for certain time-
@@ -496,13 +525,16 @@ int Antex::find_satellite_antenna(int prn, SATELLITE_SYSTEM ss,
 
   ReceiverAntenna cur_ant;
   Satellite cur_sat;
+  const SatId target(ss, prn);
   int stat1, stat2;
 
   while (!(stat1 = read_next_antenna_type(cur_ant, line))) {
-    cur_sat.system() = SATELLITE_SYSTEM::mixed;
     ant_pos = __istream.tellg();
-    if (!resolve_satellite_antenna_line(line, cur_sat)) {
-      if (cur_sat.prn() == prn && cur_sat.system() == ss) {
+    // only fully resolve the line of the satellite we are looking for
+    if (satellite_antenna_id(line) == target) {
+      cur_sat.system() = SATELLITE_SYSTEM::mixed;
+      if (!resolve_satellite_antenna_line(line, cur_sat) &&
+          cur_sat.prn() == prn && cur_sat.system() == ss) {
         if (!check_time_interval(__istream, at)) {
           if (sv != nullptr)
             *sv = cur_sat;
@@ -0,0 +1,54 @@
+#include "arena.hpp"
+#include <algorithm>
+
+using ngpt::EpochArena;
+
+EpochArena::EpochArena(std::size_t capacity) {
+  capacity = std::max(capacity, alignof(std::max_align_t));
+  blocks_.reserve(8);
+  blocks_.push_back(Block{new char[capacity], capacity});
+}
+
+EpochArena::~EpochArena() noexcept {
+  for (auto &b : blocks_)
+    delete[] b.data;
+}
+
+std::size_t EpochArena::capacity() const noexcept {
+  std::size_t size = 0;
+  for (const auto &b : blocks_)
+    size += b.size;
+  return size;
+}
+
+std::size_t EpochArena::used() const noexcept {
+  std::size_t size = used_;
+  for (std::size_t i = 0; i < current_; i++)
+    size += blocks_[i].size;
+  return size;
+}
+
+/// @details Blocks after the current one (kept from previous epochs) are
+///          tried first, in order; if none of them is large enough, a new
+///          block, twice the size of the last one (or large enough for the
+///          request) is appended.
+void *EpochArena::allocate_slow(std::size_t bytes, std::size_t align) noexcept {
+  // worst case padding included
+  const std::size_t need = bytes + align - 1;
+  for (std::size_t i = current_ + 1; i < blocks_.size(); i++) {
+    if (blocks_[i].size >= need) {
+      current_ = i;
+      used_ = 0;
+      return allocate(bytes, align);
+    }
+  }
+  const std::size_t size = std::max(2 * blocks_.back().size, need);
+  try {
+    blocks_.push_back(Block{new char[size], size});
+  } catch (std::bad_alloc &) {
+    return nullptr;
+  }
+  current_ = blocks_.size() - 1;
+  used_ = 0;
+  return allocate(bytes, align);
+}
@@ -0,0 +1,167 @@
+#ifndef __GNSS_ARENA_HPP__
+#define __GNSS_ARENA_HPP__
+
+/// @file     arena.hpp
+///
+/// @brief    A monotonic (bump) arena for per-epoch scratch memory, and a
+///           standard allocator drawing from it.
+///
+/// @details  Memory is handed out from a list of blocks by advancing an
+///           offset; individual deallocations are no-ops. reset() makes
+///           all memory available again in O(1) (no destructors are run,
+///           no block is freed). When a block is exhausted the next one is
+///           used; a new block is only allocated (from the heap) if the
+///           list is exhausted too. Hence, once the arena has grown to an
+///           epoch's high-water mark, an epoch (allocate ..., reset) does
+///           no heap allocation at all.
+///
+///           Typical use is one arena per processing thread, reset at the
+///           start of every epoch:
+///           @code
+///           ngpt::EpochArena arena(64 * 1024);
+///           for (each epoch) {
+///             arena.reset();
+///             double *w = arena.allocate_array<double>(nsats);
+///             ngpt::arena_vector<int> idx(arena);
+///             ...
+///           }
+///           @endcode
+///
+/// @warning  Objects placed in the arena must not be used after reset();
+///           arena containers must be destroyed (or left unused) before it.
+///           An arena is not thread safe.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace ngpt {
+
+/// @class EpochArena
+/// A monotonic memory arena with O(1) reset.
+class EpochArena {
+public:
+  /// @brief Constructor; allocate the first block
+  /// @param[in] capacity Size of the first block in bytes; later blocks are
+  ///                     at least as large
+  /// @throw std::bad_alloc if the block cannot be allocated
+  explicit EpochArena(std::size_t capacity = 64 * 1024);
+
+  /// @brief Copy not allowed !
+  EpochArena(const EpochArena &) = delete;
+
+  /// @brief Assignment not allowed !
+  EpochArena &operator=(const EpochArena &) = delete;
+
+  /// @brief Destructor; free all blocks
+  ~EpochArena() noexcept;
+
+  /// @brief Allocate (uninitialized) memory
+  /// @param[in] bytes Number of bytes
+  /// @param[in] align Alignment; a power of 2
+  /// @return Pointer to the memory, or nullptr if a new block was needed and
+  ///         could not be allocated
+  void *allocate(std::size_t bytes,
+                 std::size_t align = alignof(std::max_align_t)) noexcept {
+    const Block &b = blocks_[current_];
+    char *p = b.data + used_;
+    const std::size_t pad =
+        (align - (reinterpret_cast<std::uintptr_t>(p) & (align - 1))) &
+        (align - 1);
+    if (used_ + pad + bytes <= b.size) {
+      used_ += pad + bytes;
+      return p + pad;
+    }
+    return allocate_slow(bytes, align);
+  }
+
+  /// @brief Allocate an (uninitialized) array of n objects of a trivial type
+  /// @return Pointer to the array, or nullptr on failure
+  template <typename T> T *allocate_array(std::size_t n) noexcept {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Arena arrays are never destructed");
+    return static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /// @brief Make all memory available again; O(1)
+  void reset() noexcept {
+    current_ = 0;
+    used_ = 0;
+  }
+
+  /// @brief Total size of all blocks in bytes
+  std::size_t capacity() const noexcept;
+
+  /// @brief Number of blocks
+  std::size_t num_blocks() const noexcept { return blocks_.size(); }
+
+  /// @brief Bytes in use (including alignment padding and the unused tails
+  ///        of exhausted blocks)
+  std::size_t used() const noexcept;
+
+private:
+  struct Block {
+    char *data;
+    std::size_t size;
+  };
+
+  /// @brief Allocate from the next block(s), adding a block if needed
+  void *allocate_slow(std::size_t bytes, std::size_t align) noexcept;
+
+  std::vector<Block> blocks_; ///< All blocks, in order of use
+  std::size_t current_{0};    ///< Index of the block in use
+  std::size_t used_{0};       ///< Bytes used in the current block
+};                            // EpochArena
+
+/// @class ArenaAllocator
+/// A standard allocator drawing from an EpochArena; deallocate is a no-op.
+template <typename T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  /// @brief Constructor
+  ArenaAllocator(EpochArena &arena) noexcept : arena_(&arena) {}
+
+  /// @brief Rebinding constructor
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+      : arena_(other.arena()) {}
+
+  /// @throw std::bad_alloc if the arena cannot grow
+  T *allocate(std::size_t n) {
+    void *p = arena_->allocate(n * sizeof(T), alignof(T));
+    if (!p)
+      throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+
+  void deallocate(T *, std::size_t) noexcept {}
+
+  /// @brief The arena
+  EpochArena *arena() const noexcept { return arena_; }
+
+private:
+  EpochArena *arena_;
+}; // ArenaAllocator
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a,
+                const ArenaAllocator<U> &b) noexcept {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a,
+                const ArenaAllocator<U> &b) noexcept {
+  return !(a == b);
+}
+
+/// A vector using an EpochArena
+template <typename T> using arena_vector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace ngpt
+
+#endif
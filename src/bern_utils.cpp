@@ -1,6 +1,10 @@
 #include "bern_utils.hpp"
+#include "diagnostics.hpp"
 #include "ggdatetime/datetime_read.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <stdexcept>
 #ifdef DEBUG
@@ -10,12 +14,13 @@
 
 constexpr int MAX_SATELLIT_CHARS = 256;
 
-/// Constructor; after this, the stream will be opened, and the start of
-/// 'PART 2' of the file marked.
+/// Constructor; after this, the stream will be opened, the start of
+/// 'PART 2' of the file marked and all of its (microwave sensor) records
+/// read and indexed.
 ///
 /// @param[in] fn  The SATELLIT's filename
 /// @throw std::runtime_error If the file cannot be found/opened or the call
-///        to BernSatellit::initialize() fails
+///        to BernSatellit::initialize() or BernSatellit::read_part2() fails
 ngpt::BernSatellit::BernSatellit(const char *fn)
     : __filename(fn), __istream(fn, std::ios_base::in), __part2(0) {
   if (initialize()) {
@@ -24,23 +29,23 @@ ngpt::BernSatellit::BernSatellit(const char *fn)
     throw std::runtime_error(
         "[ERROR] BernSatellit::BernSatellit Failed to read SATELLIT header");
   }
+  if (read_part2()) {
+    if (__istream.is_open())
+      __istream.close();
+    throw std::runtime_error(
+        "[ERROR] BernSatellit::BernSatellit Failed to read SATELLIT PART 2");
+  }
 }
 
-/// Search through all the record lines in 'PART 2' block of the file, to
-/// match a GLONASS satellite with the given svn for the given time interval.
-/// If such a satellite is found, return the recorded frequency channel.
-/// @param[in]  svn   The SVN of the GLONASS satellite
-/// @param[in]  eph   The time/epoch for which we want the satellite
-/// @param[out] ifrqn The frequency channel of the given satellite for the given
-///                   epoch
-/// @param[out] prn   The prn number of the satellite as recorded in the
-///                   SATELLIT file
-/// @return    -1 -> Satellite not matched in file
-///             0 -> Satellite matched and ifrqn assigned
-///            >0 -> An error occured while reading the records
-int ngpt::BernSatellit::get_frequency_channel(
-    int svn, const ngpt::datetime<ngpt::seconds> &eph, int &ifrqn, int &prn) {
-  const int max_lines = 1000;
+/// Read all record lines in the 'PART 2' block of the file; only microwave
+/// sensor records (type 'MW') are stored. The records are sorted by (svn,
+/// start time) and an index sorted by (prn, start time) is built; records
+/// with the same key keep their order in the file.
+/// This function should only be called once, inside the object's
+/// constructor (after initialize).
+/// @return  Anything other than 0, denotes an error
+int ngpt::BernSatellit::read_part2() {
+  const int max_lines = 10000;
   char line[MAX_SATELLIT_CHARS];
 
   // The stream should be open by now!
@@ -50,54 +55,177 @@ int ngpt::BernSatellit::get_frequency_channel(
   // Go to the top of the relevant field (in file)
   __istream.seekg(__part2);
 
-  // keep reading untill we match svn and epoch
-  int line_count = 0, csvn;
+  int line_count = 0;
   char *end;
-  bool satellite_matched = false;
-  ngpt::datetime<ngpt::seconds> start, stop;
+  __records.clear();
   __istream.getline(line, MAX_SATELLIT_CHARS);
-  while (!satellite_matched && line_count < max_lines) {
+  while (line_count < max_lines && __istream.good()) {
     // we are only interested in satellites of type: 'MW' everything else
     // is desregarded and may cause a problem when resolving; e.g. SLR records
     // have no SVN field
     if (line[5] == 'M' && line[6] == 'W') {
-      csvn = static_cast<int>(std::strtol(line + 28, &end, 10));
+      SatellitRecord rec;
+      rec.svn = static_cast<int>(std::strtol(line + 28, &end, 10));
       if (errno == ERANGE || end == line + 28) {
         errno = 0;
         return 2;
       }
-      if (csvn == svn) {
-        start = ngpt::strptime_ymd_hms<ngpt::seconds>(line + 41);
-        stop = ngpt::datetime<ngpt::seconds>::max();
-        for (int i = 62; i < 82; i++) {
-          if (line[i] != ' ') {
-            stop = ngpt::strptime_ymd_hms<ngpt::seconds>(line + 62);
-            break;
-          }
-        }
-        if (eph >= start && eph < stop) {
-          satellite_matched = true;
-          prn = static_cast<int>(std::strtol(line, &end, 10));
-          ifrqn = static_cast<int>(std::strtol(line + 193, &end, 10));
-          if (errno == ERANGE) {
-            errno = 0;
-            // throw std::runtime_error("[ERROR] Failed to resolve svn from
-            // SATELLIT file");
-            return 3;
-          } else {
-            return 0;
-          }
+      rec.prn = static_cast<int>(std::strtol(line, &end, 10));
+      rec.start = ngpt::strptime_ymd_hms<ngpt::seconds>(line + 41);
+      rec.stop = ngpt::datetime<ngpt::seconds>::max();
+      for (int i = 62; i < 82; i++) {
+        if (line[i] != ' ') {
+          rec.stop = ngpt::strptime_ymd_hms<ngpt::seconds>(line + 62);
+          break;
         }
       }
+      rec.ifrqn = (std::strlen(line) > 193)
+                      ? static_cast<int>(std::strtol(line + 193, &end, 10))
+                      : 0;
+      if (errno == ERANGE) {
+        errno = 0;
+        return 3;
+      }
+      __records.push_back(rec);
     }
     __istream.getline(line, MAX_SATELLIT_CHARS);
     ++line_count;
     // check for end of records
     if (std::strlen(line) < 10 || !std::strncmp("PART 3", line, 6))
-      return -1;
+      break;
   }
+  if (line_count >= max_lines)
+    return 5;
+
+  std::stable_sort(__records.begin(), __records.end(),
+            [](const SatellitRecord &a, const SatellitRecord &b) {
+              return (a.svn < b.svn) || (a.svn == b.svn && a.start < b.start);
+            });
+  __prn_index.resize(__records.size());
+  for (std::size_t i = 0; i < __records.size(); i++)
+    __prn_index[i] = i;
+  std::stable_sort(__prn_index.begin(), __prn_index.end(),
+            [this](std::size_t i, std::size_t j) {
+              const auto &a = __records[i];
+              const auto &b = __records[j];
+              return (a.prn < b.prn) || (a.prn == b.prn && a.start < b.start);
+            });
+
+  return 0;
+}
 
-  return (line_count >= max_lines) ? (-1) : 5;
+/// Search through the records of the 'PART 2' block of the file, to match a
+/// satellite with the given svn for the given time interval. If such a
+/// satellite is found, return the recorded frequency channel.
+/// Validity intervals of the same svn may overlap (e.g. an open-ended record
+/// left in place after the satellite was reassigned); then, as when reading
+/// the file top to bottom, the first (earliest starting) record that covers
+/// eph is matched.
+/// @param[in]  svn   The SVN of the GLONASS satellite
+/// @param[in]  eph   The time/epoch for which we want the satellite
+/// @param[out] ifrqn The frequency channel of the given satellite for the given
+///                   epoch
+/// @param[out] prn   The prn number of the satellite as recorded in the
+///                   SATELLIT file
+/// @return    -1 -> Satellite not matched in file
+///             0 -> Satellite matched and ifrqn assigned
+int ngpt::BernSatellit::get_frequency_channel(
+    int svn, const ngpt::datetime<ngpt::seconds> &eph, int &ifrqn,
+    int &prn) const noexcept {
+  // last record with (svn, start) <= (svn, eph)
+  auto it = std::upper_bound(
+      __records.cbegin(), __records.cend(), eph,
+      [svn](const ngpt::datetime<ngpt::seconds> &t, const SatellitRecord &r) {
+        return (svn < r.svn) || (svn == r.svn && t < r.start);
+      });
+  // walk back through all records of svn starting at or before eph
+  auto match = __records.cend();
+  while (it != __records.cbegin() && (it - 1)->svn == svn) {
+    --it;
+    if (eph < it->stop)
+      match = it;
+  }
+  if (match == __records.cend())
+    return -1;
+  prn = match->prn;
+  ifrqn = match->ifrqn;
+  return 0;
+}
+
+/// Search through the records of the 'PART 2' block of the file, to match a
+/// satellite with the given prn for the given time interval. If such a
+/// satellite is found, return its svn and frequency channel. As for
+/// get_frequency_channel, overlapping records resolve to the first
+/// (earliest starting) one that covers eph.
+/// @param[in]  prn   The PRN of the satellite as recorded in the SATELLIT
+///                   file (e.g. 101 for GLONASS R01)
+/// @param[in]  eph   The time/epoch for which we want the satellite
+/// @param[out] svn   The SVN of the satellite
+/// @param[out] ifrqn The frequency channel of the given satellite for the given
+///                   epoch
+/// @return    -1 -> Satellite not matched in file
+///             0 -> Satellite matched and svn/ifrqn assigned
+int ngpt::BernSatellit::get_svn_and_channel(
+    int prn, const ngpt::datetime<ngpt::seconds> &eph, int &svn,
+    int &ifrqn) const noexcept {
+  // last record with (prn, start) <= (prn, eph)
+  auto it = std::upper_bound(
+      __prn_index.cbegin(), __prn_index.cend(), eph,
+      [this, prn](const ngpt::datetime<ngpt::seconds> &t, std::size_t i) {
+        const auto &r = __records[i];
+        return (prn < r.prn) || (prn == r.prn && t < r.start);
+      });
+  // walk back through all records of prn starting at or before eph
+  const SatellitRecord *match = nullptr;
+  while (it != __prn_index.cbegin() && __records[*(it - 1)].prn == prn) {
+    const auto &rec = __records[*(--it)];
+    if (eph < rec.stop)
+      match = &rec;
+  }
+  if (!match)
+    return -1;
+  svn = match->svn;
+  ifrqn = match->ifrqn;
+  return 0;
+}
+
+/// Same as above, but the satellite is given as satellite system and PRN (as
+/// in RINEX); the PRN is translated to the Bernese numbering, i.e. 1-99 for
+/// GPS, 101-199 for GLONASS, 201-299 for Galileo, 301-399 for SBAS, 401-499
+/// for BeiDou, 501-599 for QZSS and 601-699 for IRNSS.
+/// @return    -1 -> Satellite not matched in file
+///             0 -> Satellite matched and svn/ifrqn assigned
+///             1 -> Invalid satellite system
+int ngpt::BernSatellit::get_svn_and_channel(
+    SATELLITE_SYSTEM sys, int prn, const ngpt::datetime<ngpt::seconds> &eph,
+    int &svn, int &ifrqn) const noexcept {
+  int offset;
+  switch (sys) {
+  case (SATELLITE_SYSTEM::gps):
+    offset = 0;
+    break;
+  case (SATELLITE_SYSTEM::glonass):
+    offset = 100;
+    break;
+  case (SATELLITE_SYSTEM::galileo):
+    offset = 200;
+    break;
+  case (SATELLITE_SYSTEM::sbas):
+    offset = 300;
+    break;
+  case (SATELLITE_SYSTEM::beidou):
+    offset = 400;
+    break;
+  case (SATELLITE_SYSTEM::qzss):
+    offset = 500;
+    break;
+  case (SATELLITE_SYSTEM::irnss):
+    offset = 600;
+    break;
+  default:
+    return 1;
+  }
+  return get_svn_and_channel(prn + offset, eph, svn, ifrqn);
 }
 
 /// This function should only be called once, inside the object's constructor.
@@ -126,7 +254,7 @@ int ngpt::BernSatellit::initialize() noexcept {
   // ----------------------------------------------------
   __istream.getline(line, MAX_SATELLIT_CHARS);
   if (std::strncmp(line1, line, line1_sz)) {
-    std::cerr << "\n[ERROR] Failed to verify first liine of SATELIT file";
+    ngpt::diagnostics::error("Failed to verify first liine of SATELIT file");
     return 10;
   }
 
@@ -2,8 +2,10 @@
 #define __GNSS_BERN_UTILS_HPP__
 
 #include "ggdatetime/dtcalendar.hpp"
+#include "satsys.hpp"
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 namespace ngpt {
 
@@ -14,6 +16,9 @@ namespace ngpt {
 /// correspondance of GLONASS svn numbers to frequency channels.
 /// An example of such a file, can be found at CODE's ftp repository, aka
 /// ftp://ftp.aiub.unibe.ch/BSWUSER52/GEN/SATELLIT.I14
+/// The records of 'PART 2' (microwave sensors only) are read once, at
+/// construction, and stored in a table sorted by (svn, start time); queries
+/// are binary searches on this table and perform no file I/O.
 class BernSatellit {
 public:
   /// Let's not write this more than once.
@@ -44,16 +49,45 @@ public:
 
   /// @brief Get (GLONASS) satellite frequency channel, given svn
   int get_frequency_channel(int svn, const ngpt::datetime<ngpt::seconds> &eph,
-                            int &ifrqn, int &prn);
+                            int &ifrqn, int &prn) const noexcept;
+
+  /// @brief Get satellite svn and frequency channel, given the prn (as
+  ///        recorded in the SATELLIT file, e.g. 101 for GLONASS R01)
+  int get_svn_and_channel(int prn, const ngpt::datetime<ngpt::seconds> &eph,
+                          int &svn, int &ifrqn) const noexcept;
+
+  /// @brief Get satellite svn and frequency channel, given the satellite
+  ///        system and (RINEX) prn
+  int get_svn_and_channel(SATELLITE_SYSTEM sys, int prn,
+                          const ngpt::datetime<ngpt::seconds> &eph, int &svn,
+                          int &ifrqn) const noexcept;
+
+  /// @brief Number of (microwave sensor) records read off from 'PART 2'
+  std::size_t num_records() const noexcept { return __records.size(); }
 
 private:
+  /// A (microwave sensor) record of 'PART 2'
+  struct SatellitRecord {
+    int svn;                             ///< SVN number
+    int prn;                             ///< PRN number (as in SATELLIT)
+    int ifrqn;                           ///< Frequency channel (GLONASS)
+    ngpt::datetime<ngpt::seconds> start; ///< Start of validity interval
+    ngpt::datetime<ngpt::seconds> stop;  ///< End of validity interval
+  };
+
   /// @brief Initialize the instance (open stream and validate format)
   int initialize() noexcept;
 
+  /// @brief Read and sort the records of 'PART 2'
+  int read_part2();
+
   std::string __filename;  ///< The name of the file.
   std::ifstream __istream; ///< The infput (file) stream.
   pos_type __part2;        ///< Mark the 'PART 2: ON-BOARD SENSORS' field.
-};                         // BernSatellit
+  std::vector<SatellitRecord> __records; ///< Records sorted by (svn, start)
+  std::vector<std::size_t> __prn_index;  ///< Indexes to __records, sorted by
+                                         ///< (prn, start)
+};                                       // BernSatellit
 
 } // namespace ngpt
 
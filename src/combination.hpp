@@ -0,0 +1,116 @@
+#ifndef __GNSS_COMBINATION_HPP__
+#define __GNSS_COMBINATION_HPP__
+
+/// @file     combination.hpp
+///
+/// @brief    Dual-frequency linear combinations of observables, with
+///           coefficients computed at compile time.
+///
+/// @details  For a satellite system S and two frequency bands B1, B2 (of
+///           frequencies f1, f2), combination_traits<S, B1, B2> holds the
+///           (constexpr) coefficients of the usual combinations, such that
+///           the combination is a1 * X1 + a2 * X2 (X being phase or code
+///           observations in meters):
+///           - ionosphere-free:  a1 = f1^2/(f1^2-f2^2), a2 = -f2^2/(f1^2-f2^2)
+///           - geometry-free:    a1 = 1, a2 = -1
+///           - wide-lane:        a1 = f1/(f1-f2), a2 = -f2/(f1-f2)
+///           - narrow-lane:      a1 = f1/(f1+f2), a2 = f2/(f1+f2)
+///           The Melbourne-Wübbena combination is the wide-lane of the phase
+///           minus the narrow-lane of the code observations.
+///           The make_* functions build the respective GnssObservable%s
+///           from the observation codes (which should be on bands B1 and B2).
+///
+///           GLONASS is not supported, since FDMA signals have no (constant)
+///           frequency; see GlonassFdmaTable::observable_frequencies.
+///
+///           E.g. the GPS L1/L2 ionosphere-free code combination:
+///           @code
+///           using gps12 = ngpt::combination_traits<SATELLITE_SYSTEM::gps,1,2>;
+///           GnssObservable pc(SATELLITE_SYSTEM::gps, ObservationCode("C1C"),
+///                             gps12::if_coef1);
+///           pc.add(SATELLITE_SYSTEM::gps, ObservationCode("C2W"),
+///                  gps12::if_coef2);
+///           @endcode
+
+#include "gnssobs.hpp"
+#include "gnssobsrv.hpp"
+#include "satsys.hpp"
+
+namespace ngpt {
+
+/// Coefficients of dual-frequency combinations for the bands B1, B2 of the
+/// satellite system S.
+template <SATELLITE_SYSTEM S, int B1, int B2> struct combination_traits {
+  /// Frequencies (MHz) of the two bands
+  static constexpr double f1{satellite_system_traits<S>::band2frequency(B1)};
+  static constexpr double f2{satellite_system_traits<S>::band2frequency(B2)};
+  static_assert(f1 > 0e0 && f2 > 0e0, "Band not used by satellite system");
+  static_assert(f1 != f2, "Combination of bands with equal frequencies");
+
+  /// Ionosphere-free coefficients
+  static constexpr double if_coef1{f1 * f1 / (f1 * f1 - f2 * f2)};
+  static constexpr double if_coef2{-f2 * f2 / (f1 * f1 - f2 * f2)};
+
+  /// Geometry-free coefficients
+  static constexpr double gf_coef1{1e0};
+  static constexpr double gf_coef2{-1e0};
+
+  /// Wide-lane coefficients
+  static constexpr double wl_coef1{f1 / (f1 - f2)};
+  static constexpr double wl_coef2{-f2 / (f1 - f2)};
+
+  /// Narrow-lane coefficients
+  static constexpr double nl_coef1{f1 / (f1 + f2)};
+  static constexpr double nl_coef2{f2 / (f1 + f2)};
+
+  /// Wide-lane and narrow-lane wavelengths (meters)
+  static constexpr double wl_wavelength{299792458e0 / ((f1 - f2) * 1e6)};
+  static constexpr double nl_wavelength{299792458e0 / ((f1 + f2) * 1e6)};
+
+  /// Ionosphere-free observable
+  static GnssObservable make_iono_free(ObservationCode c1,
+                                       ObservationCode c2) noexcept {
+    return make(c1, if_coef1, c2, if_coef2);
+  }
+
+  /// Geometry-free observable
+  static GnssObservable make_geometry_free(ObservationCode c1,
+                                           ObservationCode c2) noexcept {
+    return make(c1, gf_coef1, c2, gf_coef2);
+  }
+
+  /// Wide-lane observable
+  static GnssObservable make_wide_lane(ObservationCode c1,
+                                       ObservationCode c2) noexcept {
+    return make(c1, wl_coef1, c2, wl_coef2);
+  }
+
+  /// Narrow-lane observable
+  static GnssObservable make_narrow_lane(ObservationCode c1,
+                                         ObservationCode c2) noexcept {
+    return make(c1, nl_coef1, c2, nl_coef2);
+  }
+
+  /// Melbourne-Wübbena observable, from phase (l1, l2) and code (p1, p2)
+  /// codes
+  static GnssObservable
+  make_melbourne_wubbena(ObservationCode l1, ObservationCode l2,
+                         ObservationCode p1, ObservationCode p2) noexcept {
+    GnssObservable mw = make(l1, wl_coef1, l2, wl_coef2);
+    mw.add(S, p1, -nl_coef1);
+    mw.add(S, p2, -nl_coef2);
+    return mw;
+  }
+
+private:
+  static GnssObservable make(ObservationCode c1, double a1, ObservationCode c2,
+                             double a2) noexcept {
+    GnssObservable obs(S, c1, a1);
+    obs.add(S, c2, a2);
+    return obs;
+  }
+}; // combination_traits
+
+} // namespace ngpt
+
+#endif
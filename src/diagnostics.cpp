@@ -0,0 +1,311 @@
+#include "diagnostics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using ngpt::diagnostics::Handler;
+using ngpt::diagnostics::Level;
+using ngpt::diagnostics::Message;
+
+namespace {
+/// Messages per thread ring (a power of 2)
+constexpr std::uint32_t ring_size{64};
+/// Rate limit slots per thread (a power of 2)
+constexpr std::uint32_t num_sites{64};
+
+using steady = std::chrono::steady_clock;
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             steady::now().time_since_epoch())
+      .count();
+}
+
+/// Rate limit state of a message site (on one thread)
+struct Site {
+  const char *fmt{nullptr};
+  std::int64_t window_start{0};
+  std::uint32_t count{0};
+  std::uint32_t suppressed{0};
+};
+
+/// A thread's messages; the owning thread is the only producer, a flushing
+/// thread (holding Registry::flush_mtx) the only consumer.
+struct Ring {
+  Message slots[ring_size];
+  std::atomic<std::uint32_t> head{0}; ///< Next slot to write (producer)
+  std::atomic<std::uint32_t> tail{0}; ///< Next slot to read (consumer)
+  std::atomic<std::uint64_t> reported{0};
+  std::atomic<std::uint64_t> suppressed{0};
+  std::atomic<std::uint64_t> dropped{0};
+  Site sites[num_sites]; ///< Producer only
+  int id{0};
+};
+
+/// Single writer increment
+void add(std::atomic<std::uint64_t> &v, std::uint64_t n) noexcept {
+  v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/// All rings; never destroyed, since threads may exit after static
+/// destructors have run.
+struct Registry {
+  std::mutex reg_mtx;         ///< Guards live, next_id and retired counts
+  std::mutex flush_mtx;       ///< Held by the (single) consumer
+  std::vector<Ring *> live;   ///< Rings of running threads
+  std::vector<Ring *> scratch; ///< Copy of live; used under flush_mtx
+  Handler handler;            ///< Empty means default; under flush_mtx
+  int next_id{0};
+  std::uint64_t reported{0}, suppressed{0}, dropped{0};
+  std::atomic<std::uint64_t> delivered{0};
+  std::atomic<int> max_per_interval{10};
+  std::atomic<std::int64_t> interval_ns{1000000000};
+  std::atomic<bool> auto_flush{true};
+};
+
+Registry &registry() noexcept {
+  static Registry *r = new Registry;
+  return *r;
+}
+
+/// Set while the thread delivers messages; messages reported by a handler
+/// are buffered but not flushed recursively.
+thread_local bool in_flush{false};
+
+void default_handler(const Message &msg) {
+  std::cerr << "\n[" << ngpt::diagnostics::level_name(msg.level) << "] "
+            << msg.text;
+  if (msg.suppressed)
+    std::cerr << "\n        (" << msg.suppressed
+              << " more such message(s) suppressed)";
+}
+
+/// Deliver all messages of a ring; the caller holds flush_mtx
+int drain(Registry &r, Ring &ring) noexcept {
+  int n = 0;
+  std::uint32_t t = ring.tail.load(std::memory_order_relaxed);
+  const std::uint32_t h = ring.head.load(std::memory_order_acquire);
+  Message msg;
+  for (; t != h; ++t, ++n) {
+    msg = ring.slots[t & (ring_size - 1)];
+    ring.tail.store(t + 1, std::memory_order_release);
+    try {
+      if (r.handler)
+        r.handler(msg);
+      else
+        default_handler(msg);
+    } catch (std::exception &) {
+      // a failing handler loses the message
+    }
+  }
+  r.delivered.fetch_add(n, std::memory_order_relaxed);
+  return n;
+}
+
+/// Deliver the messages of all threads; the caller holds flush_mtx
+int drain_all(Registry &r) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(r.reg_mtx);
+    try {
+      r.scratch = r.live;
+    } catch (std::exception &) {
+      r.scratch.clear();
+    }
+  }
+  in_flush = true;
+  int n = 0;
+  for (Ring *ring : r.scratch)
+    n += drain(r, *ring);
+  in_flush = false;
+  return n;
+}
+
+/// Owns the thread's ring; at thread exit, remaining messages are delivered
+/// and the counts are moved to the registry.
+struct RingHolder {
+  Ring *ring{nullptr};
+  ~RingHolder() noexcept {
+    if (!ring)
+      return;
+    Registry &r = registry();
+    std::lock_guard<std::mutex> flock(r.flush_mtx);
+    in_flush = true;
+    drain(r, *ring);
+    in_flush = false;
+    std::lock_guard<std::mutex> lock(r.reg_mtx);
+    r.reported += ring->reported.load(std::memory_order_relaxed);
+    r.suppressed += ring->suppressed.load(std::memory_order_relaxed);
+    r.dropped += ring->dropped.load(std::memory_order_relaxed);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), ring));
+    delete ring;
+  }
+};
+
+/// The calling thread's ring, created on first use; nullptr if it cannot be
+/// allocated
+Ring *thread_ring() noexcept {
+  thread_local RingHolder holder;
+  if (holder.ring)
+    return holder.ring;
+  Ring *ring = new (std::nothrow) Ring;
+  if (!ring)
+    return nullptr;
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.reg_mtx);
+  try {
+    r.live.push_back(ring);
+  } catch (std::exception &) {
+    delete ring;
+    return nullptr;
+  }
+  ring->id = r.next_id++;
+  holder.ring = ring;
+  return ring;
+}
+
+/// Apply the rate limit to a site; on success, set the number of messages
+/// suppressed since the last one reported
+bool admit(Ring &ring, const char *fmt, std::uint32_t &suppressed) noexcept {
+  Registry &r = registry();
+  const int max = r.max_per_interval.load(std::memory_order_relaxed);
+  if (max < 1) {
+    suppressed = 0;
+    return true;
+  }
+  const auto key = reinterpret_cast<std::uintptr_t>(fmt);
+  Site &site = ring.sites[((key >> 3) * 0x9E3779B1u) & (num_sites - 1)];
+  const std::int64_t t = now_ns();
+  if (site.fmt != fmt) {
+    site.fmt = fmt;
+    site.window_start = t;
+    site.count = 0;
+    site.suppressed = 0;
+  } else if (t - site.window_start >=
+             r.interval_ns.load(std::memory_order_relaxed)) {
+    site.window_start = t;
+    site.count = 0;
+  }
+  if (site.count >= static_cast<std::uint32_t>(max)) {
+    ++site.suppressed;
+    add(ring.suppressed, 1);
+    return false;
+  }
+  ++site.count;
+  suppressed = site.suppressed;
+  site.suppressed = 0;
+  return true;
+}
+
+void vreport(Level level, const char *fmt, std::va_list args) noexcept {
+  Ring *ring = thread_ring();
+  if (!ring)
+    return;
+  std::uint32_t suppressed;
+  if (!admit(*ring, fmt, suppressed))
+    return;
+
+  const std::uint32_t h = ring->head.load(std::memory_order_relaxed);
+  if (h - ring->tail.load(std::memory_order_acquire) >= ring_size) {
+    add(ring->dropped, 1);
+  } else {
+    Message &msg = ring->slots[h & (ring_size - 1)];
+    msg.level = level;
+    msg.thread = ring->id;
+    msg.suppressed = suppressed;
+    if (std::vsnprintf(msg.text, ngpt::diagnostics::max_text, fmt, args) < 0)
+      msg.text[0] = '\0';
+    ring->head.store(h + 1, std::memory_order_release);
+    add(ring->reported, 1);
+  }
+
+  Registry &r = registry();
+  if (r.auto_flush.load(std::memory_order_relaxed) && !in_flush &&
+      r.flush_mtx.try_lock()) {
+    drain_all(r);
+    r.flush_mtx.unlock();
+  }
+}
+} // namespace
+
+const char *ngpt::diagnostics::level_name(Level level) noexcept {
+  switch (level) {
+  case Level::info:
+    return "INFO";
+  case Level::warning:
+    return "WARNING";
+  case Level::error:
+    return "ERROR";
+  }
+  return "UNKNOWN";
+}
+
+void ngpt::diagnostics::report(Level level, const char *fmt, ...) noexcept {
+  std::va_list args;
+  va_start(args, fmt);
+  vreport(level, fmt, args);
+  va_end(args);
+}
+
+void ngpt::diagnostics::warning(const char *fmt, ...) noexcept {
+  std::va_list args;
+  va_start(args, fmt);
+  vreport(Level::warning, fmt, args);
+  va_end(args);
+}
+
+void ngpt::diagnostics::error(const char *fmt, ...) noexcept {
+  std::va_list args;
+  va_start(args, fmt);
+  vreport(Level::error, fmt, args);
+  va_end(args);
+}
+
+/// If called from a handler, nothing is delivered (and 0 is returned).
+int ngpt::diagnostics::flush() noexcept {
+  if (in_flush)
+    return 0;
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.flush_mtx);
+  return drain_all(r);
+}
+
+Handler ngpt::diagnostics::set_handler(Handler handler) {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.flush_mtx);
+  drain_all(r);
+  std::swap(r.handler, handler);
+  return handler;
+}
+
+void ngpt::diagnostics::set_rate_limit(int max_per_interval,
+                                       double interval) noexcept {
+  Registry &r = registry();
+  r.max_per_interval.store(max_per_interval, std::memory_order_relaxed);
+  r.interval_ns.store(static_cast<std::int64_t>(interval * 1e9),
+                      std::memory_order_relaxed);
+}
+
+void ngpt::diagnostics::set_auto_flush(bool on) noexcept {
+  registry().auto_flush.store(on, std::memory_order_relaxed);
+}
+
+void ngpt::diagnostics::stats(Stats &s) noexcept {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.reg_mtx);
+  s.reported = r.reported;
+  s.suppressed = r.suppressed;
+  s.dropped = r.dropped;
+  for (const Ring *ring : r.live) {
+    s.reported += ring->reported.load(std::memory_order_relaxed);
+    s.suppressed += ring->suppressed.load(std::memory_order_relaxed);
+    s.dropped += ring->dropped.load(std::memory_order_relaxed);
+  }
+  s.delivered = r.delivered.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,114 @@
+#ifndef __GNSS_DIAGNOSTICS_HPP__
+#define __GNSS_DIAGNOSTICS_HPP__
+
+/// @file     diagnostics.hpp
+///
+/// @brief    Library diagnostics (warnings and error descriptions): buffered
+///           per thread, rate limited and delivered to a user handler.
+///
+/// @details  Library functions report problems via their return status;
+///           the accompanying messages are reported here instead of being
+///           written to std::cerr/std::cout from the (possibly concurrent)
+///           reading and computing threads.
+///
+///           Each thread writes its messages to its own bounded ring buffer
+///           (single producer, single consumer; no locks). If a ring is full
+///           the message is dropped and counted. A message site (the format
+///           string) may report at most max_per_interval messages per
+///           interval on each thread; further messages of the site are
+///           counted and the count is attached to the next message the site
+///           reports.
+///
+///           Messages are passed to the handler (by default, a function
+///           writing them to std::cerr) when flush() is called, when a
+///           thread exits, or, with auto flush on (the default), right after
+///           they are reported, provided that no other thread is currently
+///           flushing. Services that must never call the handler from a
+///           worker thread should switch auto flush off and call flush()
+///           periodically, e.g. from a logging thread.
+
+#include <cstdint>
+#include <functional>
+
+namespace ngpt {
+namespace diagnostics {
+
+/// Severity of a message
+enum class Level : int { info, warning, error };
+
+/// Max number of characters (including the null terminator) of a message
+constexpr int max_text{256};
+
+/// A reported message
+struct Message {
+  Level level;              ///< Severity
+  int thread;               ///< Id of the reporting thread (0, 1, ...)
+  std::uint32_t suppressed; ///< Messages of the same site suppressed (on the
+                            ///< reporting thread) before this one
+  char text[max_text];      ///< The message, without a level tag; lines after
+                            ///< the first start with '\n'
+};
+
+/// Message handler; called by one thread at a time
+using Handler = std::function<void(const Message &)>;
+
+/// Counts of reported messages, summed over all threads
+struct Stats {
+  std::uint64_t reported;   ///< Messages buffered
+  std::uint64_t suppressed; ///< Messages not buffered, because of the rate
+                            ///< limit
+  std::uint64_t dropped;    ///< Messages not buffered, because the ring was
+                            ///< full
+  std::uint64_t delivered;  ///< Messages passed to the handler
+};
+
+/// @brief Name of a level, e.g. "WARNING"
+const char *level_name(Level level) noexcept;
+
+/// @brief Report a message (printf-like format)
+void report(Level level, const char *fmt, ...) noexcept
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/// @brief Report a warning (printf-like format)
+void warning(const char *fmt, ...) noexcept
+#if defined(__GNUC__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+/// @brief Report an error (printf-like format)
+void error(const char *fmt, ...) noexcept
+#if defined(__GNUC__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+/// @brief Pass all buffered messages (of all threads) to the handler
+/// @return The number of messages delivered
+int flush() noexcept;
+
+/// @brief Set the message handler; an empty handler restores the default
+///        one (writing to std::cerr). Buffered messages are delivered to
+///        the previous handler first.
+/// @return The previous handler
+Handler set_handler(Handler handler);
+
+/// @brief Set the rate limit: at most max_per_interval messages per site,
+///        thread and interval (seconds). A value of max_per_interval < 1
+///        disables the limit.
+void set_rate_limit(int max_per_interval, double interval) noexcept;
+
+/// @brief Switch automatic delivery (right after a message is reported) on
+///        or off
+void set_auto_flush(bool on) noexcept;
+
+/// @brief Message counts
+void stats(Stats &s) noexcept;
+
+} // namespace diagnostics
+} // namespace ngpt
+
+#endif
@@ -3,14 +3,36 @@
 
 #include "eigen3/Eigen/Core"
 #include "eigen3/Eigen/Geometry"
-#include "eigen3/Eigen/Sparse"
+#include "eigen3/Eigen/LU"
+#include "instrument.hpp"
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstdio>
+#include <iostream>
+#include <vector>
 
 namespace ngpt {
 
-template <int Params> class Kalman {
+/// Kalman filter for a receiver's position and clock (bias and drift), from
+/// pseudoranges.
+///
+/// All matrices and vectors have compile-time maximum sizes (at most MaxObs
+/// observations per update), so that Eigen stores them inline; an update
+/// does not allocate memory.
+template <int Params, int MaxObs = 64> class Kalman {
+  /// Per observation vector
+  using ObsVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, MaxObs, 1>;
+  /// Observation by observation matrix
+  using ObsMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0,
+                                  MaxObs, MaxObs>;
+  /// Jacobian (observations by parameters)
+  using Jacobian =
+      Eigen::Matrix<double, Eigen::Dynamic, Params, 0, MaxObs, Params>;
+  /// Filter gain (parameters by observations)
+  using Gain =
+      Eigen::Matrix<double, Params, Eigen::Dynamic, 0, Params, MaxObs>;
+
 public:
   Kalman(std::initializer_list<double> &&l, double c = 1e0) {
     assert(l.size() == Params);
@@ -26,31 +48,45 @@ public:
       printf("%12.3f +/-%10.3f", state_(i), std::sqrt(P_(i, i)));
   }
 
-  void update(int nsats, const std::vector<double> *obs,
-              const std::vector<std::array<double, 4>> *sv, double dt,
-              const std::vector<double> *w = nullptr, bool dbg = false) {
+  /// @brief The i-th state parameter
+  double state(int i) const noexcept { return state_(i); }
+
+  /// @brief Filter update
+  /// @param[in] nsats Number of observations (at most MaxObs)
+  /// @param[in] obs   Array of nsats pseudoranges
+  /// @param[in] sv    Array of nsats satellite states (x, y, z, clock)
+  /// @param[in] dt    Time since the previous update
+  /// @param[in] w     Array of nsats weights (optional)
+  /// @param[in] dbg   Print intermediate results
+  /// @return 0 on success, 1 if nsats is out of range (nothing is updated)
+  int update(int nsats, const double *obs, const std::array<double, 4> *sv,
+             double dt, const double *w = nullptr, bool dbg = false) {
+    NGPT_TIME_SCOPE(filter_update);
+    if (nsats < 1 || nsats > MaxObs)
+      return 1;
+    NGPT_COUNT(filter_updates);
     // set the vector pointrers
     nsats_ = nsats;
     obs_ = obs;
     sv_ = sv;
     // state prediction : x(1|0) = F(0)*x(0|0)
     // Wait!! update F(3,4) to dt
-    F_.coeffRef(3, 4) = dt;
+    F_(3, 4) = dt;
     // std::cout<<"\nmatrix F\n"<<F_;
     state_ = F_ * state_;
     if (dbg)
       std::cout << "\nstate\n" << state_;
     // measurement prediction: p(1|0) = F(x(1|0)) = sqrt(....) + c*dt
-    auto p = compute_pseudorange_vector();
+    compute_pseudorange_vector();
     if (dbg)
-      std::cout << "\nComputed\n" << p;
+      std::cout << "\nComputed\n" << p_;
     // measurement residuals: v(1) = p(1) - p(1|0)
-    auto v = measurement_vector();
+    measurement_vector();
     if (dbg)
-      std::cout << "\nObserved:\n" << v;
-    v -= p;
+      std::cout << "\nObserved:\n" << v_;
+    v_ -= p_;
     if (dbg)
-      std::cout << "\nResiduals\n" << v;
+      std::cout << "\nResiduals\n" << v_;
     // evaluate Jacobian: H(1)
     evaluate_jacobian();
     if (dbg)
@@ -67,40 +103,46 @@ public:
     if (dbg)
       std::cout << "\nNext P=\n" << P_;
     // residual covariance: S = H(1)*P(1|0)*H^T(1) + R(1)
-    Eigen::MatrixXd S(H_ * P_ * H_.transpose());
+    HP_.noalias() = H_ * P_;
+    S_.noalias() = HP_ * H_.transpose();
     if (w)
       for (int i = 0; i < nsats_; i++)
-        S(i, i) += (100e0 + (*w)[i]);
+        S_(i, i) += (100e0 + w[i]);
     if (dbg)
-      std::cout << "\nResidual cov\n" << S;
+      std::cout << "\nResidual cov\n" << S_;
     // filter gain W: W = P(1|0) * H^T(1) *S^-1(1)
-    Eigen::MatrixXd W = P_ * H_.transpose() * S.inverse();
+    Sinv_ = S_.inverse();
+    W_.noalias() = P_ * H_.transpose() * Sinv_;
     if (dbg)
-      std::cout << "\nKalman Gain\n" << W;
+      std::cout << "\nKalman Gain\n" << W_;
     // update state covariance
-    P_ = P_ - W * S * W.transpose();
+    WS_.noalias() = W_ * S_;
+    P_.noalias() -= WS_ * W_.transpose();
     // std::cout<<"\nFinal P=\n"<<P_;
     // update state
-    state_ = state_ + W * v;
+    state_.noalias() += W_ * v_;
     // std::cout<<"\nFinal state\n"<<state_;
     // update the index
     ++update_idx;
-    return;
+    return 0;
+  }
+
+  /// @brief Filter update, with observations, states and weights in vectors
+  /// @see update(int, const double*, const std::array<double, 4>*, double,
+  ///      const double*, bool)
+  int update(int nsats, const std::vector<double> *obs,
+             const std::vector<std::array<double, 4>> *sv, double dt,
+             const std::vector<double> *w = nullptr, bool dbg = false) {
+    assert(obs->size() >= (std::size_t)nsats &&
+           sv->size() >= (std::size_t)nsats);
+    return update(nsats, obs->data(), sv->data(), dt,
+                  w ? w->data() : nullptr, dbg);
   }
 
 private:
   void initialize_F(double dt = 1e0) noexcept {
-    Eigen::SparseMatrix<double> sm(Params, Params);
-    sm.reserve(Params + 1);
-    std::vector<Eigen::Triplet<double>> tripletList;
-    tripletList.emplace_back(0, 0, 1e0);
-    tripletList.emplace_back(1, 1, 1e0);
-    tripletList.emplace_back(2, 2, 1e0);
-    tripletList.emplace_back(3, 3, 1e0);
-    tripletList.emplace_back(3, 4, dt);
-    tripletList.emplace_back(4, 4, 1e0);
-    sm.setFromTriplets(tripletList.begin(), tripletList.end());
-    F_ = std::move(sm);
+    F_.setIdentity();
+    F_(3, 4) = dt;
   }
 
   void make_dummy_P(double val) {
@@ -130,35 +172,33 @@ private:
     return;
   }
 
-  decltype(auto) compute_pseudorange_vector() {
-    Eigen::Matrix<double, Eigen::Dynamic, 1> p;
+  void compute_pseudorange_vector() noexcept {
+    ObsVector &p = p_;
     p.resize(nsats_, 1);
     const double xr = state_(0);
     const double yr = state_(1);
     const double zr = state_(2);
     const double cdt = state_(3);
     for (int i = 0; i < nsats_; i++) {
-      const double xs = (*sv_)[i][0];
-      const double ys = (*sv_)[i][1];
-      const double zs = (*sv_)[i][2];
+      const double xs = sv_[i][0];
+      const double ys = sv_[i][1];
+      const double zs = sv_[i][2];
       p(i) = std::sqrt((xs - xr) * (xs - xr) + (ys - yr) * (ys - yr) +
                        (zs - zr) * (zs - zr)) +
              cdt;
     }
-    return p;
   }
 
-  decltype(auto) measurement_vector(bool apply_sat_clock = true) {
-    Eigen::Matrix<double, Eigen::Dynamic, 1> p;
+  void measurement_vector(bool apply_sat_clock = true) noexcept {
+    ObsVector &p = v_;
     p.resize(nsats_, 1);
     if (apply_sat_clock) {
       for (int i = 0; i < nsats_; i++)
-        p(i) = (*obs_)[i] + (*sv_)[i][3] * 299792458e0 * coef;
+        p(i) = obs_[i] + sv_[i][3] * 299792458e0 * coef;
     } else {
       for (int i = 0; i < nsats_; i++)
-        p(i) = (*obs_)[i];
+        p(i) = obs_[i];
     }
-    return p;
   }
 
   decltype(auto) make_R_matrix() {}
@@ -169,9 +209,9 @@ private:
     const double yr = state_(1);
     const double zr = state_(2);
     for (int i = 0; i < nsats_; i++) {
-      const double xs = (*sv_)[i][0];
-      const double ys = (*sv_)[i][1];
-      const double zs = (*sv_)[i][2];
+      const double xs = sv_[i][0];
+      const double ys = sv_[i][1];
+      const double zs = sv_[i][2];
       double r = std::sqrt((xs - xr) * (xs - xr) + (ys - yr) * (ys - yr) +
                            (zs - zr) * (zs - zr));
       H_(i, 0) = -coef * (xs - xr) / r;
@@ -189,9 +229,9 @@ private:
     const double yr = state_(1);
     const double zr = state_(2);
     for (int i = 0; i < nsats_; i++) {
-      const double xs = (*sv_)[i][0];
-      const double ys = (*sv_)[i][1];
-      const double zs = (*sv_)[i][2];
+      const double xs = sv_[i][0];
+      const double ys = sv_[i][1];
+      const double zs = sv_[i][2];
       double r = std::sqrt((xs - xr) * (xs - xr) + (ys - yr) * (ys - yr) +
                            (zs - zr) * (zs - zr));
       Htmp(i, 0) = -(xs - xr) / r;
@@ -205,11 +245,19 @@ private:
 
   Eigen::Matrix<double, Params, 1> state_;
   Eigen::Matrix<double, Params, Params> P_; // TODO this is actually symmetric
-  Eigen::Matrix<double, Eigen::Dynamic, Params> H_;
+  Jacobian H_;
   double coef{1e0};
-  Eigen::SparseMatrix<double> F_;
-  const std::vector<double> *obs_{nullptr};
-  const std::vector<std::array<double, 4>> *sv_{nullptr};
+  Eigen::Matrix<double, Params, Params> F_;
+  // scratch space of update()
+  ObsVector p_;    ///< Computed pseudoranges
+  ObsVector v_;    ///< Observed pseudoranges, then residuals
+  Jacobian HP_;    ///< H * P
+  ObsMatrix S_;    ///< Residual covariance
+  ObsMatrix Sinv_; ///< Inverse of S
+  Gain W_;         ///< Filter gain
+  Gain WS_;        ///< W * S
+  const double *obs_{nullptr};
+  const std::array<double, 4> *sv_{nullptr};
   int nsats_{0};
   int update_idx{0};
 };
@@ -0,0 +1,88 @@
+#include "geometry.hpp"
+#include "ggeodesy/car2ell.hpp"
+#include "ggeodesy/geodesy.hpp"
+
+using ngpt::EpochGeometry;
+using ngpt::StationGeometry;
+
+/// @details The rotation angle is omega_e*tau; the rotation is about the
+///          z-axis, so the z component(s) are left unchanged. The same
+///          rotation is applied to the velocity vector (if n is 6).
+void ngpt::sagnac_rotate(const double *in, double tau, double *out,
+                         int n) noexcept {
+  const double theta = geometry::omega_earth * tau;
+  const double sint = std::sin(theta);
+  const double cost = std::cos(theta);
+  for (int i = 0; i < n; i += 3) {
+    const double xi = in[i];
+    const double yi = in[i + 1];
+    out[i] = cost * xi + sint * yi;
+    out[i + 1] = -sint * xi + cost * yi;
+    out[i + 2] = in[i + 2];
+  }
+}
+
+/// @details The station's ellipsoidal coordinates and the trigonometric
+///          numbers of latitude and longitude are computed here once and
+///          reused by every call to topocentric/line_of_sight.
+StationGeometry::StationGeometry(double x, double y, double z) noexcept
+    : x_(x), y_(y), z_(z) {
+  ngpt::car2ell<ngpt::ellipsoid::grs80>(x_, y_, z_, lat_, lon_, hgt_);
+  sinf_ = std::sin(lat_);
+  cosf_ = std::cos(lat_);
+  sinl_ = std::sin(lon_);
+  cosl_ = std::cos(lon_);
+}
+
+double StationGeometry::range(const double *pos) const noexcept {
+  const double dx = pos[0] - x_;
+  const double dy = pos[1] - y_;
+  const double dz = pos[2] - z_;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void StationGeometry::topocentric(double dx, double dy, double dz, double &e,
+                                  double &n, double &u) const noexcept {
+  n = -sinf_ * cosl_ * dx - sinf_ * sinl_ * dy + cosf_ * dz;
+  e = -sinl_ * dx + cosl_ * dy;
+  u = cosf_ * cosl_ * dx + cosf_ * sinl_ * dy + sinf_ * dz;
+}
+
+double StationGeometry::line_of_sight(const double *pos, double *unit,
+                                      double &az, double &el) const noexcept {
+  const double dx = pos[0] - x_;
+  const double dy = pos[1] - y_;
+  const double dz = pos[2] - z_;
+  const double r = std::sqrt(dx * dx + dy * dy + dz * dz);
+  unit[0] = dx / r;
+  unit[1] = dy / r;
+  unit[2] = dz / r;
+  double e, n, u;
+  topocentric(unit[0], unit[1], unit[2], e, n, u);
+  az = std::atan2(e, n);
+  if (az < 0e0)
+    az += 2e0 * ngpt::DPI;
+  el = std::atan2(u, std::sqrt(e * e + n * n));
+  return r;
+}
+
+void EpochGeometry::reserve(std::size_t n) {
+  for (auto v : {&x, &y, &z, &vx, &vy, &vz, &clock, &tau, &range, &ux, &uy,
+                 &uz, &azimuth, &elevation})
+    v->reserve(n);
+  status.reserve(n);
+}
+
+void EpochGeometry::resize(std::size_t n) {
+  if (n > x.size()) {
+    for (auto v : {&x, &y, &z, &vx, &vy, &vz, &clock, &tau, &range, &ux, &uy,
+                   &uz, &azimuth, &elevation})
+      v->resize(n);
+    status.resize(n);
+  }
+  size_ = n;
+}
+
+double EpochGeometry::zenith(std::size_t i) const noexcept {
+  return ngpt::DPI / 2e0 - elevation[i];
+}
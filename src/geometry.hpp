@@ -0,0 +1,203 @@
+#ifndef __GNSS_GEOMETRY_HPP__
+#define __GNSS_GEOMETRY_HPP__
+
+/// @file     geometry.hpp
+///
+/// @brief    Station-to-satellite geometry, i.e. satellite positions at
+///           signal transmission time (light-time iteration and Earth
+///           rotation (Sagnac) correction), ranges, line-of-sight unit
+///           vectors, azimuth and elevation angles.
+///
+/// @details  A StationGeometry instance holds the station's ECEF and
+///           ellipsoidal coordinates, along with the trigonometric numbers
+///           needed to rotate vectors to the local (topocentric) frame;
+///           these are computed once (at construction).
+///           An EpochGeometry instance holds the results for all satellites
+///           of an epoch, stored as a structure of arrays; reuse the same
+///           instance for every epoch, so that no memory is allocated once
+///           it has grown to the maximum number of satellites.
+
+#include "ggdatetime/dtcalendar.hpp"
+#include "navrnx.hpp"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ngpt {
+
+namespace geometry {
+/// Speed of light in vacuum in meters/sec
+constexpr double speed_of_light{299792458e0};
+/// Earth's rotation rate in radians/sec (WGS84)
+constexpr double omega_earth{7.2921151467e-5};
+/// Max number of light-time iterations
+constexpr int max_light_time_iterations{10};
+/// Light-time iterations stop when the change is less than this (seconds)
+constexpr double light_time_tolerance{1e-12};
+/// Initial (approximate) light-time for GNSS satellites in seconds
+constexpr double nominal_light_time{0.075e0};
+} // namespace geometry
+
+/// @brief Rotate a satellite state vector from the ECEF frame at signal
+///        transmission to the ECEF frame at signal reception (i.e. apply
+///        the Earth rotation/Sagnac correction)
+/// @param[in]  in  State vector at transmission (at least 3 elements)
+/// @param[in]  tau Signal travel time in seconds
+/// @param[out] out Rotated state vector (same size as in)
+/// @param[in]  n   Number of elements in the state vector; 3 (position only)
+///                 or 6 (position and velocity)
+void sagnac_rotate(const double *in, double tau, double *out,
+                   int n = 3) noexcept;
+
+/// @class StationGeometry
+/// A (static) station, with precomputed quantities for the transformation
+/// to the topocentric frame.
+class StationGeometry {
+public:
+  /// @brief Constructor from ECEF coordinates (meters); the ellipsoidal
+  ///        coordinates are computed w.r.t. the GRS80 ellipsoid
+  StationGeometry(double x, double y, double z) noexcept;
+
+  double x() const noexcept { return x_; }
+  double y() const noexcept { return y_; }
+  double z() const noexcept { return z_; }
+  /// @brief Latitude in radians
+  double latitude() const noexcept { return lat_; }
+  /// @brief Longitude in radians
+  double longitude() const noexcept { return lon_; }
+  /// @brief Ellipsoidal height in meters
+  double height() const noexcept { return hgt_; }
+
+  /// @brief Geometric distance between the station and a point
+  /// @param[in] pos ECEF position (x, y, z) in meters
+  double range(const double *pos) const noexcept;
+
+  /// @brief Project an ECEF vector (e.g. station to satellite) to the local
+  ///        east, north, up frame
+  void topocentric(double dx, double dy, double dz, double &e, double &n,
+                   double &u) const noexcept;
+
+  /// @brief Compute the line-of-sight quantities from the station to a point
+  /// @param[in]  pos  ECEF position (x, y, z) in meters
+  /// @param[out] unit Unit vector from the station to pos (3 elements)
+  /// @param[out] az   Azimuth in radians in the range [0, 2pi)
+  /// @param[out] el   Elevation in radians in the range [-pi/2, pi/2]
+  /// @return The geometric distance (range) in meters
+  double line_of_sight(const double *pos, double *unit, double &az,
+                       double &el) const noexcept;
+
+  /// @brief Compute the state vector and clock correction of a satellite at
+  ///        signal transmission time; the state is expressed in the ECEF
+  ///        frame at reception time (Sagnac-corrected).
+  /// @param[in]  nav   The navigation message to use
+  /// @param[in]  t_rx  The epoch of signal reception
+  /// @param[out] state Satellite position and velocity (6 elements)
+  /// @param[out] clock Satellite clock correction at transmission (sec)
+  /// @param[out] tau   Signal travel time in seconds
+  /// @return 0 on success, >0 denotes an error; if the light-time
+  ///         iteration did not converge, 1 is returned (state, clock and tau
+  ///         are still assigned the last values computed). A negative value
+  ///         is a warning from NavDataFrame::stateNclock (e.g. -1 for a
+  ///         GLONASS message used outside its fit interval); state, clock and
+  ///         tau are computed and can be used.
+  template <typename T>
+  int transmit_state(const NavDataFrame &nav, const ngpt::datetime<T> &t_rx,
+                     double *state, double &clock, double &tau) const {
+    double sv[6];
+    double tau_new;
+    int warning = 0;
+    tau = geometry::nominal_light_time;
+    for (int i = 0; i < geometry::max_light_time_iterations; i++) {
+      const int status = nav.stateNclock(t_rx, sv, clock, -tau);
+      if (status > 0)
+        return status;
+      warning = status;
+      sagnac_rotate(sv, tau, state, 6);
+      tau_new = range(state) / geometry::speed_of_light;
+      if (std::abs(tau_new - tau) < geometry::light_time_tolerance) {
+        tau = tau_new;
+        return warning;
+      }
+      tau = tau_new;
+    }
+    return 1;
+  }
+
+private:
+  double x_, y_, z_;       ///< ECEF coordinates in meters
+  double lat_, lon_, hgt_; ///< Ellipsoidal coordinates (radians, meters)
+  double sinf_, cosf_;     ///< sin and cos of latitude
+  double sinl_, cosl_;     ///< sin and cos of longitude
+}; // StationGeometry
+
+/// @class EpochGeometry
+/// Station-to-satellite geometry for all satellites of an epoch, stored as a
+/// structure of arrays; element i of each array refers to the i-th
+/// satellite (navigation message) passed to compute().
+class EpochGeometry {
+public:
+  std::vector<double> x, y, z;    ///< SV position in meters, ECEF at t_rx
+  std::vector<double> vx, vy, vz; ///< SV velocity in meters/sec
+  std::vector<double> clock;      ///< SV clock correction in seconds
+  std::vector<double> tau;        ///< Signal travel time in seconds
+  std::vector<double> range;      ///< Geometric range in meters
+  std::vector<double> ux, uy, uz; ///< Station-to-SV unit vector
+  std::vector<double> azimuth;    ///< Azimuth in radians
+  std::vector<double> elevation;  ///< Elevation in radians
+  std::vector<int> status;        ///< Status per SV; 0 means ok, <0 warning
+
+  /// @brief Reserve memory for (at least) n satellites
+  void reserve(std::size_t n);
+
+  /// @brief Set the number of satellites; memory is only allocated if n is
+  ///        larger than any previous size
+  void resize(std::size_t n);
+
+  /// @brief Number of satellites
+  std::size_t size() const noexcept { return size_; }
+
+  /// @brief Zenith angle of the i-th satellite in radians
+  double zenith(std::size_t i) const noexcept;
+
+  /// @brief Compute the geometry for all satellites of an epoch
+  /// @param[in] sta   The station
+  /// @param[in] t_rx  The epoch of signal reception
+  /// @param[in] navs  Array of n pointers to the navigation messages to use
+  ///                  (one per satellite)
+  /// @param[in] n     Number of satellites
+  /// @return The number of satellites for which the computation failed;
+  ///         see the status vector for individual results (a negative
+  ///         status is a warning; the geometry is still computed)
+  template <typename T>
+  int compute(const StationGeometry &sta, const ngpt::datetime<T> &t_rx,
+              const NavDataFrame *const *navs, std::size_t n) {
+    resize(n);
+    int errors = 0;
+    double state[6], unit[3];
+    for (std::size_t i = 0; i < n; i++) {
+      status[i] = sta.transmit_state(*navs[i], t_rx, state, clock[i], tau[i]);
+      if (status[i] > 0) {
+        ++errors;
+        continue;
+      }
+      x[i] = state[0];
+      y[i] = state[1];
+      z[i] = state[2];
+      vx[i] = state[3];
+      vy[i] = state[4];
+      vz[i] = state[5];
+      range[i] = sta.line_of_sight(state, unit, azimuth[i], elevation[i]);
+      ux[i] = unit[0];
+      uy[i] = unit[1];
+      uz[i] = unit[2];
+    }
+    return errors;
+  }
+
+private:
+  std::size_t size_{0}; ///< Number of satellites in use
+}; // EpochGeometry
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,106 @@
+#include "glofdma.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+using ngpt::GlonassFdmaTable;
+using glo_traits =
+    ngpt::satellite_system_traits<ngpt::SATELLITE_SYSTEM::glonass>;
+
+void GlonassFdmaTable::clear() noexcept {
+  for (int i = 0; i <= max_slot; i++) {
+    channels_[i] = unknown_channel;
+    for (int j = 0; j < num_bands; j++)
+      freqs_[i][j] = 0e0;
+  }
+}
+
+/// Set the frequency channel of a slot; the frequencies of all bands for
+/// this slot are computed here.
+/// @param[in] slot    The slot number, in range [1, max_slot]
+/// @param[in] channel The frequency channel, in range [-7, 6]
+/// @return 0 on success, 1 if slot or channel are out of range
+int GlonassFdmaTable::set_channel(int slot, int channel) noexcept {
+  if (slot < 1 || slot > max_slot || channel < glo_traits::min_channel ||
+      channel > glo_traits::max_channel)
+    return 1;
+  channels_[slot] = channel;
+  for (int j = 0; j < num_bands; j++)
+    freqs_[slot][j] = glo_traits::band2frequency(j + 1, channel);
+  return 0;
+}
+
+int GlonassFdmaTable::size() const noexcept {
+  int num = 0;
+  for (int i = 1; i <= max_slot; i++)
+    num += (channels_[i] != unknown_channel);
+  return num;
+}
+
+/// Fill the table (all slots) using a Bernese SATELLIT file; slots not
+/// matched in the file are marked as unknown.
+/// @param[in] bern A BernSatellit instance
+/// @param[in] t    The epoch for which we want the frequency channels
+/// @return The number of slots for which the frequency channel was resolved
+int GlonassFdmaTable::set_from_bern(
+    const BernSatellit &bern, const ngpt::datetime<ngpt::seconds> &t) noexcept {
+  int svn, channel, num = 0;
+  clear();
+  for (int slot = 1; slot <= max_slot; slot++) {
+    if (!bern.get_svn_and_channel(SATELLITE_SYSTEM::glonass, slot, t, svn,
+                                  channel))
+      num += !set_channel(slot, channel);
+  }
+  return num;
+}
+
+/// Resolve a line of type "GLONASS SLOT / FRQ #" as described in RINEX
+/// v3.x; the format is I3,1X,8(A1,I2.2,1X,I2,1X), i.e. up to 8 slots per
+/// line. Continuation lines have an empty first field.
+/// @param[in] line A header line of type "GLONASS SLOT / FRQ #"
+/// @return Anything other than 0 denotes an error
+int GlonassFdmaTable::resolve_rnx_line(const char *line) noexcept {
+  char buf[3] = {'\0', '\0', '\0'};
+  char *end;
+  for (int i = 0; i < 8; i++) {
+    const char *entry = line + 4 + i * 7;
+    if (*entry != 'R')
+      break;
+    std::memcpy(buf, entry + 1, 2);
+    int slot = static_cast<int>(std::strtol(buf, &end, 10));
+    if (end == buf || errno == ERANGE) {
+      errno = 0;
+      return 1;
+    }
+    std::memcpy(buf, entry + 4, 2);
+    int channel = static_cast<int>(std::strtol(buf, &end, 10));
+    if (end == buf || errno == ERANGE) {
+      errno = 0;
+      return 2;
+    }
+    if (set_channel(slot, channel))
+      return 3;
+  }
+  return 0;
+}
+
+/// Compute the frequency of a (GLONASS) observable (aka the sum of
+/// coefficient times frequency of each of its parts) for every slot with a
+/// known frequency channel. Use this to precompute combination frequencies
+/// once, instead of computing them for every observation.
+/// @param[in]  obs   A GLONASS observable (e.g. a linear combination)
+/// @param[out] freqs An array of (at least) max_slot+1 elements; at output,
+///                   freqs[slot] holds the frequency (MHz) of the observable
+///                   for the given slot, or 0 if the channel is unknown
+/// @return Anything other than 0 denotes an error (e.g. a part of the
+///         observable is on a band not used by its satellite system)
+int GlonassFdmaTable::observable_frequencies(const GnssObservable &obs,
+                                             double *freqs) const noexcept {
+  freqs[0] = 0e0;
+  for (const auto &part : obs.underlying_vector())
+    if (part.__coef != 0e0 && part.frequency(0) == 0e0)
+      return 1;
+  for (int slot = 1; slot <= max_slot; slot++)
+    freqs[slot] = has_channel(slot) ? obs.frequency(channels_[slot]) : 0e0;
+  return 0;
+}
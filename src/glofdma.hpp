@@ -0,0 +1,84 @@
+#ifndef __GNSS_GLONASS_FDMA_HPP__
+#define __GNSS_GLONASS_FDMA_HPP__
+
+/// @file     glofdma.hpp
+///
+/// @brief    GLONASS FDMA frequency channels per slot (aka PRN).
+///
+/// @details  GLONASS FDMA signals (bands 1 and 2) are transmitted at a
+///           frequency that depends on the satellite's frequency channel.
+///           A GlonassFdmaTable holds the channel of every slot and the
+///           (precomputed) frequencies of every band per slot, so that
+///           frequencies (and hence combination coefficients) are resolved
+///           once (e.g. per epoch or per file) and then looked up. The table
+///           can be filled from a Bernese SATELLIT file or from the RINEX
+///           observation header field "GLONASS SLOT / FRQ #".
+
+#include "bern_utils.hpp"
+#include "ggdatetime/dtcalendar.hpp"
+#include "gnssobsrv.hpp"
+#include "satsys.hpp"
+
+namespace ngpt {
+
+/// @class GlonassFdmaTable
+/// Frequency channel and band frequencies (MHz) per GLONASS slot.
+class GlonassFdmaTable {
+public:
+  /// Max slot number (slots are in the range [1, max_slot])
+  static constexpr int max_slot{32};
+  /// Channel value for slots with unknown frequency channel
+  static constexpr int unknown_channel{100};
+  /// Number of GLONASS frequency bands stored (bands 1, 2 and 3)
+  static constexpr int num_bands{3};
+
+  /// @brief Constructor; all slots have unknown channels
+  GlonassFdmaTable() noexcept { clear(); }
+
+  /// @brief Mark all slots as unknown
+  void clear() noexcept;
+
+  /// @brief Set the frequency channel of a slot
+  /// @return 0 on success, 1 if slot or channel are out of range
+  int set_channel(int slot, int channel) noexcept;
+
+  /// @brief Frequency channel of a slot (unknown_channel if not set)
+  int channel(int slot) const noexcept {
+    return (slot > 0 && slot <= max_slot) ? channels_[slot] : unknown_channel;
+  }
+
+  /// @brief True if the frequency channel of the slot is known
+  bool has_channel(int slot) const noexcept {
+    return channel(slot) != unknown_channel;
+  }
+
+  /// @brief Number of slots with known frequency channel
+  int size() const noexcept;
+
+  /// @brief Frequency (MHz) of a band (1, 2 or 3) for a slot; 0 if the
+  ///        channel of the slot (or the band) is unknown
+  double frequency(int slot, int band) const noexcept {
+    return (has_channel(slot) && band > 0 && band <= num_bands)
+               ? freqs_[slot][band - 1]
+               : 0e0;
+  }
+
+  /// @brief Fill the table from a Bernese SATELLIT file, for a given epoch
+  int set_from_bern(const BernSatellit &bern,
+                    const ngpt::datetime<ngpt::seconds> &t) noexcept;
+
+  /// @brief Resolve a line of type "GLONASS SLOT / FRQ #" (RINEX v3.x)
+  int resolve_rnx_line(const char *line) noexcept;
+
+  /// @brief Precompute the frequency of an observable for every slot
+  int observable_frequencies(const GnssObservable &obs, double *freqs) const
+      noexcept;
+
+private:
+  int channels_[max_slot + 1];           ///< Channel per slot (index 0 unused)
+  double freqs_[max_slot + 1][num_bands]; ///< Frequencies (MHz) per slot/band
+};                                        // GlonassFdmaTable
+
+} // namespace ngpt
+
+#endif
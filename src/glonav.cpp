@@ -1,4 +1,6 @@
 #include "navrnx.hpp"
+#include "diagnostics.hpp"
+#include "instrument.hpp"
 #include <cerrno>
 #include <iostream>
 #include <stdexcept>
@@ -282,13 +284,15 @@ noexcept
 /// @see  GLONASS-ICD, Appendix J, "Algorithms for determination of SV center of
 ///       mass position and velocity vector components using ephemeris data"
 int NavDataFrame::glo_ecef(double t_sec, double *state) const noexcept {
+  NGPT_TIME_SCOPE(glonass_state);
   int status = 0;
 
   const double toe_sec = toe__.sec().to_fractional_seconds();
   if (std::abs(t_sec - toe_sec) > 15 * 60e0) {
-    std::cerr << "\n[WARNING] NavDataFrame::glo_ecef() Time interval too large!"
-              << "abs(" << t_sec << " - " << toe_sec << ") > " << 15 * 60e0
-              << " sec";
+    ngpt::diagnostics::warning(
+        "NavDataFrame::glo_ecef() Time interval too large! abs(%g - %g) > %g "
+        "sec",
+        t_sec, toe_sec, 15 * 60e0);
     status = -1;
   }
 
@@ -320,7 +324,11 @@ int NavDataFrame::glo_ecef(double t_sec, double *state) const noexcept {
   std::copy(x, x + 6, yti);
   // Perform Runge-Kutta 4th
   // while (std::abs(ti-t_lim)>1e-9 && ++max_it<1500) {
-  while (h > 0 ? ti < t_lim : ti > t_lim && ++max_it < 1500) {
+  while ((h > 0 ? ti < t_lim : ti > t_lim) && ++max_it < 1500) {
+    // last step is shortened, so that we end up exactly at t_lim
+    const bool last = (h > 0) ? (ti + h >= t_lim) : (ti + h <= t_lim);
+    if (last)
+      h = t_lim - ti;
     // compute k1
     glo_state_deriv(yti, acc, k1);
     // compute k2
@@ -339,11 +347,13 @@ int NavDataFrame::glo_ecef(double t_sec, double *state) const noexcept {
     for (int i = 0; i < 6; i++)
       yti[i] += (h / 6) * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
     // update ti
-    ti += h;
+    ti = last ? t_lim : ti + h;
   }
+  NGPT_COUNT_N(rk4_steps, max_it);
   if (max_it >= 1500) {
-    std::cerr << "\n[ERROR] NavDataFrame::glo_ecef() h=" << h << ", from "
-              << toe_sec << " to " << t_lim << " last t=" << ti;
+    ngpt::diagnostics::error(
+        "NavDataFrame::glo_ecef() h=%g, from %g to %g last t=%g", h, toe_sec,
+        t_lim, ti);
     return 10;
   }
 
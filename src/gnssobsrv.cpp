@@ -2,7 +2,21 @@
 #include <algorithm>
 #include <stdexcept>
 
+/// @throw std::runtime_error for GLONASS FDMA signals, since the frequency
+///        depends on the frequency channel; use
+///        __ObsPart::frequency(int channel) for these.
 double ngpt::__ObsPart::frequency() const {
+  using ngpt::SATELLITE_SYSTEM;
+  using glo_traits = ngpt::satellite_system_traits<SATELLITE_SYSTEM::glonass>;
+  int band = __type.band();
+
+  if (__type.satsys() == SATELLITE_SYSTEM::glonass && glo_traits::is_fdma(band))
+    throw std::runtime_error(
+        "[ERROR] __ObsPart::frequency() GLONASS FDMA signal needs channel");
+  return this->frequency(0);
+}
+
+double ngpt::__ObsPart::frequency(int channel) const noexcept {
   using ngpt::SATELLITE_SYSTEM;
   int band = __type.band();
 
@@ -12,9 +26,9 @@ double ngpt::__ObsPart::frequency() const {
                band) *
            __coef;
   case SATELLITE_SYSTEM::glonass:
-    /*return ngpt::satellite_system_traits<SATELLITE_SYSTEM::glonass>
-      ::band2frequency(band)*__coef;*/
-    return 0;
+    return ngpt::satellite_system_traits<
+               SATELLITE_SYSTEM::glonass>::band2frequency(band, channel) *
+           __coef;
   case SATELLITE_SYSTEM::sbas:
     return ngpt::satellite_system_traits<
                SATELLITE_SYSTEM::sbas>::band2frequency(band) *
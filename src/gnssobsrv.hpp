@@ -22,8 +22,9 @@
 ///            for more details.
 
 #include "gnssobs.hpp"
+#include "inline_vector.hpp"
 #include "satsys.hpp"
-#include <vector>
+#include <string>
 
 namespace ngpt {
 
@@ -96,8 +97,15 @@ struct __ObsPart {
   bool operator!=(const __ObsPart &o) const noexcept { return !(*this == o); }
 
   /// nominal frequency multiplied by coefficient in MHz
+  /// @throw std::runtime_error for GLONASS FDMA signals (the frequency
+  ///        depends on the channel; use frequency(int))
   double frequency() const;
 
+  /// frequency multiplied by coefficient in MHz, for a given (GLONASS)
+  /// frequency channel; the channel is ignored for all other systems. The
+  /// frequency is 0 if the band is not used by the satellite system.
+  double frequency(int channel) const noexcept;
+
   /// return the type
   GnssRawObservable type() const noexcept { return __type; }
 
@@ -105,8 +113,18 @@ struct __ObsPart {
 
 }; // __ObsPart
 
+/// @class GnssObservable
+/// An observable, i.e. a linear combination of (at most max_parts) raw
+/// observables. The terms are stored inline, so that constructing, copying
+/// and comparing observables never allocates memory.
 class GnssObservable {
 public:
+  /// Max number of terms (raw observables) in a combination
+  static constexpr std::size_t max_parts{4};
+
+  /// Storage of the terms
+  using parts_type = ngpt::InlineVector<__ObsPart, max_parts>;
+
   GnssObservable(ngpt::SATELLITE_SYSTEM sys, ngpt::ObservationCode code,
                  double coef = 1e0) noexcept {
     __vec.emplace_back(sys, code, coef);
@@ -116,25 +134,50 @@ public:
     __vec.emplace_back(obs, coef);
   }
 
-  void add(GnssRawObservable obs, double coef = 1e0) noexcept {
-    __vec.emplace_back(obs, coef);
+  /// @brief Add a term
+  /// @return 0 on success, 1 if the observable already has max_parts terms
+  ///         (the term is not added)
+  int add(GnssRawObservable obs, double coef = 1e0) noexcept {
+    return __vec.emplace_back(obs, coef);
   }
 
-  void add(ngpt::SATELLITE_SYSTEM sys, ngpt::ObservationCode code,
-           double coef = 1e0) noexcept {
-    __vec.emplace_back(sys, code, coef);
+  /// @brief Add a term
+  /// @return 0 on success, 1 if the observable already has max_parts terms
+  ///         (the term is not added)
+  int add(ngpt::SATELLITE_SYSTEM sys, ngpt::ObservationCode code,
+          double coef = 1e0) noexcept {
+    return __vec.emplace_back(sys, code, coef);
   }
 
-  double frequency() const noexcept {
+  /// @brief Number of terms
+  std::size_t size() const noexcept { return __vec.size(); }
+
+  /// @brief Frequency of the observable in MHz (sum of coefficient times
+  ///        frequency, for all parts)
+  /// @throw std::runtime_error if any of the parts is a GLONASS FDMA signal;
+  ///        use frequency(int) in this case
+  double frequency() const {
     double frequency = 0e0;
     for (const auto &v : __vec)
       frequency += v.frequency();
     return frequency;
   }
 
-  std::vector<__ObsPart> underlying_vector() const noexcept { return __vec; }
+  /// @brief Frequency of the observable in MHz, for a given GLONASS frequency
+  ///        channel
+  double frequency(int channel) const noexcept {
+    double frequency = 0e0;
+    for (const auto &v : __vec)
+      frequency += v.frequency(channel);
+    return frequency;
+  }
+
+  /// @brief The terms (a view; no copy is made)
+  ngpt::ConstSpan<__ObsPart> underlying_vector() const noexcept {
+    return __vec.view();
+  }
 
-  std::vector<__ObsPart> &underlying_vector() noexcept { return __vec; }
+  parts_type &underlying_vector() noexcept { return __vec; }
 
   bool operator==(const GnssObservable &) const noexcept;
 
@@ -155,7 +198,7 @@ public:
   std::string to_string() const noexcept;
 
 private:
-  std::vector<__ObsPart> __vec;
+  parts_type __vec;
 }; // class GnssObservable
 
 } // namespace ngpt
@@ -1,4 +1,5 @@
 #include "navrnx.hpp"
+#include "diagnostics.hpp"
 #include <cassert>
 #include <cerrno>
 #include <iostream>
@@ -242,8 +243,8 @@ float NavDataFrame::gps_ura() const noexcept {
     ura_meters =
         static_cast<float>((long)(std::round(ura_meters * 10e0))) / 10e0;
   } else {
-    std::cerr << "\n[WARNING] URA index is " << ura_index
-              << " use satellite at your own risk!";
+    ngpt::diagnostics::warning(
+        "URA index is %g use satellite at your own risk!", ura_index);
   }
   return ura_meters;
 }
@@ -253,3 +254,15 @@ float NavDataFrame::gps_ura() const noexcept {
 int NavDataFrame::gps_fit_interval() const noexcept {
   return 3600L * static_cast<int>(data__[28]);
 }
+
+/// QZSS messages record a fit interval flag (IS-QZSS-PNT): 0 for two hours,
+/// 1 for more than two hours (taken as four hours here). Some writers record
+/// the fit interval in hours instead (as for GPS); values > 1 are treated as
+/// hours.
+/// @return Fit interval in seconds
+int NavDataFrame::qzs_fit_interval() const noexcept {
+  const int flag = static_cast<int>(data__[28]);
+  if (flag > 1)
+    return 3600L * flag;
+  return flag ? 4 * 3600L : 2 * 3600L;
+}
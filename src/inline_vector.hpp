@@ -0,0 +1,108 @@
+#ifndef __GNSS_INLINE_VECTOR_HPP__
+#define __GNSS_INLINE_VECTOR_HPP__
+
+/// @file     inline_vector.hpp
+///
+/// @brief    A fixed-capacity vector with inline storage, and a read-only
+///           view of contiguous elements.
+///
+/// @details  An InlineVector holds up to N elements inside the object itself,
+///           so that constructing, copying and filling it never touches the
+///           heap. It is meant for small, bounded collections (e.g. the
+///           terms of a linear combination of observables); elements must be
+///           trivially copyable, so that the whole vector is too. Adding an
+///           element to a full vector fails (with a status), it never grows.
+///
+///           A ConstSpan is a (pointer, size) pair referring to elements
+///           owned by someone else; use it to expose a container's elements
+///           without copying them.
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ngpt {
+
+/// @class ConstSpan
+/// A read-only view of size() contiguous elements; it does not own them.
+template <typename T> class ConstSpan {
+public:
+  /// @brief Constructor
+  constexpr ConstSpan(const T *data = nullptr, std::size_t size = 0) noexcept
+      : data_(data), size_(size) {}
+
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return !size_; }
+  constexpr const T *data() const noexcept { return data_; }
+  constexpr const T *begin() const noexcept { return data_; }
+  constexpr const T *end() const noexcept { return data_ + size_; }
+
+  /// @warning No bounds checking
+  constexpr const T &operator[](std::size_t i) const noexcept {
+    return data_[i];
+  }
+
+private:
+  const T *data_;
+  std::size_t size_;
+}; // ConstSpan
+
+/// @class InlineVector
+/// A vector of at most N (trivially copyable) elements, stored inline.
+template <typename T, std::size_t N> class InlineVector {
+  static_assert(std::is_trivially_copyable<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+                "InlineVector elements must be trivially copyable");
+  static_assert(N > 0, "InlineVector capacity must be positive");
+
+public:
+  /// @brief Max number of elements
+  static constexpr std::size_t capacity() noexcept { return N; }
+
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return !size_; }
+  bool full() const noexcept { return size_ == N; }
+
+  T *data() noexcept { return std::launder(reinterpret_cast<T *>(buf_)); }
+  const T *data() const noexcept {
+    return std::launder(reinterpret_cast<const T *>(buf_));
+  }
+
+  T *begin() noexcept { return data(); }
+  T *end() noexcept { return data() + size_; }
+  const T *begin() const noexcept { return data(); }
+  const T *end() const noexcept { return data() + size_; }
+
+  /// @warning No bounds checking
+  T &operator[](std::size_t i) noexcept { return data()[i]; }
+  const T &operator[](std::size_t i) const noexcept { return data()[i]; }
+
+  /// @brief A read-only view of the elements (valid while the vector is
+  ///        alive and not modified)
+  ConstSpan<T> view() const noexcept { return ConstSpan<T>(data(), size_); }
+
+  /// @brief Construct an element (from args) at the end
+  /// @return 0 on success, 1 if the vector is full (nothing is added)
+  template <typename... Args> int emplace_back(Args &&... args) noexcept {
+    static_assert(std::is_nothrow_constructible<T, Args...>::value,
+                  "InlineVector elements must be nothrow constructible");
+    if (size_ == N)
+      return 1;
+    ::new (static_cast<void *>(buf_ + size_ * sizeof(T)))
+        T(std::forward<Args>(args)...);
+    ++size_;
+    return 0;
+  }
+
+  /// @brief Remove all elements
+  void clear() noexcept { size_ = 0; }
+
+private:
+  alignas(T) unsigned char buf_[N * sizeof(T)];
+  std::size_t size_{0};
+}; // InlineVector
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,237 @@
+#include "instrument.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using ngpt::instrument::Counter;
+using ngpt::instrument::Snapshot;
+using ngpt::instrument::Stage;
+using ngpt::instrument::detail::ThreadStats;
+
+namespace {
+using steady = std::chrono::steady_clock;
+
+/// Min. time span used to calibrate the timer rate
+constexpr double min_calibration_seconds{10e-3};
+
+std::uint64_t raw_ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      steady::now().time_since_epoch().count());
+#endif
+}
+
+/// All threads' stats; never destroyed, since threads may exit after static
+/// destructors have run.
+struct Registry {
+  std::mutex mtx;
+  std::vector<ThreadStats *> live;
+  std::uint64_t counters[ngpt::instrument::num_counters]{};
+  std::uint64_t calls[ngpt::instrument::num_stages]{};
+  std::uint64_t ticks[ngpt::instrument::num_stages]{};
+  int threads{0};
+  std::uint64_t tick0{raw_ticks()};
+  steady::time_point time0{steady::now()};
+};
+
+Registry &registry() noexcept {
+  static Registry *r = new Registry;
+  return *r;
+}
+
+std::uint64_t value(const std::atomic<std::uint64_t> &v) noexcept {
+  return v.load(std::memory_order_relaxed);
+}
+
+/// Owns a thread's stats; at thread exit, the values are moved to the
+/// registry.
+struct ThreadHolder {
+  ThreadStats stats;
+  bool registered{false};
+
+  ThreadHolder() noexcept {
+    for (auto &c : stats.counters)
+      c.store(0, std::memory_order_relaxed);
+    for (auto &c : stats.calls)
+      c.store(0, std::memory_order_relaxed);
+    for (auto &c : stats.ticks)
+      c.store(0, std::memory_order_relaxed);
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    try {
+      r.live.push_back(&stats);
+      registered = true;
+      ++r.threads;
+    } catch (std::exception &) {
+      // not aggregated until the thread exits
+    }
+  }
+
+  ~ThreadHolder() noexcept {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    for (int i = 0; i < ngpt::instrument::num_counters; i++)
+      r.counters[i] += value(stats.counters[i]);
+    for (int i = 0; i < ngpt::instrument::num_stages; i++) {
+      r.calls[i] += value(stats.calls[i]);
+      r.ticks[i] += value(stats.ticks[i]);
+    }
+    if (registered)
+      r.live.erase(std::find(r.live.begin(), r.live.end(), &stats));
+    else
+      ++r.threads;
+  }
+};
+
+constexpr const char *counter_names[] = {
+    "epochs_parsed", "sat_lines_skipped", "kepler_iterations",
+    "rk4_steps",     "nav_seeks",         "filter_updates"};
+
+constexpr const char *stage_names[] = {"obs_epoch",     "nav_record",
+                                       "kepler_state",  "glonass_state",
+                                       "sp3_epoch",     "filter_update"};
+
+static_assert(sizeof(counter_names) / sizeof(counter_names[0]) ==
+                  ngpt::instrument::num_counters,
+              "A name is needed for every counter");
+static_assert(sizeof(stage_names) / sizeof(stage_names[0]) ==
+                  ngpt::instrument::num_stages,
+              "A name is needed for every stage");
+} // namespace
+
+const char *ngpt::instrument::counter_name(Counter c) noexcept {
+  const int i = static_cast<int>(c);
+  return (i >= 0 && i < num_counters) ? counter_names[i] : "unknown";
+}
+
+const char *ngpt::instrument::stage_name(Stage s) noexcept {
+  const int i = static_cast<int>(s);
+  return (i >= 0 && i < num_stages) ? stage_names[i] : "unknown";
+}
+
+/// The thread-local holder is created here, on the thread's first event.
+ThreadStats *ngpt::instrument::detail::register_thread() noexcept {
+  thread_local ThreadHolder holder;
+#ifdef NGPT_INSTRUMENT
+  tls_stats = &holder.stats;
+#endif
+  return &holder.stats;
+}
+
+/// The rate is the ratio of ticks to steady clock time since the registry
+/// was created; if less than min_calibration_seconds have passed, the
+/// function waits. With a steady clock timer, the rate is exact.
+double ngpt::instrument::detail::ticks_per_second() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  Registry &r = registry();
+  std::uint64_t t1;
+  double dt;
+  do {
+    t1 = raw_ticks();
+    dt = std::chrono::duration<double>(steady::now() - r.time0).count();
+  } while (dt < min_calibration_seconds);
+  return static_cast<double>(t1 - r.tick0) / dt;
+#else
+  return static_cast<double>(steady::period::den) / steady::period::num;
+#endif
+}
+
+void ngpt::instrument::snapshot(Snapshot &snap) noexcept {
+#ifdef NGPT_INSTRUMENT
+  snap.enabled = true;
+#else
+  snap.enabled = false;
+#endif
+  snap.ticks_per_second = detail::ticks_per_second();
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mtx);
+  snap.threads = r.threads;
+  std::copy(r.counters, r.counters + num_counters, snap.counters);
+  std::copy(r.calls, r.calls + num_stages, snap.calls);
+  std::copy(r.ticks, r.ticks + num_stages, snap.ticks);
+  for (const ThreadStats *s : r.live) {
+    for (int i = 0; i < num_counters; i++)
+      snap.counters[i] += value(s->counters[i]);
+    for (int i = 0; i < num_stages; i++) {
+      snap.calls[i] += value(s->calls[i]);
+      snap.ticks[i] += value(s->ticks[i]);
+    }
+  }
+}
+
+void ngpt::instrument::reset() noexcept {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mtx);
+  std::fill(r.counters, r.counters + num_counters, 0);
+  std::fill(r.calls, r.calls + num_stages, 0);
+  std::fill(r.ticks, r.ticks + num_stages, 0);
+  for (ThreadStats *s : r.live) {
+    for (auto &c : s->counters)
+      c.store(0, std::memory_order_relaxed);
+    for (auto &c : s->calls)
+      c.store(0, std::memory_order_relaxed);
+    for (auto &c : s->ticks)
+      c.store(0, std::memory_order_relaxed);
+  }
+}
+
+/// The object holds the build flag, the number of threads, the timer rate,
+/// a "counters" object (name: count) and a "stages" object (name: calls,
+/// ticks, seconds and nanoseconds per call).
+std::string ngpt::instrument::to_json(const Snapshot &snap) {
+  char buf[256];
+  std::string json;
+  std::snprintf(buf, sizeof buf,
+                "{\n  \"enabled\": %s,\n  \"threads\": %d,\n"
+                "  \"ticks_per_second\": %.6e,\n  \"counters\": {",
+                snap.enabled ? "true" : "false", snap.threads,
+                snap.ticks_per_second);
+  json += buf;
+  for (int i = 0; i < num_counters; i++) {
+    std::snprintf(buf, sizeof buf, "%s\n    \"%s\": %llu", i ? "," : "",
+                  counter_names[i],
+                  static_cast<unsigned long long>(snap.counters[i]));
+    json += buf;
+  }
+  json += "\n  },\n  \"stages\": {";
+  for (int i = 0; i < num_stages; i++) {
+    const double sec = snap.ticks_per_second > 0e0
+                           ? snap.ticks[i] / snap.ticks_per_second
+                           : 0e0;
+    std::snprintf(buf, sizeof buf,
+                  "%s\n    \"%s\": {\"calls\": %llu, \"ticks\": %llu, "
+                  "\"seconds\": %.9e, \"ns_per_call\": %.3f}",
+                  i ? "," : "", stage_names[i],
+                  static_cast<unsigned long long>(snap.calls[i]),
+                  static_cast<unsigned long long>(snap.ticks[i]), sec,
+                  snap.calls[i] ? sec * 1e9 / snap.calls[i] : 0e0);
+    json += buf;
+  }
+  json += "\n  }\n}\n";
+  return json;
+}
+
+/// @return 0 on success; 1 if the file cannot be opened, 2 on a write (or
+///         allocation) error
+int ngpt::instrument::write_json(const char *fn, const Snapshot &snap) noexcept {
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+  int err = 0;
+  try {
+    const std::string json = to_json(snap);
+    err = std::fwrite(json.data(), 1, json.size(), fp) != json.size();
+  } catch (std::exception &) {
+    err = 1;
+  }
+  err |= (std::fclose(fp) != 0);
+  return err ? 2 : 0;
+}
@@ -0,0 +1,187 @@
+#ifndef __GNSS_INSTRUMENT_HPP__
+#define __GNSS_INSTRUMENT_HPP__
+
+/// @file     instrument.hpp
+///
+/// @brief    Hot-path instrumentation: per-thread event counters and scoped
+///           stage timers, aggregated in snapshots that can be exported as
+///           JSON.
+///
+/// @details  Instrumentation is compiled in only if NGPT_INSTRUMENT is
+///           defined (configure with --enable-instrumentation); otherwise
+///           the NGPT_COUNT, NGPT_COUNT_N and NGPT_TIME_SCOPE macros expand
+///           to nothing and snapshots hold zeros.
+///
+///           Each thread records into its own block of counters, with a
+///           plain load and store (no locked instruction). The block is
+///           registered on the thread's first event. A snapshot adds up
+///           the blocks of all live threads and of threads that already
+///           exited. Values read while other threads are still recording
+///           may lag behind, but a single counter is never torn.
+///
+///           Timers read the time stamp counter (rdtsc) on x86 and a
+///           steady clock elsewhere. Ticks are converted to seconds with a
+///           rate calibrated against std::chrono::steady_clock.
+///
+///           Macros used in header-only code (e.g. Kalman::update) are
+///           expanded in the including translation unit, so that unit must
+///           be compiled with NGPT_INSTRUMENT too.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#ifdef NGPT_INSTRUMENT
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace ngpt {
+namespace instrument {
+
+/// Event counters.
+enum class Counter : int {
+  epochs_parsed,     ///< Observation RINEX epochs parsed
+  sat_lines_skipped, ///< Observation RINEX satellite lines skipped (system
+                     ///< not collected)
+  kepler_iterations, ///< Iterations of solve_kepler
+  rk4_steps,         ///< Runge-Kutta steps of GLONASS state integration
+  nav_seeks,         ///< Navigation RINEX stream repositionings
+  filter_updates,    ///< Kalman filter updates
+  count              ///< Number of counters (not a counter)
+};
+
+/// Timed stages.
+enum class Stage : int {
+  obs_epoch,     ///< ObservationRnx::read_next_epoch
+  nav_record,    ///< NavDataFrame::set_from_rnx3
+  kepler_state,  ///< NavDataFrame::kepler2state
+  glonass_state, ///< NavDataFrame::glo_ecef
+  sp3_epoch,     ///< Sp3c::get_next_epoch
+  filter_update, ///< Kalman::update
+  count          ///< Number of stages (not a stage)
+};
+
+constexpr int num_counters{static_cast<int>(Counter::count)};
+constexpr int num_stages{static_cast<int>(Stage::count)};
+
+/// @brief Name of a counter (as used in the JSON export)
+const char *counter_name(Counter c) noexcept;
+
+/// @brief Name of a stage (as used in the JSON export)
+const char *stage_name(Stage s) noexcept;
+
+/// Counters and timers summed over all threads.
+struct Snapshot {
+  bool enabled;                         ///< Library built with NGPT_INSTRUMENT
+  int threads;                          ///< Threads that recorded events
+  double ticks_per_second;              ///< Timer rate
+  std::uint64_t counters[num_counters]; ///< Event counts
+  std::uint64_t calls[num_stages];      ///< Timed calls per stage
+  std::uint64_t ticks[num_stages];      ///< Ticks spent per stage
+};
+
+/// @brief Sum the counters and timers of all threads
+void snapshot(Snapshot &snap) noexcept;
+
+/// @brief Zero the counters and timers of all threads; call this when no
+///        other thread is recording
+void reset() noexcept;
+
+/// @brief Format a snapshot as a JSON object
+std::string to_json(const Snapshot &snap);
+
+/// @brief Write a snapshot as JSON
+int write_json(const char *fn, const Snapshot &snap) noexcept;
+
+namespace detail {
+
+/// One thread's counters; only the owning thread writes to them.
+struct ThreadStats {
+  std::atomic<std::uint64_t> counters[num_counters];
+  std::atomic<std::uint64_t> calls[num_stages];
+  std::atomic<std::uint64_t> ticks[num_stages];
+};
+
+/// @brief Create and register the calling thread's ThreadStats
+ThreadStats *register_thread() noexcept;
+
+/// @brief Timer ticks per second (calibrated)
+double ticks_per_second() noexcept;
+
+#ifdef NGPT_INSTRUMENT
+/// The calling thread's stats; set on the first event
+inline thread_local ThreadStats *tls_stats{nullptr};
+
+inline ThreadStats &stats() noexcept {
+  ThreadStats *s = tls_stats;
+  return s ? *s : *register_thread();
+}
+
+/// Single writer increment; a plain load and store
+inline void add(std::atomic<std::uint64_t> &v, std::uint64_t n) noexcept {
+  v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void count(Counter c, std::uint64_t n) noexcept {
+  add(stats().counters[static_cast<int>(c)], n);
+}
+
+inline std::uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/// @class ScopedTimer
+/// Add the ticks between construction and destruction to a stage.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(Stage s) noexcept
+      : stage_(static_cast<int>(s)), t0_(ticks()) {}
+  ~ScopedTimer() noexcept {
+    const std::uint64_t t1 = ticks();
+    ThreadStats &st = stats();
+    add(st.ticks[stage_], t1 - t0_);
+    add(st.calls[stage_], 1);
+  }
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  int stage_;
+  std::uint64_t t0_;
+};
+#endif
+} // namespace detail
+
+} // namespace instrument
+} // namespace ngpt
+
+#ifdef NGPT_INSTRUMENT
+#define NGPT_INSTRUMENT_CAT2(a, b) a##b
+#define NGPT_INSTRUMENT_CAT(a, b) NGPT_INSTRUMENT_CAT2(a, b)
+/// Increment a counter (a ngpt::instrument::Counter enumerator) by one
+#define NGPT_COUNT(c)                                                          \
+  ::ngpt::instrument::detail::count(::ngpt::instrument::Counter::c, 1)
+/// Increment a counter by n
+#define NGPT_COUNT_N(c, n)                                                     \
+  ::ngpt::instrument::detail::count(::ngpt::instrument::Counter::c,            \
+                                    static_cast<std::uint64_t>(n))
+/// Time the rest of the enclosing scope as a stage (a
+/// ngpt::instrument::Stage enumerator)
+#define NGPT_TIME_SCOPE(s)                                                     \
+  const ::ngpt::instrument::detail::ScopedTimer NGPT_INSTRUMENT_CAT(           \
+      ngpt_scoped_timer_, __LINE__)(::ngpt::instrument::Stage::s)
+#else
+#define NGPT_COUNT(c) ((void)0)
+#define NGPT_COUNT_N(c, n) ((void)0)
+#define NGPT_TIME_SCOPE(s) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,132 @@
+#include "ionosphere.hpp"
+#include "geometry.hpp"
+#include "ggeodesy/geodesy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using ngpt::Klobuchar;
+using ngpt::SATELLITE_SYSTEM;
+
+namespace {
+constexpr double D2PI = 2e0 * ngpt::DPI;
+
+/// Earth radius over Earth radius plus shell height, for the BeiDou
+/// Klobuchar model (R = 6378 km, h = 375 km)
+constexpr double bds_shell_ratio{6378e3 / (6378e3 + 375e3)};
+
+/// Angular distance between the station and the pierce point of a shell
+/// model, given the elevation and the shell ratio R/(R+h)
+inline double earth_angle(double el, double ratio) noexcept {
+  return ngpt::DPI / 2e0 - el - std::asin(ratio * std::cos(el));
+}
+
+/// Latitude and longitude of the pierce point, given the station latitude
+/// (sin/cos), longitude, the angular distance psi and the azimuth
+inline void pierce_point(double sinf, double cosf, double lon, double psi,
+                         double az, double &lat_p, double &lon_p) noexcept {
+  const double sinp = std::sin(psi);
+  lat_p = std::asin(sinf * std::cos(psi) + cosf * sinp * std::cos(az));
+  lon_p = lon + std::asin(sinp * std::sin(az) / std::cos(lat_p));
+}
+
+/// Bring t (seconds) in the range [0, 86400)
+inline double seconds_of_day(double t) noexcept {
+  t = std::fmod(t, 86400e0);
+  return t < 0e0 ? t + 86400e0 : t;
+}
+} // namespace
+
+/// @details The station latitude and longitude (in semicircles for GPS and
+///          QZSS, trigonometric numbers for BeiDou) are computed here.
+Klobuchar::Klobuchar(SATELLITE_SYSTEM sys, const double *alpha,
+                     const double *beta, double lat, double lon)
+    : is_bds_(sys == SATELLITE_SYSTEM::beidou), lat_sc_(lat / ngpt::DPI),
+      lon_sc_(lon / ngpt::DPI), lon_(lon), sinf_(std::sin(lat)),
+      cosf_(std::cos(lat)) {
+  switch (sys) {
+  case (SATELLITE_SYSTEM::gps):
+    fref_ = satellite_system_traits<SATELLITE_SYSTEM::gps>::band2frequency(1);
+    break;
+  case (SATELLITE_SYSTEM::qzss):
+    fref_ = satellite_system_traits<SATELLITE_SYSTEM::qzss>::band2frequency(1);
+    break;
+  case (SATELLITE_SYSTEM::beidou):
+    fref_ =
+        satellite_system_traits<SATELLITE_SYSTEM::beidou>::band2frequency(1);
+    break;
+  default:
+    throw std::runtime_error(
+        "[ERROR] Klobuchar::Klobuchar() Cannot handle satellite system");
+  }
+  for (int i = 0; i < 4; i++) {
+    alpha_[i] = alpha[i];
+    beta_[i] = beta[i];
+  }
+}
+
+/// IS-GPS-200, 20.3.3.5.2.5; all angles in semicircles.
+double Klobuchar::gps_delay(double t, double az, double el) const noexcept {
+  const double E = el / ngpt::DPI;
+  const double psi = 0.0137e0 / (E + 0.11e0) - 0.022e0;
+  const double phi_i =
+      std::min(std::max(lat_sc_ + psi * std::cos(az), -0.416e0), 0.416e0);
+  const double lam_i =
+      lon_sc_ + psi * std::sin(az) / std::cos(phi_i * ngpt::DPI);
+  const double phi_m =
+      phi_i + 0.064e0 * std::cos((lam_i - 1.617e0) * ngpt::DPI);
+  const double tl = seconds_of_day(4.32e4 * lam_i + t);
+  const double F = 1e0 + 16e0 * std::pow(0.53e0 - E, 3);
+  const double amp = std::max(
+      alpha_[0] + phi_m * (alpha_[1] + phi_m * (alpha_[2] + phi_m * alpha_[3])),
+      0e0);
+  const double per = std::max(
+      beta_[0] + phi_m * (beta_[1] + phi_m * (beta_[2] + phi_m * beta_[3])),
+      72000e0);
+  const double x = D2PI * (tl - 50400e0) / per;
+  const double x2 = x * x;
+  const double T =
+      (std::abs(x) < 1.57e0)
+          ? F * (5e-9 + amp * (1e0 - x2 / 2e0 + x2 * x2 / 24e0))
+          : F * 5e-9;
+  return geometry::speed_of_light * T;
+}
+
+/// BDS-SIS-ICD, 5.2.4.7; the vertical delay is mapped to the slant
+/// direction via the shell (375 km) mapping function.
+double Klobuchar::bds_delay(double t, double az, double el) const noexcept {
+  const double psi = earth_angle(el, bds_shell_ratio);
+  double phi_m, lam_m;
+  pierce_point(sinf_, cosf_, lon_, psi, az, phi_m, lam_m);
+  const double tl = seconds_of_day(t + lam_m * 43200e0 / ngpt::DPI);
+  const double pm = std::abs(phi_m / ngpt::DPI);
+  const double A2 = std::max(
+      alpha_[0] + pm * (alpha_[1] + pm * (alpha_[2] + pm * alpha_[3])), 0e0);
+  const double A4 = std::min(
+      std::max(beta_[0] + pm * (beta_[1] + pm * (beta_[2] + pm * beta_[3])),
+               72000e0),
+      172800e0);
+  const double Iz = (std::abs(tl - 50400e0) < A4 / 4e0)
+                        ? 5e-9 + A2 * std::cos(D2PI * (tl - 50400e0) / A4)
+                        : 5e-9;
+  const double rc = bds_shell_ratio * std::cos(el);
+  return geometry::speed_of_light * Iz / std::sqrt(1e0 - rc * rc);
+}
+
+double Klobuchar::slant_delay(double t, double az, double el) const noexcept {
+  return is_bds_ ? bds_delay(t, az, el) : gps_delay(t, az, el);
+}
+
+/// The variant is resolved once per call (not per satellite); t is brought
+/// in the range of a day once too.
+void Klobuchar::slant_delay(double t, const double *az, const double *el,
+                            std::size_t n, double *delay) const noexcept {
+  t = seconds_of_day(t);
+  if (is_bds_) {
+    for (std::size_t i = 0; i < n; i++)
+      delay[i] = bds_delay(t, az[i], el[i]);
+  } else {
+    for (std::size_t i = 0; i < n; i++)
+      delay[i] = gps_delay(t, az[i], el[i]);
+  }
+}
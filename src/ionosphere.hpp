@@ -0,0 +1,92 @@
+#ifndef __GNSS_IONOSPHERE_HPP__
+#define __GNSS_IONOSPHERE_HPP__
+
+/// @file     ionosphere.hpp
+///
+/// @brief    Broadcast ionosphere models: Klobuchar (GPS, QZSS and BeiDou
+///           variants). The Galileo model (NeQuick-G) is not implemented;
+///           it needs the CCIR maps and an integration of the electron
+///           density along the ray. The Galileo broadcast coefficients are
+///           still available via NavigationRnx::ionospheric_corr.
+///
+/// @details  As for the troposphere models, every model is split in a site
+///           part and an epoch/satellite part. The broadcast coefficients and
+///           the station terms (e.g. latitude/longitude in semicircles and
+///           their trigonometric numbers) are set at construction. The batch
+///           function slant_delay evaluates the model for all satellites of
+///           an epoch (given azimuth and elevation) into a caller-provided
+///           buffer.
+///
+///           All delays are given in meters, on the reference frequency of
+///           the model (see reference_frequency); use scale_to to get the
+///           delay on any other frequency (aka multiply by (f_ref/f)^2).
+///           The broadcast coefficients can be extracted from a navigation
+///           RINEX header, via NavigationRnx::ionospheric_corr.
+
+#include "satsys.hpp"
+#include <cstddef>
+
+namespace ngpt {
+
+/// @class Klobuchar
+/// The Klobuchar model. For GPS (and QZSS) the algorithm is the one of
+/// IS-GPS-200 (20.3.3.5.2.5), with the ionospheric pierce point in
+/// geomagnetic latitude; for BeiDou it is the one of the BDS-SIS-ICD
+/// (5.2.4.7), with the pierce point at 375 km and the coefficients
+/// expressed in geographic latitude.
+class Klobuchar {
+public:
+  /// @brief Constructor
+  /// @param[in] sys   The satellite system of the coefficients; one of GPS,
+  ///                  QZSS or BeiDou
+  /// @param[in] alpha The four alpha coefficients
+  /// @param[in] beta  The four beta coefficients
+  /// @param[in] lat   Station latitude in radians
+  /// @param[in] lon   Station longitude in radians
+  /// @throw std::runtime_error if the satellite system is not supported
+  Klobuchar(SATELLITE_SYSTEM sys, const double *alpha, const double *beta,
+            double lat, double lon);
+
+  /// @brief Reference frequency in MHz (L1 for GPS/QZSS, B1I for BeiDou)
+  double reference_frequency() const noexcept { return fref_; }
+
+  /// @brief Factor to scale a delay from the reference frequency to the
+  ///        given frequency (in MHz)
+  double scale_to(double freq) const noexcept {
+    return (fref_ / freq) * (fref_ / freq);
+  }
+
+  /// @brief Slant ionospheric delay for one satellite
+  /// @param[in] t  Seconds of day in the system's time scale (GPST or BDT)
+  /// @param[in] az Azimuth in radians
+  /// @param[in] el Elevation in radians
+  /// @return Slant delay in meters on the reference frequency
+  double slant_delay(double t, double az, double el) const noexcept;
+
+  /// @brief Slant ionospheric delays for all satellites of an epoch
+  /// @param[in]  t     Seconds of day in the system's time scale
+  /// @param[in]  az    Azimuths in radians (n elements)
+  /// @param[in]  el    Elevations in radians (n elements)
+  /// @param[in]  n     Number of satellites
+  /// @param[out] delay Slant delays in meters on the reference frequency (n
+  ///                   elements)
+  void slant_delay(double t, const double *az, const double *el,
+                   std::size_t n, double *delay) const noexcept;
+
+private:
+  double gps_delay(double t, double az, double el) const noexcept;
+  double bds_delay(double t, double az, double el) const noexcept;
+
+  double alpha_[4];   ///< Amplitude coefficients
+  double beta_[4];    ///< Period coefficients
+  bool is_bds_;       ///< BeiDou variant
+  double fref_;       ///< Reference frequency (MHz)
+  double lat_sc_;     ///< Station latitude in semicircles
+  double lon_sc_;     ///< Station longitude in semicircles
+  double lon_;        ///< Station longitude in radians
+  double sinf_, cosf_; ///< Trigonometric numbers of station latitude
+};                     // Klobuchar
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef __GNSS_KEPLER_HPP__
+#define __GNSS_KEPLER_HPP__
+
+/// @file     kepler.hpp
+///
+/// @brief    Solution of Kepler's equation, M = E - e*sin(E), for the
+///           eccentric anomaly E.
+
+#include "instrument.hpp"
+#include <cmath>
+
+namespace ngpt {
+
+namespace kepler {
+/// Convergence limit (radians) for the eccentric anomaly
+constexpr double limit{1e-14};
+/// Max number of iterations; for GNSS orbits (e < 0.1) convergence takes 2
+/// or 3 iterations
+constexpr int max_iterations{10};
+} // namespace kepler
+
+/// @brief Solve Kepler's equation M = E - e*sin(E) for E, using Halley's
+///        method.
+///
+/// The starting value is the third order series expansion of E in e, aka
+/// E0 = M + e*sin(M) + e^2*sin(M)*cos(M); since Halley's method has cubic
+/// convergence, near-circular orbits (e.g. GNSS) converge in 2 to 3
+/// iterations.
+/// @param[in]  M     Mean anomaly in radians
+/// @param[in]  e     Eccentricity (0 <= e < 1)
+/// @param[out] E     Eccentric anomaly in radians
+/// @param[out] sinE  sin(E) (so that callers do not need to recompute it)
+/// @param[out] cosE  cos(E) (so that callers do not need to recompute it)
+/// @return The number of iterations performed, or -1 if the solution did
+///         not converge (in kepler::max_iterations); in this case E holds
+///         the last estimate
+inline int solve_kepler(double M, double e, double &E, double &sinE,
+                        double &cosE) noexcept {
+  const double sinM = std::sin(M);
+  E = M + e * sinM * (1e0 + e * std::cos(M));
+  for (int i = 1; i <= kepler::max_iterations; i++) {
+    sinE = std::sin(E);
+    cosE = std::cos(E);
+    const double f = E - e * sinE - M;
+    const double fp = 1e0 - e * cosE;
+    const double fpp = e * sinE;
+    const double dE = f / (fp - 0.5e0 * f * fpp / fp);
+    E -= dE;
+    if (std::abs(dE) < kepler::limit) {
+      sinE = std::sin(E);
+      cosE = std::cos(E);
+      NGPT_COUNT_N(kepler_iterations, i);
+      return i;
+    }
+  }
+  NGPT_COUNT_N(kepler_iterations, kepler::max_iterations);
+  return -1;
+}
+
+/// @brief Solve Kepler's equation M = E - e*sin(E) for E.
+/// @see solve_kepler(double, double, double&, double&, double&)
+inline int solve_kepler(double M, double e, double &E) noexcept {
+  double sinE, cosE;
+  return solve_kepler(M, e, E, sinE, cosE);
+}
+
+} // namespace ngpt
+
+#endif
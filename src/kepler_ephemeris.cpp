@@ -0,0 +1,152 @@
+#include "kepler_ephemeris.hpp"
+#include "kepler.hpp"
+#include <cmath>
+#include <stdexcept>
+
+using ngpt::KeplerEphemeris;
+using ngpt::SATELLITE_SYSTEM;
+
+namespace {
+/// System-dependent constants needed to prepare an ephemeris
+struct KeplerSystemConstants {
+  double mi;         ///< Gravitational constant
+  double omegae_dot; ///< Earth's rotation rate
+  double f_clock;    ///< Relativistic clock correction constant
+};
+
+template <SATELLITE_SYSTEM S>
+KeplerSystemConstants constants_for() noexcept {
+  using traits = ngpt::satellite_system_traits<S>;
+  return {traits::mi(), traits::omegae_dot(), traits::f_clock()};
+}
+} // namespace
+
+/// @details See KeplerEphemeris::set
+/// @throw std::runtime_error if the satellite system of the frame is not
+///        one of GPS, Galileo, BeiDou, QZSS or IRNSS
+KeplerEphemeris::KeplerEphemeris(const NavDataFrame &nav) {
+  if (set(nav))
+    throw std::runtime_error("[ERROR] KeplerEphemeris::KeplerEphemeris() "
+                             "Cannot handle satellite system");
+}
+
+/// Compute and store all epoch-independent quantities of the navigation
+/// block. The layout of the data block is the same for GPS, Galileo, BeiDou,
+/// QZSS and IRNSS (see NavDataFrame::kepler2state).
+/// @param[in] nav A navigation data block for GPS, Galileo, BeiDou, QZSS or
+///                IRNSS
+/// @return 0 on success, 1 if the satellite system is not supported
+int KeplerEphemeris::set(const NavDataFrame &nav) noexcept {
+  KeplerSystemConstants c;
+  switch (nav.system()) {
+  case (SATELLITE_SYSTEM::gps):
+    c = constants_for<SATELLITE_SYSTEM::gps>();
+    break;
+  case (SATELLITE_SYSTEM::galileo):
+    c = constants_for<SATELLITE_SYSTEM::galileo>();
+    break;
+  case (SATELLITE_SYSTEM::beidou):
+    c = constants_for<SATELLITE_SYSTEM::beidou>();
+    break;
+  case (SATELLITE_SYSTEM::qzss):
+    c = constants_for<SATELLITE_SYSTEM::qzss>();
+    break;
+  case (SATELLITE_SYSTEM::irnss):
+    c = constants_for<SATELLITE_SYSTEM::irnss>();
+    break;
+  default:
+    return 1;
+  }
+
+  sys_ = nav.system();
+  prn_ = nav.prn();
+  const auto toe = nav.toe<ngpt::seconds>();
+  const auto toc = nav.toc<ngpt::seconds>();
+  toe_mjd_ = toe.mjd().as_underlying_type();
+  toe_sec_ = toe.sec().to_fractional_seconds();
+  toc_m_toe_ = toc.sec().to_fractional_seconds() - toe_sec_ +
+               86400e0 * static_cast<double>(toc.mjd().as_underlying_type() -
+                                              toe_mjd_);
+
+  const double sqrtA = nav.data(10);
+  A_ = sqrtA * sqrtA;
+  e_ = nav.data(8);
+  sqrt1me2_ = std::sqrt(1e0 - e_ * e_);
+  n_ = std::sqrt(c.mi / (A_ * A_ * A_)) + nav.data(5);
+  M0_ = nav.data(6);
+  omega_ = nav.data(17);
+  cuc_ = nav.data(7);
+  cus_ = nav.data(9);
+  crc_ = nav.data(16);
+  crs_ = nav.data(4);
+  cic_ = nav.data(12);
+  cis_ = nav.data(14);
+  i0_ = nav.data(15);
+  idot_ = nav.data(19);
+  Omega0_ = nav.data(13) - c.omegae_dot * nav.data(11);
+  Omegadot_ = nav.data(18) - c.omegae_dot;
+  af0_ = nav.data(0);
+  af1_ = nav.data(1);
+  af2_ = nav.data(2);
+  Frel_ = c.f_clock * e_ * sqrtA;
+  return 0;
+}
+
+/// The algorithm is the one of IS-GPS-200 (Table 20-IV), augmented with the
+/// time derivatives to get the SV velocity. The clock correction uses the
+/// same eccentric anomaly as the position (aka at tk, not at t - ToC).
+int KeplerEphemeris::evaluate(double tk, double *state, double &clock,
+                              double *Ek) const noexcept {
+  // Solve Kepler's equation
+  double E, sinE, cosE;
+  if (ngpt::solve_kepler(M0_ + n_ * tk, e_, E, sinE, cosE) < 0)
+    return 1;
+  if (Ek)
+    *Ek = E;
+
+  const double ecosEm1 = 1e0 - e_ * cosE;
+  const double vk = std::atan2(sqrt1me2_ * sinE, cosE - e_); // True Anomaly
+  const double Edot = n_ / ecosEm1;
+  const double vdot = Edot * sqrt1me2_ / ecosEm1;
+
+  // Second Harmonic Perturbations
+  const double Fk = vk + omega_;
+  const double sin2F = std::sin(2e0 * Fk);
+  const double cos2F = std::cos(2e0 * Fk);
+  const double uk = Fk + cus_ * sin2F + cuc_ * cos2F;
+  const double rk = A_ * ecosEm1 + crs_ * sin2F + crc_ * cos2F;
+  const double ik = i0_ + cis_ * sin2F + cic_ * cos2F + idot_ * tk;
+  const double ukdot = vdot * (1e0 + 2e0 * (cus_ * cos2F - cuc_ * sin2F));
+  const double rkdot =
+      A_ * e_ * sinE * Edot + 2e0 * vdot * (crs_ * cos2F - crc_ * sin2F);
+  const double ikdot = idot_ + 2e0 * vdot * (cis_ * cos2F - cic_ * sin2F);
+
+  // Positions and velocities in orbital plane
+  const double sinu = std::sin(uk);
+  const double cosu = std::cos(uk);
+  const double xp = rk * cosu;
+  const double yp = rk * sinu;
+  const double xpdot = rkdot * cosu - yp * ukdot;
+  const double ypdot = rkdot * sinu + xp * ukdot;
+
+  // Corrected longitude of ascending node
+  const double Ok = Omega0_ + Omegadot_ * tk;
+  const double sinO = std::sin(Ok);
+  const double cosO = std::cos(Ok);
+  const double sini = std::sin(ik);
+  const double cosi = std::cos(ik);
+
+  state[0] = xp * cosO - yp * sinO * cosi;
+  state[1] = xp * sinO + yp * cosO * cosi;
+  state[2] = yp * sini;
+  state[3] = -xp * Omegadot_ * sinO + xpdot * cosO - ypdot * sinO * cosi -
+             yp * (Omegadot_ * cosO * cosi - ikdot * sinO * sini);
+  state[4] = xp * Omegadot_ * cosO + xpdot * sinO + ypdot * cosO * cosi -
+             yp * (Omegadot_ * sinO * cosi + ikdot * cosO * sini);
+  state[5] = ypdot * sini + yp * ikdot * cosi;
+
+  // Clock correction
+  const double dt = tk - toc_m_toe_;
+  clock = af0_ + (af1_ + af2_ * dt) * dt + Frel_ * sinE;
+  return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef __GNSS_KEPLER_EPHEMERIS_HPP__
+#define __GNSS_KEPLER_EPHEMERIS_HPP__
+
+/// @file     kepler_ephemeris.hpp
+///
+/// @brief    A "prepared" broadcast ephemeris for systems using Keplerian
+///           elements (GPS, Galileo, BeiDou, QZSS and IRNSS).
+///
+/// @details  A KeplerEphemeris is built once from a NavDataFrame; all
+///           quantities that do not depend on the evaluation epoch (e.g.
+///           semi-major axis, corrected mean motion, sqrt(1-e^2), the
+///           longitude of the ascending node at the start of the week, the
+///           relativistic clock factor) are computed at construction, so that
+///           an evaluation only involves the epoch-dependent part of the
+///           algorithm. Kepler's equation is solved via solve_kepler.
+///           The type is trivially copyable, so that arrays of prepared
+///           ephemerides can be copied (or mapped) as plain memory.
+
+#include "ggdatetime/dtcalendar.hpp"
+#include "navrnx.hpp"
+#include "satsys.hpp"
+#include <type_traits>
+
+namespace ngpt {
+
+/// @class KeplerEphemeris
+/// Precomputed broadcast ephemeris for GPS, Galileo, BeiDou, QZSS and IRNSS.
+class KeplerEphemeris {
+public:
+  /// @brief Default constructor; the instance is unusable until set
+  KeplerEphemeris() noexcept = default;
+
+  /// @brief Constructor from a navigation data block
+  /// @throw std::runtime_error if the satellite system of the frame is not
+  ///        one of GPS, Galileo, BeiDou, QZSS or IRNSS
+  explicit KeplerEphemeris(const NavDataFrame &nav);
+
+  /// @brief Set from a navigation data block
+  int set(const NavDataFrame &nav) noexcept;
+
+  /// @brief Satellite system
+  SATELLITE_SYSTEM system() const noexcept { return sys_; }
+
+  /// @brief PRN
+  int prn() const noexcept { return prn_; }
+
+  /// @brief Compute state vector and clock correction
+  /// @param[in]  tk    Seconds since ToE
+  /// @param[out] state SV position (meters) and velocity (meters/sec) in ECEF;
+  ///                   must have length >= 6
+  /// @param[out] clock SV clock correction (seconds), including the
+  ///                   relativistic correction but not code biases (e.g. tgd)
+  /// @param[out] Ek    If not null, the eccentric anomaly (radians)
+  /// @return Anything other than 0 denotes an error
+  int evaluate(double tk, double *state, double &clock,
+               double *Ek = nullptr) const noexcept;
+
+  /// @brief Seconds since ToE for a given epoch (plus an optional offset in
+  ///        seconds)
+  template <typename T>
+  double seconds_since_toe(const ngpt::datetime<T> &t,
+                           double offset = 0e0) const noexcept {
+    return t.sec().to_fractional_seconds() - toe_sec_ + offset +
+           86400e0 * static_cast<double>(t.mjd().as_underlying_type() -
+                                          toe_mjd_);
+  }
+
+  /// @brief Compute state vector and clock correction at epoch t+offset
+  /// @see KeplerEphemeris::evaluate
+  template <typename T>
+  int stateNclock(const ngpt::datetime<T> &t, double *state, double &clock,
+                  double offset = 0e0) const noexcept {
+    return evaluate(seconds_since_toe(t, offset), state, clock);
+  }
+
+private:
+  SATELLITE_SYSTEM sys_{}; ///< Satellite system
+  int prn_{0};             ///< PRN
+  long toe_mjd_{0};        ///< MJD of ToE
+  double toe_sec_{0e0};    ///< Seconds of day of ToE
+  double toc_m_toe_{0e0};  ///< ToC - ToE in seconds
+  double A_{0e0};          ///< Semi-major axis (meters)
+  double e_{0e0};          ///< Eccentricity
+  double sqrt1me2_{0e0};   ///< sqrt(1 - e^2)
+  double n_{0e0};          ///< Corrected mean motion (rad/sec)
+  double M0_{0e0};         ///< Mean anomaly at reference time
+  double omega_{0e0};      ///< Argument of perigee
+  double cuc_{0e0}, cus_{0e0}, crc_{0e0}, crs_{0e0}, cic_{0e0}, cis_{0e0};
+  double i0_{0e0};         ///< Inclination at reference time
+  double idot_{0e0};       ///< Rate of inclination angle
+  double Omega0_{0e0};     ///< Omega0 - omega_e * toe (at start of week)
+  double Omegadot_{0e0};   ///< Omega_dot - omega_e
+  double af0_{0e0}, af1_{0e0}, af2_{0e0}; ///< Clock polynomial
+  double Frel_{0e0};       ///< F * e * sqrt(A) (relativistic clock term)
+};                         // KeplerEphemeris
+
+static_assert(std::is_trivially_copyable<KeplerEphemeris>::value,
+              "KeplerEphemeris must be trivially copyable");
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,170 @@
+#include "live_ephemeris.hpp"
+#include <cmath>
+#include <new>
+#include <stdexcept>
+
+using ngpt::LiveEphemerisStore;
+using ngpt::SATELLITE_SYSTEM;
+
+namespace {
+/// Seconds since MJD 0 of a datetime<seconds>
+inline double to_seconds(const ngpt::datetime<ngpt::seconds> &t) noexcept {
+  return static_cast<double>(t.mjd().as_underlying_type()) * 86400e0 +
+         t.sec().to_fractional_seconds();
+}
+} // namespace
+
+/// @throw std::runtime_error if all reader slots are in use
+LiveEphemerisStore::Reader::Reader(const LiveEphemerisStore &store)
+    : store_(store), slot_(nullptr) {
+  for (int i = 0; i < max_readers; i++) {
+    bool expected = false;
+    if (store_.readers_[i].in_use.compare_exchange_strong(expected, true)) {
+      slot_ = &store_.readers_[i];
+      slot_->epoch.store(0);
+      return;
+    }
+  }
+  throw std::runtime_error("[ERROR] LiveEphemerisStore::Reader::Reader() Too "
+                           "many registered readers");
+}
+
+LiveEphemerisStore::Reader::~Reader() noexcept {
+  slot_->epoch.store(0);
+  slot_->in_use.store(false, std::memory_order_release);
+}
+
+LiveEphemerisStore::LiveEphemerisStore() noexcept {
+  for (auto &s : sats_)
+    s.store(nullptr, std::memory_order_relaxed);
+}
+
+/// No reader may be registered (or use the store) at destruction.
+LiveEphemerisStore::~LiveEphemerisStore() noexcept {
+  for (auto &s : sats_)
+    delete s.load();
+  for (auto &r : retired_)
+    delete r.second;
+}
+
+/// The satellite's node is copied, the message is inserted (replacing a
+/// message with the same ToC, if any; the oldest message is dropped if the
+/// node is full) and the new node is made visible to readers. The old node
+/// is retired and freed as soon as no reader can hold it.
+/// @param[in] frame The new message
+/// @return 0 on success, 1 if the satellite is out of range, 2 on allocation
+///         failure
+int LiveEphemerisStore::publish(const NavDataFrame &frame) noexcept {
+  const int idx = frame.sat_id().index();
+  if (idx < 0)
+    return 1;
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+
+  const SatNode *old_node = sats_[idx].load(std::memory_order_relaxed);
+  SatNode *node = new (std::nothrow) SatNode;
+  if (!node)
+    return 2;
+  if (old_node)
+    *node = *old_node;
+
+  // insert, sorted by ToC
+  const double toc = to_seconds(frame.toc());
+  int pos = 0;
+  while (pos < node->count && to_seconds(node->msgs[pos].toc()) < toc)
+    ++pos;
+  if (pos < node->count && to_seconds(node->msgs[pos].toc()) == toc) {
+    // replace
+  } else {
+    if (node->count == messages_per_sat) {
+      // drop the oldest
+      if (pos == 0) {
+        delete node;
+        return 0;
+      }
+      for (int i = 1; i < pos; i++) {
+        node->msgs[i - 1] = node->msgs[i];
+        node->keps[i - 1] = node->keps[i];
+        node->has_kep[i - 1] = node->has_kep[i];
+      }
+      --pos;
+    } else {
+      for (int i = node->count; i > pos; i--) {
+        node->msgs[i] = node->msgs[i - 1];
+        node->keps[i] = node->keps[i - 1];
+        node->has_kep[i] = node->has_kep[i - 1];
+      }
+      ++node->count;
+    }
+  }
+  node->msgs[pos] = frame;
+  node->has_kep[pos] = !node->keps[pos].set(frame);
+
+  sats_[idx].store(node, std::memory_order_seq_cst);
+  if (old_node) {
+    try {
+      retired_.emplace_back(epoch_.load(std::memory_order_seq_cst), old_node);
+    } catch (std::exception &) {
+      // cannot retire; leak the node rather than free it under a reader
+    }
+  }
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  reclaim_locked();
+  return 0;
+}
+
+std::size_t LiveEphemerisStore::reclaim() noexcept {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  return reclaim_locked();
+}
+
+std::size_t LiveEphemerisStore::pending_reclamation() const noexcept {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  return retired_.size();
+}
+
+/// A node retired at epoch e may be held by readers that announced an epoch
+/// <= e; it is freed when every active reader has announced a later epoch
+/// (or is not in a critical section).
+std::size_t LiveEphemerisStore::reclaim_locked() noexcept {
+  std::uint64_t min_epoch = UINT64_MAX;
+  for (const auto &r : readers_) {
+    const std::uint64_t e = r.epoch.load(std::memory_order_seq_cst);
+    if (e && e < min_epoch)
+      min_epoch = e;
+  }
+  std::size_t freed = 0;
+  auto it = retired_.begin();
+  while (it != retired_.end()) {
+    if (it->first < min_epoch) {
+      delete it->second;
+      *it = retired_.back();
+      retired_.pop_back();
+      ++freed;
+    } else {
+      ++it;
+    }
+  }
+  return freed;
+}
+
+int LiveEphemerisStore::select(const SatNode &node, SATELLITE_SYSTEM sys,
+                               long mjd, double sec) noexcept {
+  const double t = static_cast<double>(mjd) * 86400e0 + sec;
+  if (sys == SATELLITE_SYSTEM::glonass) {
+    int best = -1;
+    double dmin = 0e0;
+    for (int i = 0; i < node.count; i++) {
+      const double d =
+          std::abs(to_seconds(node.msgs[i].toe<ngpt::seconds>()) - t);
+      if (best < 0 || d < dmin) {
+        best = i;
+        dmin = d;
+      }
+    }
+    return best;
+  }
+  for (int i = node.count - 1; i >= 0; i--)
+    if (to_seconds(node.msgs[i].toc()) <= t)
+      return i;
+  return -1;
+}
@@ -0,0 +1,200 @@
+#ifndef __GNSS_LIVE_EPHEMERIS_HPP__
+#define __GNSS_LIVE_EPHEMERIS_HPP__
+
+/// @file     live_ephemeris.hpp
+///
+/// @brief    A concurrent store of navigation messages, for real-time
+///           processing: writers publish new messages (e.g. decoded from a
+///           stream) while reader threads evaluate orbits.
+///
+/// @details  The store is RCU-style: every satellite has an (atomic) pointer
+///           to an immutable node holding its most recent messages. A writer
+///           copies the node, inserts the new message and swaps the pointer;
+///           readers only load the pointer. The old node is retired and freed
+///           via epoch-based reclamation, once no reader can still hold it.
+///
+///           Readers register once (per thread) via a LiveEphemerisStore::Reader;
+///           every lookup announces the current global epoch in the reader's
+///           (cache-line sized) slot, loads the node and clears the slot. This
+///           is a fixed number of atomic operations, i.e. readers are
+///           wait-free and never blocked by writers. Writers serialize on a
+///           mutex (they never wait for readers; nodes that cannot be freed
+///           yet are kept for a later reclamation pass).
+
+#include "ggdatetime/dtcalendar.hpp"
+#include "kepler_ephemeris.hpp"
+#include "navrnx.hpp"
+#include "satid.hpp"
+#include "satsys.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ngpt {
+
+/// @class LiveEphemerisStore
+/// Concurrent (RCU-style) store of navigation messages.
+class LiveEphemerisStore {
+public:
+  /// Max PRN per satellite system
+  static constexpr int max_prn{SatId::max_prn};
+  /// Number of satellite systems (excluding mixed)
+  static constexpr int num_systems{SatId::num_systems};
+  /// Max number of satellites
+  static constexpr int max_sats{SatId::max_sats};
+  /// Max number of (concurrently) registered readers
+  static constexpr int max_readers{64};
+  /// Number of (most recent) messages kept per satellite
+  static constexpr int messages_per_sat{4};
+
+private:
+  /// Immutable set of messages of a satellite, sorted by ToC
+  struct SatNode {
+    int count{0};
+    NavDataFrame msgs[messages_per_sat];
+    KeplerEphemeris keps[messages_per_sat];
+    bool has_kep[messages_per_sat]{};
+  };
+
+  /// A reader's announcement slot; 0 means the reader is not in a critical
+  /// section
+  struct alignas(64) ReaderSlot {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool> in_use{false};
+  };
+
+public:
+  /// @class Reader
+  /// A registered reader; create one per (reader) thread and use it for all
+  /// lookups of that thread. Not thread-safe by itself.
+  class Reader {
+  public:
+    /// @brief Register a reader
+    /// @throw std::runtime_error if max_readers readers are registered
+    explicit Reader(const LiveEphemerisStore &store);
+
+    /// @brief Destructor; unregister
+    ~Reader() noexcept;
+
+    /// @brief Copy not allowed !
+    Reader(const Reader &) = delete;
+
+    /// @brief Assignment not allowed !
+    Reader &operator=(const Reader &) = delete;
+
+    /// @brief Compute the state vector and clock correction of a satellite
+    ///        at epoch t+offset
+    ///
+    /// The message used is (as for NavSnapshot::find) the one with the ToE
+    /// closest to t for GLONASS, else the latest message with ToC <= t.
+    /// @return 0 on success, -1 if no message is available, else the status
+    ///         of the orbit evaluation
+    template <typename T>
+    int stateNclock(SATELLITE_SYSTEM sys, int prn, const ngpt::datetime<T> &t,
+                    double *state, double &clock,
+                    double offset = 0e0) const noexcept {
+      const int idx = index(sys, prn);
+      if (idx < 0)
+        return -1;
+      enter();
+      const SatNode *node =
+          store_.sats_[idx].load(std::memory_order_seq_cst);
+      int status = -1;
+      if (node) {
+        const int i = select(*node, sys, t.mjd().as_underlying_type(),
+                             t.sec().to_fractional_seconds());
+        if (i >= 0) {
+          if (node->has_kep[i]) {
+            status = node->keps[i].stateNclock(t, state, clock, offset);
+          } else {
+            status = node->msgs[i].stateNclock(t, state, clock, offset);
+          }
+        }
+      }
+      exit();
+      return status;
+    }
+
+    /// @brief Get (a copy of) the message to use for a satellite at epoch t
+    /// @return 0 on success, -1 if no message is available
+    template <typename T>
+    int get(SATELLITE_SYSTEM sys, int prn, const ngpt::datetime<T> &t,
+            NavDataFrame &frame) const noexcept {
+      const int idx = index(sys, prn);
+      if (idx < 0)
+        return -1;
+      enter();
+      const SatNode *node =
+          store_.sats_[idx].load(std::memory_order_seq_cst);
+      int status = -1;
+      if (node) {
+        const int i = select(*node, sys, t.mjd().as_underlying_type(),
+                             t.sec().to_fractional_seconds());
+        if (i >= 0) {
+          frame = node->msgs[i];
+          status = 0;
+        }
+      }
+      exit();
+      return status;
+    }
+
+  private:
+    void enter() const noexcept {
+      slot_->epoch.store(store_.epoch_.load(std::memory_order_seq_cst),
+                         std::memory_order_seq_cst);
+    }
+    void exit() const noexcept {
+      slot_->epoch.store(0, std::memory_order_release);
+    }
+
+    const LiveEphemerisStore &store_;
+    ReaderSlot *slot_;
+  }; // Reader
+
+  /// @brief Constructor; the store is empty
+  LiveEphemerisStore() noexcept;
+
+  /// @brief Destructor; all readers must be unregistered
+  ~LiveEphemerisStore() noexcept;
+
+  /// @brief Copy not allowed !
+  LiveEphemerisStore(const LiveEphemerisStore &) = delete;
+
+  /// @brief Assignment not allowed !
+  LiveEphemerisStore &operator=(const LiveEphemerisStore &) = delete;
+
+  /// @brief Dense index of a satellite; -1 if out of range
+  static int index(SATELLITE_SYSTEM sys, int prn) noexcept {
+    return SatId::index(sys, prn);
+  }
+
+  /// @brief Publish a new message (thread-safe)
+  int publish(const NavDataFrame &frame) noexcept;
+
+  /// @brief Free retired nodes no reader can hold anymore (thread-safe)
+  std::size_t reclaim() noexcept;
+
+  /// @brief Number of retired nodes not freed yet
+  std::size_t pending_reclamation() const noexcept;
+
+private:
+  /// @brief Index of the message to use for epoch (mjd, sec); -1 if none
+  static int select(const SatNode &node, SATELLITE_SYSTEM sys, long mjd,
+                    double sec) noexcept;
+
+  /// @brief Free retired nodes; the writer mutex must be held
+  std::size_t reclaim_locked() noexcept;
+
+  std::atomic<const SatNode *> sats_[max_sats]; ///< Current node per sat
+  mutable ReaderSlot readers_[max_readers];      ///< Reader slots
+  std::atomic<std::uint64_t> epoch_{1};          ///< Global epoch
+  mutable std::mutex writer_mutex_;              ///< Serializes writers
+  std::vector<std::pair<std::uint64_t, const SatNode *>> retired_;
+};                                               // LiveEphemerisStore
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,248 @@
+#include "nav_merge.hpp"
+#include <algorithm>
+#include <cstring>
+
+using ngpt::NavDataFrame;
+using ngpt::NavMerger;
+using ngpt::SATELLITE_SYSTEM;
+
+namespace {
+/// Index (in the data block) of the issue of data; -1 if the system has none
+inline int iod_index(SATELLITE_SYSTEM sys) noexcept {
+  return (sys == SATELLITE_SYSTEM::glonass || sys == SATELLITE_SYSTEM::sbas)
+             ? -1
+             : 3;
+}
+
+/// Index (in the data block) of the transmission time of message; for
+/// GLONASS this is the message frame time tk (data[2]), which depends on the
+/// frame a receiver decoded the (otherwise identical) message from
+inline int ttom_index(SATELLITE_SYSTEM sys) noexcept {
+  switch (sys) {
+  case SATELLITE_SYSTEM::glonass:
+  case SATELLITE_SYSTEM::sbas:
+    return 2;
+  default:
+    return 27;
+  }
+}
+
+/// Index (in the data block) of the Galileo data sources
+constexpr int gal_data_source_index{20};
+
+/// A data word; -0 and +0 are the same
+inline double word(const NavDataFrame &f, int i) noexcept {
+  return f.data(i) + 0e0;
+}
+
+/// FNV-1a (64 bit) over the bytes of a value
+inline std::uint64_t fnv1a(std::uint64_t h, const void *ptr,
+                           std::size_t size) noexcept {
+  const unsigned char *c = static_cast<const unsigned char *>(ptr);
+  for (std::size_t i = 0; i < size; i++) {
+    h ^= c[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+constexpr std::uint64_t fnv1a_basis{0xcbf29ce484222325ULL};
+
+inline std::uint64_t hash_word(std::uint64_t h, double d) noexcept {
+  return fnv1a(h, &d, sizeof(d));
+}
+
+inline std::uint64_t hash_identity(const NavDataFrame &f) noexcept {
+  const int sys = static_cast<int>(f.system());
+  const int prn = f.prn();
+  const long mjd = f.toc().mjd().as_underlying_type();
+  const long sec = f.toc().sec().as_underlying_type();
+  std::uint64_t h = fnv1a(fnv1a_basis, &sys, sizeof(sys));
+  h = fnv1a(h, &prn, sizeof(prn));
+  h = fnv1a(h, &mjd, sizeof(mjd));
+  h = fnv1a(h, &sec, sizeof(sec));
+  if (const int i = iod_index(f.system()); i >= 0)
+    h = hash_word(h, word(f, i));
+  if (f.system() == SATELLITE_SYSTEM::galileo)
+    h = hash_word(h, word(f, gal_data_source_index));
+  return h;
+}
+
+inline std::uint64_t hash_data(const NavDataFrame &f) noexcept {
+  const int skip = ttom_index(f.system());
+  std::uint64_t h = fnv1a_basis;
+  for (int i = 0; i < 31; i++)
+    if (i != skip)
+      h = hash_word(h, word(f, i));
+  return h;
+}
+
+/// Data block order (excluding the transmission time); used to break ties
+inline bool data_less(const NavDataFrame &a, const NavDataFrame &b) noexcept {
+  const int skip = ttom_index(a.system());
+  for (int i = 0; i < 31; i++) {
+    if (i == skip)
+      continue;
+    if (word(a, i) != word(b, i))
+      return word(a, i) < word(b, i);
+  }
+  return false;
+}
+
+/// Sort order of merged messages: system, prn, ToC, issue of data (and data
+/// sources for Galileo)
+inline bool frame_less(const NavDataFrame &a, const NavDataFrame &b) noexcept {
+  if (a.system() != b.system())
+    return a.system() < b.system();
+  if (a.prn() != b.prn())
+    return a.prn() < b.prn();
+  if (a.toc() != b.toc())
+    return a.toc() < b.toc();
+  if (const int i = iod_index(a.system()); i >= 0 && word(a, i) != word(b, i))
+    return word(a, i) < word(b, i);
+  return word(a, gal_data_source_index) < word(b, gal_data_source_index);
+}
+} // namespace
+
+bool NavMerger::same_identity(const NavDataFrame &a,
+                              const NavDataFrame &b) noexcept {
+  if (a.system() != b.system() || a.prn() != b.prn() || a.toc() != b.toc())
+    return false;
+  if (const int i = iod_index(a.system()); i >= 0 && word(a, i) != word(b, i))
+    return false;
+  return a.system() != SATELLITE_SYSTEM::galileo ||
+         word(a, gal_data_source_index) == word(b, gal_data_source_index);
+}
+
+bool NavMerger::same_data(const NavDataFrame &a,
+                          const NavDataFrame &b) noexcept {
+  const int skip = ttom_index(a.system());
+  for (int i = 0; i < 31; i++)
+    if (i != skip && word(a, i) != word(b, i))
+      return false;
+  return true;
+}
+
+/// Call fn(first, last) for every identity, where [first, last) are the
+/// indexes (in entries_) of its variants.
+template <typename F> void NavMerger::for_each_identity(F &&fn) const {
+  std::vector<std::size_t> group;
+  std::vector<char> done;
+  for (const auto &it : index_) {
+    const auto &bucket = it.second;
+    // more than one identity in a bucket only on hash collisions
+    done.assign(bucket.size(), 0);
+    for (std::size_t i = 0; i < bucket.size(); i++) {
+      if (done[i])
+        continue;
+      group.clear();
+      for (std::size_t j = i; j < bucket.size(); j++) {
+        if (!done[j] && same_identity(entries_[bucket[i]].frame,
+                                      entries_[bucket[j]].frame)) {
+          group.push_back(bucket[j]);
+          done[j] = 1;
+        }
+      }
+      fn(group);
+    }
+  }
+}
+
+/// @param[in] frame The message to add
+/// @return 0 if the message is new (either a new identity or a new data
+///         variant of an identity), -1 if it is a duplicate, 1 on allocation
+///         failure (the message is not added)
+int NavMerger::add(const NavDataFrame &frame) noexcept {
+  const std::uint64_t idh = hash_identity(frame);
+  const std::uint64_t dh = hash_data(frame);
+  try {
+    auto &bucket = index_[idh];
+    for (std::size_t idx : bucket) {
+      Entry &e = entries_[idx];
+      if (e.data_hash == dh && same_identity(e.frame, frame) &&
+          same_data(e.frame, frame)) {
+        ++e.count;
+        // keep the earliest transmission time
+        if (const int k = ttom_index(frame.system());
+            k >= 0 && frame.data(k) < e.frame.data(k))
+          e.frame.data(k) = frame.data(k);
+        ++num_input_;
+        ++num_duplicates_;
+        return -1;
+      }
+    }
+    bucket.reserve(bucket.size() + 1);
+    entries_.push_back(Entry{frame, idh, dh, 1});
+    bucket.push_back(entries_.size() - 1);
+  } catch (std::exception &) {
+    return 1;
+  }
+  ++num_input_;
+  return 0;
+}
+
+/// All messages of the file are read (via NavigationRnx::read_all_records)
+/// and added.
+/// @param[in] nav         The navigation RINEX
+/// @param[in] num_threads Number of threads used to decode the file
+/// @return 0 on success, 1 on allocation failure, else the status of
+///         NavigationRnx::read_all_records
+int NavMerger::add(NavigationRnx &nav, int num_threads) noexcept {
+  std::vector<NavDataFrame> frames;
+  if (int j = nav.read_all_records(frames, num_threads); j)
+    return j;
+  try {
+    entries_.reserve(entries_.size() + frames.size() / 2);
+  } catch (std::exception &) {
+    // not fatal; just grow as needed
+  }
+  for (const auto &f : frames)
+    if (add(f) > 0)
+      return 1;
+  return 0;
+}
+
+/// For every identity, the variant seen the most times is selected; ties
+/// are broken by the data block (see nav_merge.hpp).
+/// @param[out] frames The merged messages, sorted by system, PRN, ToC and
+///                    issue of data
+/// @return 0 on success, 1 on allocation failure
+int NavMerger::merge(std::vector<NavDataFrame> &frames) const noexcept {
+  try {
+    frames.clear();
+    frames.reserve(entries_.size());
+    for_each_identity([&](const std::vector<std::size_t> &group) {
+      const Entry *best = &entries_[group[0]];
+      for (std::size_t i = 1; i < group.size(); i++) {
+        const Entry &e = entries_[group[i]];
+        if (e.count > best->count ||
+            (e.count == best->count && data_less(e.frame, best->frame)))
+          best = &e;
+      }
+      frames.push_back(best->frame);
+    });
+    std::sort(frames.begin(), frames.end(), frame_less);
+  } catch (std::exception &) {
+    return 1;
+  }
+  return 0;
+}
+
+std::size_t NavMerger::num_conflicts() const noexcept {
+  std::size_t conflicts = 0;
+  try {
+    for_each_identity([&](const std::vector<std::size_t> &group) {
+      if (group.size() > 1)
+        ++conflicts;
+    });
+  } catch (std::exception &) {
+    return 0;
+  }
+  return conflicts;
+}
+
+void NavMerger::clear() noexcept {
+  entries_.clear();
+  index_.clear();
+  num_input_ = num_duplicates_ = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef __GNSS_NAV_MERGE_HPP__
+#define __GNSS_NAV_MERGE_HPP__
+
+/// @file     nav_merge.hpp
+///
+/// @brief    Merge navigation messages from any number of sources (e.g.
+///           hourly navigation RINEX files of many stations) into one
+///           compact, duplicate-free and sorted set.
+///
+/// @details  A message is identified by its satellite (system and PRN), its
+///           ToC and its issue of data (IODE, IODnav, AODE or IODEC; none for
+///           GLONASS and SBAS). For Galileo, the clock related data source
+///           bits are part of the identity too, since I/NAV and F/NAV
+///           messages share an IODnav but hold different clock parameters.
+///           Identity and data block are hashed; a message whose identity
+///           and data both match a stored message is a duplicate. The
+///           transmission time of message (the message frame time tk for
+///           GLONASS) is not part of the data compared (it differs between
+///           receivers tracking the same message); the earliest one is kept.
+///
+///           Messages with the same identity but different data are
+///           conflicts. These are resolved deterministically (irrespective
+///           of the order the sources are added): the variant seen the most
+///           times wins and ties are broken by the data block (the smallest,
+///           comparing the data words in order).
+
+#include "navrnx.hpp"
+#include "satsys.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ngpt {
+
+/// @class NavMerger
+/// Deduplicating merger of navigation messages.
+class NavMerger {
+public:
+  /// @brief Constructor; the merger is empty
+  NavMerger() noexcept {};
+
+  /// @brief Add a navigation message
+  int add(const NavDataFrame &frame) noexcept;
+
+  /// @brief Add all navigation messages of a navigation RINEX
+  int add(NavigationRnx &nav, int num_threads = 0) noexcept;
+
+  /// @brief Merged messages, sorted by system, PRN, ToC and issue of data
+  int merge(std::vector<NavDataFrame> &frames) const noexcept;
+
+  /// @brief Number of messages added
+  std::size_t num_input() const noexcept { return num_input_; }
+
+  /// @brief Number of messages found to be duplicates
+  std::size_t num_duplicates() const noexcept { return num_duplicates_; }
+
+  /// @brief Number of (distinct) messages stored, including conflicting
+  ///        variants
+  std::size_t num_stored() const noexcept { return entries_.size(); }
+
+  /// @brief Number of identities with more than one data variant
+  std::size_t num_conflicts() const noexcept;
+
+  /// @brief Remove all messages
+  void clear() noexcept;
+
+private:
+  /// A distinct message (one data variant of an identity)
+  struct Entry {
+    NavDataFrame frame;       ///< The message
+    std::uint64_t id_hash;    ///< Hash of the identity
+    std::uint64_t data_hash;  ///< Hash of the data block
+    std::size_t count;        ///< Times the message was added
+  };
+
+  /// @brief True if two messages have the same identity
+  static bool same_identity(const NavDataFrame &a,
+                            const NavDataFrame &b) noexcept;
+
+  /// @brief True if two messages have the same data block (excluding the
+  ///        transmission time)
+  static bool same_data(const NavDataFrame &a, const NavDataFrame &b) noexcept;
+
+  /// @brief Call fn on the indexes (in entries_) of the variants of every
+  ///        identity
+  template <typename F> void for_each_identity(F &&fn) const;
+
+  std::vector<Entry> entries_; ///< Distinct messages
+  /// Identity hash to indexes (in entries_) of its variants
+  std::unordered_map<std::uint64_t, std::vector<std::size_t>> index_;
+  std::size_t num_input_{0};      ///< Messages added
+  std::size_t num_duplicates_{0}; ///< Duplicates found
+};                                // NavMerger
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,258 @@
+#include "nav_snapshot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using ngpt::NavSnapshot;
+using ngpt::NavSnapshotHeader;
+using ngpt::NavSnapshotIndex;
+using ngpt::NavSnapshotRecord;
+using ngpt::SATELLITE_SYSTEM;
+
+constexpr char NavSnapshot::magic[8];
+
+namespace {
+/// Seconds since MJD 0; used to compare epochs within the snapshot
+inline double to_seconds(long mjd, double sec) noexcept {
+  return static_cast<double>(mjd) * 86400e0 + sec;
+}
+
+/// Sort order of records: system, prn and ToC
+inline bool record_less(const NavSnapshotRecord &a,
+                        const NavSnapshotRecord &b) noexcept {
+  if (a.sys != b.sys)
+    return a.sys < b.sys;
+  if (a.prn != b.prn)
+    return a.prn < b.prn;
+  if (a.toc_mjd != b.toc_mjd)
+    return a.toc_mjd < b.toc_mjd;
+  return a.toc_sec < b.toc_sec;
+}
+} // namespace
+
+void NavSnapshotRecord::set(const NavDataFrame &frame) noexcept {
+  std::memset(static_cast<void *>(this), 0, sizeof(NavSnapshotRecord));
+  sys = static_cast<std::int32_t>(frame.system());
+  prn = frame.prn();
+  const auto toc = frame.toc<ngpt::seconds>();
+  const auto toe = frame.toe<ngpt::seconds>();
+  toc_mjd = toc.mjd().as_underlying_type();
+  toc_sec = toc.sec().as_underlying_type();
+  toe_mjd = toe.mjd().as_underlying_type();
+  toe_sec = toe.sec().as_underlying_type();
+  for (int i = 0; i < 31; i++)
+    data[i] = frame.data(i);
+  has_kepler = !kepler.set(frame);
+}
+
+void NavSnapshotRecord::to_frame(NavDataFrame &frame) const noexcept {
+  frame.system() = system();
+  frame.prn() = prn;
+  frame.set_toc(ngpt::datetime<ngpt::seconds>(
+      ngpt::modified_julian_day(toc_mjd), ngpt::seconds(toc_sec)));
+  frame.set_toe(ngpt::datetime<ngpt::seconds>(
+      ngpt::modified_julian_day(toe_mjd), ngpt::seconds(toe_sec)));
+  for (int i = 0; i < 31; i++)
+    frame.data(i) = data[i];
+}
+
+/// Messages are sorted (by system, prn and ToC) and indexed here; the input
+/// need not be sorted.
+/// @param[in] fn     The snapshot file to write
+/// @param[in] frames The navigation messages
+/// @return Anything other than 0 denotes an error
+int ngpt::write_nav_snapshot(const char *fn,
+                             const std::vector<NavDataFrame> &frames) noexcept {
+  std::vector<NavSnapshotRecord> records;
+  std::vector<NavSnapshotIndex> index;
+  try {
+    records.resize(frames.size());
+    for (std::size_t i = 0; i < frames.size(); i++)
+      records[i].set(frames[i]);
+    std::sort(records.begin(), records.end(), record_less);
+    for (std::size_t i = 0; i < records.size(); i++) {
+      if (index.empty() || index.back().sys != records[i].sys ||
+          index.back().prn != records[i].prn)
+        index.push_back({records[i].sys, records[i].prn, i, 0});
+      ++index.back().count;
+    }
+  } catch (std::exception &) {
+    return 1;
+  }
+
+  NavSnapshotHeader hdr;
+  std::memcpy(hdr.magic, NavSnapshot::magic, sizeof(hdr.magic));
+  hdr.version = NavSnapshot::version;
+  hdr.record_size = sizeof(NavSnapshotRecord);
+  hdr.num_sats = index.size();
+  hdr.num_records = records.size();
+
+  std::ofstream fout(fn, std::ios::binary | std::ios::trunc);
+  if (!fout.is_open())
+    return 2;
+  fout.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  fout.write(reinterpret_cast<const char *>(index.data()),
+             index.size() * sizeof(NavSnapshotIndex));
+  fout.write(reinterpret_cast<const char *>(records.data()),
+             records.size() * sizeof(NavSnapshotRecord));
+  return fout.good() ? 0 : 3;
+}
+
+/// @param[in] fn  The snapshot file to write
+/// @param[in] nav The navigation RINEX; all (remaining) messages are read
+/// @return Anything other than 0 denotes an error
+int ngpt::write_nav_snapshot(const char *fn, NavigationRnx &nav) noexcept {
+  std::vector<NavDataFrame> frames;
+  NavDataFrame frame;
+  int j;
+  try {
+    while (!(j = nav.read_next_record(frame)))
+      frames.push_back(frame);
+  } catch (std::exception &) {
+    return 1;
+  }
+  if (j > 0)
+    return j;
+  return write_nav_snapshot(fn, frames);
+}
+
+/// @details The file is mapped read-only and shared; the header (magic
+///          string, version, record size and file size) is validated.
+/// @throw   std::runtime_error if the file cannot be opened/mapped or is not
+///          a (valid) snapshot
+NavSnapshot::NavSnapshot(const char *fn) {
+  int fd = ::open(fn, O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("[ERROR] NavSnapshot::NavSnapshot() Failed to "
+                             "open file: " +
+                             std::string(fn));
+  struct stat st;
+  if (::fstat(fd, &st) ||
+      static_cast<std::size_t>(st.st_size) < sizeof(NavSnapshotHeader)) {
+    ::close(fd);
+    throw std::runtime_error("[ERROR] NavSnapshot::NavSnapshot() Invalid "
+                             "snapshot file: " +
+                             std::string(fn));
+  }
+  length_ = static_cast<std::size_t>(st.st_size);
+  addr_ = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr_ == MAP_FAILED) {
+    addr_ = nullptr;
+    throw std::runtime_error("[ERROR] NavSnapshot::NavSnapshot() Failed to "
+                             "map file: " +
+                             std::string(fn));
+  }
+
+  const auto *hdr = static_cast<const NavSnapshotHeader *>(addr_);
+  if (std::memcmp(hdr->magic, magic, sizeof(magic)) ||
+      hdr->version != version ||
+      hdr->record_size != sizeof(NavSnapshotRecord) ||
+      length_ != sizeof(NavSnapshotHeader) +
+                     hdr->num_sats * sizeof(NavSnapshotIndex) +
+                     hdr->num_records * sizeof(NavSnapshotRecord)) {
+    unmap();
+    throw std::runtime_error("[ERROR] NavSnapshot::NavSnapshot() Invalid "
+                             "or incompatible snapshot file: " +
+                             std::string(fn));
+  }
+  num_sats_ = hdr->num_sats;
+  num_records_ = hdr->num_records;
+  const char *base = static_cast<const char *>(addr_);
+  index_ = reinterpret_cast<const NavSnapshotIndex *>(
+      base + sizeof(NavSnapshotHeader));
+  records_ = reinterpret_cast<const NavSnapshotRecord *>(
+      base + sizeof(NavSnapshotHeader) + num_sats_ * sizeof(NavSnapshotIndex));
+}
+
+NavSnapshot::~NavSnapshot() noexcept { unmap(); }
+
+NavSnapshot::NavSnapshot(NavSnapshot &&other) noexcept
+    : addr_(other.addr_), length_(other.length_), index_(other.index_),
+      records_(other.records_), num_sats_(other.num_sats_),
+      num_records_(other.num_records_) {
+  other.addr_ = nullptr;
+  other.unmap();
+}
+
+NavSnapshot &NavSnapshot::operator=(NavSnapshot &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    addr_ = other.addr_;
+    length_ = other.length_;
+    index_ = other.index_;
+    records_ = other.records_;
+    num_sats_ = other.num_sats_;
+    num_records_ = other.num_records_;
+    other.addr_ = nullptr;
+    other.unmap();
+  }
+  return *this;
+}
+
+void NavSnapshot::unmap() noexcept {
+  if (addr_)
+    ::munmap(addr_, length_);
+  addr_ = nullptr;
+  length_ = 0;
+  index_ = nullptr;
+  records_ = nullptr;
+  num_sats_ = num_records_ = 0;
+}
+
+const NavSnapshotRecord *NavSnapshot::records(SATELLITE_SYSTEM sys, int prn,
+                                              std::size_t &count) const
+    noexcept {
+  const std::int32_t s = static_cast<std::int32_t>(sys);
+  const auto *end = index_ + num_sats_;
+  const auto *it = std::lower_bound(
+      index_, end, std::make_pair(s, prn),
+      [](const NavSnapshotIndex &e, const std::pair<std::int32_t, int> &k) {
+        return e.sys < k.first || (e.sys == k.first && e.prn < k.second);
+      });
+  if (it == end || it->sys != s || it->prn != prn) {
+    count = 0;
+    return nullptr;
+  }
+  count = it->count;
+  return records_ + it->first;
+}
+
+const NavSnapshotRecord *NavSnapshot::find(SATELLITE_SYSTEM sys, int prn,
+                                           long mjd, double sec) const
+    noexcept {
+  std::size_t count;
+  const NavSnapshotRecord *first = records(sys, prn, count);
+  if (!first)
+    return nullptr;
+  const NavSnapshotRecord *last = first + count;
+  const double t = to_seconds(mjd, sec);
+
+  if (sys == SATELLITE_SYSTEM::glonass) {
+    // pick the message with the closest ToE
+    const NavSnapshotRecord *best = first;
+    double dmin = std::abs(
+        to_seconds(first->toe_mjd, static_cast<double>(first->toe_sec)) - t);
+    for (const auto *it = first + 1; it < last; ++it) {
+      const double d = std::abs(
+          to_seconds(it->toe_mjd, static_cast<double>(it->toe_sec)) - t);
+      if (d < dmin) {
+        dmin = d;
+        best = it;
+      }
+    }
+    return best;
+  }
+
+  const auto *it = std::upper_bound(
+      first, last, t, [](double tt, const NavSnapshotRecord &r) {
+        return tt < to_seconds(r.toc_mjd, static_cast<double>(r.toc_sec));
+      });
+  return (it == first) ? nullptr : it - 1;
+}
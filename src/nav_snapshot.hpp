@@ -0,0 +1,186 @@
+#ifndef __GNSS_NAV_SNAPSHOT_HPP__
+#define __GNSS_NAV_SNAPSHOT_HPP__
+
+/// @file     nav_snapshot.hpp
+///
+/// @brief    A binary, position-independent snapshot of a set of navigation
+///           messages, to be memory-mapped (read-only) by any number of
+///           processes.
+///
+/// @details  The snapshot is written once (e.g. from a merged navigation
+///           RINEX file) via write_nav_snapshot. The file layout is:
+///           - a NavSnapshotHeader,
+///           - an index of NavSnapshotIndex entries, one per satellite,
+///             sorted by (system, prn),
+///           - the NavSnapshotRecord%s, sorted by (system, prn, ToC).
+///           There are no pointers in the file (all references are record
+///           indexes), so it can be mapped at any address. A NavSnapshot maps
+///           the file (MAP_SHARED, PROT_READ) and lookups (binary searches)
+///           as well as orbit evaluations for Keplerian systems (GPS,
+///           Galileo, BeiDou, QZSS and IRNSS) work directly on the mapped
+///           memory, since records hold a prepared (and trivially copyable)
+///           KeplerEphemeris. Processes mapping the same snapshot share the
+///           same physical pages.
+///
+///           The layout is native (byte order, alignment); a snapshot should
+///           be read on the same architecture it was written. The header
+///           holds the record size, so that mismatches are detected.
+
+#include "ggdatetime/dtcalendar.hpp"
+#include "kepler_ephemeris.hpp"
+#include "navrnx.hpp"
+#include "satsys.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace ngpt {
+
+/// Header of a navigation snapshot file
+struct NavSnapshotHeader {
+  char magic[8];             ///< "NGPTNAV" (null-terminated)
+  std::uint32_t version;     ///< Layout version
+  std::uint32_t record_size; ///< sizeof(NavSnapshotRecord)
+  std::uint64_t num_sats;    ///< Number of index entries
+  std::uint64_t num_records; ///< Number of records
+};
+
+/// Index entry of a navigation snapshot; records [first, first+count) belong
+/// to the satellite.
+struct NavSnapshotIndex {
+  std::int32_t sys;    ///< Satellite system (cast to int)
+  std::int32_t prn;    ///< PRN
+  std::uint64_t first; ///< Index of the first record of the satellite
+  std::uint64_t count; ///< Number of records of the satellite
+};
+
+/// A navigation message in the snapshot layout.
+struct NavSnapshotRecord {
+  std::int32_t sys;         ///< Satellite system (cast to int)
+  std::int32_t prn;         ///< PRN
+  std::int64_t toc_mjd;     ///< MJD of ToC
+  std::int64_t toc_sec;     ///< Seconds of day of ToC
+  std::int64_t toe_mjd;     ///< MJD of ToE
+  std::int64_t toe_sec;     ///< Seconds of day of ToE
+  double data[31];          ///< The data block (see NavDataFrame)
+  std::int32_t has_kepler;  ///< 1 if kepler is set (Keplerian systems)
+  std::int32_t padding;     ///< Unused
+  KeplerEphemeris kepler;   ///< Prepared ephemeris (if has_kepler)
+
+  /// @brief Satellite system
+  SATELLITE_SYSTEM system() const noexcept {
+    return static_cast<SATELLITE_SYSTEM>(sys);
+  }
+
+  /// @brief Set from a navigation message
+  void set(const NavDataFrame &frame) noexcept;
+
+  /// @brief Copy to a navigation message
+  void to_frame(NavDataFrame &frame) const noexcept;
+};
+
+static_assert(std::is_trivially_copyable<NavSnapshotRecord>::value,
+              "NavSnapshotRecord must be trivially copyable");
+
+/// @brief Write a set of navigation messages to a snapshot file
+int write_nav_snapshot(const char *fn,
+                       const std::vector<NavDataFrame> &frames) noexcept;
+
+/// @brief Read all messages of a navigation RINEX and write them to a
+///        snapshot file
+int write_nav_snapshot(const char *fn, NavigationRnx &nav) noexcept;
+
+/// @class NavSnapshot
+/// A read-only, memory-mapped navigation snapshot.
+class NavSnapshot {
+public:
+  /// Magic string of snapshot files
+  static constexpr char magic[8] = "NGPTNAV";
+  /// Current layout version
+  static constexpr std::uint32_t version{1};
+
+  /// @brief Constructor; map a snapshot file
+  explicit NavSnapshot(const char *fn);
+
+  /// @brief Destructor; unmap the file
+  ~NavSnapshot() noexcept;
+
+  /// @brief Copy not allowed !
+  NavSnapshot(const NavSnapshot &) = delete;
+
+  /// @brief Assignment not allowed !
+  NavSnapshot &operator=(const NavSnapshot &) = delete;
+
+  /// @brief Move constructor
+  NavSnapshot(NavSnapshot &&other) noexcept;
+
+  /// @brief Move assignment operator
+  NavSnapshot &operator=(NavSnapshot &&other) noexcept;
+
+  /// @brief Number of records
+  std::size_t size() const noexcept { return num_records_; }
+
+  /// @brief Number of satellites
+  std::size_t num_satellites() const noexcept { return num_sats_; }
+
+  const NavSnapshotRecord *begin() const noexcept { return records_; }
+  const NavSnapshotRecord *end() const noexcept {
+    return records_ + num_records_;
+  }
+
+  /// @brief All records of a satellite
+  /// @param[out] count The number of records of the satellite
+  /// @return Pointer to the first record (or nullptr if the satellite is not
+  ///         in the snapshot)
+  const NavSnapshotRecord *records(SATELLITE_SYSTEM sys, int prn,
+                                   std::size_t &count) const noexcept;
+
+  /// @brief Find the message to use for a satellite at an epoch
+  ///
+  /// For GLONASS, this is the message with the ToE closest to t; for any
+  /// other system, the latest message with ToC <= t. Validity (fit interval,
+  /// health) is not checked.
+  /// @return The record or nullptr if no message is found
+  template <typename T>
+  const NavSnapshotRecord *find(SATELLITE_SYSTEM sys, int prn,
+                                const ngpt::datetime<T> &t) const noexcept {
+    return find(sys, prn, t.mjd().as_underlying_type(),
+                t.sec().to_fractional_seconds());
+  }
+
+  /// @brief Compute the state vector and clock correction of a satellite at
+  ///        epoch t+offset, using the message returned by find
+  /// @return 0 on success, -1 if no message is found, else the status of the
+  ///         orbit evaluation
+  template <typename T>
+  int stateNclock(SATELLITE_SYSTEM sys, int prn, const ngpt::datetime<T> &t,
+                  double *state, double &clock,
+                  double offset = 0e0) const noexcept {
+    const NavSnapshotRecord *rec = find(sys, prn, t);
+    if (!rec)
+      return -1;
+    if (rec->has_kepler)
+      return rec->kepler.stateNclock(t, state, clock, offset);
+    NavDataFrame frame;
+    rec->to_frame(frame);
+    return frame.stateNclock(t, state, clock, offset);
+  }
+
+private:
+  const NavSnapshotRecord *find(SATELLITE_SYSTEM sys, int prn, long mjd,
+                                double sec) const noexcept;
+  void unmap() noexcept;
+
+  void *addr_{nullptr};                       ///< Start of mapping
+  std::size_t length_{0};                     ///< Length of mapping
+  const NavSnapshotIndex *index_{nullptr};    ///< The index
+  const NavSnapshotRecord *records_{nullptr}; ///< The records
+  std::size_t num_sats_{0};                   ///< Number of index entries
+  std::size_t num_records_{0};                ///< Number of records
+};                                            // NavSnapshot
+
+} // namespace ngpt
+
+#endif
@@ -1,81 +1,463 @@
-#include "navrnx.hpp"
-#include <cerrno>
-#include <iostream>
-#include <stdexcept>
+#include "navcmp.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <system_error>
+#include <thread>
 
+using ngpt::NavCmpRecord;
+using ngpt::NavCmpStats;
 using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::SatId;
 
-/// WGS 84 value of the earth's gravitational constant for GPS user
-constexpr double mi_gps{3.986005e14};
-
-/// WGS 84 value of the earth's rotation rate
-constexpr double OMEGAE_dot{7.2921151467e-5};
-
-/// @brief get SV coordinates (WGS84) from navigation block
-/// see IS-GPS-200H, User Algorithm for Ephemeris Determination
-int NavDataFrame::gps_ecef(double t_insow, double &x, double &y,
-                           double &z) const noexcept {
-  constexpr double LIMIT{1e-14};   //  Limit for solving (iteratively)
-                                   //+ the Kepler equation for the
-                                   //+ eccentricity anomaly
-  double A(data__[10] * data[10]); //  Semi-major axis
-  double n0(std::sqrt(mi_gps / (A * A * A))); //  Computed mean motion (rad/sec)
-  double tk(t - data__[11]); //  Time from ephemeris reference epoch
-  if (tk > 302400e0)
-    tk -= 604800e0;
-  if (tk < 302400e0)
-    tk += 604800e0;
-  double n(n0 + data__[5]);      //  Corrected mean motion
-  double Mk(data__[6] + n * tk); //  Mean anomaly
-
-  // Solve (iteratively) Kepler's equation for Ek
-  double E(Mk);
-  double Ek(0e0);
-  double e(data__[8]);
-  for (int i = 0; std::abs(E - Ek) > LIMIT && i < 1001; i++) {
-    Ek = E;
-    E = std::sin(Ek) * e + Mk;
+namespace {
+/// Speed of light (m/sec)
+constexpr double speed_of_light{299792458e0};
+
+/// Earth's rotation rate (rad/sec); used to get the inertial velocity
+constexpr double omega_earth{7.2921151467e-5};
+
+/// BDT minus GPS time (sec)
+constexpr double bdt_minus_gpst{-14e0};
+
+/// Half step (sec) of the central difference used for the velocity
+constexpr double velocity_step{0.5e0};
+
+/// Messages with a reference time further away than this (sec) from an
+/// epoch are never searched
+constexpr double max_search_span{86400e0};
+
+/// Number of satellite systems
+constexpr int num_systems{SatId::num_systems};
+
+/// Magic string and layout version of binary comparison files
+constexpr char magic[8] = "NGPTCMP";
+constexpr std::uint32_t version{1};
+
+/// Seconds since MJD 0 of a datetime<seconds>
+inline double to_seconds(const ngpt::datetime<ngpt::seconds> &t) noexcept {
+  return static_cast<double>(t.mjd().as_underlying_type()) * 86400e0 +
+         t.sec().to_fractional_seconds();
+}
+
+/// Offset (sec) from GPS time to the time scale of a system's messages
+inline double time_scale_offset(SATELLITE_SYSTEM sys,
+                                int leap_seconds) noexcept {
+  switch (sys) {
+  case SATELLITE_SYSTEM::glonass:
+    return -static_cast<double>(leap_seconds);
+  case SATELLITE_SYSTEM::beidou:
+    return bdt_minus_gpst;
+  default:
+    return 0e0;
+  }
+}
+
+/// Reference time of a message (sec since MJD 0); ToE for GLONASS, else ToC
+inline double reference_time(const NavDataFrame &f) noexcept {
+  return (f.system() == SATELLITE_SYSTEM::glonass)
+             ? to_seconds(f.toe<ngpt::seconds>())
+             : to_seconds(f.toc());
+}
+
+/// True if the message is healthy and valid at t (sec since MJD 0, in the
+/// message's time scale); see NavigationRnx::find_next_valid
+inline bool valid_at(const NavDataFrame &f, double t) noexcept {
+  if (f.sv_health())
+    return false;
+  const double fit = static_cast<double>(f.fit_interval());
+  const double ref = reference_time(f);
+  if (f.system() == SATELLITE_SYSTEM::glonass)
+    return t >= ref - fit && t < ref + fit;
+  return t >= ref && t < ref + fit;
+}
+
+/// An Sp3 epoch
+struct Epoch {
+  long mjd;  ///< MJD
+  long usec; ///< Microseconds of day
+};
+
+/// An Sp3 record of a satellite
+struct Sp3Sample {
+  std::size_t epoch;           ///< Index of the epoch
+  std::array<double, 4> vals;  ///< Position (m) and clock (microsec)
+  bool has_clock;              ///< False if the clock is missing
+};
+
+/// A satellite to compare
+struct Satellite {
+  SATELLITE_SYSTEM sys;
+  int prn;
+  std::vector<Sp3Sample> samples;         ///< Sp3 records, in time order
+  std::vector<const NavDataFrame *> msgs; ///< Messages, by reference time
+  std::vector<NavCmpRecord> records;      ///< Differences
+  std::vector<std::size_t> record_epochs; ///< Epoch index of each record
+  int missing{0};                         ///< Epochs with no valid message
+};
+
+/// Select the message to use at t (sec since MJD 0, message time scale);
+/// next is the index of the first message with reference time after t.
+/// For GLONASS the valid message closest to t is selected, else the latest
+/// valid message.
+const NavDataFrame *select(const Satellite &sat, std::size_t next,
+                           double t) noexcept {
+  const NavDataFrame *best = nullptr;
+  double dmin = 0e0;
+  for (std::size_t i = next; i-- > 0;) {
+    const double d = t - reference_time(*sat.msgs[i]);
+    if (d > max_search_span)
+      break;
+    if (valid_at(*sat.msgs[i], t)) {
+      best = sat.msgs[i];
+      dmin = d;
+      break;
+    }
+  }
+  if (sat.sys == SATELLITE_SYSTEM::glonass) {
+    for (std::size_t i = next; i < sat.msgs.size(); i++) {
+      const double d = reference_time(*sat.msgs[i]) - t;
+      if (best && d >= dmin)
+        break;
+      if (valid_at(*sat.msgs[i], t)) {
+        best = sat.msgs[i];
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+/// Compare the broadcast and precise orbits and clocks of a satellite, at
+/// all of its Sp3 epochs
+void compare_satellite(Satellite &sat, const std::vector<Epoch> &epochs,
+                       int leap_seconds) noexcept {
+  const double offset = time_scale_offset(sat.sys, leap_seconds);
+  std::size_t next = 0;
+  double state[6], before[6], after[6], clock, dummy;
+  for (const auto &s : sat.samples) {
+    const Epoch &e = epochs[s.epoch];
+    const ngpt::datetime<ngpt::seconds> t(ngpt::modified_julian_day(e.mjd),
+                                          ngpt::seconds(e.usec / 1000000L));
+    const double dt = (e.usec % 1000000L) * 1e-6 + offset;
+    const double ts = to_seconds(t) + dt;
+    while (next < sat.msgs.size() && reference_time(*sat.msgs[next]) <= ts)
+      ++next;
+
+    const NavDataFrame *f = select(sat, next, ts);
+    if (!f || f->stateNclock(t, state, clock, dt) ||
+        f->stateNclock(t, before, dummy, dt - velocity_step) ||
+        f->stateNclock(t, after, dummy, dt + velocity_step)) {
+      ++sat.missing;
+      continue;
+    }
+
+    // radial, along and cross-track unit vectors of the precise orbit;
+    // velocity is inertial (v + omega x r)
+    const double *r = s.vals.data();
+    double v[3];
+    for (int k = 0; k < 3; k++)
+      v[k] = (after[k] - before[k]) / (2e0 * velocity_step);
+    v[0] -= omega_earth * r[1];
+    v[1] += omega_earth * r[0];
+    const double rn = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    const double er[3] = {r[0] / rn, r[1] / rn, r[2] / rn};
+    double ec[3] = {r[1] * v[2] - r[2] * v[1], r[2] * v[0] - r[0] * v[2],
+                    r[0] * v[1] - r[1] * v[0]};
+    const double cn = std::sqrt(ec[0] * ec[0] + ec[1] * ec[1] + ec[2] * ec[2]);
+    for (int k = 0; k < 3; k++)
+      ec[k] /= cn;
+    const double ea[3] = {ec[1] * er[2] - ec[2] * er[1],
+                          ec[2] * er[0] - ec[0] * er[2],
+                          ec[0] * er[1] - ec[1] * er[0]};
+    const double d[3] = {state[0] - r[0], state[1] - r[1], state[2] - r[2]};
+
+    NavCmpRecord rec;
+    rec.sys = static_cast<std::int32_t>(sat.sys);
+    rec.prn = sat.prn;
+    rec.mjd = e.mjd;
+    rec.sec = e.usec * 1e-6;
+    rec.radial = d[0] * er[0] + d[1] * er[1] + d[2] * er[2];
+    rec.along = d[0] * ea[0] + d[1] * ea[1] + d[2] * ea[2];
+    rec.cross = d[0] * ec[0] + d[1] * ec[1] + d[2] * ec[2];
+    rec.clock = s.has_clock ? speed_of_light * (clock - s.vals[3] * 1e-6)
+                            : std::numeric_limits<double>::quiet_NaN();
+    sat.records.push_back(rec);
+    sat.record_epochs.push_back(s.epoch);
+  }
+}
+
+/// Reserve room for a satellite's records; false on allocation failure
+bool reserve_records(Satellite &sat) noexcept {
+  try {
+    sat.records.reserve(sat.samples.size());
+    sat.record_epochs.reserve(sat.samples.size());
+  } catch (std::exception &) {
+    return false;
   }
-  if (i >= 1000)
+  return true;
+}
+
+/// Per-satellite statistics of the records; aligned are the clock
+/// differences with the per-epoch, per-system mean removed
+NavCmpStats satellite_stats(const Satellite &sat,
+                            const std::vector<double> &aligned) noexcept {
+  NavCmpStats st;
+  st.sys = sat.sys;
+  st.prn = sat.prn;
+  st.epochs = static_cast<int>(sat.records.size());
+  st.missing = sat.missing;
+  st.clock_epochs = 0;
+  for (int k = 0; k < 4; k++)
+    st.mean[k] = st.rms[k] = st.max_abs[k] = 0e0;
+  st.rms_3d = st.clock_rms_aligned = 0e0;
+
+  double sq3d = 0e0, sqal = 0e0;
+  for (std::size_t i = 0; i < sat.records.size(); i++) {
+    const auto &rec = sat.records[i];
+    const double c[4] = {rec.radial, rec.along, rec.cross, rec.clock};
+    const int n = std::isnan(rec.clock) ? 3 : 4;
+    for (int k = 0; k < n; k++) {
+      st.mean[k] += c[k];
+      st.rms[k] += c[k] * c[k];
+      st.max_abs[k] = std::max(st.max_abs[k], std::abs(c[k]));
+    }
+    sq3d += c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    if (n == 4) {
+      ++st.clock_epochs;
+      sqal += aligned[i] * aligned[i];
+    }
+  }
+  for (int k = 0; k < 4; k++) {
+    const int n = (k < 3) ? st.epochs : st.clock_epochs;
+    if (n) {
+      st.mean[k] /= n;
+      st.rms[k] = std::sqrt(st.rms[k] / n);
+    }
+  }
+  if (st.epochs)
+    st.rms_3d = std::sqrt(sq3d / st.epochs);
+  if (st.clock_epochs)
+    st.clock_rms_aligned = std::sqrt(sqal / st.clock_epochs);
+  return st;
+}
+} // namespace
+
+/// @details The Sp3 file is read (from the start of its data section) and
+///          its records grouped per satellite; the (healthy) messages of
+///          every satellite are sorted by reference time. Satellites are
+///          then compared in parallel, each thread picking the next
+///          satellite not yet compared. Satellites of the Sp3 file with no
+///          messages at all are reported with 0 epochs. Sp3 records with a
+///          missing position are ignored.
+/// @param[in]  frames       The navigation messages (any order)
+/// @param[in]  sp3          The Sp3 file (its epochs are taken in GPS time)
+/// @param[out] stats        Statistics per satellite, ordered by system and
+///                          PRN
+/// @param[out] records      If not null, the per-epoch differences, ordered
+///                          by satellite (as stats) and then time
+/// @param[in]  leap_seconds GPS minus UTC (sec); used for GLONASS
+/// @param[in]  num_threads  Number of threads; if <=0, the hardware
+///                          concurrency is used
+/// @return 0 on success, 1 on allocation failure, else 10 plus the status of
+///         Sp3c::get_next_epoch
+int ngpt::compare_nav_sp3(const std::vector<NavDataFrame> &frames, Sp3c &sp3,
+                          std::vector<NavCmpStats> &stats,
+                          std::vector<NavCmpRecord> *records,
+                          int leap_seconds, int num_threads) noexcept {
+  std::vector<Epoch> epochs;
+  std::vector<Satellite> sats;
+  std::array<int, SatId::max_sats> slot;
+  slot.fill(-1);
+
+  // read the Sp3 file; group records per satellite
+  // ------------------------------------------------------------
+  try {
+    auto vec = sp3.allocate_epoch_vector();
+    ngpt::datetime<ngpt::microseconds> t;
+    int sats_read, j;
+    sp3.rewind();
+    do {
+      if ((j = sp3.get_next_epoch(t, vec, sats_read)) > 0)
+        return 10 + j;
+      epochs.push_back(
+          Epoch{t.mjd().as_underlying_type(), t.sec().as_underlying_type()});
+      for (int i = 0; i < sats_read; i++) {
+        const auto &rec = vec[i];
+        const int idx = rec.sat_id().index();
+        if (idx < 0 || rec.flag_.is_set(Sp3Event::bad_abscent_position))
+          continue;
+        if (slot[idx] < 0) {
+          slot[idx] = static_cast<int>(sats.size());
+          sats.push_back(Satellite{rec.s_, rec.prn_, {}, {}, {}, {}, 0});
+        }
+        sats[slot[idx]].samples.push_back(
+            Sp3Sample{epochs.size() - 1, rec.vals_,
+                      !rec.flag_.is_set(Sp3Event::bad_abscent_clock)});
+      }
+    } while (!j);
+
+    // messages per satellite, sorted by reference time
+    for (const auto &f : frames) {
+      const int idx = f.sat_id().index();
+      if (idx >= 0 && slot[idx] >= 0)
+        sats[slot[idx]].msgs.push_back(&f);
+    }
+    for (auto &sat : sats)
+      std::stable_sort(sat.msgs.begin(), sat.msgs.end(),
+                       [](const NavDataFrame *a, const NavDataFrame *b) {
+                         return reference_time(*a) < reference_time(*b);
+                       });
+    std::sort(sats.begin(), sats.end(),
+              [](const Satellite &a, const Satellite &b) {
+                return SatId::index(a.sys, a.prn) < SatId::index(b.sys, b.prn);
+              });
+  } catch (std::exception &) {
+    return 1;
+  }
+  for (auto &sat : sats)
+    if (!reserve_records(sat))
+      return 1;
+
+  // compare, in parallel over satellites
+  // ------------------------------------------------------------
+  std::atomic<std::size_t> next_sat{0};
+  auto work = [&]() noexcept {
+    std::size_t i;
+    while ((i = next_sat.fetch_add(1)) < sats.size())
+      compare_satellite(sats[i], epochs, leap_seconds);
+  };
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  const std::size_t nt = std::max<std::size_t>(
+      1, std::min<std::size_t>(num_threads, sats.size()));
+  std::vector<std::thread> workers;
+  try {
+    workers.reserve(nt - 1);
+  } catch (std::exception &) {
+    // not fatal; compare in this thread only
+  }
+  for (std::size_t c = 1; c < nt && workers.size() < workers.capacity(); c++) {
+    try {
+      workers.emplace_back(work);
+    } catch (std::system_error &) {
+      break;
+    }
+  }
+  work();
+  for (auto &w : workers)
+    w.join();
+
+  // remove the per-epoch, per-system mean of the clock differences
+  // ------------------------------------------------------------
+  try {
+    std::vector<double> sum(epochs.size() * num_systems, 0e0);
+    std::vector<int> count(epochs.size() * num_systems, 0);
+    for (const auto &sat : sats) {
+      const std::size_t s = static_cast<std::size_t>(sat.sys);
+      for (std::size_t i = 0; i < sat.records.size(); i++) {
+        if (std::isnan(sat.records[i].clock))
+          continue;
+        sum[sat.record_epochs[i] * num_systems + s] += sat.records[i].clock;
+        ++count[sat.record_epochs[i] * num_systems + s];
+      }
+    }
+
+    stats.clear();
+    stats.reserve(sats.size());
+    if (records)
+      records->clear();
+    std::vector<double> aligned;
+    for (const auto &sat : sats) {
+      const std::size_t s = static_cast<std::size_t>(sat.sys);
+      aligned.assign(sat.records.size(), 0e0);
+      for (std::size_t i = 0; i < sat.records.size(); i++) {
+        const std::size_t k = sat.record_epochs[i] * num_systems + s;
+        if (count[k])
+          aligned[i] = sat.records[i].clock - sum[k] / count[k];
+      }
+      stats.push_back(satellite_stats(sat, aligned));
+      if (records)
+        records->insert(records->end(), sat.records.begin(),
+                        sat.records.end());
+    }
+  } catch (std::exception &) {
+    return 1;
+  }
+  return 0;
+}
+
+/// One line per satellite, preceded by a header line.
+/// @param[in] fn    The file to write
+/// @param[in] stats The statistics (see compare_nav_sp3)
+/// @return 0 on success, 1 if the file cannot be opened, 2 on write failure
+int ngpt::write_navcmp_csv(const char *fn,
+                           const std::vector<NavCmpStats> &stats) noexcept {
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+  std::fprintf(fp, "sat,epochs,missing,clock_epochs,"
+                   "mean_r,rms_r,max_r,mean_a,rms_a,max_a,mean_c,rms_c,max_c,"
+                   "mean_clk,rms_clk,max_clk,rms_3d,rms_clk_aligned\n");
+  for (const auto &st : stats) {
+    std::fprintf(fp, "%c%02d,%d,%d,%d", ngpt::satsys_to_char(st.sys), st.prn,
+                 st.epochs, st.missing, st.clock_epochs);
+    for (int k = 0; k < 4; k++)
+      std::fprintf(fp, ",%.4f,%.4f,%.4f", st.mean[k], st.rms[k],
+                   st.max_abs[k]);
+    std::fprintf(fp, ",%.4f,%.4f\n", st.rms_3d, st.clock_rms_aligned);
+  }
+  const bool ok = !std::ferror(fp);
+  return (std::fclose(fp) || !ok) ? 2 : 0;
+}
+
+/// One line per satellite and epoch, preceded by a header line; a missing
+/// clock difference is written as an empty field.
+/// @param[in] fn      The file to write
+/// @param[in] records The differences (see compare_nav_sp3)
+/// @return 0 on success, 1 if the file cannot be opened, 2 on write failure
+int ngpt::write_navcmp_csv(const char *fn,
+                           const std::vector<NavCmpRecord> &records) noexcept {
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+  std::fprintf(fp, "sat,mjd,sec,radial,along,cross,clock\n");
+  for (const auto &rec : records) {
+    std::fprintf(fp, "%c%02d,%ld,%.6f,%.4f,%.4f,%.4f,",
+                 ngpt::satsys_to_char(static_cast<SATELLITE_SYSTEM>(rec.sys)),
+                 static_cast<int>(rec.prn), static_cast<long>(rec.mjd),
+                 rec.sec, rec.radial, rec.along, rec.cross);
+    if (!std::isnan(rec.clock))
+      std::fprintf(fp, "%.4f", rec.clock);
+    std::fputc('\n', fp);
+  }
+  const bool ok = !std::ferror(fp);
+  return (std::fclose(fp) || !ok) ? 2 : 0;
+}
+
+/// A NavCmpHeader followed by the records, in native byte order.
+/// @param[in] fn      The file to write
+/// @param[in] records The differences (see compare_nav_sp3)
+/// @return 0 on success, 1 if the file cannot be opened, 2 on write failure
+int ngpt::write_navcmp_binary(
+    const char *fn, const std::vector<NavCmpRecord> &records) noexcept {
+  NavCmpHeader hdr;
+  std::memcpy(hdr.magic, magic, sizeof(hdr.magic));
+  hdr.version = version;
+  hdr.record_size = sizeof(NavCmpRecord);
+  hdr.num_records = records.size();
+
+  std::ofstream fout(fn, std::ios::binary | std::ios::trunc);
+  if (!fout.is_open())
     return 1;
-  Ek = E;
-
-  double sinE(std::sin(E));
-  double cosE(std::cos(E));
-  double ecosEm1(1e0 - e * cosE);
-  double vk_ar((std::sqrt(1e0 - e * e) * sinE) / ecosEm1);
-  double vk_pr((cosE - e) / ecosEm1);
-  double vk(std::atan2(vk_ar, vk_pr)); // True Anomaly
-  double cosVk(std::cos(vk));
-  Ek = std::acos((e + cosVk) / (1e0 + e * cosVk)); // Eccentric Anomaly
-
-  // Second Harmonic Perturbations
-  double Fk(vk + data__[17]); // Argument of Latitude
-  double sin2F(std::sin(2e0 * Fk));
-  double cos2F(std::cos(2e0 * Fk));
-  double duk(data__[9] * sin2F + data__[7] * cos2F);   // Argument of Latitude
-                                                       //+ Correction
-  double drk(data__[4] * sin2F + data__[16] * cos2F);  // Radius Correction
-  double dik(data__[14] * sin2F + data__[12] * cos2F); // Inclination Correction
-
-  double uk(Fk + duk);                           // Corrected Argument
-                                                 //+ of Latitude
-  double rk(A * (1e0 - e * std::cos(Ek)) + drk); // Corrected Radius
-  double ik(data__[15] + dik + data__[19] * tk); // Corrected Inclination
-
-  // Positions in orbital plane
-  double xk_dot(rk * std::cos(uk));
-  double yk_dot(rk * std::sin(uk));
-
-  // Corrected longitude of ascending node
-  double omega_k(data__[13] + (data__[18] - OMEGAE_dot) * tk -
-                 OMEGAE_dot * data__[11]);
-  double sinOk(std::sin(omega_k));
-  double cosOk(std::cos(omega_k));
-  double cosik(std::cos(ik));
-
-  x = xk_dot * cosOk - yk_dot * sinOk * cosik;
-  y = xk_dot * sinOk - yk_dot * cosOk * cosik;
-  z = yk_dot * std::sin(ik);
-  return;
+  fout.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  fout.write(reinterpret_cast<const char *>(records.data()),
+             records.size() * sizeof(NavCmpRecord));
+  return fout.good() ? 0 : 2;
 }
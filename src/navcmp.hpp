@@ -0,0 +1,102 @@
+#ifndef __GNSS_NAVCMP_HPP__
+#define __GNSS_NAVCMP_HPP__
+
+/// @file     navcmp.hpp
+///
+/// @brief    Compare broadcast orbits and clocks (navigation messages)
+///           against precise ones (an Sp3 file), for all satellites and
+///           epochs of the Sp3 file.
+///
+/// @details  For every Sp3 epoch and satellite, the broadcast message valid
+///           at the epoch is selected (same rules as
+///           NavigationRnx::find_next_valid; unhealthy messages are skipped)
+///           and the broadcast state and clock are evaluated. Differences
+///           are always broadcast minus precise; orbit differences are
+///           projected onto the radial, along-track and cross-track axes of
+///           the precise orbit (the inertial velocity, used for the along
+///           and cross axes, is differenced from the broadcast orbit).
+///           Clock differences are given in meters; since the Sp3 and
+///           broadcast clocks need not refer to the same reference clock,
+///           statistics of the clock differences are also given after
+///           removing (per epoch and satellite system) the mean over all
+///           satellites.
+///
+///           Sp3 epochs are taken to be in GPS time; GLONASS messages are
+///           evaluated in UTC (via the leap seconds) and BeiDou messages in
+///           BDT. Broadcast orbits refer to the antenna phase center while
+///           Sp3 orbits usually refer to the center of mass; this offset is
+///           not corrected and shows up in the differences.
+///
+///           The Sp3 file is read once; satellites are then processed in
+///           parallel.
+
+#include "navrnx.hpp"
+#include "satsys.hpp"
+#include "sp3c.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace ngpt {
+
+/// Broadcast minus precise differences of a satellite at one epoch.
+struct NavCmpRecord {
+  std::int32_t sys; ///< Satellite system (cast to int)
+  std::int32_t prn; ///< PRN
+  std::int64_t mjd; ///< MJD of the epoch
+  double sec;       ///< Seconds of day of the epoch
+  double radial;    ///< Radial difference (m)
+  double along;     ///< Along-track difference (m)
+  double cross;     ///< Cross-track difference (m)
+  double clock;     ///< Clock difference (m); NaN if the Sp3 clock is missing
+};
+
+static_assert(std::is_trivially_copyable<NavCmpRecord>::value,
+              "NavCmpRecord must be trivially copyable");
+
+/// Broadcast minus precise statistics of a satellite. Components are
+/// indexed as radial (0), along-track (1), cross-track (2) and clock (3);
+/// all in meters.
+struct NavCmpStats {
+  SATELLITE_SYSTEM sys; ///< Satellite system
+  int prn;              ///< PRN
+  int epochs;           ///< Epochs compared
+  int missing;          ///< Sp3 epochs with no valid broadcast message
+  int clock_epochs;     ///< Epochs with a clock difference
+  double mean[4];       ///< Mean of the differences
+  double rms[4];        ///< RMS of the differences
+  double max_abs[4];    ///< Max absolute difference
+  double rms_3d;        ///< RMS of the 3D orbit difference
+  double clock_rms_aligned; ///< RMS of the clock differences after removing
+                            ///< the per-epoch, per-system mean
+};
+
+/// @brief Compare navigation messages against an Sp3 file
+int compare_nav_sp3(const std::vector<NavDataFrame> &frames, Sp3c &sp3,
+                    std::vector<NavCmpStats> &stats,
+                    std::vector<NavCmpRecord> *records = nullptr,
+                    int leap_seconds = 18, int num_threads = 0) noexcept;
+
+/// @brief Write per-satellite statistics in CSV format
+int write_navcmp_csv(const char *fn,
+                     const std::vector<NavCmpStats> &stats) noexcept;
+
+/// @brief Write per-epoch differences in CSV format
+int write_navcmp_csv(const char *fn,
+                     const std::vector<NavCmpRecord> &records) noexcept;
+
+/// Header of a binary comparison file; the records follow.
+struct NavCmpHeader {
+  char magic[8];             ///< "NGPTCMP" (null-terminated)
+  std::uint32_t version;     ///< Layout version
+  std::uint32_t record_size; ///< sizeof(NavCmpRecord)
+  std::uint64_t num_records; ///< Number of records
+};
+
+/// @brief Write per-epoch differences in binary format
+int write_navcmp_binary(const char *fn,
+                        const std::vector<NavCmpRecord> &records) noexcept;
+
+} // namespace ngpt
+
+#endif
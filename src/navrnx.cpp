@@ -1,11 +1,17 @@
 #include "navrnx.hpp"
+#include "diagnostics.hpp"
 #include "ggdatetime/datetime_read.hpp"
+#include "instrument.hpp"
 #include "nvarstr.hpp"
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
 
 using ngpt::NavDataFrame;
 using ngpt::NavigationRnx;
@@ -67,37 +73,113 @@ int __lines_per_satsys_v3__(ngpt::SATELLITE_SYSTEM s,
 ///           function expect that the first line to be read is:
 ///           "SV/ EPOCH / SV CLK". Depending on the satellite system (to be
 ///           resolved from the first line) it will read the respective number
-///           of lines and resolve them.
+///           of lines and resolve them (via set_from_rnx3(const char*, ...)).
 /// @param[in] inp Input file (nav RINEX v3) stream, placed before (aka first
 ///                line to be read is:) "SV/ EPOCH / SV CLK"
 /// @return    Anything other than 0 denotes an error.
-/// @todo the line toc__ = ngpt::strptime_ymd_hms<ngpt::seconds>(line+3); may
-/// throw! what can i do about this?
 int NavDataFrame::set_from_rnx3(std::ifstream &inp) noexcept {
-  char line[MAX_RECORD_CHARS];
-  char *str_end;
+  char block[MAX_RECORD_CHARS * 8];
+  char *line = block;
 
 #ifdef DEBUG
   if (!inp.good())
     return 50;
 #endif
 
-  // Read the first line.
+  // Read the first line and resolve the satellite system.
   // ------------------------------------------------------------
   if (!inp.getline(line, MAX_RECORD_CHARS)) {
     return 1;
   }
-  sys__ = ngpt::char_to_satsys(*line);
-  toc__ = ngpt::strptime_ymd_hms<ngpt::seconds>(line + 3);
-  prn__ = std::strtol(line + 1, &str_end, 10);
-  if (!prn__ || errno == ERANGE) {
-    errno = 0;
+  int last_line_recs = 0;
+  int lines_in_block;
+  try {
+    lines_in_block =
+        __lines_per_satsys_v3__(ngpt::char_to_satsys(*line), last_line_recs);
+  } catch (std::exception &) {
+    return 4;
+  }
+  if (lines_in_block < 0) {
+    return 4;
+  }
+
+  // gather the lines of the block (newline-separated)
+  for (int ln = 0; ln < lines_in_block; ln++) {
+    if (ln && !inp.getline(line, MAX_RECORD_CHARS)) {
+      return (ln == lines_in_block - 1) ? 7 : 5;
+    }
+    line += std::strlen(line);
+    *line++ = '\n';
+  }
+
+  const char *next;
+  return this->set_from_rnx3(block, line, next);
+}
+
+/// @details: Resolve a Nav. RINEX v3.x data block, held in memory, to a
+///           NavDataFrame. The block starts at the line "SV/ EPOCH / SV CLK";
+///           lines are separated by newlines ('\n', optionaly preceded by
+///           '\r') and need not be null-terminated. Numeric fields are
+///           resolved via __fixed2double__, i.e. Fortran exponents ('D') are
+///           handled while parsing (no __for2cpp__ pass is needed).
+/// @param[in]  block Start of the data block
+/// @param[in]  end   End of the buffer holding the block (no char at or after
+///                   end is read)
+/// @param[out] next  Start of the line following the block
+/// @return    Anything other than 0 denotes an error.
+/// @todo the line toc__ = ngpt::strptime_ymd_hms<ngpt::seconds>(line+3); may
+/// throw! what can i do about this?
+int NavDataFrame::set_from_rnx3(const char *block, const char *end,
+                                const char *&next) noexcept {
+  NGPT_TIME_SCOPE(nav_record);
+  constexpr int W = 19;
+  const char *line = block;
+  const char *eol;
+
+  // find the end of the current line; strip a trailing '\r'
+  auto line_end = [&end](const char *str) -> const char * {
+    const char *c = static_cast<const char *>(
+        std::memchr(str, '\n', static_cast<std::size_t>(end - str)));
+    if (!c)
+      c = end;
+    return (c > str && *(c - 1) == '\r') ? c - 1 : c;
+  };
+  // move to the start of the next line
+  auto next_line = [&end](const char *str) -> const char * {
+    const char *c = static_cast<const char *>(
+        std::memchr(str, '\n', static_cast<std::size_t>(end - str)));
+    return c ? c + 1 : end;
+  };
+
+  // Resolve the first line.
+  // ------------------------------------------------------------
+  if (line >= end) {
+    return 1;
+  }
+  eol = line_end(line);
+  if (eol - line < 23) {
+    return 1;
+  }
+  char epoch[24];
+  std::memcpy(epoch, line, 23);
+  epoch[23] = '\0';
+  try {
+    sys__ = ngpt::char_to_satsys(*line);
+    toc__ = ngpt::strptime_ymd_hms<ngpt::seconds>(epoch + 3);
+  } catch (std::exception &) {
+    return 4;
+  }
+  prn__ = 0;
+  for (const char *c = line + 1; c < line + 3; ++c) {
+    if (*c >= '0' && *c <= '9')
+      prn__ = prn__ * 10 + (*c - '0');
+    else if (*c != ' ')
+      return 2;
+  }
+  if (!prn__) {
     return 2;
   }
-  // replace 'D' or 'd' with 'e' in remaining floats
-  __for2cpp__(line + 23);
-  if (!__char2double__<3, 19>(line + 23, data__)) {
-    errno = 0;
+  if (!__fixed2double__<W>(line + 23, eol, data__, 3)) {
     return 3;
   }
 
@@ -107,57 +189,43 @@ int NavDataFrame::set_from_rnx3(std::ifstream &inp) noexcept {
   if (lines_in_block < 0) {
     return 4;
   }
-  // read all but the last line (** all but galileo or beidou **)
-  if (sys__ != SATELLITE_SYSTEM::galileo && sys__ != SATELLITE_SYSTEM::beidou) {
-    for (ln = 0; ln < lines_in_block - 1; ln++) {
-      if (!inp.getline(line, MAX_RECORD_CHARS)) {
-        return 5;
-      }
-      // replace 'D' or 'd' with 'e'
-      __for2cpp__(line);
-      // read 4 doubles into data__
-      if (!__char2double__<4, 19>(line + 4, data__ + 3 + ln * 4)) {
-        errno = 0;
-        return 6;
-      }
+  // read all but the last line; galileo and beidou have an empty record in
+  // line #5
+  const bool short_line_5 =
+      (sys__ == SATELLITE_SYSTEM::galileo || sys__ == SATELLITE_SYSTEM::beidou);
+  for (ln = 0; ln < lines_in_block - 1; ln++) {
+    line = next_line(line);
+    if (line >= end) {
+      return 5;
     }
-  } else { // galileo and beidou have an empty record in line #5
-    for (ln = 0; ln < lines_in_block - 1; ln++) {
-      if (!inp.getline(line, MAX_RECORD_CHARS)) {
-        return 5;
-      }
-      // replace 'D' or 'd' with 'e'
-      __for2cpp__(line);
-      // read 4 doubles into data__
-      if (ln != 4) {
-        if (!__char2double__<4, 19>(line + 4, data__ + 3 + ln * 4)) {
-          errno = 0;
-          return 6;
-        }
-      } else {
-        if (!__char2double__<3, 19>(line + 4, data__ + 3 + ln * 4)) {
-          errno = 0;
-          return 6;
-        }
-      }
+    eol = line_end(line);
+    // read 4 (or 3) doubles into data__
+    const int recs = (short_line_5 && ln == 4) ? 3 : 4;
+    if (!__fixed2double__<W>(line + 4, eol, data__ + 3 + ln * 4, recs)) {
+      return 6;
     }
+    if (recs == 3)
+      data__[3 + ln * 4 + 3] = 0e0;
   }
 
   // read last line
-  if (!inp.getline(line, MAX_RECORD_CHARS)) {
+  line = next_line(line);
+  if (line >= end) {
     return 7;
   }
-  // replace 'D' or 'd' with 'e'
-  __for2cpp__(line);
+  eol = line_end(line);
   // read remaining last_line_recs doubles into data__
-  if (!__char2double__<19>(line + 4, data__ + 3 + ln * 4, last_line_recs)) {
-    errno = 0;
+  if (!__fixed2double__<W>(line + 4, eol, data__ + 3 + ln * 4,
+                           last_line_recs)) {
     return 8;
   }
+  // spare slots are always zero
+  std::fill(data__ + 3 + ln * 4 + last_line_recs, data__ + 31, 0e0);
+  next = next_line(line);
 
-  // If we read a GLONASS navigation frame, convert SV state vector to meters
-  // (originaly in km)
-  if (sys__ == SATELLITE_SYSTEM::glonass) {
+  // If we read a GLONASS or SBAS navigation frame, convert SV state vector to
+  // meters (originaly in km)
+  if (sys__ == SATELLITE_SYSTEM::glonass || sys__ == SATELLITE_SYSTEM::sbas) {
     for (int i : {3, 4, 5, 7, 8, 9, 11, 12, 13})
       data__[i] *= 1e3;
   }
@@ -171,10 +239,7 @@ int NavDataFrame::set_from_rnx3(std::ifstream &inp) noexcept {
       sys__ == SATELLITE_SYSTEM::beidou)
     assert(std::abs(data__[11] - (int)data__[11]) < 1e-15);
 #endif
-  if (sys__ == SATELLITE_SYSTEM::gps || sys__ == SATELLITE_SYSTEM::glonass ||
-      sys__ == SATELLITE_SYSTEM::galileo || sys__ == SATELLITE_SYSTEM::beidou) {
-    toe__ = this->toe2date<ngpt::seconds>();
-  }
+  toe__ = this->toe2date<ngpt::seconds>();
 
   return 0;
 }
@@ -198,6 +263,68 @@ NavigationRnx::NavigationRnx(const char *filename)
   }
 }
 
+namespace {
+/// Copy the (fixed-width) field [start, start+width) of a line to buf
+/// (null-terminated); the copy stops at the end of the line, if the line is
+/// shorter than start+width.
+void copy_field(const char *line, int start, int width, char *buf) noexcept {
+  int i = 0;
+  while (i < start && line[i])
+    ++i;
+  int j = 0;
+  for (; j < width && line[i]; j++, i++)
+    buf[j] = line[i];
+  buf[j] = '\0';
+}
+
+/// Width of the field [start, start+width) of a line, cut at the end of the
+/// line (trailing blanks of header lines are often trimmed); 0 if the line
+/// ends before start.
+int field_width(const char *line, int start, int width) noexcept {
+  int i = 0;
+  while (i < start + width && line[i])
+    ++i;
+  return (i > start) ? i - start : 0;
+}
+
+/// Resolve a fixed-width floating point field, possibly written in Fortran
+/// notation (aka with a 'D' exponent), via __fixed2double__; a blank field
+/// is resolved as 0, anything other than blanks after the number is an
+/// error.
+/// @return Anything other than 0 denotes an error
+int fixed_double(const char *line, int start, int width, double &val) noexcept {
+  const int w = field_width(line, start, width);
+  if (!w) {
+    val = 0e0;
+    return 0;
+  }
+  return !ngpt::__fixed2double__(line + start, w, val);
+}
+
+/// Resolve a fixed-width integer field, via __fixed2long__; a blank field is
+/// resolved as 0, anything other than blanks after the number is an error.
+/// @return Anything other than 0 denotes an error
+int fixed_long(const char *line, int start, int width, long &val) noexcept {
+  const int w = field_width(line, start, width);
+  if (!w) {
+    val = 0;
+    return 0;
+  }
+  return !ngpt::__fixed2long__(line + start, w, val);
+}
+
+/// Resolve the correction type of an "IONOSPHERIC CORR" line (first 4
+/// chars) to an IONO_CORR_TYPE (cast to int); unknown types return -1.
+int iono_corr_type(const char *line) noexcept {
+  constexpr const char *types[] = {"GPSA", "GPSB", "GAL ", "QZSA", "QZSB",
+                                   "BDSA", "BDSB", "IRNA", "IRNB"};
+  for (int i = 0; i < 9; i++)
+    if (!std::strncmp(line, types[i], 4))
+      return i;
+  return -1;
+}
+} // namespace
+
 /// Read a RINEX Navigation v3.x header and assign vital information.
 /// The function will read all header lines, stoping after the line:
 /// "END OF HEADER"
@@ -230,9 +357,50 @@ int NavigationRnx::read_header() noexcept {
   // Keep on readling lines until 'END OF HEADER'.
   // ----------------------------------------------------
   int dummy_it = 0;
+  __iono_flags = 0;
+  __time_corr.clear();
+  __has_leap_sec = false;
   __istream.getline(line, MAX_HEADER_CHARS);
   while (dummy_it < MAX_HEADER_LINES &&
          std::strncmp(line + 60, "END OF HEADER", eoh_size)) {
+    if (!std::strncmp(line + 60, "IONOSPHERIC CORR",
+                      std::strlen("IONOSPHERIC CORR"))) {
+      int type = iono_corr_type(line);
+      if (type >= 0 &&
+          resolve_iono_corr(line, static_cast<ngpt::IONO_CORR_TYPE>(type), 5,
+                            12, 4)) {
+        ngpt::diagnostics::error("NavigationRnx::read_header() Failed to "
+                                 "resolve field: \"IONOSPHERIC CORR\"");
+        return 30;
+      }
+    } else if (!std::strncmp(line + 60, "ION ALPHA",
+                             std::strlen("ION ALPHA")) ||
+               !std::strncmp(line + 60, "ION BETA",
+                             std::strlen("ION BETA"))) {
+      auto type = (line[64] == 'A') ? ngpt::IONO_CORR_TYPE::gpsa
+                                    : ngpt::IONO_CORR_TYPE::gpsb;
+      if (resolve_iono_corr(line, type, 2, 12, 4)) {
+        ngpt::diagnostics::error("NavigationRnx::read_header() Failed to "
+                                 "resolve field: \"ION ALPHA/BETA\"");
+        return 30;
+      }
+    } else if (!std::strncmp(line + 60, "TIME SYSTEM CORR",
+                             std::strlen("TIME SYSTEM CORR")) ||
+               !std::strncmp(line + 60, "DELTA-UTC",
+                             std::strlen("DELTA-UTC"))) {
+      if (resolve_time_corr(line)) {
+        ngpt::diagnostics::error("NavigationRnx::read_header() Failed to "
+                                 "resolve field: \"TIME SYSTEM CORR\"");
+        return 31;
+      }
+    } else if (!std::strncmp(line + 60, "LEAP SECONDS",
+                             std::strlen("LEAP SECONDS"))) {
+      if (resolve_leap_seconds(line)) {
+        ngpt::diagnostics::error("NavigationRnx::read_header() Failed to "
+                                 "resolve field: \"LEAP SECONDS\"");
+        return 32;
+      }
+    }
     __istream.getline(line, MAX_HEADER_CHARS);
     dummy_it++;
   }
@@ -247,6 +415,100 @@ int NavigationRnx::read_header() noexcept {
   return 0;
 }
 
+/// @param[in]  type   The type of correction parameters
+/// @param[out] params At output, the (four) correction parameters; for the
+///                    Galileo type, the fourth element is 0
+/// @return 0 on success, 1 if the parameters were not found in the header
+int NavigationRnx::ionospheric_corr(IONO_CORR_TYPE type, double *params) const
+    noexcept {
+  const int i = static_cast<int>(type);
+  if (!(__iono_flags & (1u << i)))
+    return 1;
+  for (int j = 0; j < 4; j++)
+    params[j] = __iono_corr[i][j];
+  return 0;
+}
+
+/// @param[in]  type The type of the correction, e.g. "GPUT" (4 chars)
+/// @param[out] corr At output, the correction (if found)
+/// @return 0 on success, 1 if the correction was not found in the header
+int NavigationRnx::time_system_corr(const char *type,
+                                    TimeSystemCorrection &corr) const noexcept {
+  for (const auto &c : __time_corr) {
+    if (!std::strncmp(c.type, type, 4)) {
+      corr = c;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/// Resolve num fixed-width floating point parameters starting at column
+/// start, and store them as the parameters of the given type. Blank
+/// parameters (e.g. the fourth one for Galileo) are set to 0.
+int NavigationRnx::resolve_iono_corr(const char *line, IONO_CORR_TYPE type,
+                                     int start, int width, int num) noexcept {
+  const int i = static_cast<int>(type);
+  for (int j = 0; j < num; j++)
+    if (fixed_double(line, start + j * width, width, __iono_corr[i][j]))
+      return 1;
+  __iono_flags |= (1u << i);
+  return 0;
+}
+
+/// The v3.x format is A4,1X,D17.10,D16.9,1X,I6,1X,I4,1X,A5,1X,I2; a v2.x
+/// "DELTA-UTC: A0,A1,T,W" line (3X,2D19.12,2I9) is stored as a "GPUT"
+/// correction.
+/// @return 0 on success, 1 if a field cannot be resolved, 2 if the
+///         correction cannot be stored
+int NavigationRnx::resolve_time_corr(const char *line) noexcept {
+  TimeSystemCorrection c;
+  long t_ref, week, utc_id = 0;
+  if (!std::strncmp(line + 60, "DELTA-UTC", std::strlen("DELTA-UTC"))) {
+    std::memcpy(c.type, "GPUT", 4);
+    if (fixed_double(line, 3, 19, c.a0) || fixed_double(line, 22, 19, c.a1) ||
+        fixed_long(line, 41, 9, t_ref) || fixed_long(line, 50, 9, week))
+      return 1;
+  } else {
+    std::memcpy(c.type, line, 4);
+    if (fixed_double(line, 5, 17, c.a0) || fixed_double(line, 22, 16, c.a1) ||
+        fixed_long(line, 38, 7, t_ref) || fixed_long(line, 45, 5, week) ||
+        fixed_long(line, 56, 3, utc_id))
+      return 1;
+    copy_field(line, 51, 5, c.source);
+    for (int i = 4; i >= 0 && c.source[i] == ' '; i--)
+      c.source[i] = '\0';
+  }
+  c.t_ref = t_ref;
+  c.week = static_cast<int>(week);
+  c.utc_id = static_cast<int>(utc_id);
+  try {
+    __time_corr.push_back(c);
+  } catch (std::exception &) {
+    return 2;
+  }
+  return 0;
+}
+
+/// The format is 4I6,A3 (the last three fields and the time system are
+/// optional; v2.x files only hold the first field).
+int NavigationRnx::resolve_leap_seconds(const char *line) noexcept {
+  long vals[4];
+  for (int i = 0; i < 4; i++)
+    if (fixed_long(line, i * 6, 6, vals[i]))
+      return 1;
+  __leap_sec.delta_ls = static_cast<int>(vals[0]);
+  __leap_sec.delta_lsf = static_cast<int>(vals[1]);
+  __leap_sec.wn_lsf = static_cast<int>(vals[2]);
+  __leap_sec.dn = static_cast<int>(vals[3]);
+  char sys[4];
+  copy_field(line, 24, 3, sys);
+  __leap_sec.sys = std::strncmp(sys, "BDS", 3) ? SATELLITE_SYSTEM::gps
+                                               : SATELLITE_SYSTEM::beidou;
+  __has_leap_sec = true;
+  return 0;
+}
+
 /// @details Read the next nav data block and assign it.
 /// param[in] nav A NavDataFrame where the read in RINEX block will be resolved
 ///               to.
@@ -336,6 +598,7 @@ ngpt::SATELLITE_SYSTEM NavigationRnx::peak_satsys(int &status) noexcept {
 /// @details Set the nav RINEX stream to end of header, ready to restart
 ///          reading nav data blocks
 void NavigationRnx::rewind(pos_type pos) noexcept {
+  NGPT_COUNT(nav_seeks);
   if (pos == pos_type(-1)) {
     __istream.seekg(__end_of_head);
   } else {
@@ -344,6 +607,160 @@ void NavigationRnx::rewind(pos_type pos) noexcept {
   return;
 }
 
+/// @details Read and resolve all navigation data blocks of the file (i.e.
+///          everything after the header, irrespective of the current stream
+///          position), in order. The data section is read into memory in one
+///          go; block boundaries are found by a (fast) scan of the buffer,
+///          since every block has a fixed number of lines given its satellite
+///          system (see __lines_per_satsys_v3__). The blocks are then resolved
+///          (via NavDataFrame::set_from_rnx3(const char*, ...)) in parallel,
+///          each thread decoding a contiguous range of frames.
+///          At exit the stream is placed at the end of the file (use rewind
+///          to read it again).
+/// @param[out] frames      All navigation messages of the file, in the order
+///                         they are recorded; on error, its contents are
+///                         unspecified
+/// @param[in]  num_threads Number of threads to use; if <= 0, the number of
+///                         hardware threads is used. Threads are only spawned
+///                         for (at least) min_records_per_thread blocks each
+/// @return   = 0 All ok; all blocks resolved
+///           > 0 Error; either:
+///               * 60 failed to read the file or to allocate memory,
+///               * 61 unknown satellite system at a block start,
+///               * 62 the last block of the file is incomplete,
+///               * else the status of set_from_rnx3 for the first block that
+///                 failed
+int NavigationRnx::read_all_records(std::vector<NavDataFrame> &frames,
+                                    int num_threads) noexcept {
+  constexpr std::size_t min_records_per_thread{256};
+  std::vector<char> buf;
+  std::vector<std::size_t> starts;
+
+  // read the data section
+  // ------------------------------------------------------------
+  try {
+    __istream.clear();
+    NGPT_COUNT(nav_seeks);
+    __istream.seekg(0, std::ios::end);
+    const pos_type eof = __istream.tellg();
+    __istream.seekg(__end_of_head);
+    if (eof == pos_type(-1) || !__istream.good())
+      return clear_stream(60);
+    buf.resize(static_cast<std::size_t>(eof - __end_of_head));
+    if (!__istream.read(buf.data(), buf.size()))
+      return clear_stream(60);
+  } catch (std::exception &) {
+    return clear_stream(60);
+  }
+  const char *const begin = buf.data();
+  const char *const end = begin + buf.size();
+
+  // scan for block boundaries
+  // ------------------------------------------------------------
+  const char *p = begin;
+  int dummy;
+  while (p < end) {
+    const char *eol = static_cast<const char *>(
+        std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (!eol)
+      eol = end;
+    // skip blank lines (e.g. at the end of the file)
+    const char *c = p;
+    while (c < eol && (*c == ' ' || *c == '\r' || *c == '\t'))
+      ++c;
+    if (c == eol) {
+      p = eol + (eol < end);
+      continue;
+    }
+    int lines;
+    try {
+      lines = __lines_per_satsys_v3__(ngpt::char_to_satsys(*p), dummy);
+    } catch (std::exception &) {
+      return 61;
+    }
+    if (lines < 0)
+      return 61;
+    try {
+      starts.push_back(static_cast<std::size_t>(p - begin));
+    } catch (std::exception &) {
+      return 60;
+    }
+    for (; lines && p < end; --lines) {
+      eol = static_cast<const char *>(
+          std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+      p = eol ? eol + 1 : end;
+    }
+    // the last line of the file need not end with a newline, but all lines
+    // of the block must be there
+    if (lines)
+      return 62;
+  }
+  try {
+    frames.resize(starts.size());
+  } catch (std::exception &) {
+    return 60;
+  }
+
+  // decode the blocks
+  // ------------------------------------------------------------
+  const std::size_t n = starts.size();
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  std::size_t nt = std::max<std::size_t>(
+      1, std::min<std::size_t>(num_threads, n / min_records_per_thread));
+  // status per chunk
+  std::vector<int> status;
+  try {
+    status.assign(nt, 0);
+  } catch (std::exception &) {
+    nt = 1;
+  }
+  auto decode = [&](std::size_t first, std::size_t last,
+                    int &st) noexcept {
+    const char *next;
+    for (std::size_t i = first; i < last && !st; i++)
+      st = frames[i].set_from_rnx3(begin + starts[i], end, next);
+  };
+
+  if (nt == 1) {
+    int st = 0;
+    decode(0, n, st);
+    return st;
+  }
+
+  std::vector<std::thread> workers;
+  std::vector<std::size_t> serial; // chunks no thread could be spawned for
+  const std::size_t chunk_size = (n + nt - 1) / nt;
+  try {
+    workers.reserve(nt - 1);
+    serial.reserve(nt - 1);
+  } catch (std::exception &) {
+    int st = 0;
+    decode(0, n, st);
+    return st;
+  }
+  for (std::size_t c = 1; c < nt; c++) {
+    const std::size_t first = c * chunk_size;
+    const std::size_t last = std::min(n, first + chunk_size);
+    try {
+      workers.emplace_back(decode, first, last, std::ref(status[c]));
+    } catch (std::system_error &) {
+      serial.push_back(c);
+    }
+  }
+  decode(0, std::min(n, chunk_size), status[0]);
+  for (std::size_t c : serial)
+    decode(c * chunk_size, std::min(n, (c + 1) * chunk_size), status[c]);
+  for (auto &w : workers)
+    w.join();
+
+  // report the first block (in file order) that failed
+  for (int st : status)
+    if (st)
+      return st;
+  return 0;
+}
+
 /// @param[out] curpos  Current position (before starting the function) of the
 ///                     instane's stream; after the execution you can rewing
 ///                     back to curpos and pretend nothing changed
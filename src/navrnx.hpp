@@ -1,10 +1,14 @@
 #ifndef __NAVIGATION_RINEX_HPP__
 #define __NAVIGATION_RINEX_HPP__
 
+#include "diagnostics.hpp"
 #include "ggdatetime/dtcalendar.hpp"
+#include "kepler.hpp"
+#include "satid.hpp"
 #include "satsys.hpp"
 #include <iostream>
 #include <fstream>
+#include <vector>
 #ifdef DEBUG
 #include "ggdatetime/datetime_write.hpp"
 #endif
@@ -23,10 +27,20 @@ public:
   /// @brief Set from a RINEX 3.x navigation data block
   int set_from_rnx3(std::ifstream &inp) noexcept;
 
+  /// @brief Set from a RINEX 3.x navigation data block held in memory
+  int set_from_rnx3(const char *block, const char *end,
+                    const char *&next) noexcept;
+
+  /// @brief Time of ephemeris as datetime<T> instance
+  ///
+  /// For SBAS, ToE is the epoch of the state vector, i.e. ToC. For an
+  /// unknown (or mixed) satellite system, datetime<T>::min() is returned.
   template <typename T, typename = std::enable_if_t<T::is_of_sec_type>>
-  ngpt::datetime<T> toe2date() const {
+  ngpt::datetime<T> toe2date() const noexcept {
     switch (this->sys__) {
     case (SATELLITE_SYSTEM::gps):
+    case (SATELLITE_SYSTEM::qzss):
+    case (SATELLITE_SYSTEM::irnss):
       return gps_toe2date<T>();
     case (SATELLITE_SYSTEM::glonass):
       return glo_toe2date<T>();
@@ -35,65 +49,95 @@ public:
     case (SATELLITE_SYSTEM::beidou):
       return bds_toe2date<T>();
     case (SATELLITE_SYSTEM::sbas):
-    case (SATELLITE_SYSTEM::qzss):
-    case (SATELLITE_SYSTEM::irnss):
+      return toc__.cast_to<T>();
     case (SATELLITE_SYSTEM::mixed):
-      std::cerr << "\n[ERROR] NavDataFrame::toe2date() Cannot handle satellite "
-                   "system: "
-                << satsys_to_char(sys__);
-      throw std::runtime_error(
-          "ERROR] NavDataFrame::toe2date() Cannot handle satellite system");
+      break;
     }
     return datetime<T>::min();
   }
 
+  /// @brief Compute satellite state and clock correction at epoch t+dt
+  /// @param[in] t  The epoch
+  /// @param[out] state The SV state vector (position and velocity) in meters
+  ///               and meters/sec
+  /// @param[out] clock The SV clock correction in seconds
+  /// @param[in] dt An offset in (fractional) seconds to add to t; use this
+  ///               to evaluate at signal transmission time (e.g. dt=-tau)
+  ///               without loss of precision
+  /// @return Anything other than 0 denotes an error; 100 is returned for an
+  ///         unknown (or mixed) satellite system
   template <typename T, typename = std::enable_if_t<T::is_of_sec_type>>
-  int stateNclock(const ngpt::datetime<T> &t, double *state,
-                  double &clock) const {
+  int stateNclock(const ngpt::datetime<T> &t, double *state, double &clock,
+                  double dt = 0e0) const noexcept {
     switch (this->sys__) {
     case (SATELLITE_SYSTEM::gps):
-      return gps_stateNclock(t, state, clock);
+      return sys_stateNclock<SATELLITE_SYSTEM::gps>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::glonass):
-      return glo_stateNclock(t, state, clock);
+      return sys_stateNclock<SATELLITE_SYSTEM::glonass>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::galileo):
-      return gal_stateNclock(t, state, clock);
+      return sys_stateNclock<SATELLITE_SYSTEM::galileo>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::beidou):
-      return bds_stateNclock(t, state, clock);
+      return sys_stateNclock<SATELLITE_SYSTEM::beidou>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::sbas):
+      return sys_stateNclock<SATELLITE_SYSTEM::sbas>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::qzss):
+      return sys_stateNclock<SATELLITE_SYSTEM::qzss>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::irnss):
+      return sys_stateNclock<SATELLITE_SYSTEM::irnss>(t, state, clock, dt);
     case (SATELLITE_SYSTEM::mixed):
-      std::cerr << "\n[ERROR] NavDataFrame::stateNclock() Cannot handle "
-                   "satellite system: "
-                << satsys_to_char(sys__);
-      throw std::runtime_error(
-          "ERROR] NavDataFrame::stateNclock) Cannot handle satellite system");
+      break;
     }
     return 100;
   }
 
-  int sv_health() const {
+  /// @brief Compute satellite state and clock correction at epoch t+dt, for
+  ///        a satellite system known at compile time
+  ///
+  /// Keplerian systems (GPS, Galileo, BeiDou, QZSS and IRNSS) share the same
+  /// data block layout and use kepler2state and sv_clock; GLONASS messages
+  /// are integrated (glo_stateNclock) and SBAS state vectors propagated
+  /// (sbas_stateNclock). The frame's system must be S.
+  /// @see stateNclock
+  template <SATELLITE_SYSTEM S, typename T,
+            typename = std::enable_if_t<T::is_of_sec_type>>
+  int sys_stateNclock(const ngpt::datetime<T> &t, double *state,
+                      double &clock, double dt = 0e0) const noexcept {
+    if constexpr (S == SATELLITE_SYSTEM::glonass) {
+      return glo_stateNclock(t, state, clock, dt);
+    } else if constexpr (S == SATELLITE_SYSTEM::sbas) {
+      return sbas_stateNclock(t, state, clock, dt);
+    } else {
+      static_assert(S != SATELLITE_SYSTEM::mixed,
+                    "Cannot compute state for a mixed satellite system");
+      int status;
+      if ((status = this->kepler2state<S>(this->ref2toe<T>(t) + dt, state)))
+        return status;
+      return sv_clock<S>(this->ref2toc<T>(t) + dt, clock);
+    }
+  }
+
+  /// @brief SV health; 0 means healthy. For an unknown (or mixed) satellite
+  ///        system, -1 is returned
+  int sv_health() const noexcept {
     switch (this->sys__) {
     case (SATELLITE_SYSTEM::glonass):
+    case (SATELLITE_SYSTEM::sbas):
       return static_cast<int>(data__[6]);
     case (SATELLITE_SYSTEM::gps):
     case (SATELLITE_SYSTEM::galileo):
     case (SATELLITE_SYSTEM::beidou):
-      return static_cast<int>(data__[24]);
-    case (SATELLITE_SYSTEM::sbas):
     case (SATELLITE_SYSTEM::qzss):
     case (SATELLITE_SYSTEM::irnss):
+      return static_cast<int>(data__[24]);
     case (SATELLITE_SYSTEM::mixed):
-      std::cerr << "\n[ERROR] NavDataFrame::sv_health() Cannot handle "
-                   "satellite system: "
-                << satsys_to_char(sys__);
-      throw std::runtime_error(
-          "ERROR] NavDataFrame::sv_clock() Cannot handle satellite system");
+      break;
     }
-    return 100;
+    return -1;
   }
 
-  long fit_interval() const {
+  /// @brief Fit interval (validity of the message) in seconds. For an unknown
+  ///        (or mixed) satellite system, 0 is returned
+  long fit_interval() const noexcept {
     switch (this->sys__) {
     case (SATELLITE_SYSTEM::glonass):
       return 15 * 60L;
@@ -102,17 +146,16 @@ public:
     case (SATELLITE_SYSTEM::galileo):
     case (SATELLITE_SYSTEM::beidou):
       return 4L * 60 * 60;
-    case (SATELLITE_SYSTEM::sbas):
     case (SATELLITE_SYSTEM::qzss):
+      return qzs_fit_interval();
     case (SATELLITE_SYSTEM::irnss):
+      return 2L * 60 * 60;
+    case (SATELLITE_SYSTEM::sbas):
+      return 6L * 60;
     case (SATELLITE_SYSTEM::mixed):
-      std::cerr << "\n[ERROR] NavDataFrame::fit_interval() Cannot handle "
-                   "satellite system: "
-                << satsys_to_char(sys__);
-      throw std::runtime_error(
-          "ERROR] NavDataFrame::fit_interval() Cannot handle satellite system");
+      break;
     }
-    return 100;
+    return 0;
   }
 
   /// @brief Reference t to the beggining of ToE (aka 00:00:00 of ToE)
@@ -142,61 +185,66 @@ public:
   }
 
   template <typename T>
-  int gps_stateNclock(ngpt::datetime<T> t, double *state, double &dt) const
-      noexcept {
-    int status = 0;
-    double t_sec = this->ref2toe<T>(t);
-    // if ((status=gps_ecef(t_sec, state))) return status;
-    if ((status = this->kepler2state<SATELLITE_SYSTEM::gps>(t_sec, state)))
-      return status;
-    t_sec = this->ref2toc<T>(t);
-    status = sv_clock<SATELLITE_SYSTEM::gps>(t_sec, dt);
-    // status=gps_dtsv(t_sec, dt);
-    return status;
+  int gps_stateNclock(ngpt::datetime<T> t, double *state, double &dt,
+                      double offset = 0e0) const noexcept {
+    return sys_stateNclock<SATELLITE_SYSTEM::gps>(t, state, dt, offset);
   }
 
   template <typename T>
-  int gal_stateNclock(ngpt::datetime<T> t, double *state, double &dt) const
-      noexcept {
-    int status = 0;
-    double t_sec = this->ref2toe<T>(t);
-    // if ((status=gal_ecef(t_sec, state))) return status;
-    if ((status = this->kepler2state<SATELLITE_SYSTEM::galileo>(t_sec, state)))
-      return status;
-    t_sec = this->ref2toc<T>(t);
-    status = sv_clock<SATELLITE_SYSTEM::galileo>(t_sec, dt);
-    // status=gal_dtsv(t_sec, dt);
-    return status;
+  int gal_stateNclock(ngpt::datetime<T> t, double *state, double &dt,
+                      double offset = 0e0) const noexcept {
+    return sys_stateNclock<SATELLITE_SYSTEM::galileo>(t, state, dt, offset);
   }
 
   template <typename T>
-  int bds_stateNclock(ngpt::datetime<T> t, double *state, double &dt) const
-      noexcept {
-    int status = 0;
-    double t_sec = this->ref2toe<T>(t);
-    // if ((status=bds_ecef(t_sec, state))) return status;
-    if ((status = this->kepler2state<SATELLITE_SYSTEM::beidou>(t_sec, state)))
-      return status;
-    t_sec = this->ref2toc<T>(t);
-    status = sv_clock<SATELLITE_SYSTEM::beidou>(t_sec, dt);
-    // status=bds_dtsv(t_sec, dt);
-    return status;
+  int bds_stateNclock(ngpt::datetime<T> t, double *state, double &dt,
+                      double offset = 0e0) const noexcept {
+    return sys_stateNclock<SATELLITE_SYSTEM::beidou>(t, state, dt, offset);
+  }
+
+  /// @brief Propagate the SBAS (GEO) state vector to epoch t
+  ///
+  /// The message holds the position, velocity and acceleration (ECEF, WGS84)
+  /// at ToC; the state is propagated as x = x0 + v0*dt + a*dt^2/2 and
+  /// v = v0 + a*dt, and the clock as aGf0 + aGf1*dt (as in the SBAS MOPS,
+  /// DO-229, A.4.4.11).
+  /// @param[in]  t      The epoch (GPS time)
+  /// @param[out] state  The SV state vector (position and velocity) in meters
+  ///                    and meters/sec
+  /// @param[out] dt     The SV clock correction in seconds
+  /// @param[in]  offset An offset in (fractional) seconds to add to t
+  /// @return Always 0
+  template <typename T>
+  int sbas_stateNclock(ngpt::datetime<T> t, double *state, double &dt,
+                       double offset = 0e0) const noexcept {
+    const double tk = this->ref2toc<T>(t) + offset -
+                      toc__.sec().to_fractional_seconds();
+    const double half_tk2 = 5e-1 * tk * tk;
+    for (int i = 0; i < 3; i++) {
+      const double *x = data__ + 3 + 4 * i;
+      state[i] = x[0] + x[1] * tk + x[2] * half_tk2;
+      state[i + 3] = x[1] + x[2] * tk;
+    }
+    dt = data__[0] + data__[1] * tk;
+    return 0;
   }
 
   /// @brief Compute SV centre of mass state vector in ECEF PZ90 frame at
   ///        epoch epoch using the simplified algorithm
   /// @param[in] epoch The time in UTC for which we want the SV state
   /// @param[out] The SV centre of mass state vector in meters, meters/sec
+  /// @return 0 on success, >0 on error; -1 if t is more than 15 min away from
+  ///         ToE (state and clock are still computed)
   template <typename T>
-  int glo_stateNclock(ngpt::datetime<T> t, double *state, double &dt) const
-      noexcept {
-    int status = 0;
-    double t_sec = this->ref2toe<T>(t);
-    if ((status = glo_ecef(t_sec, state)))
-      return status;
+  int glo_stateNclock(ngpt::datetime<T> t, double *state, double &dt,
+                      double offset = 0e0) const noexcept {
+    int status = 0, warning = 0;
+    double t_sec = this->ref2toe<T>(t) + offset;
+    if ((warning = glo_ecef(t_sec, state)) > 0)
+      return warning;
     if ((status = glo_clock(t_sec, dt)))
       return status;
-    return 0;
+    return warning;
   }
 
   double data(int idx) const noexcept { return data__[idx]; }
@@ -212,6 +260,9 @@ public:
 
   int &prn() noexcept { return prn__; }
 
+  /// @brief The (compact) satellite id of the message
+  SatId sat_id() const noexcept { return SatId(sys__, prn__); }
+
   ngpt::datetime<ngpt::seconds> toc() const noexcept { return toc__; }
 
   template <typename T, typename = std::enable_if_t<T::is_of_sec_type>>
@@ -226,8 +277,11 @@ public:
 
   void set_toc(ngpt::datetime<ngpt::seconds> d) noexcept { toc__ = d; }
 
+  void set_toe(ngpt::datetime<ngpt::seconds> d) noexcept { toe__ = d; }
+
   /* NEW FUNCTIONS */
   int gps_fit_interval() const noexcept;
+  int qzs_fit_interval() const noexcept;
   float gps_ura() const noexcept;
   float gal_sisa() const noexcept;
   int gal_iod_nav() const noexcept;
@@ -253,7 +307,8 @@ private:
   /// information, see the (now obsolete function gps_ecef, gal_ecef and
   /// bds_ecef).
   /// @tparam S            The satellite system of the NavDataFrame; only works
-  ///                      for systems: GPS, GALILEO and BeiDou
+  ///                      for systems: GPS, GALILEO, BeiDou, QZSS and IRNSS
+  ///                      (QZSS and IRNSS use the same layout)
   /// @param[in]  t_sec    Time (in seconds) from ToE in the same system as ToE
   /// @param[out] state    SV x,y,z -components of antenna phase center position
   ///                      in the ECEF coordinate system in meters; the
@@ -267,14 +322,12 @@ private:
   template <SATELLITE_SYSTEM S>
   int kepler2state(double t_sec, double *state, double *Ek_ptr = nullptr) const
       noexcept {
+    NGPT_TIME_SCOPE(kepler_state);
     int status = 0;
 
     constexpr double MI_SYS = ngpt::satellite_system_traits<S>::mi();
     constexpr double OMEGAE_SYS =
         ngpt::satellite_system_traits<S>::omegae_dot();
-    constexpr double LIMIT{1e-14};           //  Limit for solving (iteratively)
-                                             //+ the Kepler equation for the
-                                             //+ eccentricity anomaly
     const double A(data__[10] * data__[10]); //  Semi-major axis
     const double n0(
         std::sqrt(MI_SYS / (A * A * A))); //  Computed mean motion (rad/sec)
@@ -282,8 +335,8 @@ private:
     const double tk(t_sec - toe_sec);
 #ifdef DEBUG
     if (tk < -302400e0 || tk > 302400e0) {
-      std::cerr
-          << "\n[ERROR] NavDataFrame::kepler2state Delta-seconds are off! WTF?";
+      diagnostics::error(
+          "NavDataFrame::kepler2state Delta-seconds are off! WTF?");
       return -1;
     }
 #endif
@@ -291,23 +344,14 @@ private:
     const double Mk(data__[6] + n * tk); //  Mean anomaly
 
     // Solve (iteratively) Kepler's equation for Ek
-    double E(Mk);
-    double Ek(0e0);
+    double Ek, sinE, cosE;
     const double e(data__[8]);
-    int i;
-    for (i = 0; std::abs(E - Ek) > LIMIT && i < 1001; i++) {
-      Ek = E;
-      E = std::sin(Ek) * e + Mk;
-    }
-    if (i >= 1000)
+    if (ngpt::solve_kepler(Mk, e, Ek, sinE, cosE) < 0)
       return 1;
-    Ek = E;
 
     if (Ek_ptr)
       *Ek_ptr = Ek;
 
-    const double sinE(std::sin(E));
-    const double cosE(std::cos(E));
     const double ecosEm1(1e0 - e * cosE);
     const double vk_ar((std::sqrt(1e0 - e * e) * sinE) / ecosEm1);
     const double vk_pr((cosE - e) / ecosEm1);
@@ -373,6 +417,7 @@ private:
   /// more information, see the (now obsolete function gps_ecef, gal_ecef and
   /// bds_ecef).
   /// @tparam S         The satellite system of the NavDataFrame; only works
+  ///                   for systems: GPS, GALILEO, BeiDou, QZSS and IRNSS
   /// @param[in]  t_sec Time (in seconds) from ToC
   /// @param[out] dt_sv SV Clock Correction in seconds; satellite clock bias
   ///                   includes relativity correction without code bias (tgd or
@@ -389,14 +434,11 @@ private:
       noexcept {
     constexpr double MI_SYS = ngpt::satellite_system_traits<S>::mi();
     constexpr double F_CLOCK = ngpt::satellite_system_traits<S>::f_clock();
-    constexpr double LIMIT{1e-14}; //  Limit for solving (iteratively)
-                                   //+ the Kepler equation for the
-                                   //+ eccentricity anomaly
     double dt = t_sec - toc__.sec().to_fractional_seconds();
 #ifdef DEBUG
     if (dt < -302400e0 || dt > 302400e0) {
-      std::cerr
-          << "\n[ERROR] NavDataFrame::gps_dtsv Delta-seconds are off! WTF?";
+      diagnostics::error(
+          "NavDataFrame::gps_dtsv Delta-seconds are off! WTF?");
       return -1;
     }
     /*
@@ -413,16 +455,8 @@ private:
           std::sqrt(MI_SYS / (A * A * A))); //  Computed mean motion (rad/sec)
       double n(n0 + data__[5]);             //  Corrected mean motion
       double Mk(data__[6] + n * dt);        //  Mean anomaly
-      double E(Mk);
-      double e(data__[8]);
-      int i;
-      for (i = 0; std::abs(E - Ek) > LIMIT && i < 1001; i++) {
-        Ek = E;
-        E = std::sin(Ek) * e + Mk;
-      }
-      if (i >= 1000)
+      if (ngpt::solve_kepler(Mk, data__[8], Ek) < 0)
         return 1;
-      Ek = E;
     } else {
       Ek = *Ein;
     }
@@ -545,9 +579,9 @@ private:
       }*/
     } else {
       if (std::abs(test - (double)sd_toe) < 1e-15) {
-        std::cerr << "\n[WARNING] NavDataFrame::glo_toe2date() ToE not set "
-                     "correctly for unhealhty satellite: "
-                  << satsys_to_char(sys__) << prn__;
+        diagnostics::warning("NavDataFrame::glo_toe2date() ToE not set "
+                             "correctly for unhealhty satellite: %c%02d",
+                             satsys_to_char(sys__), prn__);
       }
     }
 #endif
@@ -572,6 +606,46 @@ private:
   */
 };
 
+/// @enum IONO_CORR_TYPE
+/// Types of broadcast ionospheric correction parameters, as recorded in the
+/// "IONOSPHERIC CORR" lines of a RINEX v3.x navigation header (e.g. "GPSA"
+/// holds the Klobuchar alpha coefficients, "GAL " the Galileo ai0-ai2).
+enum class IONO_CORR_TYPE : int {
+  gpsa,
+  gpsb,
+  gal,
+  qzsa,
+  qzsb,
+  bdsa,
+  bdsb,
+  irna,
+  irnb
+};
+
+/// Time system correction parameters, as recorded in a "TIME SYSTEM CORR"
+/// line of a RINEX v3.x navigation header; for a correction of type e.g.
+/// "GPUT", the correction is CORR(s) = a0 + a1 * DELTAT, where DELTAT is the
+/// difference from the reference epoch (t_ref, week).
+struct TimeSystemCorrection {
+  char type[5]{};   ///< Correction type, e.g. "GPUT", "GAGP" (null-terminated)
+  double a0{0e0};   ///< Constant term (seconds)
+  double a1{0e0};   ///< Linear term (seconds/second)
+  long t_ref{0};    ///< Reference time (seconds into week)
+  int week{0};      ///< Reference week number
+  char source[6]{}; ///< Augmentation system providing the correction (if any)
+  int utc_id{0};    ///< UTC identifier (0 if not known)
+};
+
+/// Leap seconds, as recorded in the "LEAP SECONDS" line of a RINEX v3.x
+/// navigation header.
+struct LeapSeconds {
+  int delta_ls{0};  ///< Current number of leap seconds
+  int delta_lsf{0}; ///< Future or past number of leap seconds (0 if n/a)
+  int wn_lsf{0};    ///< Week number of the future or past leap second
+  int dn{0};        ///< Day number of the future or past leap second
+  SATELLITE_SYSTEM sys{SATELLITE_SYSTEM::gps}; ///< Time system (GPS or BDS)
+};
+
 class NavigationRnx {
 public:
   /// Let's not write this more than once.
@@ -603,6 +677,29 @@ public:
   /// @brief Read, resolve and store next navigation data block
   int read_next_record(NavDataFrame &) noexcept;
 
+  /// @brief Read and resolve all navigation data blocks, decoding them in
+  ///        parallel
+  int read_all_records(std::vector<NavDataFrame> &frames,
+                       int num_threads = 0) noexcept;
+
+  /// @brief Get ionospheric correction parameters recorded in the header
+  int ionospheric_corr(IONO_CORR_TYPE type, double *params) const noexcept;
+
+  /// @brief All time system corrections recorded in the header
+  const std::vector<TimeSystemCorrection> &time_system_corr() const noexcept {
+    return __time_corr;
+  }
+
+  /// @brief Get a time system correction (given its type) from the header
+  int time_system_corr(const char *type, TimeSystemCorrection &corr) const
+      noexcept;
+
+  /// @brief True if the "LEAP SECONDS" record was found in the header
+  bool has_leap_seconds() const noexcept { return __has_leap_sec; }
+
+  /// @brief Leap seconds recorded in the header (see has_leap_seconds)
+  const LeapSeconds &leap_seconds() const noexcept { return __leap_sec; }
+
   /// @brief Check the first line of the following message to get the sat. sys
   ngpt::SATELLITE_SYSTEM peak_satsys(int &) noexcept;
 
@@ -704,12 +801,27 @@ private:
   /// @brief clear the instance stream and return the exit_status
   int clear_stream(int exit_status) noexcept;
 
+  /// @brief Resolve an "IONOSPHERIC CORR" (or v2.x "ION ALPHA/BETA") line
+  int resolve_iono_corr(const char *line, IONO_CORR_TYPE type, int start,
+                        int width, int num) noexcept;
+
+  /// @brief Resolve a "TIME SYSTEM CORR" (or v2.x "DELTA-UTC") line
+  int resolve_time_corr(const char *line) noexcept;
+
+  /// @brief Resolve a "LEAP SECONDS" line
+  int resolve_leap_seconds(const char *line) noexcept;
+
   std::string __filename;    ///< The name of the file
   std::ifstream __istream;   ///< The infput (file) stream
   SATELLITE_SYSTEM __satsys; ///< satellite system
   float __version;           ///< Rinex version (e.g. 3.4)
   pos_type __end_of_head;    ///< Mark the 'END OF HEADER' field
-};                           // NavigationRnx
+  double __iono_corr[9][4]{}; ///< Ionospheric correction parameters
+  unsigned __iono_flags{0};   ///< Bit i set if __iono_corr[i] is available
+  std::vector<TimeSystemCorrection> __time_corr; ///< Time system corrections
+  LeapSeconds __leap_sec;     ///< Leap seconds
+  bool __has_leap_sec{false}; ///< True if LEAP SECONDS record is available
+};                            // NavigationRnx
 
 } // namespace ngpt
 
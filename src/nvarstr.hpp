@@ -1,6 +1,8 @@
 #ifndef __NTUA_VARIOUS_STR_FUNCTIONS_HPP__
 #define __NTUA_VARIOUS_STR_FUNCTIONS_HPP__
 
+#include <cerrno>
+#include <cstdlib>
 #include <string>
 
 namespace ngpt {
@@ -117,6 +119,171 @@ inline bool __char2double__(const char *line, double *data, int N) noexcept {
   return errno ? false : true;
 }
 
+/// @details Resolve a double written in a fixed-width field via std::strtod,
+///          after replacing 'D' or 'd' with 'E'; the (fallback) slow path of
+///          __fixed2double__.
+/// @param[in]  str   Start of the field
+/// @param[in]  width Number of chars in the field (at most 63)
+/// @param[out] val   The resolved double
+/// @return  True if the field was resolved; false otherwise (errno is not
+///          changed)
+inline bool __strtod_field__(const char *str, int width, double &val) noexcept {
+  char buf[64];
+  int n = 0;
+  for (const char *c = str; c < str + width && n < 63; ++c, ++n)
+    buf[n] = (*c == 'D' || *c == 'd') ? 'E' : *c;
+  buf[n] = '\0';
+  char *end;
+  const int errno_in = errno;
+  errno = 0;
+  val = std::strtod(buf, &end);
+  const bool ok = (end != buf && errno != ERANGE);
+  errno = errno_in;
+  if (!ok)
+    return false;
+  while (*end == ' ')
+    ++end;
+  return *end == '\0';
+}
+
+/// @details Resolve a double written in a fixed-width field, in Fortran or C
+///          notation, i.e. the exponent may be marked by any of 'D', 'd', 'E'
+///          or 'e' (so there is no need to call __for2cpp__ first). Leading
+///          and trailing blanks are allowed; a blank field resolves to 0.
+///          Fields with up to 15 significant digits and a (decimal) scale
+///          within +/-22 are converted with a single (exact) floating point
+///          operation, which gives the same (correctly rounded) result as
+///          std::strtod; any other field falls back to std::strtod.
+/// @param[in]  str   Start of the field
+/// @param[in]  width Number of chars in the field (at most 63)
+/// @param[out] val   The resolved double
+/// @return  True if the field was resolved; false otherwise (errno is not
+///          changed)
+inline bool __fixed2double__(const char *str, int width, double &val) noexcept {
+  constexpr double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *c = str;
+  const char *e = str + width;
+  while (c < e && *c == ' ')
+    ++c;
+  if (c == e) {
+    val = 0e0;
+    return true;
+  }
+  bool neg = false;
+  if (*c == '-' || *c == '+')
+    neg = (*c++ == '-');
+  unsigned long long m = 0;
+  int digits = 0, scale = 0, ndig = 0;
+  for (; c < e && *c >= '0' && *c <= '9'; ++c, ++ndig) {
+    m = m * 10 + (*c - '0');
+    if (m)
+      ++digits;
+  }
+  if (c < e && *c == '.') {
+    for (++c; c < e && *c >= '0' && *c <= '9'; ++c, ++ndig) {
+      m = m * 10 + (*c - '0');
+      if (m)
+        ++digits;
+      --scale;
+    }
+  }
+  if (!ndig || digits > 18)
+    return __strtod_field__(str, width, val);
+  if (c < e && (*c == 'D' || *c == 'd' || *c == 'E' || *c == 'e')) {
+    ++c;
+    bool eneg = false;
+    if (c < e && (*c == '-' || *c == '+'))
+      eneg = (*c++ == '-');
+    if (c == e || *c < '0' || *c > '9')
+      return false;
+    int ex = 0;
+    for (; c < e && *c >= '0' && *c <= '9'; ++c)
+      if (ex < 10000)
+        ex = ex * 10 + (*c - '0');
+    scale += eneg ? -ex : ex;
+  }
+  for (const char *t = c; t < e; ++t)
+    if (*t != ' ')
+      return false;
+  if (!m) {
+    val = neg ? -0e0 : 0e0;
+    return true;
+  }
+  if (digits <= 15 && scale >= -22 && scale <= 22) {
+    val = (scale < 0) ? static_cast<double>(m) / pow10[-scale]
+                      : static_cast<double>(m) * pow10[scale];
+    if (neg)
+      val = -val;
+    return true;
+  }
+  return __strtod_field__(str, width, val);
+}
+
+/// @details Resolve an integer written in a fixed-width field. Leading and
+///          trailing blanks are allowed; a blank field resolves to 0.
+/// @param[in]  str   Start of the field
+/// @param[in]  width Number of chars in the field (at most 63)
+/// @param[out] val   The resolved integer
+/// @return  True if the field was resolved; false otherwise (errno is not
+///          changed)
+inline bool __fixed2long__(const char *str, int width, long &val) noexcept {
+  char buf[64];
+  int n = 0;
+  for (const char *c = str; c < str + width && n < 63; ++c, ++n)
+    buf[n] = *c;
+  buf[n] = '\0';
+  const char *c = buf;
+  while (*c == ' ')
+    ++c;
+  if (*c == '\0') {
+    val = 0;
+    return true;
+  }
+  char *end;
+  const int errno_in = errno;
+  errno = 0;
+  val = std::strtol(c, &end, 10);
+  const bool ok = (end != c && errno != ERANGE);
+  errno = errno_in;
+  if (!ok)
+    return false;
+  while (*end == ' ')
+    ++end;
+  return *end == '\0';
+}
+
+/// @details Resolve N doubles written in fixed-width fields of M chars (i.e.
+///          in the format N*DM.x as in RINEX 3.x) and assign them to
+///          data[0,N), via __fixed2double__. The fields are bounded by
+///          line_end (i.e. the end of the line); a field partially after
+///          line_end is cut there, a field starting at or after line_end
+///          resolves to 0 (as a blank field; trailing blanks are often
+///          trimmed).
+/// @param[in]  line     Start of the first field
+/// @param[in]  line_end End of the line (e.g. the position of the newline)
+/// @param[out] data     An array of (at least) N elements
+/// @param[in]  N        Number of fields
+/// @return  True if all numbers were resolved and assigned; false otherwise
+template <int M>
+inline bool __fixed2double__(const char *line, const char *line_end,
+                             double *data, int N) noexcept {
+  for (int i = 0; i < N; i++) {
+    if (line >= line_end) {
+      data[i] = 0e0;
+      line += M;
+      continue;
+    }
+    const int w =
+        (line_end - line < M) ? static_cast<int>(line_end - line) : M;
+    if (!__fixed2double__(line, w, data[i]))
+      return false;
+    line += M;
+  }
+  return true;
+}
+
 /// @brief Replace all occurancies of 'D' or 'd' with 'E' in given c-string.
 /// @param[in] line A c-string; the replacement will happen 'in-place' so at
 ///                 exit the string may be different.
@@ -1,7 +1,10 @@
 #include "obsrnx.hpp"
+#include "diagnostics.hpp"
 #include "ggdatetime/datetime_read.hpp"
+#include "instrument.hpp"
 #include "nvarstr.hpp"
 #include <algorithm>
+#include <cmath>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -21,6 +24,29 @@ constexpr int MAX_HEADER_LINES{1000};
 /// Max satellites in eopch
 constexpr int MAX_SAT_IN_EPOCH{80};
 
+/// Resolution of the epoch seconds field (F11.7) in RINEX v3.x, i.e. the
+/// number of ticks per second
+constexpr long EPOCH_TICKS_PER_SEC{10000000L};
+
+/// Size of a buffer holding an epoch line (RINEX v3.04: 56 chars, including
+/// the receiver clock offset), with the terminating null char and room for
+/// trailing blanks
+constexpr std::size_t max_epoch_line_chars{81};
+
+/// Resolve a right-justified integer field of n chars (leading blanks
+/// allowed) with no sign; returns -1 if the field is not such an integer
+inline int fixed_int(const char *str, int n) noexcept {
+  int i = 0, v = 0;
+  while (i < n - 1 && str[i] == ' ')
+    ++i;
+  for (; i < n; i++) {
+    if (str[i] < '0' || str[i] > '9')
+      return -1;
+    v = v * 10 + (str[i] - '0');
+  }
+  return v;
+}
+
 /// Size of 'END OF HEADER' C-string.
 /// std::strlen is not 'constexr' so eoh_size can't be one either. Note however
 /// that gcc has a builtin constexpr strlen function (if we want to disable this
@@ -88,8 +114,10 @@ ObservationRnx::ObservationRnx(const char *filename)
         "[ERROR] Failed to read (obs) RINEX header; Error Code: " +
         std::to_string(j));
   }
+  // large enough for a record line with all observables and for an epoch
+  // line with a receiver clock offset (56 chars)
   std::size_t maxobs = this->max_obs();
-  __buf_sz = maxobs * 16 + 4;
+  __buf_sz = std::max(maxobs * 16 + 4, max_epoch_line_chars);
   __buf = new char[__buf_sz];
 }
 
@@ -155,7 +183,6 @@ int ObservationRnx::max_obs() const noexcept {
 ///       SYS / PCVS APPLIED
 ///       SYS / SCALE FACTOR
 ///       SYS / PHASE SHIFT
-///       GLONASS SLOT / FRQ #
 ///       GLONASS COD/PHS/BIS
 ///       LEAP SECONDS
 ///       # OF SATELLITES
@@ -212,15 +239,15 @@ int ObservationRnx::read_header() noexcept {
     } else if (!std::strncmp(line + 60, "APPROX POSITION XYZ",
                              std::strlen("APPROX POSITION XYZ"))) {
       if (!ngpt::__char2double__<3, 14>(line, __approx)) {
-        std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to "
-                     "resolve field: \"APPROX POSITION XYZ\"";
+        ngpt::diagnostics::error("ObservationRnx::read_header() Failed to "
+                                 "resolve field: \"APPROX POSITION XYZ\"");
         return 51;
       }
     } else if (!std::strncmp(line + 60, "ANTENNA: DELTA H/E/N",
                              std::strlen("ANTENNA: DELTA H/E/N"))) {
       if (!ngpt::__char2double__<3, 14>(line, __eccentricity)) {
-        std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to "
-                     "resolve field: \"ANTENNA: DELTA H/E/N\"";
+        ngpt::diagnostics::error("ObservationRnx::read_header() Failed to "
+                                 "resolve field: \"ANTENNA: DELTA H/E/N\"");
         return 52;
       }
     } else if (!std::strncmp(line + 60, "SYS / # / OBS TYPES",
@@ -232,24 +259,32 @@ int ObservationRnx::read_header() noexcept {
       int i = std::strtol(line, &end, 10);
       if ((errno || (line + 3) == end) || (i != 0 && i != 1)) {
         errno = 0;
-        std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to "
-                     "resolve field: \"RCV CLOCK OFFS APPL\"";
-        std::cerr << "\n        Fatal while resolving the answer (integer)";
+        ngpt::diagnostics::error(
+            "ObservationRnx::read_header() Failed to resolve field: \"RCV "
+            "CLOCK OFFS APPL\""
+            "\n        Fatal while resolving the answer (integer)");
         return 60;
       }
       __rcv_clk_offs_applied = i;
       if (__rcv_clk_offs_applied) {
-        std::cout
-            << "\n[WARNING] Epoch, code, and phase are corrected by applying "
-            << "          the real-time-derived receiver clock offset"
-            << "\n        aka \"RCV CLOCK OFFS APPL\" is ON at RINEX";
+        ngpt::diagnostics::warning(
+            "Epoch, code, and phase are corrected by applying the "
+            "real-time-derived receiver clock offset"
+            "\n        aka \"RCV CLOCK OFFS APPL\" is ON at RINEX");
+      }
+    } else if (!std::strncmp(line + 60, "GLONASS SLOT / FRQ #",
+                             std::strlen("GLONASS SLOT / FRQ #"))) {
+      if (__glo_fdma.resolve_rnx_line(line)) {
+        ngpt::diagnostics::error("ObservationRnx::read_header() Failed to "
+                                 "resolve field: \"GLONASS SLOT / FRQ #\"");
+        return 62;
       }
     } else if (!std::strncmp(line + 60, "TIME OF FIRST OBS",
                              std::strlen("TIME OF FIRST OBS"))) {
       try {
         __epoch_start = ngpt::strptime_ymd_hms<ngpt::microseconds>(line);
       } catch (std::invalid_argument &e) {
-        std::cerr << "\n[ERROR] " << e.what();
+        ngpt::diagnostics::error("%s", e.what());
         return 61;
       }
     }
@@ -291,17 +326,19 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
   std::vector<ngpt::ObservationCode> obsvec;
   auto satsys = ngpt::char_to_satsys(line[0]);
   if (__obstmap.find(satsys) != __obstmap.end()) {
-    std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to resolve "
-                 "field: \"SYS / # / OBS TYPES\"";
-    std::cerr << "\n        Fatal Already resolved this satellite system!";
+    ngpt::diagnostics::error(
+        "ObservationRnx::read_header() Failed to resolve field: \"SYS / # / "
+        "OBS TYPES\""
+        "\n        Fatal Already resolved this satellite system!");
     return 1;
   }
   int obsnum = std::strtol(line + 3, &end, 10);
   if (errno || (line + 3) == end) {
     errno = 0;
-    std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to resolve "
-                 "field: \"SYS / # / OBS TYPES\"";
-    std::cerr << "\n        Fatal while interpreting Number of Obs Types";
+    ngpt::diagnostics::error(
+        "ObservationRnx::read_header() Failed to resolve field: \"SYS / # / "
+        "OBS TYPES\""
+        "\n        Fatal while interpreting Number of Obs Types");
     return 2;
   }
   // int lines_to_read = (obsnum-1)/13;
@@ -310,11 +347,11 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
     try {
       obsvec.emplace_back(line + 7 + resolved * 4);
     } catch (std::exception &e) {
-      std::cerr << e.what();
-      std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to resolve "
-                   "field: \"SYS / # / OBS TYPES\"";
-      std::cerr << "\n        Fatal while resolving type: \""
-                << (line + 6 + resolved * 3) << "\"";
+      ngpt::diagnostics::error(
+          "%s\n        ObservationRnx::read_header() Failed to resolve field: "
+          "\"SYS / # / OBS TYPES\""
+          "\n        Fatal while resolving type: \"%s\"",
+          e.what(), line + 6 + resolved * 3);
       return 3;
     }
     ++resolved;
@@ -323,11 +360,12 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
       __istream.getline(line, MAX_HEADER_CHARS);
       if (std::strncmp(line + 60, "SYS / # / OBS TYPES",
                        std::strlen("SYS / # / OBS TYPES"))) {
-        std::cerr << "\n[ERROR] ObservationRnx::read_header() Failed to "
-                     "resolve field: \"SYS / # / OBS TYPES\"";
-        std::cerr << "\n        Fatal; expected line \"SYS / # / OBS TYPES\" "
-                     "and got: "
-                  << "\n        \"" << (line + 60) << "\"";
+        ngpt::diagnostics::error(
+            "ObservationRnx::read_header() Failed to resolve field: \"SYS / "
+            "# / OBS TYPES\""
+            "\n        Fatal; expected line \"SYS / # / OBS TYPES\" and got: "
+            "\n        \"%s\"",
+            line + 60);
         return 4;
       }
       resolved = 0;
@@ -335,6 +373,17 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
   } while (vecsz < obsnum);
 
   if (obsvec.size() == (std::size_t)obsnum) {
+    try {
+      // codes that do not pack to a SignalId (e.g. an attribute not in A-Z)
+      // would all share the invalid id; leave them out of the index
+      for (std::size_t i = 0; i < obsvec.size(); i++) {
+        const SignalId sig(satsys, obsvec[i]);
+        if (sig.valid())
+          __obscols.emplace(sig, i);
+      }
+    } catch (std::exception &) {
+      return 10;
+    }
     __obstmap[satsys] = std::move(obsvec);
     return 0;
   }
@@ -342,14 +391,38 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
   return 9;
 }
 
+/// @brief Modified Julian Day of a calendar date
+///
+/// Consecutive epochs are (almost always) of the same day, so the last date
+/// resolved and its MJD are cached and the calendar conversion only happens
+/// when the date changes.
+ngpt::modified_julian_day ObservationRnx::__epoch_day__(int y, int m,
+                                                        int d) noexcept {
+  const long ymd = (y * 100L + m) * 100L + d;
+  if (ymd != __epoch_ymd) {
+#ifdef DEBUG
+    assert(ngpt::day_of_month(d).is_valid(ngpt::year(y), ngpt::month(m)));
+#endif
+    __epoch_mjd = ngpt::modified_julian_day(ngpt::year(y), ngpt::month(m),
+                                            ngpt::day_of_month(d));
+    __epoch_ymd = ymd;
+  }
+  return __epoch_mjd;
+}
+
 /// @brief Resolve an epoch header line for a RINEX v.3x files
 ///
+/// The line is expected in the fixed format of the RINEX v3.x specifications,
+/// aka "> YYYY MM DD hh mm ss.sssssss  fnnn"; the date and time fields are
+/// then resolved as integers. Lines that do not follow the format exactly
+/// (e.g. missing leading zeros) are resolved field by field via strtol/strtod.
+///
 /// @param[in] cline An EPOCH header line as described in RINEX v3.x
 ///                  specifications
 /// @param[out] mjd  The Modified Julian Day of the reference epoch (resolved
 ///                  from Year, Month and DayOfMonth)
-/// @param[out] sec  Seconds of day (to go with mjd), resolved from hours,
-///                  minuts and seconds fields
+/// @param[out] ticks Time of day (to go with mjd) in units of 1e-7 seconds,
+///                  resolved from hours, minuts and seconds fields
 /// @param[out] flag Epoch flag:
 ///                  * 0 -> OK
 ///                  * 1 -> power failure between previous and current epoch
@@ -360,75 +433,88 @@ int ObservationRnx::__resolve_obstypes_304__(const char *cline) noexcept {
 /// @warning error codes (at return) should be in range [0,10)
 int ObservationRnx::__resolve_epoch_304__(const char *cline,
                                           ngpt::modified_julian_day &mjd,
-                                          double &sec, int &flag, int &num_sats,
+                                          long &ticks, int &flag,
+                                          int &num_sats,
                                           double &rcvr_coff) noexcept {
-  using ngpt::day_of_month;
-  using ngpt::month;
-  using ngpt::year;
-
   std::size_t lnlen = std::strlen(cline);
 
   if (*cline != '>' || lnlen < 35) {
-    std::cerr << "\n[ERROR] ObservationRnx::__resolve_epoch_304__() Invalid "
-                 "epoch line";
-    std::cerr << "\n        Line was: \"" << cline << "\" length: " << lnlen;
+    ngpt::diagnostics::error("ObservationRnx::__resolve_epoch_304__() Invalid "
+                             "epoch line"
+                             "\n        Line was: \"%s\" length: %zu",
+                             cline, lnlen);
     return 1;
   }
 
-  // resolve the day as Modified Julian Day
   char *end;
-  const char *start = cline + 2;
   int dints[5];
-  for (int i = 0; i < 5; i++) {
-    dints[i] = static_cast<int>(std::strtol(start, &end, 10));
+  // fixed format: date/time fields at columns 2, 7, 10, 13, 16 and seconds
+  // as F11.7 at column 18
+  constexpr int dcols[] = {2, 7, 10, 13, 16};
+  constexpr int dwidths[] = {4, 2, 2, 2, 2};
+  bool fixed = (cline[21] == '.');
+  for (int i = 0; i < 5 && fixed; i++)
+    fixed = (cline[dcols[i] - 1] == ' ' &&
+             (dints[i] = fixed_int(cline + dcols[i], dwidths[i])) >= 0);
+  int isec, fsec = -1;
+  if (fixed && (isec = fixed_int(cline + 18, 3)) >= 0)
+    fsec = fixed_int(cline + 22, 7);
+
+  if (fsec >= 0) {
+    ticks = ((dints[3] * 60L + dints[4]) * 60L + isec) * EPOCH_TICKS_PER_SEC +
+            fsec;
+  } else {
+    // resolve the fields one by one
+    const char *start = cline + 2;
+    for (int i = 0; i < 5; i++) {
+      dints[i] = static_cast<int>(std::strtol(start, &end, 10));
+      if (errno || start == end) {
+        ngpt::diagnostics::error("ObservationRnx::__resolve_epoch_304__() "
+                                 "failed to resolve epoch"
+                                 "\n        Line was: \"%s\"",
+                                 cline);
+        errno = 0;
+        return 2;
+      }
+      start = ++end;
+    }
+    double rsec = std::strtod(start, &end);
     if (errno || start == end) {
-      std::cerr << "\n[ERROR] ObservationRnx::__resolve_epoch_304__() failed "
-                   "to resolve epoch";
-      std::cerr << "\n        Line was: \"" << cline << "\"";
+      ngpt::diagnostics::error("ObservationRnx::__resolve_epoch_304__() "
+                               "failed to resolve seconds"
+                               "\n        Line was: \"%s\"",
+                               cline);
       errno = 0;
-      return 2;
+      return 3;
     }
-    start = ++end;
+    ticks = (dints[3] * 60L + dints[4]) * 60L * EPOCH_TICKS_PER_SEC +
+            std::lround(rsec * EPOCH_TICKS_PER_SEC);
   }
-#ifdef DEBUG
-  day_of_month dom(dints[2]);
-  assert(dom.is_valid(year(dints[0]), month(dints[1])));
-#endif
-  mjd = ngpt::modified_julian_day(year(dints[0]), month(dints[1]),
-                                  day_of_month(dints[2]));
-
-  // resolve seconds of day
-  double rsec = std::strtod(start, &end);
-  if (errno || start == end) {
-    std::cerr << "\n[ERROR] ObservationRnx::__resolve_epoch_304__() failed to "
-                 "resolve seconds";
-    std::cerr << "\n        Line was: \"" << cline << "\"";
-    errno = 0;
-    return 3;
-  }
-  sec = (dints[3] * 60e0 + dints[4]) * 60e0 + rsec;
+
+  // resolve the day as Modified Julian Day
+  mjd = __epoch_day__(dints[0], dints[1], dints[2]);
 
   // resolve the epoch flag
   flag = cline[31] - '0';
 
   // resolve num of satellites in epoch
-  num_sats = static_cast<int>(std::strtol(cline + 32, &end, 10));
-  if (errno || start == end) {
-    std::cerr << "\n[ERROR] ObservationRnx::__resolve_epoch_304__() failed to "
-                 "resolve num sats";
-    std::cerr << "\n        Line was: \"" << cline << "\"";
-    errno = 0;
+  if ((num_sats = fixed_int(cline + 32, 3)) < 0) {
+    ngpt::diagnostics::error("ObservationRnx::__resolve_epoch_304__() "
+                             "failed to resolve num sats"
+                             "\n        Line was: \"%s\"",
+                             cline);
     return 4;
   }
 
   // resolve clock offset if any
-  if (lnlen > 41) {
-    rcvr_coff =
-        string_is_empty(cline + 41) ? 0e0 : std::strtod(cline + 41, &end);
-    if (errno || start == end) {
-      std::cerr << "\n[ERROR] ObservationRnx::__resolve_epoch_304__() failed "
-                   "to resolve receiver clock offset";
-      std::cerr << "\n        Line was: \"" << cline << "\"";
+  rcvr_coff = 0e0;
+  if (lnlen > 41 && !string_is_empty(cline + 41)) {
+    rcvr_coff = std::strtod(cline + 41, &end);
+    if (errno || end == cline + 41) {
+      ngpt::diagnostics::error("ObservationRnx::__resolve_epoch_304__() "
+                               "failed to resolve receiver clock offset"
+                               "\n        Line was: \"%s\"",
+                               cline);
       errno = 0;
       return 5;
     }
@@ -600,9 +686,9 @@ ObservationRnx::set_read_map(
       auto newvec = this->obs_getter(*i, s, status);
       // inapropriate sat sys or status>0
       if (s != inobs.first || status > 0) {
-        std::cerr << "\n[ERROR] ObservationRnx::set_read_map() Failed to set "
-                     "getter for"
-                  << " observable: " << i->to_string();
+        ngpt::diagnostics::error("ObservationRnx::set_read_map() Failed to "
+                                 "set getter for observable: %s",
+                                 i->to_string().c_str());
         return ResultType{};
       }
       // status is ok; add vector
@@ -619,15 +705,18 @@ ObservationRnx::set_read_map(
         // from the input map; otherwise the order of the input and output maps
         // will not be correct!
       } else {
-        std::cerr << "\n[WARNING] ObservationRnx::set_read_map() Cannot handle "
-                     "Observable:"
-                  << i->to_string();
         if (skip_missing) {
-          std::cerr << "\n          Missing either Satellite System or "
-                       "Observation Type(s)";
-          std::cerr << "\n          Observable will be ignored!";
+          ngpt::diagnostics::warning(
+              "ObservationRnx::set_read_map() Cannot handle Observable:%s"
+              "\n          Missing either Satellite System or Observation "
+              "Type(s)"
+              "\n          Observable will be ignored!",
+              i->to_string().c_str());
           i = inobs.second.erase(i);
         } else {
+          ngpt::diagnostics::warning(
+              "ObservationRnx::set_read_map() Cannot handle Observable:%s",
+              i->to_string().c_str());
           return ResultType{};
         }
       }
@@ -675,7 +764,8 @@ ObservationRnx::set_read_map(
 /// @param[in]  obs  The GnssObservable to get info for
 /// @param[out] sys  The satellite system of the observable
 /// @param[out] status The return status as follows:
-///                  -2 : Observable does not exist in RINEX file
+///                  -2 : Observable does not exist in RINEX file, or
+///                       its code cannot be packed to a SignalId
 ///                  -1 : Satellite system (of observable) does not exist in
 ///                  RINEX
 ///                   0 : all ok
@@ -687,41 +777,42 @@ ObservationRnx::obs_getter(const GnssObservable &obs, SATELLITE_SYSTEM &sys,
   status = 0;
   // result vector
   vecof_idpair ovec;
-  // the GnssObservable underlying vector
-  auto vec = obs.underlying_vector();
+  // the GnssObservable terms (a view, not a copy)
+  const auto vec = obs.underlying_vector();
   sys = vec[0].type().satsys();
-  // vector of ObservationCodes for given sat. sys. in this RINEX
-  auto it = __obstmap.find(sys);
-  if (it == __obstmap.end()) {
-    std::cerr << "\n[WARNING] ObservationRnx::obs_getter() Rinex file does not "
-                 "contain obsrvations for satellite system: "
-              << satsys_to_char(sys);
+  // the sat. sys. must be in this RINEX
+  if (__obstmap.find(sys) == __obstmap.end()) {
+    ngpt::diagnostics::warning(
+        "ObservationRnx::obs_getter() Rinex file does not contain obsrvations "
+        "for satellite system: %c",
+        satsys_to_char(sys));
     status = -1;
     return vecof_idpair{};
   }
-  const std::vector<ObservationCode> &satsys_codes = it->second;
-  // ok, now: satsys_codes is the std::vector<ObservationCode> of the relevant
-  // satsys; remember i is __ObsPart
+  ovec.reserve(vec.size());
+  // remember i is __ObsPart
   for (const auto &i : vec) {
     if (i.type().satsys() != sys) {
-      std::cerr << "\n[ERROR] ObservationRnx::obs_getter() Cannot handle mixed "
-                   "Satellite System observables";
-      std::cerr << "\n        Problem with GnssObservable: " << obs.to_string();
+      ngpt::diagnostics::error(
+          "ObservationRnx::obs_getter() Cannot handle mixed Satellite System "
+          "observables"
+          "\n        Problem with GnssObservable: %s",
+          obs.to_string().c_str());
       status = 1;
       return vecof_idpair{};
     }
-    // for every __ObsPart in correlate an ObservationCode
-    auto j =
-        std::find(satsys_codes.begin(), satsys_codes.end(), i.type().code());
-    if (j == satsys_codes.end()) {
-      std::cerr << "\n[WARNING] Cannot find observable in RINEX ("
-                << i.type().code().to_string() << ")";
+    // for every __ObsPart in correlate a column (via its SignalId); codes
+    // without a (valid) SignalId are not indexed
+    const SignalId sig(sys, i.type().code());
+    auto j = sig.valid() ? __obscols.find(sig) : __obscols.end();
+    if (j == __obscols.end()) {
+      ngpt::diagnostics::warning("Cannot find observable in RINEX (%s)",
+                                 i.type().code().to_string().c_str());
       status = -2;
       return vecof_idpair{};
     }
-    std::size_t idx = std::distance(satsys_codes.begin(), j);
     double coef = i.__coef;
-    ovec.emplace_back(idx, coef);
+    ovec.emplace_back(j->second, coef);
   }
   return ovec;
 }
@@ -820,7 +911,7 @@ int ObservationRnx::sat_epoch_collect(const std::vector<vecof_idpair> &sysobs,
 ///                     with elements one vector per GnssObservation, containing
 ///                     pairs of (col.index, factor).
 /// @param[out] satobs  The collected results; that is a vector of pairs of
-///                     type <Satellite, vector<double>> where for each
+///                     type <SatId, vector<double>> where for each
 ///                     satellite we have the observation values in one-to-one
 ///                     correspondance (in the same order) as in the
 ///                     mmap[SATSYS] vector. The elements in range [0,
@@ -839,13 +930,13 @@ int ObservationRnx::sat_epoch_collect(const std::vector<vecof_idpair> &sysobs,
 int ObservationRnx::collect_epoch(
     int numsats, int &satscollected,
     std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
-    std::vector<std::pair<ngpt::Satellite, std::vector<double>>>
+    std::vector<std::pair<ngpt::SatId, std::vector<double>>>
         &satobs) noexcept {
   typedef
       typename std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>>::iterator
           mmap_it;
   using OutputVecIt =
-      std::vector<std::pair<ngpt::Satellite, std::vector<double>>>::iterator;
+      std::vector<std::pair<ngpt::SatId, std::vector<double>>>::iterator;
 
   satscollected = 0;
 #ifdef DEBUG
@@ -862,9 +953,10 @@ int ObservationRnx::collect_epoch(
     try {
       s = char_to_satsys(*__buf);
     } catch (std::exception &e) {
-      std::cerr << "\n[ERROR] ObservationRnx::collect_epoch() Failed to "
-                   "resolve Satellite System";
-      std::cerr << "\n        Line was: \"" << __buf << "\"";
+      ngpt::diagnostics::error("ObservationRnx::collect_epoch() Failed to "
+                               "resolve Satellite System"
+                               "\n        Line was: \"%s\"",
+                               __buf);
       return 1;
     }
 
@@ -872,12 +964,13 @@ int ObservationRnx::collect_epoch(
     int status = 0;
     mmap_it it = mmap.end();
     if ((it = mmap.find(s)) != mmap.end()) {
-      if ((status = sat_epoch_collect(mmap[s], prn, ovec_it->second)) > 0)
+      if ((status = sat_epoch_collect(it->second, prn, ovec_it->second)) > 0)
         return 1;
-      Satellite sat(s, prn);
-      ovec_it->first = sat;
+      ovec_it->first = SatId(s, prn);
       ++ovec_it;
       ++satscollected;
+    } else {
+      NGPT_COUNT(sat_lines_skipped);
     }
     ++sat_it;
   }
@@ -898,7 +991,7 @@ int ObservationRnx::collect_epoch(
 /// result in the output vector satobs; So, satobs will have REAL size equal to
 /// the number of satellites read and resolved (which can obviously be smaller
 /// that number of satellites in epoch). Each entry will be a pair of
-/// <Satellite, vector<double>>, where the second element is actually the
+/// <SatId, vector<double>>, where the second element is actually the
 /// GnssObservables collected; this internal vector will have REAL size equal to
 /// the element of the corresponding sat. system in the input map. That is if
 /// satobs[i]=<G01, {20.e0, 21,e0 ,....}> the REAL size of the vector is equal
@@ -913,13 +1006,16 @@ int ObservationRnx::collect_epoch(
 /// vector
 ///                     with elements one vector per GnssObservation, containing
 ///                     pairs of (col.index, factor).
-/// @param[out] satobs  Vector of results; aka pairs of Satellite and
+/// @param[out] satobs  Vector of results; aka pairs of SatId and
 /// vector<double>
 ///                     holding the observable values for each of the input
 ///                     GnssObservables (as in mmap[satsys]). Only use the
 ///                     values in range [0, sats). To create this vector, see
 ///                     ObservationRnx::initialize_epoch_vector()
 /// @param[out] sats    Actual number of satellites written in satobs vector
+/// @param[out] mjd     Modified Julian Day of the epoch
+/// @param[out] ticks   Time of day of the epoch, in units of 1e-7 seconds (the
+///                     resolution of the RINEX epoch field)
 /// @return An integer as:
 ///                     * -1 : EOF encountered
 ///                     *  0 : All ok
@@ -929,10 +1025,11 @@ int ObservationRnx::collect_epoch(
 ///      * Please use the function ObservationRnx::initialize_epoch_vector to
 ///        initialize a long enough output vector to pass in this function (as
 ///        satobs). If this vector is not long enough it can cause problems.
-int ObservationRnx::read_next_epoch(
+int ObservationRnx::__read_next_epoch__(
     std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
-    std::vector<std::pair<ngpt::Satellite, std::vector<double>>> &satobs,
-    int &sats, ngpt::modified_julian_day &mjd, double &secofday) noexcept {
+    std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
+    int &sats, ngpt::modified_julian_day &mjd, long &ticks) noexcept {
+  NGPT_TIME_SCOPE(obs_epoch);
   int c, j;
   sats = 0;
   if ((c = __istream.peek()) != EOF) {
@@ -941,12 +1038,13 @@ int ObservationRnx::read_next_epoch(
     double rcvr_coff;
     int flag, num_sats;
     // resolve epoch header
-    if ((j = __resolve_epoch_304__(__buf, mjd, secofday, flag, num_sats,
+    if ((j = __resolve_epoch_304__(__buf, mjd, ticks, flag, num_sats,
                                    rcvr_coff)))
       return 20 + j;
     // resolve observation block
     if ((j = collect_epoch(num_sats, sats, mmap, satobs)))
       return 30 + j;
+    NGPT_COUNT(epochs_parsed);
   }
   if (__istream.eof()) {
     __istream.clear();
@@ -955,13 +1053,48 @@ int ObservationRnx::read_next_epoch(
   return 0;
 }
 
+/// Read the next epoch; the epoch is returned as MJD and seconds of day.
+/// @see ObservationRnx::__read_next_epoch__
+int ObservationRnx::read_next_epoch(
+    std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
+    std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
+    int &sats, ngpt::modified_julian_day &mjd, double &secofday) noexcept {
+  long ticks = 0;
+  const int status = __read_next_epoch__(mmap, satobs, sats, mjd, ticks);
+  secofday = static_cast<double>(ticks) / EPOCH_TICKS_PER_SEC;
+  return status;
+}
+
+/// Read the next epoch; the epoch is returned as a datetime, rounded to the
+/// nearest microsecond (exact for any sampling rate up to 1 MHz).
+/// @see ObservationRnx::__read_next_epoch__
+int ObservationRnx::read_next_epoch(
+    std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
+    std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
+    int &sats, ngpt::datetime<ngpt::microseconds> &t) noexcept {
+  constexpr long ticks_per_usec{EPOCH_TICKS_PER_SEC / 1000000L};
+  constexpr long usec_per_day{86400L * 1000000L};
+  ngpt::modified_julian_day mjd;
+  long ticks = 0;
+  const int status = __read_next_epoch__(mmap, satobs, sats, mjd, ticks);
+  if (!status) {
+    long usec = (ticks + ticks_per_usec / 2) / ticks_per_usec;
+    if (usec >= usec_per_day) {
+      usec -= usec_per_day;
+      mjd = ngpt::modified_julian_day(mjd.as_underlying_type() + 1);
+    }
+    t = ngpt::datetime<ngpt::microseconds>(mjd, ngpt::microseconds(usec));
+  }
+  return status;
+}
+
 /// This function will return a vector with a big enough size to read all epochs
 /// in the RINEX file. Before start reading epochs in a RINEX, call this
 /// function with the input map that will be used for reading, and get the
 /// output vector to then use in the function ObservationRnx::read_next_epoch()
 /// @param[in] mmap  The map to use for reading this instance
 /// @return a vector that can hold any epoch's satellite records.
-std::vector<std::pair<ngpt::Satellite, std::vector<double>>>
+std::vector<std::pair<ngpt::SatId, std::vector<double>>>
 ObservationRnx::initialize_epoch_vector(
     std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap) const
     noexcept {
@@ -969,9 +1102,9 @@ ObservationRnx::initialize_epoch_vector(
   for (const auto &it : mmap)
     if ((tmp = it.second.size()) > max_obs)
       max_obs = tmp;
-  std::pair<Satellite, std::vector<double>> emptyp{
-      Satellite(), std::vector<double>(max_obs, RNXOBS_MISSING_VAL)};
-  std::vector<std::pair<ngpt::Satellite, std::vector<double>>> vec(
+  std::pair<SatId, std::vector<double>> emptyp{
+      SatId(), std::vector<double>(max_obs, RNXOBS_MISSING_VAL)};
+  std::vector<std::pair<ngpt::SatId, std::vector<double>>> vec(
       MAX_SAT_IN_EPOCH, emptyp);
   return vec;
 }
@@ -3,11 +3,14 @@
 
 #include "antenna.hpp"
 #include "ggdatetime/dtcalendar.hpp"
+#include "glofdma.hpp"
 #include "gnssobsrv.hpp"
 #include "satellite.hpp"
+#include "satid.hpp"
 #include "satsys.hpp"
 #include <fstream>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #ifdef DEBUG
 #include "ggdatetime/datetime_write.hpp"
@@ -70,6 +73,12 @@ public:
   /// @brief get TIME OF FIRST OBS
   auto time_of_first_obs() const noexcept { return __epoch_start; }
 
+  /// @brief GLONASS frequency channels as recorded in the header field
+  ///        "GLONASS SLOT / FRQ #" (empty if the field is missing)
+  const GlonassFdmaTable &glonass_fdma_table() const noexcept {
+    return __glo_fdma;
+  }
+
 #ifdef DEBUG
   void print_members() const noexcept {
     std::cout << "\nfilename     :" << __filename
@@ -101,12 +110,19 @@ public:
   /// @brief Collect all satellite observation for next epoch based on input map
   int read_next_epoch(
       std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
-      std::vector<std::pair<ngpt::Satellite, std::vector<double>>> &satobs,
+      std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
       int &sats, ngpt::modified_julian_day &mjd, double &secofday) noexcept;
 
+  /// @brief Collect all satellite observation for next epoch based on input
+  ///        map; the epoch is returned as a datetime (microsecond resolution)
+  int read_next_epoch(
+      std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
+      std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
+      int &sats, ngpt::datetime<ngpt::microseconds> &t) noexcept;
+
   /// @brief Initialize a big enough vector to hold any epoch in current
   /// instance
-  std::vector<std::pair<ngpt::Satellite, std::vector<double>>>
+  std::vector<std::pair<ngpt::SatId, std::vector<double>>>
   initialize_epoch_vector(
       std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap) const
       noexcept;
@@ -117,9 +133,18 @@ private:
 
   /// @brief Resolve an epoch header line for a RINEX v.3x files
   int __resolve_epoch_304__(const char *cline, ngpt::modified_julian_day &mjd,
-                            double &sec, int &flag, int &num_sats,
+                            long &ticks, int &flag, int &num_sats,
                             double &rcvr_coff) noexcept;
 
+  /// @brief Modified Julian Day of a calendar date (memoized)
+  ngpt::modified_julian_day __epoch_day__(int y, int m, int d) noexcept;
+
+  /// @brief Read the next epoch; time of day is returned in ticks (1e-7 sec)
+  int __read_next_epoch__(
+      std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
+      std::vector<std::pair<ngpt::SatId, std::vector<double>>> &satobs,
+      int &sats, ngpt::modified_julian_day &mjd, long &ticks) noexcept;
+
   /// @brief Collect values (actually GnssObservable values) from a satellite
   ///        record line
   int sat_epoch_collect(const std::vector<vecof_idpair> &sysobs, int &prn,
@@ -128,7 +153,7 @@ private:
   /// @brief Collect
   int collect_epoch(int numsats, int &satscollected,
                     std::map<SATELLITE_SYSTEM, std::vector<vecof_idpair>> &mmap,
-                    std::vector<std::pair<ngpt::Satellite, std::vector<double>>>
+                    std::vector<std::pair<ngpt::SatId, std::vector<double>>>
                         &satobs) noexcept;
 
   /// @brief Resolve line(s) of type "SYS / # / OBS TYPES" as RINEX v3.04
@@ -166,12 +191,21 @@ private:
   ///< descriptors (Type, Band, Attribute)
   ngpt::datetime<ngpt::microseconds> __epoch_start; ///< time of first obs
   std::map<SATELLITE_SYSTEM, std::vector<ObservationCode>> __obstmap;
+  ///< Column (index in the records of its satellite system) of every
+  ///< signal in __obstmap with a valid SignalId
+  std::unordered_map<SignalId, std::size_t> __obscols;
+  ///< GLONASS slot/frequency channel table from the header
+  GlonassFdmaTable __glo_fdma;
   ///< A char buffer which can hold an observation line
-  ///< with maximum number of observables
+  ///< with maximum number of observables, or an epoch line
   char *__buf{nullptr};
   ///< Length of __buf, aka length of maximum observation
-  ///< line in file (this->max_obs()*16+4)
+  ///< line in file (this->max_obs()*16+4), at least 81
   std::size_t __buf_sz{0};
+  ///< Last date (as YYYYMMDD) resolved off from an epoch header and its
+  ///< Modified Julian Day; the date only changes once per day
+  long __epoch_ymd{-1};
+  ngpt::modified_julian_day __epoch_mjd{};
 
 }; // ObservationRnx
 
@@ -0,0 +1,139 @@
+#include "orbit_cache.hpp"
+#include <cmath>
+#include <stdexcept>
+
+using ngpt::OrbitGridCache;
+using ngpt::SATELLITE_SYSTEM;
+
+namespace {
+/// Earth's gravitational constant (m^3/sec^2) used for the acceleration of
+/// the Taylor step; the differences between systems are negligible here
+constexpr double gm_earth{3.986004418e14};
+} // namespace
+
+/// @details All slots (and their satellite records) are allocated here; no
+///          allocation happens afterwards.
+/// @throw   std::runtime_error if num_slots is less than 1
+OrbitGridCache::OrbitGridCache(int num_slots)
+    : slots_(nullptr), num_slots_(num_slots) {
+  if (num_slots_ < 1)
+    throw std::runtime_error("[ERROR] OrbitGridCache::OrbitGridCache() "
+                             "Invalid number of epoch slots");
+  slots_.reset(new EpochSlot[num_slots_]);
+  for (int i = 0; i < num_slots_; i++)
+    slots_[i].sats.resize(max_sats);
+}
+
+/// The slot is marked as being written before waiting for its readers; a
+/// reader pins a slot before checking its state, so (with sequentially
+/// consistent ordering on both sides) either the reader sees the slot as
+/// being written and backs off, or the writer waits for the reader to unpin.
+int OrbitGridCache::begin_epoch(const epoch_type &t) noexcept {
+  const int slot = next_;
+  next_ = (next_ + 1) % num_slots_;
+  EpochSlot &s = slots_[slot];
+  s.state.store(SlotState::writing);
+  while (s.readers.load())
+    std::this_thread::yield();
+  s.epoch = t;
+  for (auto &r : s.sats)
+    r.valid = false;
+  return slot;
+}
+
+int OrbitGridCache::set(int slot, SATELLITE_SYSTEM sys, int prn,
+                        const double *state, double clock) noexcept {
+  const int idx = index(sys, prn);
+  if (idx < 0)
+    return 1;
+  SatRecord &r = slots_[slot].sats[idx];
+  for (int i = 0; i < 6; i++)
+    r.state[i] = state[i];
+  r.clock = clock;
+  r.valid = true;
+  return 0;
+}
+
+void OrbitGridCache::publish(int slot) noexcept {
+  slots_[slot].state.store(SlotState::published);
+}
+
+/// Search the slots for a published epoch equal to t and pin it.
+OrbitGridCache::EpochView OrbitGridCache::view(const epoch_type &t) const
+    noexcept {
+  for (int i = 0; i < num_slots_; i++) {
+    EpochSlot &s = slots_[i];
+    s.readers.fetch_add(1);
+    if (s.state.load() == SlotState::published && s.epoch == t)
+      return EpochView(&s);
+    s.readers.fetch_sub(1, std::memory_order_release);
+  }
+  return EpochView(nullptr);
+}
+
+int OrbitGridCache::EpochView::state(SATELLITE_SYSTEM sys, int prn,
+                                     double *state, double &clock) const
+    noexcept {
+  const int idx = index(sys, prn);
+  if (idx < 0 || !slot_->sats[idx].valid)
+    return -1;
+  const SatRecord &r = slot_->sats[idx];
+  for (int i = 0; i < 6; i++)
+    state[i] = r.state[i];
+  clock = r.clock;
+  return 0;
+}
+
+/// The acceleration used for the step is the one of the two-body problem
+/// expressed in the (rotating) ECEF frame, i.e. including the Coriolis and
+/// centrifugal terms. For a GNSS satellite and tau ~ 0.07 sec, the error of
+/// the step is well below a millimeter. The clock correction is not
+/// propagated (its change within tau is below 1e-12 sec for usual drifts).
+int OrbitGridCache::EpochView::state(SATELLITE_SYSTEM sys, int prn,
+                                     double tau, double *state,
+                                     double &clock) const noexcept {
+  const int idx = index(sys, prn);
+  if (idx < 0 || !slot_->sats[idx].valid)
+    return -1;
+  const SatRecord &r = slot_->sats[idx];
+  const double *x = r.state;
+  const double *v = r.state + 3;
+  const double w = geometry::omega_earth;
+  const double r2 = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+  const double gm_r3 = gm_earth / (r2 * std::sqrt(r2));
+  double a[3];
+  a[0] = -gm_r3 * x[0] + w * w * x[0] + 2e0 * w * v[1];
+  a[1] = -gm_r3 * x[1] + w * w * x[1] - 2e0 * w * v[0];
+  a[2] = -gm_r3 * x[2];
+  const double h = -tau;
+  for (int i = 0; i < 3; i++) {
+    state[i] = x[i] + h * (v[i] + 0.5e0 * h * a[i]);
+    state[i + 3] = v[i] + h * a[i];
+  }
+  clock = r.clock;
+  return 0;
+}
+
+/// The light-time iteration is the one of StationGeometry::transmit_state,
+/// but each iteration is a Taylor step from the cached state instead of an
+/// orbit evaluation.
+int OrbitGridCache::EpochView::transmit_state(SATELLITE_SYSTEM sys, int prn,
+                                              const StationGeometry &sta,
+                                              double *state, double &clock,
+                                              double &tau) const noexcept {
+  double sv[6];
+  double tau_new;
+  tau = geometry::nominal_light_time;
+  for (int i = 0; i < geometry::max_light_time_iterations; i++) {
+    if (this->state(sys, prn, tau, sv, clock))
+      return -1;
+    sagnac_rotate(sv, tau, state, 6);
+    tau_new = sta.range(state) / geometry::speed_of_light;
+    if (std::abs(tau_new - tau) < geometry::light_time_tolerance) {
+      tau = tau_new;
+      return 0;
+    }
+    tau = tau_new;
+  }
+  return 1;
+}
@@ -0,0 +1,184 @@
+#ifndef __GNSS_ORBIT_CACHE_HPP__
+#define __GNSS_ORBIT_CACHE_HPP__
+
+/// @file     orbit_cache.hpp
+///
+/// @brief    A station-independent cache of satellite states and clock
+///           corrections on an epoch grid, to be shared among (many)
+///           station workers.
+///
+/// @details  One (writer) thread fills the cache once per epoch, i.e.
+///           computes the state vector (position and velocity) and clock
+///           correction of every satellite at the epoch (aka the signal
+///           reception time). Any number of (reader) threads can then read
+///           these values concurrently; the signal transmission time for a
+///           given station is accounted for by a Taylor step from the cached
+///           position, velocity and (ECEF) acceleration, followed by the
+///           Earth rotation correction. Hence, for a network of stations
+///           sharing the same epoch grid, orbits are evaluated once per
+///           satellite (and not once per station and satellite).
+///
+///           The cache holds a ring of epoch slots; the writer may fill
+///           epochs ahead of the readers, as long as there is a free slot. A
+///           slot is only reused when no reader has it pinned (see EpochView).
+
+#include "geometry.hpp"
+#include "ggdatetime/dtcalendar.hpp"
+#include "satid.hpp"
+#include "satsys.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ngpt {
+
+/// @class OrbitGridCache
+/// Satellite states and clock corrections per (satellite, epoch).
+class OrbitGridCache {
+public:
+  /// Max PRN per satellite system
+  static constexpr int max_prn{SatId::max_prn};
+  /// Number of satellite systems (excluding mixed)
+  static constexpr int num_systems{SatId::num_systems};
+  /// Max number of satellites in the cache
+  static constexpr int max_sats{SatId::max_sats};
+
+  /// Type of epochs (aka keys of the epoch slots)
+  using epoch_type = ngpt::datetime<ngpt::microseconds>;
+
+private:
+  /// State of an epoch slot
+  enum class SlotState : int { empty, writing, published };
+
+  /// Cached values for one satellite
+  struct SatRecord {
+    double state[6]; ///< Position (m) and velocity (m/sec), ECEF
+    double clock;    ///< Clock correction (sec)
+    bool valid;      ///< True if the record is set for this epoch
+  };
+
+  /// An epoch slot
+  struct EpochSlot {
+    std::atomic<SlotState> state{SlotState::empty};
+    std::atomic<int> readers{0};
+    epoch_type epoch;
+    std::vector<SatRecord> sats;
+  };
+
+public:
+  /// @class EpochView
+  /// A (reader's) view of one cached epoch; the epoch slot is pinned (aka
+  /// it will not be overwritten) for the lifetime of the view.
+  class EpochView {
+  public:
+    /// @brief Copy not allowed !
+    EpochView(const EpochView &) = delete;
+    /// @brief Assignment not allowed !
+    EpochView &operator=(const EpochView &) = delete;
+    /// @brief Move constructor
+    EpochView(EpochView &&o) noexcept : slot_(o.slot_) { o.slot_ = nullptr; }
+    /// @brief Destructor; unpin the slot
+    ~EpochView() noexcept {
+      if (slot_)
+        slot_->readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// @brief False if the requested epoch is not (yet) in the cache
+    explicit operator bool() const noexcept { return slot_ != nullptr; }
+
+    /// @brief State vector and clock correction at the epoch
+    /// @return 0 on success, -1 if the satellite is not in the cache
+    int state(SATELLITE_SYSTEM sys, int prn, double *state,
+              double &clock) const noexcept;
+
+    /// @brief State vector and clock correction at epoch - tau, computed via
+    ///        a (second order) Taylor step from the epoch
+    /// @return 0 on success, -1 if the satellite is not in the cache
+    int state(SATELLITE_SYSTEM sys, int prn, double tau, double *state,
+              double &clock) const noexcept;
+
+    /// @brief State vector (in the ECEF frame at reception) and clock
+    ///        correction at signal transmission time, for a given station
+    /// @param[in]  sys   Satellite system
+    /// @param[in]  prn   Satellite PRN
+    /// @param[in]  sta   The station
+    /// @param[out] state Sagnac-corrected state vector (6 elements)
+    /// @param[out] clock Clock correction (sec)
+    /// @param[out] tau   Signal travel time (sec)
+    /// @return 0 on success, -1 if the satellite is not in the cache, 1 if
+    ///         the light-time iteration did not converge
+    int transmit_state(SATELLITE_SYSTEM sys, int prn,
+                       const StationGeometry &sta, double *state,
+                       double &clock, double &tau) const noexcept;
+
+  private:
+    friend class OrbitGridCache;
+    explicit EpochView(EpochSlot *slot) noexcept : slot_(slot) {}
+    EpochSlot *slot_;
+  }; // EpochView
+
+  /// @brief Constructor
+  /// @param[in] num_slots Number of epochs held in the cache (>= 1)
+  explicit OrbitGridCache(int num_slots = 4);
+
+  /// @brief Copy not allowed !
+  OrbitGridCache(const OrbitGridCache &) = delete;
+
+  /// @brief Assignment not allowed !
+  OrbitGridCache &operator=(const OrbitGridCache &) = delete;
+
+  /// @brief Dense index of a satellite; -1 if out of range
+  static int index(SATELLITE_SYSTEM sys, int prn) noexcept {
+    return SatId::index(sys, prn);
+  }
+
+  /// @name Writer interface; only one thread may call these
+  ///@{
+  /// @brief Start filling an epoch; the oldest slot is recycled (waiting
+  ///        for readers to unpin it, if needed)
+  /// @return The slot id to pass to set/publish
+  int begin_epoch(const epoch_type &t) noexcept;
+
+  /// @brief Store the state and clock of a satellite in a slot
+  /// @return 0 on success, 1 if the satellite is out of range
+  int set(int slot, SATELLITE_SYSTEM sys, int prn, const double *state,
+          double clock) noexcept;
+
+  /// @brief Make a slot visible to readers
+  void publish(int slot) noexcept;
+
+  /// @brief Fill an epoch from a range of ephemerides
+  ///
+  /// Each element of the range must provide system(), prn() and
+  /// stateNclock(t, state, clock) (e.g. KeplerEphemeris or NavDataFrame for
+  /// GLONASS); stateNclock must compute velocities too.
+  /// @return The number of satellites for which stateNclock failed
+  template <typename It> int fill(const epoch_type &t, It begin, It end) {
+    const int slot = begin_epoch(t);
+    int errors = 0;
+    double state[6], clock;
+    for (auto it = begin; it != end; ++it) {
+      if (it->stateNclock(t, state, clock))
+        ++errors;
+      else
+        set(slot, it->system(), it->prn(), state, clock);
+    }
+    publish(slot);
+    return errors;
+  }
+  ///@}
+
+  /// @brief Reader interface; get a view of an epoch. The view is empty
+  ///        (evaluates to false) if the epoch is not published.
+  EpochView view(const epoch_type &t) const noexcept;
+
+private:
+  std::unique_ptr<EpochSlot[]> slots_; ///< The epoch slots
+  int num_slots_;                      ///< Number of slots
+  int next_{0};                        ///< Next slot to fill (writer only)
+};                                     // OrbitGridCache
+
+} // namespace ngpt
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef __GNSS_PIPELINE_HPP__
+#define __GNSS_PIPELINE_HPP__
+
+/// @file     pipeline.hpp
+///
+/// @brief    A bounded, lock-free Single-Producer/Single-Consumer queue and a
+///           two-stage pipeline built on top of it.
+///
+/// @details  The pipeline runs a producer (e.g. decoding of RINEX epochs) in
+///           a dedicated thread and a consumer (e.g. orbit computation and
+///           filtering) in the calling thread. The two stages communicate
+///           through a ring of pre-constructed slots; slots are never
+///           destroyed or re-allocated while the pipeline runs, hence any
+///           memory owned by a slot (e.g. vectors) is recycled from epoch to
+///           epoch. This allows parsing of epoch k+1 to overlap with the
+///           processing of epoch k.
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+namespace ngpt {
+
+namespace pipeline_details {
+/// Assumed size of a cache line; used to keep the producer and consumer
+/// indexes on separate lines (avoid false sharing).
+constexpr std::size_t cache_line_size{64};
+} // namespace pipeline_details
+
+/// @class SpscQueue
+/// A bounded, lock-free, Single-Producer/Single-Consumer ring of N slots.
+/// The producer asks for a slot to write to (write_slot), fills it in-place
+/// and then publishes it (commit). The consumer asks for the next published
+/// slot (read_slot), uses it in-place and then hands it back (release).
+/// No element is ever constructed/destructed after the queue is built.
+///
+/// @tparam T The type of the slots; must be default constructible
+/// @tparam N Number of slots; must be a power of 2
+///
+/// @warning Only one thread may call the producer functions (write_slot,
+///          commit, push) and only one (other) thread may call the consumer
+///          functions (read_slot, release, pop).
+template <typename T, std::size_t N> class SpscQueue {
+  static_assert(N >= 2 && !(N & (N - 1)),
+                "SpscQueue size must be a power of 2");
+  static_assert(std::is_default_constructible<T>::value,
+                "SpscQueue slots must be default constructible");
+
+public:
+  /// @brief Default constructor; all N slots are default-constructed
+  SpscQueue() noexcept(std::is_nothrow_default_constructible<T>::value) {}
+
+  /// @brief Copy not allowed !
+  SpscQueue(const SpscQueue &) = delete;
+
+  /// @brief Assignment not allowed !
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  /// @brief Number of slots
+  static constexpr std::size_t capacity() noexcept { return N; }
+
+  /// @brief Get the next free slot to write to (producer side)
+  /// @return A pointer to the slot, or nullptr if the queue is full
+  T *write_slot() noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == N) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == N)
+        return nullptr;
+    }
+    return &buf_[tail & (N - 1)];
+  }
+
+  /// @brief Publish the slot returned by the last call to write_slot
+  void commit() noexcept {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  /// @brief Get the next published slot (consumer side)
+  /// @return A pointer to the slot, or nullptr if the queue is empty
+  T *read_slot() noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_)
+        return nullptr;
+    }
+    return &buf_[head & (N - 1)];
+  }
+
+  /// @brief Hand back the slot returned by the last call to read_slot
+  void release() noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  /// @brief Copy an element in the queue; false if the queue is full
+  bool push(const T &t) noexcept(std::is_nothrow_copy_assignable<T>::value) {
+    T *slot = write_slot();
+    if (!slot)
+      return false;
+    *slot = t;
+    commit();
+    return true;
+  }
+
+  /// @brief Extract an element off the queue; false if the queue is empty
+  bool pop(T &t) noexcept(std::is_nothrow_copy_assignable<T>::value) {
+    T *slot = read_slot();
+    if (!slot)
+      return false;
+    t = *slot;
+    release();
+    return true;
+  }
+
+  /// @brief Apply a function to every slot (e.g. to pre-allocate memory).
+  /// @warning Only call this while no producer/consumer is running.
+  template <typename F> void for_each_slot(F &&f) {
+    for (auto &slot : buf_)
+      f(slot);
+  }
+
+private:
+  ///< Next slot to be read (written by the consumer)
+  alignas(pipeline_details::cache_line_size) std::atomic<std::size_t> head_{0};
+  ///< Consumer's cached copy of tail_
+  std::size_t tail_cache_{0};
+  ///< Next slot to be written (written by the producer)
+  alignas(pipeline_details::cache_line_size) std::atomic<std::size_t> tail_{0};
+  ///< Producer's cached copy of head_
+  std::size_t head_cache_{0};
+  ///< The slots
+  alignas(pipeline_details::cache_line_size) T buf_[N];
+}; // SpscQueue
+
+/// @class TwoStagePipeline
+/// Run a producer stage in a dedicated thread and a consumer stage in the
+/// calling thread, connected via an SpscQueue of N slots.
+///
+/// The producer is a callable of type int(T&); it fills in the slot passed
+/// and returns a status. Any status other than 0 marks the slot as the last
+/// one (the slot is still handed to the consumer, e.g. to signal EOF).
+/// The consumer is a callable of type int(T&, int) which is passed the slot
+/// and the producer's status for that slot; if it returns anything other than
+/// 0, the pipeline stops.
+///
+/// Example:
+/// TwoStagePipeline<EpochBlock, 8> pl;
+/// pl.initialize_slots([&](EpochBlock& b){ b.vec = rnx.initialize_...; });
+/// int status = pl.run(
+///   [&](EpochBlock& b){ return rnx.read_next_epoch(..., b.vec, ...); },
+///   [&](EpochBlock& b, int s){ process(b); return s; });
+template <typename T, std::size_t N = 8> class TwoStagePipeline {
+  struct Slot {
+    T item;
+    int status{0};
+  };
+
+public:
+  /// @brief Pre-set every slot (e.g. allocate vectors once)
+  template <typename F> void initialize_slots(F &&f) {
+    queue_.for_each_slot([&f](Slot &s) { f(s.item); });
+  }
+
+  /// @brief Run the pipeline until the producer returns a non-zero status
+  ///        or the consumer asks to stop.
+  /// @return The (non-zero) status returned by the consumer, or else the
+  ///         (non-zero) status of the last slot the producer filled
+  /// @warning Both callables should be noexcept; an exception thrown by the
+  ///          producer stops the pipeline with status 1000.
+  template <typename Producer, typename Consumer>
+  int run(Producer &&produce, Consumer &&consume) {
+    stop_.store(false, std::memory_order_relaxed);
+
+    std::thread producer([this, &produce]() {
+      int status = 0;
+      while (!status) {
+        Slot *slot;
+        while (!(slot = queue_.write_slot())) {
+          if (stop_.load(std::memory_order_acquire))
+            return;
+          std::this_thread::yield();
+        }
+        try {
+          status = produce(slot->item);
+        } catch (...) {
+          status = 1000;
+        }
+        slot->status = status;
+        queue_.commit();
+      }
+    });
+
+    int status = 0;
+    while (!status) {
+      Slot *slot;
+      while (!(slot = queue_.read_slot()))
+        std::this_thread::yield();
+      if (!(status = consume(slot->item, slot->status)))
+        status = slot->status;
+      queue_.release();
+    }
+
+    stop_.store(true, std::memory_order_release);
+    producer.join();
+
+    // drain anything left (if the consumer stopped early)
+    while (queue_.read_slot())
+      queue_.release();
+    return status;
+  }
+
+private:
+  SpscQueue<Slot, N> queue_;
+  std::atomic<bool> stop_{false};
+}; // TwoStagePipeline
+
+} // namespace ngpt
+
+#endif
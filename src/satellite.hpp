@@ -22,6 +22,7 @@
 ///        for more details.
 
 #include "antenna.hpp"
+#include "satid.hpp"
 #include "satsys.hpp"
 
 namespace ngpt {
@@ -56,6 +57,12 @@ public:
   Satellite(SATELLITE_SYSTEM s, int PRN) noexcept
       : __system(s), __prn(PRN), __svn(-1), __antenna(){};
 
+  /// @brief Constructor from a (compact) satellite id
+  explicit Satellite(SatId id) noexcept : Satellite(id.system(), id.prn()) {}
+
+  /// @brief  Get the (compact) satellite id
+  SatId id() const noexcept { return SatId(__system, __prn); }
+
   /// @brief   Get the antenna type (non-const)
   /// @return  The satellite's antenna model as SatelliteAntenna
   SatelliteAntenna &antenna() noexcept { return __antenna; }
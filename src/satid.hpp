@@ -0,0 +1,196 @@
+#ifndef __GNSS_SATID_HPP__
+#define __GNSS_SATID_HPP__
+
+/// @file     satid.hpp
+///
+/// @brief    Compact (packed integer) identifiers for satellites and signals.
+///
+/// @details  A Satellite carries metadata (SVN, antenna, COSPAR id) and is
+///           too heavy to copy around per observation; the identifiers here
+///           are plain integers, cheap to copy, compare and hash:
+///           - SatId:       satellite system and PRN, in 16 bits
+///           - SignalId:    satellite system and ObservationCode, in 16 bits
+///           Conversions to and from the rich types are O(1) and lossless
+///           (for valid identifiers). SatId::index and SignalId::index give
+///           dense indexes, usable to address plain arrays.
+
+#include "gnssobs.hpp"
+#include "satsys.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace ngpt {
+
+/// @class SatId
+/// A satellite (system and PRN) packed in 16 bits, as (system << 8) | prn.
+class SatId {
+public:
+  /// Max PRN per satellite system (for dense indexing)
+  static constexpr int max_prn{64};
+  /// Number of satellite systems (excluding mixed)
+  static constexpr int num_systems{7};
+  /// Size of the dense index range
+  static constexpr int max_sats{max_prn * num_systems};
+
+  /// @brief Default constructor; an invalid id
+  constexpr SatId() noexcept : id_(invalid_) {}
+
+  /// @brief Constructor; the id is invalid if prn is not in [0, 255]
+  constexpr SatId(SATELLITE_SYSTEM sys, int prn) noexcept
+      : id_((prn < 0 || prn > 255)
+                ? invalid_
+                : static_cast<std::uint16_t>(
+                      (static_cast<unsigned>(sys) << 8) |
+                      static_cast<unsigned>(prn))) {}
+
+  constexpr SATELLITE_SYSTEM system() const noexcept {
+    return static_cast<SATELLITE_SYSTEM>(id_ >> 8);
+  }
+  constexpr int prn() const noexcept { return id_ & 0xff; }
+  constexpr std::uint16_t raw() const noexcept { return id_; }
+  constexpr bool valid() const noexcept { return id_ != invalid_; }
+
+  /// @brief Dense index of a satellite, in [0, max_sats); -1 if out of range
+  static constexpr int index(SATELLITE_SYSTEM sys, int prn) noexcept {
+    const int s = static_cast<int>(sys);
+    if (s < 0 || s >= num_systems || prn < 1 || prn > max_prn)
+      return -1;
+    return s * max_prn + prn - 1;
+  }
+
+  /// @brief Dense index of this satellite; -1 if out of range
+  constexpr int index() const noexcept { return index(system(), prn()); }
+
+  /// @brief Satellite of a dense index (inverse of index())
+  static constexpr SatId from_index(int idx) noexcept {
+    return (idx < 0 || idx >= max_sats)
+               ? SatId()
+               : SatId(static_cast<SATELLITE_SYSTEM>(idx / max_prn),
+                       idx % max_prn + 1);
+  }
+
+  /// @brief Construct from its raw (packed) value
+  static constexpr SatId from_raw(std::uint16_t raw) noexcept {
+    SatId id;
+    id.id_ = raw;
+    return id;
+  }
+
+  constexpr bool operator==(SatId other) const noexcept {
+    return id_ == other.id_;
+  }
+  constexpr bool operator!=(SatId other) const noexcept {
+    return id_ != other.id_;
+  }
+  constexpr bool operator<(SatId other) const noexcept {
+    return id_ < other.id_;
+  }
+
+private:
+  static constexpr std::uint16_t invalid_{0xffff};
+  std::uint16_t id_;
+}; // SatId
+
+/// @class SignalId
+/// A signal, i.e. a satellite system and an ObservationCode (type, band,
+/// attribute), packed in 15 bits:
+/// ----------+------+-----------------------------------------------+
+/// bits      | size | content                                       |
+/// ----------+------+-----------------------------------------------+
+/// 12 - 14   | 3    | satellite system                              |
+///  9 - 11   | 3    | OBSERVABLE_TYPE                               |
+///  5 -  8   | 4    | band                                          |
+///  0 -  4   | 5    | attribute; 0 for '?' (any), 1 - 26 for A - Z  |
+/// ----------+------+-----------------------------------------------+
+class SignalId {
+public:
+  /// Size of the dense index range
+  static constexpr int max_signals{1 << 15};
+
+  /// @brief Default constructor; an invalid id
+  constexpr SignalId() noexcept : id_(invalid_) {}
+
+  /// @brief Constructor; the id is invalid if any of the components is out
+  ///        of range (e.g. an attribute that is not '?' or in A - Z)
+  SignalId(SATELLITE_SYSTEM sys, const ObservationCode &code) noexcept
+      : id_(pack(sys, code.get<0>(), code.get<1>(),
+                 code.get<2>().as_char())) {}
+
+  /// @brief The signal's satellite system
+  constexpr SATELLITE_SYSTEM system() const noexcept {
+    return static_cast<SATELLITE_SYSTEM>((id_ >> 12) & 0x7);
+  }
+
+  /// @brief The signal's observation type
+  constexpr OBSERVABLE_TYPE type() const noexcept {
+    return static_cast<OBSERVABLE_TYPE>((id_ >> 9) & 0x7);
+  }
+
+  /// @brief The signal's band
+  constexpr int band() const noexcept { return (id_ >> 5) & 0xf; }
+
+  /// @brief The signal's attribute as char
+  constexpr char attribute() const noexcept {
+    const int a = id_ & 0x1f;
+    return a ? static_cast<char>('A' + a - 1) : '?';
+  }
+
+  /// @brief Convert back to an ObservationCode
+  ObservationCode code() const noexcept {
+    return ObservationCode(type(), band(), ObservationAttribute(attribute()));
+  }
+
+  constexpr std::uint16_t raw() const noexcept { return id_; }
+  constexpr bool valid() const noexcept { return id_ != invalid_; }
+
+  /// @brief Dense index in [0, max_signals); -1 if invalid
+  constexpr int index() const noexcept { return valid() ? id_ : -1; }
+
+  /// @brief Construct from its raw (packed) value
+  static constexpr SignalId from_raw(std::uint16_t raw) noexcept {
+    SignalId id;
+    id.id_ = raw;
+    return id;
+  }
+
+  constexpr bool operator==(SignalId other) const noexcept {
+    return id_ == other.id_;
+  }
+  constexpr bool operator!=(SignalId other) const noexcept {
+    return id_ != other.id_;
+  }
+  constexpr bool operator<(SignalId other) const noexcept {
+    return id_ < other.id_;
+  }
+
+private:
+  static constexpr std::uint16_t invalid_{0xffff};
+
+  static constexpr std::uint16_t pack(SATELLITE_SYSTEM sys, OBSERVABLE_TYPE t,
+                                      int band, char attr) noexcept {
+    const int s = static_cast<int>(sys);
+    const int o = static_cast<int>(t);
+    const int a = (attr == '?') ? 0
+                  : (attr >= 'A' && attr <= 'Z') ? attr - 'A' + 1
+                                                 : -1;
+    if (s < 0 || s > 7 || o < 0 || o > 7 || band < 0 || band > 15 || a < 0)
+      return invalid_;
+    return static_cast<std::uint16_t>((s << 12) | (o << 9) | (band << 5) | a);
+  }
+
+  std::uint16_t id_;
+}; // SignalId
+
+} // namespace ngpt
+
+namespace std {
+template <> struct hash<ngpt::SatId> {
+  std::size_t operator()(ngpt::SatId id) const noexcept { return id.raw(); }
+};
+template <> struct hash<ngpt::SignalId> {
+  std::size_t operator()(ngpt::SignalId id) const noexcept { return id.raw(); }
+};
+} // namespace std
+
+#endif
@@ -33,10 +33,12 @@
 ///           Version 2, as published by Sam Hocevar. See http://www.wtfpl.net/
 ///           for more details.
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <map>
 #include <stdexcept>
+#include <string>
 
 namespace ngpt {
 
@@ -70,6 +72,14 @@ char satsys_to_char(SATELLITE_SYSTEM) noexcept;
 SATELLITE_SYSTEM
 char_to_satsys(char);
 
+/// Max RINEX frequency band number; band numbers are in the range
+/// [1, max_frequency_band].
+constexpr int max_frequency_band{9};
+
+/// Nominal frequencies (MHz) of a satellite system, indexed by RINEX band
+/// number; 0 for bands not used by the system.
+using band_frequency_array = std::array<double, max_frequency_band + 1>;
+
 /// Traits for Satellite Systems. A collection of satellite system - specific
 /// "static" information for each system in ngpt::SATELLITE_SYSTEM. To be
 /// specialized for each SATELLITE_SYSTEM
@@ -80,15 +90,20 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::gps> {
   /// Identifier
   static constexpr char identifier{'G'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*L1*/ 1575.42e0, /*L2*/ 1227.60e0, 0e0, 0e0, /*L5*/ 1176.45e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
 
   /// WGS 84 value of the earth's gravitational constant for GPS user μ
   static constexpr double mi() { return 3.986005e14; }
@@ -105,13 +120,38 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::glonass> {
   /// Identifier
   static constexpr char identifier{'R'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*G1*/ 1602.000e0, /*G2*/ 1246.000e0, /*G3*/ 1202.025e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
+
+  /// Min and max frequency channel numbers (FDMA signals)
+  static constexpr int min_channel{-7};
+  static constexpr int max_channel{6};
+
+  /// Channel spacing in MHz for a frequency band; FDMA signals are
+  /// transmitted at f = f0 + k * df where k is the frequency channel. CDMA
+  /// signals (e.g. band 3) have no channel dependence (aka df = 0).
+  static constexpr double channel_spacing(int band) noexcept {
+    return (band == 1) ? 0.5625e0 : ((band == 2) ? 0.4375e0 : 0e0);
+  }
+
+  /// True if the signals of the frequency band are FDMA
+  static constexpr bool is_fdma(int band) noexcept {
+    return band == 1 || band == 2;
+  }
+
+  /// Frequency (MHz) of a frequency band for a given frequency channel; 0 if
+  /// the band is not used
+  static constexpr double band2frequency(int band, int channel) noexcept {
+    return (band > 0 && band <= max_frequency_band && band_frequencies[band])
+               ? band_frequencies[band] + channel * channel_spacing(band)
+               : 0e0;
+  }
 };
 
 /// Specialize traits for Satellite System Galileo
@@ -119,15 +159,21 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::galileo> {
   /// Identifier
   static constexpr char identifier{'E'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*E1*/ 1575.420e0, 0e0, 0e0, 0e0, /*E5a*/ 1176.450e0,
+      /*E6*/ 1278.750e0, /*E5b*/ 1207.140e0, /*E5(E5a+E5b)*/ 1191.795e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
 
   /// Geocentric gravitational constant
   static constexpr double mi() { return 3.986004418e14; }
@@ -144,15 +190,27 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::sbas> {
   /// Identifier
   static constexpr char identifier{'S'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*L1*/ 1575.42e0, 0e0, 0e0, 0e0, /*L5*/ 1176.45e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
+
+  /// WGS 84 value of the earth's gravitational constant (GEO state vectors
+  /// are given in WGS 84)
+  static constexpr double mi() { return 3.986005e14; }
+
+  /// WGS 84 value of the earth's rotation rate
+  static constexpr double omegae_dot() { return 7.2921151467e-5; }
 };
 
 /// Specialize traits for Satellite System QZSS
@@ -160,15 +218,30 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::qzss> {
   /// Identifier
   static constexpr char identifier{'J'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*L1*/ 1575.42e0, /*L2*/ 1227.60e0, 0e0, 0e0, /*L5*/ 1176.45e0,
+      /*LEX*/ 1278.75e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
+
+  /// Earth's gravitational constant (IS-QZSS-PNT, same as GPS)
+  static constexpr double mi() { return 3.986005e14; }
+
+  /// Earth's rotation rate (IS-QZSS-PNT, same as GPS)
+  static constexpr double omegae_dot() { return 7.2921151467e-5; }
+
+  /// Constant F for SV Clock Correction in seconds/sqrt(meters)
+  static constexpr double f_clock() { return -4.442807633e-10; }
 };
 
 /// Specialize traits for Satellite System BDS
@@ -176,15 +249,20 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::beidou> {
   /// Identifier
   static constexpr char identifier{'C'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  static constexpr band_frequency_array band_frequencies{
+      0e0, /*B1*/ 1561.098e0, /*B2*/ 1207.140e0, /*B3*/ 1268.520e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
 
   /// Geocentric gravitational constant
   static constexpr double mi() { return 3.986004418e14; }
@@ -210,15 +288,31 @@ template <> struct satellite_system_traits<SATELLITE_SYSTEM::irnss> {
   /// Identifier
   static constexpr char identifier{'I'};
 
-  /// Dictionary holding pairs of <frequency band, freq. value>.
-  static const std::map<int, double> frequency_map;
+  /// Frequency (MHz) per band, indexed by band number (0 if not used).
+  /// \todo in \cite rnx303 the 2nd frequency band is denoted as 'S'
+  static constexpr band_frequency_array band_frequencies{
+      0e0, 0e0, 0e0, 0e0, 0e0, /*L5*/ 1176.450e0, 0e0, 0e0, 0e0,
+      /*S*/ 2492.028e0};
 
   /// Dictionary holding pairs of <frequency band, std::string>. The
   /// string is a seqeuence of (the **only**) valid attributes for
   /// each frequency band.
   static const std::map<int, std::string> valid_atributes;
 
-  static double band2frequency(int band) { return frequency_map.at(band); }
+  /// Frequency (MHz) of a frequency band; 0 if the band is not used
+  static constexpr double band2frequency(int band) noexcept {
+    return (band > 0 && band <= max_frequency_band) ? band_frequencies[band]
+                                                    : 0e0;
+  }
+
+  /// Earth's gravitational constant (IRNSS SPS ICD, WGS 84)
+  static constexpr double mi() { return 3.986005e14; }
+
+  /// Earth's rotation rate (IRNSS SPS ICD, WGS 84)
+  static constexpr double omegae_dot() { return 7.2921151467e-5; }
+
+  /// Constant F for SV Clock Correction in seconds/sqrt(meters)
+  static constexpr double f_clock() { return -4.442807633e-10; }
 };
 
 /// Specialize traits for Satellite System MIXED
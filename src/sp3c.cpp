@@ -1,5 +1,7 @@
 #include "sp3c.hpp"
+#include "diagnostics.hpp"
 #include "ggdatetime/datetime_read.hpp"
+#include "instrument.hpp"
 #include <algorithm>
 #include <cerrno>
 #include <cstdlib>
@@ -126,7 +128,8 @@ int Sp3c::read_header() noexcept {
   ngpt::microseconds sw;
   auto gwk1 = start_epoch__.as_gps_wsow(sw);
   if (gwk1.as_underlying_type() != gwk || sw.to_fractional_seconds() != sec) {
-    std::cerr << "\n[ERROR] Sp3c::read_header() Failed to validate start date";
+    ngpt::diagnostics::error("Sp3c::read_header() Failed to validate start "
+                             "date");
     return 22;
   }
   sec = std::strtod(line + 24, &str_end);
@@ -139,7 +142,8 @@ int Sp3c::read_header() noexcept {
   sec = std::strtod(line + 45, &str_end);
   sec += mjd;
   if (sec != start_epoch__.as_mjd()) {
-    std::cerr << "\n[ERROR] Sp3c::read_header() Failed to validate start date";
+    ngpt::diagnostics::error("Sp3c::read_header() Failed to validate start "
+                             "date");
     return 24;
   }
 
@@ -243,6 +247,7 @@ int Sp3c::read_header() noexcept {
 int Sp3c::get_next_epoch(ngpt::datetime<ngpt::microseconds> &t,
                          std::vector<Sp3EpochSvRecord> &vec,
                          int &sats_read) noexcept {
+  NGPT_TIME_SCOPE(sp3_epoch);
   char line[MAX_RECORD_CHARS];
   char *end, *start, c;
   int date[5];
@@ -2,6 +2,7 @@
 #define __SP3C_IGS_FILE__
 
 #include "ggdatetime/dtcalendar.hpp"
+#include "satid.hpp"
 #include "satsys.hpp"
 #include <algorithm>
 #include <array>
@@ -48,6 +49,9 @@ struct Sp3EpochSvRecord {
   int prn_{};
   std::array<double, 4> vals_{};
   Sp3Flag flag_;
+
+  /// @brief The (compact) satellite id of the record
+  SatId sat_id() const noexcept { return SatId(s_, prn_); }
 };
 
 class Sp3c {
@@ -148,6 +152,7 @@ public:
 
   int initialize() {
     sp3_->rewind();
+    rows_.fill(-1);
     int j, nsats, k = 0;
     ngpt::datetime<ngpt::microseconds> t;
     auto vec = sp3_->allocate_epoch_vector();
@@ -157,24 +162,25 @@ public:
         return j;
       tvec_.push_back(t);
       if (!k) {
-        for (int i = 0; i < nsats; i++)
+        for (int i = 0; i < nsats; i++) {
           svec_[i][0] = vec[i];
+          const int idx = vec[i].sat_id().index();
+          if (idx >= 0)
+            rows_[idx] = i;
+        }
         running_sv = nsats;
       } else {
-        SATELLITE_SYSTEM s;
-        int prn;
         for (int i = 0; i < nsats; i++) {
-          s = vec[i].s_;
-          prn = vec[i].prn_;
-          auto it = std::find_if(svec_.begin(), svec_.begin() + running_sv,
-                                 [=](const std::vector<Sp3EpochSvRecord> &e) {
-                                   return e[0].s_ == s && e[0].prn_ == prn;
-                                 });
-          if (it == svec_.begin() + running_sv) {
+          const SatId id = vec[i].sat_id();
+          const int idx = id.index();
+          const int row = (idx < 0) ? find_row(id) : rows_[idx];
+          if (row < 0) {
             svec_[running_sv][0] = vec[i];
+            if (idx >= 0)
+              rows_[idx] = running_sv;
             ++running_sv;
           } else {
-            it->emplace_back(vec[i]);
+            svec_[row].emplace_back(vec[i]);
           }
         }
       }
@@ -184,9 +190,19 @@ public:
   }
 
 private:
+  /// @brief Row (in svec_) of a satellite not in the dense index range;
+  ///        -1 if not found
+  int find_row(SatId id) const noexcept {
+    for (int i = 0; i < running_sv; i++)
+      if (svec_[i][0].sat_id() == id)
+        return i;
+    return -1;
+  }
+
   Sp3c *sp3_;
   int K, running_sv;
   std::vector<std::vector<Sp3EpochSvRecord>> svec_;
+  std::array<int, SatId::max_sats> rows_; ///< Row in svec_ per SatId::index
   std::vector<ngpt::datetime<ngpt::microseconds>> tvec_;
 };
 
@@ -0,0 +1,809 @@
+#include "synthetic.hpp"
+#include "geometry.hpp"
+#include "gnssobs.hpp"
+#include "gnssobsrv.hpp"
+#include "ionosphere.hpp"
+#include "troposphere.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::SyntheticConfig;
+using ngpt::SyntheticConstellation;
+using ngpt::SyntheticGenerator;
+
+namespace {
+constexpr double PI = 3.14159265358979323846e0;
+constexpr double D2R = PI / 180e0;
+
+/// MJD of the GPS and BDT time origins
+constexpr long GPS_MJD0 = 44244L;
+constexpr long BDT_MJD0 = 53736L;
+
+/// BDT is behind GPS time by 14 seconds
+constexpr long BDT_OFFSET = 14L;
+
+/// Klobuchar coefficients written to the navigation header (and used for the
+/// observations); values are exactly representable in the header format.
+constexpr double KLB_ALPHA[] = {1.1176e-08, 7.4506e-09, -5.9605e-08,
+                                -5.9605e-08};
+constexpr double KLB_BETA[] = {9.0112e+04, 4.9152e+04, -1.3107e+05,
+                               -3.2768e+05};
+
+/// GLONASS frequency channel per slot (1 to 24)
+constexpr int GLO_CHANNELS[] = {1,  -4, 5,  6,  1,  -4, 5, 6,
+                                -2, -7, 0,  -1, -2, -7, 0, -1,
+                                4,  -3, 3,  2,  4,  -3, 3, 2};
+
+/// Nominal orbit and broadcast parameters of a satellite system
+struct SystemModel {
+  SATELLITE_SYSTEM sys;
+  int max_sats;        ///< Max number of satellites (PRNs)
+  int planes;          ///< Orbital planes
+  double a;            ///< Semi-major axis (m)
+  double inc;          ///< Inclination (degrees)
+  double raan_dot;     ///< Rate of right ascension (rad/sec)
+  long interval;       ///< Interval between messages (sec)
+  double mu;           ///< Gravitational constant used for the mean motion
+};
+
+constexpr SystemModel MODELS[] = {
+    {SATELLITE_SYSTEM::gps, 32, 6, 26559.7e3, 55e0, -8.1e-9, 7200L,
+     ngpt::satellite_system_traits<SATELLITE_SYSTEM::gps>::mi()},
+    {SATELLITE_SYSTEM::glonass, 24, 3, 25508.0e3, 64.8e0, 0e0, 900L,
+     3.986004418e14},
+    {SATELLITE_SYSTEM::galileo, 36, 3, 29600.3e3, 56e0, -5.6e-9, 600L,
+     ngpt::satellite_system_traits<SATELLITE_SYSTEM::galileo>::mi()},
+    {SATELLITE_SYSTEM::beidou, 63, 3, 27906.1e3, 55e0, -6.9e-9, 3600L,
+     ngpt::satellite_system_traits<SATELLITE_SYSTEM::beidou>::mi()}};
+
+const SystemModel *system_model(SATELLITE_SYSTEM sys) noexcept {
+  for (const auto &m : MODELS)
+    if (m.sys == sys)
+      return &m;
+  return nullptr;
+}
+
+/// Offset (seconds) of a system's broadcast time scale from GPS time
+long time_offset(SATELLITE_SYSTEM sys, int leap_seconds) noexcept {
+  if (sys == SATELLITE_SYSTEM::glonass)
+    return -leap_seconds;
+  if (sys == SATELLITE_SYSTEM::beidou)
+    return -BDT_OFFSET;
+  return 0L;
+}
+
+/// splitmix64; all synthetic values are hashes of the seed and an id
+std::uint64_t mix(std::uint64_t x) noexcept {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Uniform value in [0, 1) for a seed and up to four ids
+double uniform(std::uint64_t seed, std::uint64_t a, std::uint64_t b = 0,
+               std::uint64_t c = 0, std::uint64_t d = 0) noexcept {
+  std::uint64_t h = mix(seed);
+  h = mix(h ^ a);
+  h = mix(h ^ b);
+  h = mix(h ^ c);
+  h = mix(h ^ d);
+  return static_cast<double>(h >> 11) * (1e0 / 9007199254740992e0);
+}
+
+/// Approximately normal value (zero mean, unit variance; sum of four
+/// uniforms)
+double normal(std::uint64_t seed, std::uint64_t a, std::uint64_t b,
+              std::uint64_t c, std::uint64_t d) noexcept {
+  double s = 0e0;
+  for (std::uint64_t i = 0; i < 4; i++)
+    s += uniform(seed, a, b, c, (d << 2) | i);
+  return (s - 2e0) * std::sqrt(3e0);
+}
+
+/// Round a value to what is written (and read back) in a navigation RINEX
+/// (%19.12E); messages are built from rounded values so that the files
+/// describe exactly the same orbits as messages()
+double rnx_round(double x) noexcept {
+  char buf[32];
+  std::snprintf(buf, sizeof buf, "%.12E", x);
+  return std::strtod(buf, nullptr);
+}
+
+/// Floor division for (possibly negative) integers
+long floor_div(long a, long b) noexcept {
+  long q = a / b;
+  return (a % b && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+/// Civil date from MJD
+void mjd2ymd(long mjd, int &y, int &m, int &d) noexcept {
+  long l = mjd + 2400001L + 68569L;
+  long n = (4L * l) / 146097L;
+  l -= (146097L * n + 3L) / 4L;
+  long i = (4000L * (l + 1L)) / 1461001L;
+  l = l - (1461L * i) / 4L + 31L;
+  long j = (80L * l) / 2447L;
+  d = static_cast<int>(l - (2447L * j) / 80L);
+  l = j / 11L;
+  m = static_cast<int>(j + 2L - 12L * l);
+  y = static_cast<int>(100L * (n - 49L) + i + l);
+}
+
+/// Week and seconds of week since an origin (MJD), for a time given as MJD
+/// plus seconds of day
+void week_sow(long mjd, long sod, long mjd0, long &week, long &sow) noexcept {
+  const long sec = (mjd - mjd0) * 86400L + sod;
+  week = floor_div(sec, 604800L);
+  sow = sec - week * 604800L;
+}
+
+/// Split a time (seconds since the start day, may be negative) into MJD and
+/// seconds of day
+void split_day(long start_mjd, long t, long &mjd, long &sod) noexcept {
+  const long days = floor_div(t, 86400L);
+  mjd = start_mjd + days;
+  sod = t - days * 86400L;
+}
+
+int days_in_month(int y, int m) noexcept {
+  constexpr int dm[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+  return (m == 2 && leap) ? 29 : dm[m - 1];
+}
+
+/// Write a header line; content at columns 1-60, label at columns 61-80
+int header_line(std::FILE *fp, const char *content, const char *label) noexcept {
+  return std::fprintf(fp, "%-60.60s%-20.20s\n", content, label) < 0;
+}
+
+/// Write a navigation RINEX record: the epoch line (three values) followed by
+/// continuation lines of (up to) four values
+int write_record(std::FILE *fp, char sys, int prn, long mjd, long sod,
+                 const double *vals, int n) noexcept {
+  int y, m, d;
+  mjd2ymd(mjd, y, m, d);
+  if (std::fprintf(fp, "%c%02d %4d %02d %02d %02ld %02ld %02ld", sys, prn, y,
+                   m, d, sod / 3600L, (sod % 3600L) / 60L, sod % 60L) < 0)
+    return 1;
+  for (int i = 0; i < 3; i++)
+    std::fprintf(fp, "%19.12E", vals[i]);
+  for (int i = 3; i < n; i++) {
+    if ((i - 3) % 4 == 0)
+      std::fputs("\n    ", fp);
+    std::fprintf(fp, "%19.12E", vals[i]);
+  }
+  return std::fputc('\n', fp) == EOF;
+}
+} // namespace
+
+/// The nominal constellations are the (approximate) full operational ones;
+/// observables are the usual code, phase, Doppler and signal strength
+/// tracked on two frequencies.
+SyntheticConstellation ngpt::nominal_constellation(SATELLITE_SYSTEM sys) {
+  switch (sys) {
+  case SATELLITE_SYSTEM::gps:
+    return {sys, 32, {"C1C", "L1C", "D1C", "S1C", "C2W", "L2W", "S2W"}};
+  case SATELLITE_SYSTEM::glonass:
+    return {sys, 24, {"C1C", "L1C", "D1C", "S1C", "C2P", "L2P", "S2P"}};
+  case SATELLITE_SYSTEM::galileo:
+    return {sys, 24, {"C1C", "L1C", "D1C", "S1C", "C5Q", "L5Q", "S5Q"}};
+  case SATELLITE_SYSTEM::beidou:
+    // bands as in the BeiDou frequency map (B1 is 1, B2 is 2)
+    return {sys, 24, {"C1I", "L1I", "D1I", "S1I", "C2I", "L2I", "S2I"}};
+  default:
+    break;
+  }
+  throw std::runtime_error(
+      "[ERROR] nominal_constellation() Satellite system not supported");
+}
+
+/// @throw std::runtime_error if the configuration is invalid (date, rate,
+///        duration, number of stations, unsupported satellite system, too
+///        many satellites or an observable with unknown frequency)
+SyntheticGenerator::SyntheticGenerator(const SyntheticConfig &cfg)
+    : cfg_(cfg) {
+  if (cfg_.month < 1 || cfg_.month > 12 || cfg_.day < 1 ||
+      cfg_.day > days_in_month(cfg_.year, cfg_.month) || cfg_.year < 1981)
+    throw std::runtime_error(
+        "[ERROR] SyntheticGenerator::SyntheticGenerator() Invalid date");
+  if (!(cfg_.obs_rate >= 1e0 && cfg_.obs_rate <= 50e0) ||
+      !(cfg_.duration > 0e0) || !(cfg_.sp3_interval >= 1e0) ||
+      cfg_.num_stations < 1 || cfg_.num_stations > 999)
+    throw std::runtime_error("[ERROR] SyntheticGenerator::SyntheticGenerator()"
+                             " Invalid rate, duration or number of stations");
+  if (cfg_.constellations.empty())
+    throw std::runtime_error("[ERROR] SyntheticGenerator::SyntheticGenerator()"
+                             " No constellations");
+
+  start_mjd_ = ngpt::modified_julian_day(ngpt::year(cfg_.year),
+                                         ngpt::month(cfg_.month),
+                                         ngpt::day_of_month(cfg_.day))
+                   .as_underlying_type();
+
+  for (std::size_t c = 0; c < cfg_.constellations.size(); c++) {
+    const auto &con = cfg_.constellations[c];
+    const SystemModel *model = system_model(con.sys);
+    if (!model)
+      throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                               "SyntheticGenerator() Satellite system not "
+                               "supported");
+    if (con.num_sats < 1 || con.num_sats > model->max_sats)
+      throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                               "SyntheticGenerator() Invalid number of "
+                               "satellites");
+    for (std::size_t k = 0; k < c; k++)
+      if (cfg_.constellations[k].sys == con.sys)
+        throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                                 "SyntheticGenerator() Duplicate satellite "
+                                 "system");
+    if (con.observables.empty())
+      throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                               "SyntheticGenerator() No observables");
+    for (const auto &o : con.observables)
+      if (o.size() != 3 || !std::strchr("CLDS", o[0]))
+        throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                                 "SyntheticGenerator() Invalid observable");
+
+    const int per_plane = (con.num_sats + model->planes - 1) / model->planes;
+    for (int s = 0; s < con.num_sats; s++) {
+      const std::uint64_t id =
+          (static_cast<std::uint64_t>(con.sys) << 8) | (s + 1);
+      const int plane = s % model->planes;
+      const int slot = s / model->planes;
+      Orbit orb;
+      orb.sys = con.sys;
+      orb.prn = s + 1;
+      orb.a = model->a + 2e3 * (uniform(cfg_.seed, id, 1) - 0.5e0);
+      orb.e = (con.sys == SATELLITE_SYSTEM::glonass)
+                  ? 0e0
+                  : 1e-3 + 9e-3 * uniform(cfg_.seed, id, 2);
+      orb.i = (model->inc + (uniform(cfg_.seed, id, 3) - 0.5e0)) * D2R;
+      orb.raan = 2e0 * PI * plane / model->planes +
+                 0.02e0 * (uniform(cfg_.seed, id, 4) - 0.5e0);
+      orb.omega = 2e0 * PI * uniform(cfg_.seed, id, 5);
+      orb.m0 = 2e0 * PI * (slot + 0.5e0 * plane / model->planes) / per_plane +
+               0.02e0 * (uniform(cfg_.seed, id, 6) - 0.5e0) - orb.omega;
+      orb.af0 = 2e-4 * (uniform(cfg_.seed, id, 7) - 0.5e0);
+      orb.af1 = 2e-11 * (uniform(cfg_.seed, id, 8) - 0.5e0);
+      orb.channel = (con.sys == SATELLITE_SYSTEM::glonass)
+                        ? GLO_CHANNELS[s % 24]
+                        : 0;
+      orb.constellation = static_cast<int>(c);
+      orb.first_freq = freqs_.size();
+      try {
+        for (const auto &o : con.observables)
+          freqs_.push_back(
+              ngpt::__ObsPart(con.sys, ngpt::ObservationCode(o.c_str()))
+                  .frequency(orb.channel));
+      } catch (std::exception &) {
+        throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                                 "SyntheticGenerator() Observable with "
+                                 "unknown frequency");
+      }
+      orbits_.push_back(orb);
+      add_messages(orb);
+    }
+  }
+  first_msg_.push_back(msgs_.size());
+}
+
+/// Messages cover [start, start+duration] (in the system's time scale) and
+/// are spaced by the system's nominal interval. Keplerian messages hold the
+/// same elements and clock polynomial, propagated to the reference epoch,
+/// and are valid from ToC on; GLONASS messages are valid around ToE, so the
+/// last one is the first at or after the end. Each GLONASS state vector
+/// after the first is the library's own integration of the previous one.
+void SyntheticGenerator::add_messages(const Orbit &orb) {
+  const SystemModel *model = system_model(orb.sys);
+  const long offset = time_offset(orb.sys, cfg_.leap_seconds);
+  const long interval = model->interval;
+  const long t0 = floor_div(offset, interval) * interval;
+  const long t1 = static_cast<long>(std::ceil(cfg_.duration)) + offset;
+  const double n0 = std::sqrt(model->mu / (orb.a * orb.a * orb.a));
+  constexpr double we = ngpt::geometry::omega_earth;
+
+  first_msg_.push_back(msgs_.size());
+  first_ref_.push_back(static_cast<double>(t0));
+  msg_interval_.push_back(static_cast<double>(interval));
+
+  long k = 0;
+  for (long t = t0; t < t1 + interval; t += interval, ++k) {
+    if (orb.sys != SATELLITE_SYSTEM::glonass && t > t1)
+      break;
+    long mjd, sod;
+    split_day(start_mjd_, t, mjd, sod);
+    const ngpt::datetime<ngpt::seconds> ref{ngpt::modified_julian_day(mjd),
+                                            ngpt::seconds(sod)};
+    const double tr = static_cast<double>(t);
+    NavDataFrame f;
+    f.system() = orb.sys;
+    f.prn() = orb.prn;
+    f.set_toc(ref);
+
+    if (orb.sys == SATELLITE_SYSTEM::glonass) {
+      double state[6];
+      if (k == 0) {
+        // circular orbit; inertial state rotated to ECEF, theta = we*t
+        const double u = orb.m0 + orb.omega + n0 * tr;
+        const double v = std::sqrt(model->mu / orb.a);
+        const double cu = std::cos(u), su = std::sin(u);
+        const double cO = std::cos(orb.raan), sO = std::sin(orb.raan);
+        const double ci = std::cos(orb.i), si = std::sin(orb.i);
+        const double ri[] = {orb.a * (cu * cO - su * ci * sO),
+                             orb.a * (cu * sO + su * ci * cO),
+                             orb.a * su * si};
+        const double vi[] = {v * (-su * cO - cu * ci * sO),
+                             v * (-su * sO + cu * ci * cO), v * cu * si};
+        const double th = we * tr;
+        const double ct = std::cos(th), st = std::sin(th);
+        state[0] = ri[0] * ct + ri[1] * st;
+        state[1] = -ri[0] * st + ri[1] * ct;
+        state[2] = ri[2];
+        state[3] = vi[0] * ct + vi[1] * st + we * state[1];
+        state[4] = -vi[0] * st + vi[1] * ct - we * state[0];
+        state[5] = vi[2];
+      } else {
+        const NavDataFrame &prev = msgs_.back();
+        double clock;
+        if (prev.stateNclock(prev.toe<ngpt::seconds>(), state, clock,
+                             static_cast<double>(interval)))
+          throw std::runtime_error("[ERROR] SyntheticGenerator::"
+                                   "add_messages() Failed to propagate "
+                                   "GLONASS state");
+      }
+      long week, sow;
+      week_sow(mjd, sod, GPS_MJD0, week, sow);
+      f.data(0) = rnx_round(orb.af0 + orb.af1 * tr);
+      f.data(1) = rnx_round(orb.af1);
+      f.data(2) = static_cast<double>(sow);
+      const int pos[] = {3, 7, 11};
+      for (int j = 0; j < 3; j++) {
+        f.data(pos[j]) = rnx_round(state[j] * 1e-3) * 1e3;
+        f.data(pos[j] + 1) = rnx_round(state[j + 3] * 1e-3) * 1e3;
+        f.data(pos[j] + 2) = 0e0;
+      }
+      f.data(6) = 0e0;
+      f.data(10) = static_cast<double>(orb.channel);
+      f.data(14) = 0e0;
+    } else {
+      long week, sow;
+      week_sow(mjd, sod, orb.sys == SATELLITE_SYSTEM::beidou ? BDT_MJD0
+                                                             : GPS_MJD0,
+               week, sow);
+      const double M0 = std::remainder(orb.m0 + n0 * tr, 2e0 * PI);
+      const double O0 = std::remainder(
+          orb.raan + (model->raan_dot - we) * tr + we * sow, 2e0 * PI);
+      f.data(0) = rnx_round(orb.af0 + orb.af1 * tr);
+      f.data(1) = rnx_round(orb.af1);
+      f.data(3) = static_cast<double>(k % 256);
+      f.data(6) = rnx_round(M0);
+      f.data(8) = rnx_round(orb.e);
+      f.data(10) = rnx_round(std::sqrt(orb.a));
+      f.data(11) = static_cast<double>(sow);
+      f.data(13) = rnx_round(O0);
+      f.data(15) = rnx_round(orb.i);
+      f.data(17) = rnx_round(orb.omega);
+      f.data(18) = rnx_round(model->raan_dot);
+      f.data(20) = (orb.sys == SATELLITE_SYSTEM::galileo) ? 517e0 : 1e0;
+      f.data(21) = static_cast<double>(week);
+      f.data(23) = 2e0;
+      f.data(26) = f.data(3);
+      f.data(27) = static_cast<double>(sow);
+      if (orb.sys == SATELLITE_SYSTEM::gps)
+        f.data(28) = 4e0;
+    }
+    f.set_toe(f.toe2date<ngpt::seconds>());
+    msgs_.push_back(f);
+  }
+}
+
+long SyntheticGenerator::message_index(int sat, double t) const noexcept {
+  const double x = (t - first_ref_[sat]) / msg_interval_[sat];
+  const long k = (orbits_[sat].sys == SATELLITE_SYSTEM::glonass)
+                     ? std::lround(x)
+                     : static_cast<long>(std::floor(x));
+  if (k < 0 || first_msg_[sat] + k >= first_msg_[sat + 1])
+    return -1;
+  return static_cast<long>(first_msg_[sat]) + k;
+}
+
+std::string SyntheticGenerator::marker_name(int station) const {
+  char buf[16];
+  std::snprintf(buf, sizeof buf, "S%03d", station);
+  return std::string(buf);
+}
+
+/// Stations are spread (quasi uniformly) over the globe, between latitudes
+/// of about -64 and 64 degrees; coordinates are on the GRS80 ellipsoid.
+void SyntheticGenerator::station_position(int station, double *xyz) const
+    noexcept {
+  constexpr double a = 6378137e0;
+  constexpr double f = 1e0 / 298.257222101e0;
+  constexpr double e2 = f * (2e0 - f);
+  const double u = (station + 0.5e0) * 0.6180339887498949e0;
+  const double w = station * 0.7548776662466927e0 + 0.1e0;
+  const double lat = std::asin(0.9e0 * (1e0 - 2e0 * (u - std::floor(u))));
+  const double lon = 2e0 * PI * (w - std::floor(w)) - PI;
+  const double hgt = 100e0 + 10e0 * (station % 50);
+  const double sf = std::sin(lat);
+  const double N = a / std::sqrt(1e0 - e2 * sf * sf);
+  xyz[0] = (N + hgt) * std::cos(lat) * std::cos(lon);
+  xyz[1] = (N + hgt) * std::cos(lat) * std::sin(lon);
+  xyz[2] = (N * (1e0 - e2) + hgt) * sf;
+}
+
+/// @return 0 on success; 1 if the file cannot be opened, 2 on a write error
+int SyntheticGenerator::write_nav(const char *fn) const noexcept {
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+
+  int y, m, d;
+  mjd2ymd(start_mjd_, y, m, d);
+  char buf[96];
+  int err = 0;
+  std::snprintf(buf, sizeof buf, "%9.2f%11s%-20s%-20s", 3.04, "",
+                "N: GNSS NAV DATA", "M: MIXED");
+  err |= header_line(fp, buf, "RINEX VERSION / TYPE");
+  std::snprintf(buf, sizeof buf, "%-20s%-20s%04d%02d%02d 000000 GPS",
+                "synthetic", "ngpt", y, m, d);
+  err |= header_line(fp, buf, "PGM / RUN BY / DATE");
+  std::snprintf(buf, sizeof buf, "GPSA %12.4E%12.4E%12.4E%12.4E",
+                KLB_ALPHA[0], KLB_ALPHA[1], KLB_ALPHA[2], KLB_ALPHA[3]);
+  err |= header_line(fp, buf, "IONOSPHERIC CORR");
+  std::snprintf(buf, sizeof buf, "GPSB %12.4E%12.4E%12.4E%12.4E",
+                KLB_BETA[0], KLB_BETA[1], KLB_BETA[2], KLB_BETA[3]);
+  err |= header_line(fp, buf, "IONOSPHERIC CORR");
+  std::snprintf(buf, sizeof buf, "%6d", cfg_.leap_seconds);
+  err |= header_line(fp, buf, "LEAP SECONDS");
+  err |= header_line(fp, "", "END OF HEADER");
+
+  double vals[31];
+  for (const auto &f : msgs_) {
+    const auto toc = f.toc();
+    int n;
+    if (f.system() == SATELLITE_SYSTEM::glonass) {
+      n = 15;
+      for (int i = 0; i < n; i++)
+        vals[i] = f.data(i);
+      for (int i : {3, 4, 5, 7, 8, 9, 11, 12, 13})
+        vals[i] *= 1e-3;
+    } else {
+      n = (f.system() == SATELLITE_SYSTEM::galileo) ? 28 : 29;
+      for (int i = 0; i < n; i++)
+        vals[i] = f.data(i);
+    }
+    err |= write_record(fp, ngpt::satsys_to_char(f.system()), f.prn(),
+                        toc.mjd().as_underlying_type(),
+                        static_cast<long>(toc.sec().as_underlying_type()),
+                        vals, n);
+  }
+
+  err |= (std::fclose(fp) != 0);
+  return err ? 2 : 0;
+}
+
+/// Sp3 epochs are in GPS time, every sp3_interval seconds in
+/// [start, start+duration]; satellites with no message (or a failed
+/// evaluation) at an epoch are written with zero position and bad clock.
+int SyntheticGenerator::write_sp3(const char *fn) const noexcept {
+  const long interval = static_cast<long>(std::lround(cfg_.sp3_interval));
+  const long num_epochs =
+      static_cast<long>(std::floor(cfg_.duration / interval)) + 1L;
+  const int num_sats = static_cast<int>(orbits_.size());
+
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+
+  int y, m, d;
+  mjd2ymd(start_mjd_, y, m, d);
+  long week, sow;
+  week_sow(start_mjd_, 0L, GPS_MJD0, week, sow);
+  int err = 0;
+  err |= std::fprintf(fp,
+                      "#cP%4d %2d %2d %2d %2d %11.8f %7ld ORBIT IGS14 HLM  "
+                      "SYN\n",
+                      y, m, d, 0, 0, 0e0, num_epochs) < 0;
+  err |= std::fprintf(fp, "## %4ld %15.8f %14.8f %5ld %15.13f\n", week,
+                      static_cast<double>(sow), static_cast<double>(interval),
+                      start_mjd_, 0e0) < 0;
+  const int id_lines = std::max(5, (num_sats + 16) / 17);
+  for (int l = 0; l < id_lines; l++) {
+    if (l == 0)
+      std::fprintf(fp, "+  %3d   ", num_sats);
+    else
+      std::fputs("+        ", fp);
+    for (int j = l * 17; j < (l + 1) * 17; j++) {
+      if (j < num_sats)
+        std::fprintf(fp, "%c%02d", ngpt::satsys_to_char(orbits_[j].sys),
+                     orbits_[j].prn);
+      else
+        std::fputs("  0", fp);
+    }
+    std::fputc('\n', fp);
+  }
+  for (int l = 0; l < id_lines; l++) {
+    std::fputs("++       ", fp);
+    for (int j = l * 17; j < (l + 1) * 17; j++)
+      std::fprintf(fp, "%3d", j < num_sats ? 2 : 0);
+    std::fputc('\n', fp);
+  }
+  std::fputs("%c M  cc GPS ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n"
+             "%c cc cc ccc ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n"
+             "%f  1.2500000  1.025000000  0.00000000000  0.000000000000000\n"
+             "%f  0.0000000  0.000000000  0.00000000000  0.000000000000000\n"
+             "%i    0    0    0    0      0      0      0      0         0\n"
+             "%i    0    0    0    0      0      0      0      0         0\n"
+             "/* SYNTHETIC ORBITS AND CLOCKS FROM BROADCAST MESSAGES\n",
+             fp);
+
+  char line[96];
+  double state[6], clock;
+  for (long e = 0; e < num_epochs && !err; e++) {
+    const long t = e * interval;
+    long mjd, sod;
+    split_day(start_mjd_, t, mjd, sod);
+    mjd2ymd(mjd, y, m, d);
+    err |= std::fprintf(fp, "*  %4d %2d %2d %2ld %2ld %11.8f\n", y, m, d,
+                        sod / 3600L, (sod % 3600L) / 60L,
+                        static_cast<double>(sod % 60L)) < 0;
+    for (int s = 0; s < num_sats; s++) {
+      const auto &orb = orbits_[s];
+      const long ts = t + time_offset(orb.sys, cfg_.leap_seconds);
+      const long idx = message_index(s, static_cast<double>(ts));
+      split_day(start_mjd_, ts, mjd, sod);
+      const ngpt::datetime<ngpt::seconds> tsys{ngpt::modified_julian_day(mjd),
+                                               ngpt::seconds(sod)};
+      int n;
+      if (idx >= 0 && !msgs_[idx].stateNclock(tsys, state, clock)) {
+        n = std::snprintf(line, sizeof line, "P%c%02d%14.6f%14.6f%14.6f%14.6f",
+                          ngpt::satsys_to_char(orb.sys), orb.prn,
+                          state[0] * 1e-3, state[1] * 1e-3, state[2] * 1e-3,
+                          clock * 1e6);
+      } else {
+        n = std::snprintf(line, sizeof line, "P%c%02d%14.6f%14.6f%14.6f%14.6f",
+                          ngpt::satsys_to_char(orb.sys), orb.prn, 0e0, 0e0,
+                          0e0, 999999.999999e0);
+      }
+      std::memset(line + n, ' ', 80 - n);
+      line[80] = '\0';
+      err |= std::fprintf(fp, "%s\n", line) < 0;
+    }
+  }
+  err |= std::fputs("EOF\n", fp) == EOF;
+
+  err |= (std::fclose(fp) != 0);
+  return err ? 2 : 0;
+}
+
+/// Epochs are in GPS time, at obs_rate in [start, start+duration); a
+/// satellite is written if it is above the elevation mask. All observables
+/// are computed from the light-time corrected range and clocks (the
+/// receiver clock is common to all systems):
+/// * code: range + c*(dtr-dts) + tropo + iono + noise (0.3 m)
+/// * phase: (range + c*(dtr-dts) + tropo - iono)/lambda + ambiguity + noise
+///   (0.002 cycles)
+/// * Doppler: the negated rate of (range + c*(dtr-dts)) over lambda,
+///   differenced over +/-0.5 sec
+/// * signal strength: 30 + 20*sin(elevation) dBHz.
+/// The ionospheric delay is the Klobuchar delay scaled to each frequency.
+/// All buffers (including the one for the records of an epoch, sized for all
+/// satellites) are allocated before the file is opened.
+/// @return 0 on success; 1 if the file cannot be opened, 2 on a write error,
+///         3 for an invalid station, 4 on allocation failure
+int SyntheticGenerator::write_obs(const char *fn, int station) const
+    noexcept {
+  if (station < 0 || station >= cfg_.num_stations)
+    return 3;
+
+  constexpr double c = ngpt::geometry::speed_of_light;
+  const long long us_per_sec = 1000000LL;
+  const long long num_epochs = static_cast<long long>(
+      std::ceil(cfg_.duration * cfg_.obs_rate - 1e-9));
+  const int num_sats = static_cast<int>(orbits_.size());
+
+  double xyz[3];
+  station_position(station, xyz);
+  const ngpt::StationGeometry sta(xyz[0], xyz[1], xyz[2]);
+  const ngpt::Saastamoinen tropo(ngpt::standard_atmosphere(sta.height()),
+                                 sta.latitude(), sta.height());
+  const ngpt::Klobuchar iono(SATELLITE_SYSTEM::gps, KLB_ALPHA, KLB_BETA,
+                             sta.latitude(), sta.longitude());
+  const double dtr0 = 2e-4 * (uniform(cfg_.seed, 0x5354ULL, station) - 0.5e0);
+  const double dtr1 = 1e-10;
+
+  // per satellite and epoch: id (3 chars), 16 chars per observable, newline
+  std::size_t max_obs = 0;
+  for (const auto &con : cfg_.constellations)
+    max_obs = std::max(max_obs, con.observables.size());
+  std::string marker;
+  std::vector<int> glo;
+  std::vector<char> records;
+  try {
+    marker = marker_name(station);
+    for (int s = 0; s < num_sats; s++)
+      if (orbits_[s].sys == SATELLITE_SYSTEM::glonass)
+        glo.push_back(s);
+    records.resize(num_sats * (4 + 16 * max_obs) + 1);
+  } catch (std::exception &) {
+    return 4;
+  }
+
+  std::FILE *fp = std::fopen(fn, "w");
+  if (!fp)
+    return 1;
+
+  // header
+  int y, m, d;
+  mjd2ymd(start_mjd_, y, m, d);
+  char buf[96];
+  int err = 0;
+  std::snprintf(buf, sizeof buf, "%9.2f%11s%-20s%-20s", 3.04, "",
+                "OBSERVATION DATA", "M");
+  err |= header_line(fp, buf, "RINEX VERSION / TYPE");
+  std::snprintf(buf, sizeof buf, "%-20s%-20s%04d%02d%02d 000000 GPS",
+                "synthetic", "ngpt", y, m, d);
+  err |= header_line(fp, buf, "PGM / RUN BY / DATE");
+  err |= header_line(fp, marker.c_str(), "MARKER NAME");
+  err |= header_line(fp, marker.c_str(), "MARKER NUMBER");
+  std::snprintf(buf, sizeof buf, "%-20s%-40s", "synthetic", "ngpt");
+  err |= header_line(fp, buf, "OBSERVER / AGENCY");
+  std::snprintf(buf, sizeof buf, "%-20s%-20s%-20s", "0", "SYNTHETIC", "1.0");
+  err |= header_line(fp, buf, "REC # / TYPE / VERS");
+  std::snprintf(buf, sizeof buf, "%-20s%-16s%-4s", "0", "SYNTHETIC", "NONE");
+  err |= header_line(fp, buf, "ANT # / TYPE");
+  std::snprintf(buf, sizeof buf, "%14.4f%14.4f%14.4f", xyz[0], xyz[1],
+                xyz[2]);
+  err |= header_line(fp, buf, "APPROX POSITION XYZ");
+  std::snprintf(buf, sizeof buf, "%14.4f%14.4f%14.4f", 0e0, 0e0, 0e0);
+  err |= header_line(fp, buf, "ANTENNA: DELTA H/E/N");
+  for (const auto &con : cfg_.constellations) {
+    const int n = static_cast<int>(con.observables.size());
+    int len = std::snprintf(buf, sizeof buf, "%c  %3d",
+                            ngpt::satsys_to_char(con.sys), n);
+    for (int i = 0; i < n; i++) {
+      if (i && i % 13 == 0) {
+        err |= header_line(fp, buf, "SYS / # / OBS TYPES");
+        len = std::snprintf(buf, sizeof buf, "      ");
+      }
+      len += std::snprintf(buf + len, sizeof buf - len, " %3s",
+                           con.observables[i].c_str());
+    }
+    err |= header_line(fp, buf, "SYS / # / OBS TYPES");
+  }
+  if (!glo.empty()) {
+    int len = std::snprintf(buf, sizeof buf, "%3d ",
+                            static_cast<int>(glo.size()));
+    for (std::size_t i = 0; i < glo.size(); i++) {
+      if (i && i % 8 == 0) {
+        err |= header_line(fp, buf, "GLONASS SLOT / FRQ #");
+        len = std::snprintf(buf, sizeof buf, "    ");
+      }
+      len += std::snprintf(buf + len, sizeof buf - len, "R%02d %2d ",
+                           orbits_[glo[i]].prn, orbits_[glo[i]].channel);
+    }
+    err |= header_line(fp, buf, "GLONASS SLOT / FRQ #");
+  }
+  std::snprintf(buf, sizeof buf, "%10.3f", 1e0 / cfg_.obs_rate);
+  err |= header_line(fp, buf, "INTERVAL");
+  std::snprintf(buf, sizeof buf, "%6d%6d%6d%6d%6d%13.7f     GPS", y, m, d, 0,
+                0, 0e0);
+  err |= header_line(fp, buf, "TIME OF FIRST OBS");
+  err |= header_line(fp, "", "END OF HEADER");
+
+  // observations
+  const double mask = cfg_.elevation_mask * D2R;
+  double state[6], unit[3], clock, tau, az, el;
+  for (long long e = 0; e < num_epochs && !err; e++) {
+    // epoch as (integer) microseconds since the start, in GPS time
+    const long long us = static_cast<long long>(
+        std::llround(static_cast<double>(e) * 1e6 / cfg_.obs_rate));
+    const double t = static_cast<double>(us) * 1e-6;
+    const double dtr = dtr0 + dtr1 * t;
+    std::size_t nrec = 0;
+    int visible = 0;
+    for (int s = 0; s < num_sats; s++) {
+      const auto &orb = orbits_[s];
+      const auto &con = cfg_.constellations[orb.constellation];
+      const long long us_sys =
+          us + time_offset(orb.sys, cfg_.leap_seconds) * us_per_sec;
+      const long idx = message_index(s, static_cast<double>(us_sys) * 1e-6);
+      if (idx < 0)
+        continue;
+      const long long days =
+          (us_sys >= 0) ? us_sys / (86400LL * us_per_sec)
+                        : -((-us_sys + 86400LL * us_per_sec - 1) /
+                            (86400LL * us_per_sec));
+      const ngpt::datetime<ngpt::microseconds> t_rx{
+          ngpt::modified_julian_day(start_mjd_ + static_cast<long>(days)),
+          ngpt::microseconds(
+              static_cast<long>(us_sys - days * 86400LL * us_per_sec))};
+      const NavDataFrame &nav = msgs_[idx];
+      if (sta.transmit_state(nav, t_rx, state, clock, tau))
+        continue;
+      const double rho = sta.line_of_sight(state, unit, az, el);
+      if (el < mask)
+        continue;
+      const double geo = rho + c * (dtr - clock);
+      const double trp = tropo.slant_delay(PI / 2e0 - el);
+      const double ion = iono.slant_delay(
+          std::fmod(static_cast<double>(us) * 1e-6, 86400e0), az, el);
+
+      // range rate (with clocks), only if a Doppler is to be written
+      double rate = 0e0;
+      if (std::any_of(con.observables.begin(), con.observables.end(),
+                      [](const std::string &o) { return o[0] == 'D'; })) {
+        double sp[6], sm[6], cp, cm, tp, tm;
+        auto tp_rx = t_rx, tm_rx = t_rx;
+        tp_rx.add_seconds(ngpt::microseconds(500000L));
+        tm_rx.remove_seconds(ngpt::microseconds(500000L));
+        if (sta.transmit_state(nav, tp_rx, sp, cp, tp) ||
+            sta.transmit_state(nav, tm_rx, sm, cm, tm))
+          continue;
+        rate = (sta.range(sp) - sta.range(sm)) + c * (dtr1 - (cp - cm));
+      }
+
+      nrec += std::snprintf(records.data() + nrec, records.size() - nrec,
+                            "%c%02d", ngpt::satsys_to_char(orb.sys), orb.prn);
+      const std::uint64_t sat_id =
+          (static_cast<std::uint64_t>(orb.sys) << 8) | orb.prn;
+      const double snr = 30e0 + 20e0 * std::sin(el);
+      const int ssi = std::min(9, std::max(1, static_cast<int>(snr / 6e0)));
+      for (std::size_t j = 0; j < con.observables.size(); j++) {
+        const double f = freqs_[orb.first_freq + j];
+        const double lambda = c / (f * 1e6);
+        const double ion_f = ion * iono.scale_to(f);
+        double val = 0e0;
+        switch (con.observables[j][0]) {
+        case 'C':
+          val = geo + trp + ion_f +
+                0.3e0 * normal(cfg_.seed, sat_id, station, j, e);
+          break;
+        case 'L': {
+          const double amb = std::floor(
+              2e6 * (uniform(cfg_.seed, sat_id, station, j, 0xa3bULL) -
+                     0.5e0));
+          val = (geo + trp - ion_f) / lambda + amb +
+                2e-3 * normal(cfg_.seed, sat_id, station, j, e);
+        } break;
+        case 'D':
+          val = -rate / lambda +
+                1e-2 * normal(cfg_.seed, sat_id, station, j, e);
+          break;
+        default:
+          val = snr + 0.25e0 * normal(cfg_.seed, sat_id, station, j, e);
+          break;
+        }
+        if (std::abs(val) < 1e9)
+          nrec += std::snprintf(records.data() + nrec, records.size() - nrec,
+                                "%14.3f %1d", val, ssi);
+        else
+          nrec += std::snprintf(records.data() + nrec, records.size() - nrec,
+                                "%16s", "");
+      }
+      records[nrec++] = '\n';
+      ++visible;
+    }
+
+    long mjd, sod;
+    split_day(start_mjd_, static_cast<long>(us / us_per_sec), mjd, sod);
+    mjd2ymd(mjd, y, m, d);
+    const double sec = static_cast<double>(sod % 60L) +
+                       static_cast<double>(us % us_per_sec) * 1e-6;
+    err |= std::fprintf(fp, "> %4d %02d %02d %02ld %02ld%11.7f  0%3d\n", y, m,
+                        d, sod / 3600L, (sod % 3600L) / 60L, sec,
+                        visible) < 0;
+    err |= std::fwrite(records.data(), 1, nrec, fp) != nrec;
+  }
+
+  err |= (std::fclose(fp) != 0);
+  return err ? 2 : 0;
+}
@@ -0,0 +1,141 @@
+#ifndef __GNSS_SYNTHETIC_HPP__
+#define __GNSS_SYNTHETIC_HPP__
+
+/// @file     synthetic.hpp
+///
+/// @brief    Deterministic synthetic data sets: navigation RINEX v3.04,
+///           observation RINEX v3.04 and Sp3-c files of arbitrary size,
+///           for testing and benchmarking without real data.
+///
+/// @details  A SyntheticGenerator first builds a set of broadcast messages
+///           (NavDataFrame instances) for nominal constellations:
+///           * GPS, Galileo and BeiDou (MEO) satellites on near circular
+///             orbits; consecutive messages of a satellite describe the same
+///             Keplerian orbit (and clock polynomial), so that orbits are
+///             continuous across messages,
+///           * GLONASS state vectors (PZ90, at tb); the first one of a
+///             satellite is taken from a circular orbit and each next one
+///             is the (integrated) state of the previous message.
+///           Everything else is derived from these messages with the
+///           library's own models, so that all files are self-consistent:
+///           Sp3 orbits and clocks are NavDataFrame::stateNclock values and
+///           observations are computed from the light-time corrected
+///           geometry (StationGeometry::transmit_state), the Saastamoinen
+///           troposphere and the Klobuchar ionosphere (with the coefficients
+///           written to the navigation header), plus a receiver clock,
+///           carrier phase ambiguities and small noise.
+///
+///           All values are a function of the configuration (including the
+///           seed) only; the same configuration always gives identical
+///           files. Epochs are in GPS time (GLONASS messages in UTC, BeiDou
+///           messages in BDT).
+
+#include "navrnx.hpp"
+#include "satsys.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ngpt {
+
+/// A constellation of a synthetic data set.
+struct SyntheticConstellation {
+  SATELLITE_SYSTEM sys;                 ///< GPS, GLONASS, Galileo or BeiDou
+  int num_sats;                         ///< Number of satellites (PRN 1..n)
+  std::vector<std::string> observables; ///< RINEX 3 observation codes, e.g.
+                                        ///< "C1C", "L1C", "D1C", "S1C"
+};
+
+/// @brief Nominal constellation (number of satellites and a typical list of
+///        observables) of a satellite system
+/// @throw std::runtime_error if the system is not supported
+SyntheticConstellation nominal_constellation(SATELLITE_SYSTEM sys);
+
+/// Configuration of a synthetic data set.
+struct SyntheticConfig {
+  int year{2020};   ///< Start date (at 00:00:00 GPS time)
+  int month{1};     ///< Start month
+  int day{1};       ///< Start day of month
+  double duration{3600e0};     ///< Duration in seconds
+  double obs_rate{1e0};        ///< Observation rate in Hz (1 to 50)
+  double sp3_interval{900e0};  ///< Sp3 interval in seconds
+  int num_stations{1};         ///< Number of stations
+  double elevation_mask{5e0};  ///< Elevation mask in degrees
+  int leap_seconds{18};        ///< GPS minus UTC in seconds
+  unsigned long seed{1};       ///< Seed for all synthetic values
+  std::vector<SyntheticConstellation> constellations; ///< Systems to use
+};
+
+/// @class SyntheticGenerator
+/// Generate synthetic navigation, observation and Sp3 files.
+class SyntheticGenerator {
+public:
+  /// @brief Constructor; validate the configuration and build the
+  ///        navigation messages
+  explicit SyntheticGenerator(const SyntheticConfig &cfg);
+
+  /// @brief The broadcast messages, sorted by system, PRN and ToC
+  const std::vector<NavDataFrame> &messages() const noexcept {
+    return msgs_;
+  }
+
+  /// @brief Number of stations
+  int num_stations() const noexcept { return cfg_.num_stations; }
+
+  /// @brief Marker name of a station
+  std::string marker_name(int station) const;
+
+  /// @brief ECEF coordinates (meters) of a station
+  void station_position(int station, double *xyz) const noexcept;
+
+  /// @brief Write the navigation messages as a navigation RINEX v3.04
+  int write_nav(const char *fn) const noexcept;
+
+  /// @brief Write orbits and clocks of all satellites as an Sp3-c file
+  int write_sp3(const char *fn) const noexcept;
+
+  /// @brief Write the observations of a station as an observation RINEX
+  ///        v3.04
+  int write_obs(const char *fn, int station) const noexcept;
+
+private:
+  /// Orbit of a satellite (nominal elements at the start epoch)
+  struct Orbit {
+    SATELLITE_SYSTEM sys;
+    int prn;
+    double a;      ///< Semi-major axis (m)
+    double e;      ///< Eccentricity
+    double i;      ///< Inclination (rad)
+    double raan;   ///< Right ascension of the ascending node (rad)
+    double omega;  ///< Argument of perigee (rad)
+    double m0;     ///< Mean anomaly (rad)
+    double af0;    ///< Clock bias (sec)
+    double af1;    ///< Clock drift (sec/sec)
+    int channel;   ///< GLONASS frequency channel
+    int constellation;      ///< Index in SyntheticConfig::constellations
+    std::size_t first_freq; ///< Index of the first frequency in freqs_
+  };
+
+  /// @brief Build the navigation messages of a satellite
+  void add_messages(const Orbit &orb);
+
+  /// @brief Index (in msgs_) of the message to use for a satellite at a
+  ///        given time; -1 if none
+  long message_index(int sat, double t) const noexcept;
+
+  SyntheticConfig cfg_;                ///< The configuration
+  long start_mjd_;                     ///< MJD of the start epoch
+  std::vector<Orbit> orbits_;          ///< One per satellite
+  std::vector<NavDataFrame> msgs_;     ///< All messages
+  std::vector<std::size_t> first_msg_; ///< First message (in msgs_) per
+                                       ///< satellite (plus one past the end)
+  std::vector<double> first_ref_;      ///< Reference time of the first
+                                       ///< message per satellite
+  std::vector<double> msg_interval_;   ///< Message interval per satellite
+  std::vector<double> freqs_;          ///< Frequency (MHz) of every
+                                       ///< observable of every satellite
+};                                     // SyntheticGenerator
+
+} // namespace ngpt
+
+#endif
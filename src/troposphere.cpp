@@ -0,0 +1,253 @@
+#include "troposphere.hpp"
+#include "ggeodesy/geodesy.hpp"
+#include <cmath>
+
+using ngpt::Saastamoinen;
+using ngpt::TropoMapping;
+using ngpt::TropoMeteo;
+
+namespace {
+constexpr double D2PI = 2e0 * ngpt::DPI;
+
+/// Latitudes (degrees) of the UNB3 and NMF tables
+constexpr double table_lats[] = {15e0, 30e0, 45e0, 60e0, 75e0};
+
+/// UNB3 average values: P (hPa), T (K), e (hPa), beta (K/m), lambda
+constexpr double unb3_avg[5][5] = {
+    {1013.25e0, 299.65e0, 26.31e0, 6.30e-3, 2.77e0},
+    {1017.25e0, 294.15e0, 21.79e0, 6.05e-3, 3.15e0},
+    {1015.75e0, 283.15e0, 11.66e0, 5.58e-3, 2.57e0},
+    {1011.75e0, 272.15e0, 6.78e0, 5.39e-3, 1.81e0},
+    {1013.00e0, 263.65e0, 4.11e0, 4.53e-3, 1.55e0}};
+
+/// UNB3 seasonal amplitudes: P (hPa), T (K), e (hPa), beta (K/m), lambda
+constexpr double unb3_amp[5][5] = {{0e0, 0e0, 0e0, 0e0, 0e0},
+                                   {-3.75e0, 7.0e0, 8.85e0, 0.25e-3, 0.33e0},
+                                   {-2.25e0, 11.0e0, 7.24e0, 0.32e-3, 0.46e0},
+                                   {-1.75e0, 15.0e0, 5.36e0, 0.81e-3, 0.74e0},
+                                   {-0.50e0, 14.5e0, 3.39e0, 0.62e-3, 0.30e0}};
+
+/// NMF hydrostatic average coefficients a, b, c
+constexpr double nmf_hyd_avg[5][3] = {
+    {1.2769934e-3, 2.9153695e-3, 62.610505e-3},
+    {1.2683230e-3, 2.9152299e-3, 62.837393e-3},
+    {1.2465397e-3, 2.9288445e-3, 63.721774e-3},
+    {1.2196049e-3, 2.9022565e-3, 63.824265e-3},
+    {1.2045996e-3, 2.9024912e-3, 64.258455e-3}};
+
+/// NMF hydrostatic seasonal amplitudes a, b, c
+constexpr double nmf_hyd_amp[5][3] = {
+    {0e0, 0e0, 0e0},
+    {1.2709626e-5, 2.1414979e-5, 9.0128400e-5},
+    {2.6523662e-5, 3.0160779e-5, 4.3497037e-5},
+    {3.4000452e-5, 7.2562722e-5, 84.795348e-5},
+    {4.1202191e-5, 11.723375e-5, 170.37206e-5}};
+
+/// NMF wet coefficients a, b, c
+constexpr double nmf_wet[5][3] = {{5.8021897e-4, 1.4275268e-3, 4.3472961e-2},
+                                  {5.6794847e-4, 1.5138625e-3, 4.6729510e-2},
+                                  {5.8118019e-4, 1.4572752e-3, 4.3908931e-2},
+                                  {5.9727542e-4, 1.5007428e-3, 4.4626982e-2},
+                                  {6.1641693e-4, 1.7599082e-3, 5.4736038e-2}};
+
+/// Height correction coefficients a, b, c (Niell, 1996)
+constexpr double height_corr[3] = {2.53e-5, 5.49e-3, 1.14e-3};
+
+/// Interpolate linearly (in latitude) a row of N values from a table with
+/// rows at latitudes 15, 30, 45, 60 and 75 degrees.
+/// @param[in]  table The table
+/// @param[in]  lat   Absolute latitude in degrees
+/// @param[out] out   Interpolated values (N)
+template <int N>
+void lat_interpolate(const double (&table)[5][N], double lat,
+                     double *out) noexcept {
+  if (lat <= table_lats[0]) {
+    for (int i = 0; i < N; i++)
+      out[i] = table[0][i];
+  } else if (lat >= table_lats[4]) {
+    for (int i = 0; i < N; i++)
+      out[i] = table[4][i];
+  } else {
+    int j = static_cast<int>((lat - table_lats[0]) / 15e0);
+    double f = (lat - table_lats[j]) / 15e0;
+    for (int i = 0; i < N; i++)
+      out[i] = table[j][i] + (table[j + 1][i] - table[j][i]) * f;
+  }
+}
+
+/// cos of the seasonal phase, i.e. cos(2pi*(doy-28)/365.25); for the
+/// southern hemisphere, half a year is added to doy.
+inline double seasonal_cos(double lat, double doy) noexcept {
+  if (lat < 0e0)
+    doy += 365.25e0 / 2e0;
+  return std::cos(D2PI * (doy - 28e0) / 365.25e0);
+}
+
+/// Continued fraction form (Marini), normalized to 1 at zenith.
+inline double cfrac(double s, double a, double b, double c) noexcept {
+  return (1e0 + a / (1e0 + b / (1e0 + c))) / (s + a / (s + b / (s + c)));
+}
+} // namespace
+
+/// @details Reference values are: pressure 1013.25 hPa, temperature 18
+///          Celsius and relative humidity 50% at sea level; see the Bernese
+///          GNSS Software manual, p. 188.
+TropoMeteo ngpt::standard_atmosphere(double hgt) noexcept {
+  constexpr double pr = 1013.25e0;
+  constexpr double hr = 0e0;
+  constexpr double Tr = 291.15e0;
+  constexpr double Rr = 50e0;
+  TropoMeteo meteo;
+  meteo.pressure = pr * std::pow(1e0 - 0.0000226e0 * (hgt - hr), 5.225e0);
+  meteo.temperature = Tr - 0.0065e0 * (hgt - hr);
+  const double rh = Rr * std::exp(-0.0006396e0 * (hgt - hr));
+  const double T = meteo.temperature;
+  meteo.wvp = (rh / 100e0) *
+              std::exp(-37.2465e0 + 0.213166e0 * T - 0.000256908e0 * T * T);
+  return meteo;
+}
+
+/// @details The mean values and seasonal amplitudes are interpolated in
+///          latitude from the UNB3 tables (Collins and Langley, 1997) and
+///          reduced to the site's height using the temperature lapse rate
+///          and water vapour decrease factor.
+TropoMeteo ngpt::empirical_atmosphere(double lat, double hgt,
+                                      double doy) noexcept {
+  constexpr double g = 9.80665e0;
+  constexpr double Rd = 287.054e0;
+  double avg[5], amp[5];
+  const double alat = ngpt::rad2deg(std::abs(lat));
+  lat_interpolate(unb3_avg, alat, avg);
+  lat_interpolate(unb3_amp, alat, amp);
+  const double cosphs = seasonal_cos(lat, doy);
+  const double P0 = avg[0] - amp[0] * cosphs;
+  const double T0 = avg[1] - amp[1] * cosphs;
+  const double e0 = avg[2] - amp[2] * cosphs;
+  const double beta = avg[3] - amp[3] * cosphs;
+  const double lambda = avg[4] - amp[4] * cosphs;
+  const double x = 1e0 - beta * hgt / T0;
+  const double ep = g / (Rd * beta);
+  TropoMeteo meteo;
+  meteo.temperature = T0 - beta * hgt;
+  meteo.pressure = P0 * std::pow(x, ep);
+  meteo.wvp = e0 * std::pow(x, ep * (lambda + 1e0));
+  return meteo;
+}
+
+/// @details All site-dependent terms are computed here; the zenith delays
+///          follow Saastamoinen (1972), with the gravity correction of
+///          Davis et al (1985) for the hydrostatic part.
+Saastamoinen::Saastamoinen(const TropoMeteo &meteo, double lat,
+                           double hgt) noexcept {
+  const double wet = (1255e0 / meteo.temperature + 0.05e0) * meteo.wvp;
+  fac_ = 0.002277e0 * (meteo.pressure + wet);
+  zhd_ = 0.0022768e0 * meteo.pressure /
+         (1e0 - 0.00266e0 * std::cos(2e0 * lat) - 0.28e-6 * hgt);
+  zwd_ = 0.002277e0 * wet;
+}
+
+double Saastamoinen::slant_delay(double zenith) const noexcept {
+  double cosz = std::cos(zenith);
+  double out;
+  slant_delay_cosz(&cosz, 1, &out);
+  return out;
+}
+
+void Saastamoinen::slant_delay(const double *zenith, std::size_t n,
+                               double *out) const noexcept {
+  for (std::size_t i = 0; i < n; i++)
+    out[i] = std::cos(zenith[i]);
+  slant_delay_cosz(out, n, out);
+}
+
+/// @details tan^2(z) is computed as 1/cos^2(z) - 1, so that only one
+///          trigonometric number is needed per satellite.
+void Saastamoinen::slant_delay_cosz(const double *cosz, std::size_t n,
+                                    double *out) const noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    const double c = cosz[i];
+    const double tanz2 = 1e0 / (c * c) - 1e0;
+    out[i] = (fac_ - 0.002277e0 * tanz2) / c;
+  }
+}
+
+TropoMapping::TropoMapping(const double *ah, const double *aw,
+                           double hgt) noexcept
+    : hkm_(hgt * 1e-3) {
+  for (int i = 0; i < 3; i++) {
+    ah_[i] = ah[i];
+    aw_[i] = aw[i];
+  }
+}
+
+double TropoMapping::hydrostatic(double sinel) const noexcept {
+  double mh, mw;
+  map(&sinel, 1, &mh, &mw);
+  return mh;
+}
+
+double TropoMapping::wet(double sinel) const noexcept {
+  return cfrac(sinel, aw_[0], aw_[1], aw_[2]);
+}
+
+void TropoMapping::map(const double *sinel, std::size_t n, double *mh,
+                       double *mw) const noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    const double s = sinel[i];
+    const double dm =
+        (1e0 / s - cfrac(s, height_corr[0], height_corr[1], height_corr[2])) *
+        hkm_;
+    mh[i] = cfrac(s, ah_[0], ah_[1], ah_[2]) + dm;
+    mw[i] = cfrac(s, aw_[0], aw_[1], aw_[2]);
+  }
+}
+
+void TropoMapping::slant_delay(const double *sinel, std::size_t n, double zhd,
+                               double zwd, double *out) const noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    const double s = sinel[i];
+    const double dm =
+        (1e0 / s - cfrac(s, height_corr[0], height_corr[1], height_corr[2])) *
+        hkm_;
+    out[i] = zhd * (cfrac(s, ah_[0], ah_[1], ah_[2]) + dm) +
+             zwd * cfrac(s, aw_[0], aw_[1], aw_[2]);
+  }
+}
+
+/// @details See Niell (1996); the coefficients are interpolated in latitude
+///          and the seasonal term is computed for the given day of year.
+TropoMapping ngpt::niell_mapping(double lat, double hgt, double doy) noexcept {
+  double avg[3], amp[3], ah[3], aw[3];
+  const double alat = ngpt::rad2deg(std::abs(lat));
+  lat_interpolate(nmf_hyd_avg, alat, avg);
+  lat_interpolate(nmf_hyd_amp, alat, amp);
+  lat_interpolate(nmf_wet, alat, aw);
+  const double cosphs = seasonal_cos(lat, doy);
+  for (int i = 0; i < 3; i++)
+    ah[i] = avg[i] - amp[i] * cosphs;
+  return TropoMapping(ah, aw, hgt);
+}
+
+/// @details See Boehm et al (2006); b and c coefficients as in the VMF1
+///          (site-wise) formulation.
+TropoMapping ngpt::vmf1_mapping(double ah, double aw, double lat, double hgt,
+                                double doy) noexcept {
+  constexpr double c0 = 0.062e0;
+  double c10, c11, psi;
+  if (lat < 0e0) {
+    c10 = 0.002e0;
+    c11 = 0.007e0;
+    psi = ngpt::DPI;
+  } else {
+    c10 = 0.001e0;
+    c11 = 0.005e0;
+    psi = 0e0;
+  }
+  const double ch =
+      c0 + ((std::cos(D2PI * (doy - 28e0) / 365.25e0 + psi) + 1e0) * c11 / 2e0 +
+            c10) *
+               (1e0 - std::cos(lat));
+  const double hyd[] = {ah, 0.0029e0, ch};
+  const double wet[] = {aw, 0.00146e0, 0.04391e0};
+  return TropoMapping(hyd, wet, hgt);
+}
@@ -0,0 +1,147 @@
+#ifndef __GNSS_TROPOSPHERE_HPP__
+#define __GNSS_TROPOSPHERE_HPP__
+
+/// @file     troposphere.hpp
+///
+/// @brief    Tropospheric delay models: meteorological parameters from a
+///           standard or an empirical (GPT-style) atmosphere, the
+///           Saastamoinen model and continued-fraction mapping functions
+///           (Niell, VMF1-like).
+///
+/// @details  All models are split in a site part and an epoch/satellite
+///           part. Site terms (e.g. meteorological values, zenith delays,
+///           mapping function coefficients) are computed once, at
+///           construction. The batch functions evaluate the model for all
+///           satellites of an epoch into caller-provided buffers; they take
+///           cos(zenith) (aka sin(elevation)) as input and their loops hold
+///           no branches and no transcendental function calls, so that they
+///           can be auto-vectorized by the compiler.
+
+#include <cstddef>
+
+namespace ngpt {
+
+/// @brief Meteorological parameters at a site.
+struct TropoMeteo {
+  double pressure{0e0};    ///< Total pressure in hPa
+  double temperature{0e0}; ///< Temperature in Kelvin
+  double wvp{0e0};         ///< Water vapour partial pressure in hPa
+};
+
+/// @brief Meteorological parameters from the standard atmosphere (Berg), as
+///        used in the Bernese GNSS Software.
+/// @param[in] hgt Height above the sea level in meters
+TropoMeteo standard_atmosphere(double hgt) noexcept;
+
+/// @brief Meteorological parameters from an empirical, latitude and season
+///        dependent, atmosphere model (UNB3 tables).
+/// @param[in] lat Latitude in radians
+/// @param[in] hgt Height above the sea level in meters
+/// @param[in] doy Day of year (may be fractional)
+TropoMeteo empirical_atmosphere(double lat, double hgt, double doy) noexcept;
+
+/// @class Saastamoinen
+/// The Saastamoinen troposphere model. The slant delay can be computed
+/// directly, as in the Bernese GNSS Software manual (p. 188), i.e.
+/// dT = 0.002277/cos(z) * (P + (1255/T + 0.05) * e - tan^2(z))
+/// or the zenith hydrostatic and wet delays can be used along with a mapping
+/// function.
+class Saastamoinen {
+public:
+  /// @brief Constructor
+  /// @param[in] meteo Meteorological parameters at the site
+  /// @param[in] lat   Latitude in radians
+  /// @param[in] hgt   Ellipsoidal height in meters
+  Saastamoinen(const TropoMeteo &meteo, double lat, double hgt) noexcept;
+
+  /// @brief Zenith hydrostatic delay in meters
+  double zhd() const noexcept { return zhd_; }
+
+  /// @brief Zenith wet delay in meters
+  double zwd() const noexcept { return zwd_; }
+
+  /// @brief Slant delay in meters for a given zenith angle (radians)
+  double slant_delay(double zenith) const noexcept;
+
+  /// @brief Slant delays for n zenith angles (radians)
+  /// @param[in]  zenith Array of n zenith angles in radians
+  /// @param[in]  n      Number of elements
+  /// @param[out] out    Array of (at least) n elements; the slant delays in
+  ///                    meters
+  void slant_delay(const double *zenith, std::size_t n, double *out) const
+      noexcept;
+
+  /// @brief Slant delays for n values of cos(zenith); this is the (branch
+  ///        free) kernel of the model.
+  /// @param[in]  cosz Array of n cos(zenith) values
+  /// @param[in]  n    Number of elements
+  /// @param[out] out  Array of (at least) n elements; the slant delays in
+  ///                  meters
+  void slant_delay_cosz(const double *cosz, std::size_t n, double *out) const
+      noexcept;
+
+private:
+  double fac_; ///< 0.002277 * (P + (1255/T + 0.05) * e)
+  double zhd_; ///< Zenith hydrostatic delay in meters
+  double zwd_; ///< Zenith wet delay in meters
+}; // Saastamoinen
+
+/// @class TropoMapping
+/// A mapping function of the continued fraction form (Marini, Herring), for
+/// the hydrostatic and wet components; the coefficients are computed once per
+/// site (and day), see niell_mapping and vmf1_mapping.
+class TropoMapping {
+public:
+  /// @brief Constructor from coefficients
+  /// @param[in] ah  Hydrostatic coefficients a, b, c
+  /// @param[in] aw  Wet coefficients a, b, c
+  /// @param[in] hgt Ellipsoidal height in meters; used for the hydrostatic
+  ///                height correction (Niell, 1996)
+  TropoMapping(const double *ah, const double *aw, double hgt) noexcept;
+
+  /// @brief Hydrostatic mapping for a given sin(elevation)
+  double hydrostatic(double sinel) const noexcept;
+
+  /// @brief Wet mapping for a given sin(elevation)
+  double wet(double sinel) const noexcept;
+
+  /// @brief Hydrostatic and wet mapping for n values of sin(elevation), aka
+  ///        cos(zenith)
+  /// @param[in]  sinel Array of n sin(elevation) values
+  /// @param[in]  n     Number of elements
+  /// @param[out] mh    Array of (at least) n elements; hydrostatic mapping
+  /// @param[out] mw    Array of (at least) n elements; wet mapping
+  void map(const double *sinel, std::size_t n, double *mh, double *mw) const
+      noexcept;
+
+  /// @brief Slant delays in meters given zenith hydrostatic and wet delays,
+  ///        for n values of sin(elevation)
+  void slant_delay(const double *sinel, std::size_t n, double zhd, double zwd,
+                   double *out) const noexcept;
+
+private:
+  double ah_[3]; ///< Hydrostatic coefficients a, b, c
+  double aw_[3]; ///< Wet coefficients a, b, c
+  double hkm_;   ///< Height in km (for the height correction)
+}; // TropoMapping
+
+/// @brief Niell Mapping Function (NMF) for a site
+/// @param[in] lat Latitude in radians
+/// @param[in] hgt Ellipsoidal height in meters
+/// @param[in] doy Day of year (may be fractional)
+TropoMapping niell_mapping(double lat, double hgt, double doy) noexcept;
+
+/// @brief VMF1-like mapping function for a site; the 'a' coefficients are
+///        given (e.g. from a VMF1 grid), the 'b' and 'c' coefficients are
+///        computed as in VMF1 (Boehm et al, 2006).
+/// @param[in] ah  Hydrostatic coefficient a
+/// @param[in] aw  Wet coefficient a
+/// @param[in] lat Latitude in radians
+/// @param[in] hgt Ellipsoidal height in meters
+/// @param[in] doy Day of year (may be fractional)
+TropoMapping vmf1_mapping(double ah, double aw, double lat, double hgt,
+                          double doy) noexcept;
+
+} // namespace ngpt
+
+#endif
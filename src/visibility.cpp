@@ -0,0 +1,35 @@
+#include "visibility.hpp"
+
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::VisibilityPlanner;
+
+/// Windows are few per satellite (at most a handful per day), so a linear
+/// search is used.
+bool VisibilityPlanner::visible(SATELLITE_SYSTEM sys, int prn, double t) const
+    noexcept {
+  const int idx = index(sys, prn);
+  if (idx < 0 || !planned_[idx])
+    return true;
+  for (const auto &w : windows_[idx]) {
+    if (t < w.rise)
+      return false;
+    if (t <= w.set)
+      return true;
+  }
+  return false;
+}
+
+const std::vector<VisibilityPlanner::Window> &
+VisibilityPlanner::windows(SATELLITE_SYSTEM sys, int prn) const {
+  return windows_.at(static_cast<std::size_t>(index(sys, prn)));
+}
+
+void VisibilityPlanner::add_window(int idx, double rise, double set) {
+  auto &wins = windows_[idx];
+  rise -= pad_;
+  set += pad_;
+  if (!wins.empty() && rise <= wins.back().set)
+    wins.back().set = set;
+  else
+    wins.push_back({rise, set});
+}
@@ -0,0 +1,233 @@
+#ifndef __GNSS_VISIBILITY_HPP__
+#define __GNSS_VISIBILITY_HPP__
+
+/// @file     visibility.hpp
+///
+/// @brief    Prediction of satellite rise/set windows above an elevation
+///           mask, for a (static) station over a session.
+///
+/// @details  The elevation of every satellite is sampled at a coarse step
+///           (e.g. 5 minutes) over the session; whenever the elevation
+///           crosses the mask between two samples, the crossing time is
+///           refined by bisection. The resulting windows are padded by a
+///           margin (a minute by default), so that the planner errs on the side of "visible"
+///           (the exact elevation check should still be performed on the
+///           visible satellites). Satellites never added to the planner are
+///           always reported as visible.
+///
+///           A satellite is planned from all of its messages; every sample
+///           uses the message with the closest ToE, and is only computed if
+///           that ToE is within max_propagation seconds. Times not covered
+///           by any message are taken as visible. Keplerian messages are
+///           good to a few km for a day, but GLONASS and SBAS messages are
+///           state vectors to be propagated for minutes (GLONASS
+///           messages are issued every 30 min and flagged, status -1, more
+///           than 15 min away from ToE); hence their much shorter span.
+///
+///           Coarse orbit samples are computed without light-time or Earth
+///           rotation corrections; the errors introduced are well below the
+///           resolution needed here.
+
+#include "geometry.hpp"
+#include "ggdatetime/dtcalendar.hpp"
+#include "satid.hpp"
+#include "satsys.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ngpt {
+
+/// @class VisibilityPlanner
+/// Rise/set windows of satellites above an elevation mask for a station.
+class VisibilityPlanner {
+public:
+  /// Max PRN per satellite system
+  static constexpr int max_prn{SatId::max_prn};
+  /// Number of satellite systems (excluding mixed)
+  static constexpr int num_systems{SatId::num_systems};
+  /// Rise/set times are refined to this tolerance (seconds)
+  static constexpr double crossing_tolerance{1e0};
+
+  /// A visibility window in seconds since the start of the session
+  struct Window {
+    double rise; ///< Start of window (seconds since session start)
+    double set;  ///< End of window (seconds since session start)
+  };
+
+  /// @brief Constructor
+  /// @param[in] sta      The station
+  /// @param[in] mask     Elevation mask in radians
+  /// @param[in] start    Start of the session
+  /// @param[in] duration Duration of the session in seconds
+  /// @param[in] step     Sampling step in seconds; passes shorter than this
+  ///                     may be missed
+  /// @param[in] pad      Windows are widened by pad seconds on each side
+  template <typename T>
+  VisibilityPlanner(const StationGeometry &sta, double mask,
+                    const ngpt::datetime<T> &start, double duration,
+                    double step = 300e0, double pad = 60e0)
+      : sta_(sta), mask_(mask),
+        start_(start.template cast_to<ngpt::microseconds>()),
+        start_mjd_(start.mjd().as_underlying_type()),
+        start_sec_(start.sec().to_fractional_seconds()), duration_(duration),
+        step_(step), pad_(pad), planned_(max_prn * num_systems, false),
+        windows_(max_prn * num_systems) {}
+
+  /// @brief Dense index of a satellite; -1 if out of range
+  static int index(SATELLITE_SYSTEM sys, int prn) noexcept {
+    return SatId::index(sys, prn);
+  }
+
+  /// @brief Max time (seconds) a message is propagated away from its ToE
+  ///        while planning
+  static double max_propagation(SATELLITE_SYSTEM sys) noexcept {
+    return (sys == SATELLITE_SYSTEM::glonass || sys == SATELLITE_SYSTEM::sbas)
+               ? 1800e0
+               : 86400e0;
+  }
+
+  /// @brief Compute the visibility windows of a satellite from one message
+  /// @see add_satellite(const Nav *const *, std::size_t)
+  template <typename Nav> int add_satellite(const Nav &nav) {
+    const Nav *msg = &nav;
+    return add_satellite(&msg, 1);
+  }
+
+  /// @brief Compute the visibility windows of a satellite from its messages
+  ///
+  /// Nav can be any type providing system(), prn(), toe<T>() and
+  /// stateNclock(t, state, clock, offset) (e.g. NavDataFrame). All n
+  /// messages must be of the same satellite, in any order. Previously
+  /// computed windows for the satellite are replaced. A negative status of
+  /// stateNclock (e.g. a GLONASS message used more than 15 min from its
+  /// ToE) is only a warning; the orbit is used.
+  /// @return 0 on success; else the satellite is not planned (and thus always
+  ///         reported as visible) and the status of the failed orbit
+  ///         evaluation (or -1 if the satellite is out of range, or the
+  ///         messages are of different satellites) is returned
+  template <typename Nav>
+  int add_satellite(const Nav *const *msgs, std::size_t n) {
+    if (!n)
+      return -1;
+    const SATELLITE_SYSTEM sys = msgs[0]->system();
+    const int prn = msgs[0]->prn();
+    const int idx = index(sys, prn);
+    if (idx < 0)
+      return -1;
+    planned_[idx] = false;
+    auto &wins = windows_[idx];
+    wins.clear();
+
+    // ToE of every message, in seconds since the session start
+    std::vector<double> toe(n);
+    for (std::size_t i = 0; i < n; i++) {
+      if (msgs[i]->system() != sys || msgs[i]->prn() != prn)
+        return -1;
+      const auto t = msgs[i]->template toe<ngpt::seconds>();
+      toe[i] = t.sec().to_fractional_seconds() - start_sec_ +
+               86400e0 * static_cast<double>(t.mjd().as_underlying_type() -
+                                             start_mjd_);
+    }
+    const double max_dt = max_propagation(sys);
+
+    int status = 0;
+    auto f = [&](double t) -> double {
+      std::size_t k = 0;
+      for (std::size_t i = 1; i < n; i++)
+        if (std::abs(t - toe[i]) < std::abs(t - toe[k]))
+          k = i;
+      // not covered by any message; take it as visible
+      if (std::abs(t - toe[k]) > max_dt)
+        return 1e0;
+      double state[6], clock, unit[3], az, el;
+      if (int j = msgs[k]->stateNclock(start_, state, clock, t); j > 0) {
+        status = j;
+        return 0e0;
+      }
+      sta_.line_of_sight(state, unit, az, el);
+      return el - mask_;
+    };
+
+    double t0 = 0e0;
+    double f0 = f(t0);
+    double rise = 0e0;
+    bool up = (f0 >= 0e0);
+    while (t0 < duration_ && !status) {
+      const double t1 = std::min(t0 + step_, duration_);
+      const double f1 = f(t1);
+      if ((f1 >= 0e0) != up) {
+        // bisect for the crossing
+        double a = t0, b = t1;
+        while (b - a > crossing_tolerance && !status) {
+          const double m = 0.5e0 * (a + b);
+          if ((f(m) >= 0e0) == up)
+            a = m;
+          else
+            b = m;
+        }
+        if (up)
+          add_window(idx, rise, b);
+        else
+          rise = a;
+        up = !up;
+      }
+      t0 = t1;
+    }
+    if (status) {
+      wins.clear();
+      return status;
+    }
+    if (up)
+      add_window(idx, rise, duration_);
+    planned_[idx] = true;
+    return 0;
+  }
+
+  /// @brief Is the satellite (predicted to be) above the mask at epoch t?
+  ///        Satellites not planned are always visible.
+  template <typename T>
+  bool visible(SATELLITE_SYSTEM sys, int prn, const ngpt::datetime<T> &t) const
+      noexcept {
+    return visible(sys, prn,
+                   t.sec().to_fractional_seconds() - start_sec_ +
+                       86400e0 *
+                           static_cast<double>(t.mjd().as_underlying_type() -
+                                               start_mjd_));
+  }
+
+  /// @brief Is the satellite (predicted to be) above the mask at t seconds
+  ///        since the start of the session?
+  bool visible(SATELLITE_SYSTEM sys, int prn, double t) const noexcept;
+
+  /// @brief True if visibility windows are computed for the satellite
+  bool is_planned(SATELLITE_SYSTEM sys, int prn) const noexcept {
+    const int idx = index(sys, prn);
+    return idx >= 0 && planned_[idx];
+  }
+
+  /// @brief The visibility windows of a satellite (empty if not planned or
+  ///        never above the mask)
+  /// @throw std::out_of_range if the satellite is out of range
+  const std::vector<Window> &windows(SATELLITE_SYSTEM sys, int prn) const;
+
+private:
+  /// @brief Append a (padded) window, merging with the previous one if they
+  ///        overlap
+  void add_window(int idx, double rise, double set);
+
+  StationGeometry sta_;                    ///< The station
+  double mask_;                            ///< Elevation mask (radians)
+  ngpt::datetime<ngpt::microseconds> start_; ///< Start of session
+  long start_mjd_;                         ///< MJD of session start
+  double start_sec_;                       ///< Seconds of day of session start
+  double duration_;                        ///< Session duration (seconds)
+  double step_;                            ///< Sampling step (seconds)
+  double pad_;                             ///< Window padding (seconds)
+  std::vector<bool> planned_;              ///< Planned satellites
+  std::vector<std::vector<Window>> windows_; ///< Windows per satellite
+};                                         // VisibilityPlanner
+
+} // namespace ngpt
+
+#endif
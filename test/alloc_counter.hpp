@@ -0,0 +1,65 @@
+#ifndef __GNSS_TEST_ALLOC_COUNTER_HPP__
+#define __GNSS_TEST_ALLOC_COUNTER_HPP__
+
+/// @file     alloc_counter.hpp
+///
+/// @brief    Global heap allocation counter, for the tests and benchmarks.
+///
+/// @details  With glibc, malloc, calloc and realloc are interposed (and
+///           forwarded to the __libc_ versions), so that allocations not
+///           going through operator new (e.g. Eigen's dynamic matrices,
+///           strdup or the C library itself) are counted too. Elsewhere only
+///           the (replaceable) global operator new is counted.
+///
+/// @warning  The interposers are definitions; include this header in one
+///           translation unit of a program only (test only, never link it
+///           into the library).
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/// Number of heap allocations since program start
+inline std::atomic<long> allocations{0};
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+
+void* malloc(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+void* calloc(std::size_t n, std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(n, size);
+}
+void* realloc(void* p, std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(p, size);
+}
+}
+#else
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+/// @brief Number of heap allocations so far
+inline long heap_allocations() noexcept
+{
+  return allocations.load(std::memory_order_relaxed);
+}
+
+#endif
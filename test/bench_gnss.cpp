@@ -0,0 +1,430 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "obsrnx.hpp"
+#include "navrnx.hpp"
+#include "sp3c.hpp"
+#include "antex.hpp"
+#include "gauss_newton.hpp"
+#include "alloc_counter.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::ObservationRnx;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+// Microbenchmarks of the library's hot paths. Every benchmark is a "pass"
+// (a function returning the number of operations performed, <0 on error)
+// over fixed input, so that results are reproducible for the same input
+// files. A pass is repeated until at least min_time seconds elapse; this is
+// done reps times and the median ns/op is reported, along with bytes/sec
+// (for parsers) and heap allocations per operation.
+//
+// Results can be written to a baseline file (-w) and later checked against
+// it (-b): a benchmark regresses if its ns/op exceeds the baseline by more
+// than the tolerance (-t, a fraction) or if it allocates more per op.
+
+// Benchmark harness
+// ------------------------------------------------------------------------
+struct BenchResult {
+  std::string name;
+  long ops;             // operations of the measured passes
+  double ns_per_op;     // median over repetitions
+  double bytes_per_sec; // 0 if not applicable
+  double allocs_per_op;
+};
+
+struct BenchConfig {
+  double min_time = 0.2; // seconds per repetition
+  int reps = 5;          // repetitions
+};
+
+template<typename Pass>
+int run(const char* name, const BenchConfig& cfg, double bytes_per_op,
+  Pass&& pass, std::vector<BenchResult>& results)
+{
+  using clock = std::chrono::steady_clock;
+  // warm up (caches, lazily allocated buffers)
+  if (pass()<0) {
+    std::cerr<<"\n[ERROR] Benchmark "<<name<<" failed";
+    return 1;
+  }
+  std::vector<double> ns;
+  long total_ops=0, total_allocs=0;
+  for (int r=0; r<cfg.reps; r++) {
+    long ops=0, n;
+    const long a0 = heap_allocations();
+    auto t0 = clock::now();
+    double elapsed;
+    do {
+      if ((n=pass())<0) {
+        std::cerr<<"\n[ERROR] Benchmark "<<name<<" failed";
+        return 1;
+      }
+      ops += n;
+      elapsed = std::chrono::duration<double>(clock::now()-t0).count();
+    } while (elapsed<cfg.min_time);
+    total_allocs += heap_allocations()-a0;
+    total_ops += ops;
+    ns.push_back(ops ? elapsed*1e9/ops : 0e0);
+  }
+  std::sort(ns.begin(), ns.end());
+  BenchResult res;
+  res.name = name;
+  res.ops = total_ops;
+  res.ns_per_op = ns[ns.size()/2];
+  res.bytes_per_sec = (bytes_per_op>0e0 && res.ns_per_op>0e0)
+    ? bytes_per_op/(res.ns_per_op*1e-9) : 0e0;
+  res.allocs_per_op = total_ops ? static_cast<double>(total_allocs)/total_ops
+    : 0e0;
+  std::printf("\n%-22s %12ld %12.1f %12.2f %12.3f", name, res.ops,
+    res.ns_per_op, res.bytes_per_sec*1e-6, res.allocs_per_op);
+  std::fflush(stdout);
+  results.push_back(res);
+  return 0;
+}
+
+int write_baseline(const char* fn, const std::vector<BenchResult>& results)
+{
+  std::FILE* fp = std::fopen(fn, "w");
+  if (!fp) return 1;
+  std::fprintf(fp, "# name ns_per_op bytes_per_sec allocs_per_op\n");
+  for (const auto& r : results)
+    std::fprintf(fp, "%s %.3f %.1f %.6f\n", r.name.c_str(), r.ns_per_op,
+      r.bytes_per_sec, r.allocs_per_op);
+  return std::fclose(fp) ? 1 : 0;
+}
+
+int read_baseline(const char* fn, std::map<std::string, BenchResult>& base)
+{
+  std::ifstream fin(fn);
+  if (!fin.is_open()) return 1;
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line.empty() || line[0]=='#') continue;
+    char name[64];
+    BenchResult r;
+    if (std::sscanf(line.c_str(), "%63s %lf %lf %lf", name, &r.ns_per_op,
+        &r.bytes_per_sec, &r.allocs_per_op)!=4) return 2;
+    r.name = name;
+    r.ops = 0;
+    base[r.name] = r;
+  }
+  return 0;
+}
+
+// Returns the number of regressions
+int check_baseline(const std::map<std::string, BenchResult>& base,
+  const std::vector<BenchResult>& results, double tolerance)
+{
+  int regressions=0;
+  std::printf("\n\n%-22s %12s %12s %8s %10s %10s", "# Benchmark",
+    "ns/op", "base ns/op", "change", "allocs/op", "base");
+  for (const auto& r : results) {
+    auto it = base.find(r.name);
+    if (it==base.end()) {
+      std::printf("\n%-22s %12.1f %12s", r.name.c_str(), r.ns_per_op, "-");
+      continue;
+    }
+    const auto& b = it->second;
+    const double change = b.ns_per_op>0e0 ? r.ns_per_op/b.ns_per_op-1e0 : 0e0;
+    const bool slower = change>tolerance;
+    const bool allocs = r.allocs_per_op>b.allocs_per_op+1e-9;
+    std::printf("\n%-22s %12.1f %12.1f %+7.1f%% %10.3f %10.3f%s",
+      r.name.c_str(), r.ns_per_op, b.ns_per_op, change*1e2, r.allocs_per_op,
+      b.allocs_per_op, (slower||allocs) ? "  REGRESSION" : "");
+    regressions += (slower||allocs);
+  }
+  return regressions;
+}
+
+// Input helpers
+// ------------------------------------------------------------------------
+bool read_file(const char* fn, std::vector<char>& buf)
+{
+  std::ifstream fin(fn, std::ios::binary|std::ios::ate);
+  if (!fin.is_open()) return false;
+  buf.resize(fin.tellg());
+  fin.seekg(0);
+  fin.read(buf.data(), buf.size());
+  return fin.good();
+}
+
+// Offset of the first char after the "END OF HEADER" line; 0 if not found
+std::size_t end_of_header(const std::vector<char>& buf)
+{
+  const char* key = "END OF HEADER";
+  auto it = std::search(buf.begin(), buf.end(), key, key+std::strlen(key));
+  if (it==buf.end()) return 0;
+  it = std::find(it, buf.end(), '\n');
+  return (it==buf.end()) ? 0 : (it-buf.begin()+1);
+}
+
+// Deterministic RINEX observation fields (F14.3I1I1), some blank
+std::vector<char> make_obs_fields(int n)
+{
+  std::vector<char> buf(n*16+1, ' ');
+  unsigned long s = 12345;
+  for (int i=0; i<n; i++) {
+    s = s*6364136223846793005UL + 1442695040888963407UL;
+    if ((s>>60)==0) continue; // 1/16 of the fields are missing
+    const double v = static_cast<double>((s>>20)%40000000000UL)*1e-3;
+    char tmp[17];
+    std::snprintf(tmp, sizeof(tmp), "%14.3f%c%c", v,
+      ((s>>8)%8) ? ' ' : '1', static_cast<char>('1'+(s>>12)%9));
+    std::memcpy(buf.data()+i*16, tmp, 16);
+  }
+  return buf;
+}
+
+// Usage
+// ------------------------------------------------------------------------
+void usage()
+{
+  std::cerr<<"\n[ERROR] Run as: $>benchGnss [-o <Obs. RINEX>] [-n <Nav. RINEX>]"
+    "\n        [-s <Sp3>] [-a <Antex>] [-b <baseline>] [-w <baseline>]"
+    "\n        [-t <tolerance>] [-m <min seconds>] [-r <repetitions>]"
+    "\n        Benchmarks needing a file not given are skipped.\n";
+}
+
+int main(int argc, char* argv[])
+{
+  const char *obs_fn=nullptr, *nav_fn=nullptr, *sp3_fn=nullptr,
+    *atx_fn=nullptr, *base_fn=nullptr, *save_fn=nullptr;
+  double tolerance = 0.10;
+  BenchConfig cfg;
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0]!='-' || std::strlen(argv[i])!=2 || i+1>=argc) {
+      usage();
+      return 1;
+    }
+    const char* v = argv[++i];
+    switch (argv[i-1][1]) {
+      case 'o': obs_fn=v; break;
+      case 'n': nav_fn=v; break;
+      case 's': sp3_fn=v; break;
+      case 'a': atx_fn=v; break;
+      case 'b': base_fn=v; break;
+      case 'w': save_fn=v; break;
+      case 't': tolerance=std::atof(v); break;
+      case 'm': cfg.min_time=std::atof(v); break;
+      case 'r': cfg.reps=std::max(1, std::atoi(v)); break;
+      default: usage(); return 1;
+    }
+  }
+
+  std::vector<BenchResult> results;
+  int errors=0;
+  std::printf("\n%-22s %12s %12s %12s %12s", "# Benchmark", "ops", "ns/op",
+    "MB/s", "allocs/op");
+
+  // RawRnxObs__::resolve, on synthetic fields
+  {
+    constexpr int num_fields = 4096;
+    const auto fields = make_obs_fields(num_fields);
+    char field[17] = {};
+    ngpt::RawRnxObs__ raw;
+    errors += run("RawRnxObs::resolve", cfg, 16e0, [&]() -> long {
+      for (int i=0; i<num_fields; i++) {
+        std::memcpy(field, fields.data()+i*16, 16);
+        if (raw.resolve(field)) return -1;
+      }
+      return num_fields;
+    }, results);
+  }
+
+  // ObservationRnx::read_next_epoch, all observables of all systems
+  if (obs_fn) {
+    ObservationRnx obs(obs_fn);
+    std::vector<char> buf;
+    if (!read_file(obs_fn, buf) || !end_of_header(buf)) {
+      std::cerr<<"\n[ERROR] Failed to read "<<obs_fn;
+      return 2;
+    }
+    std::map<SATELLITE_SYSTEM, std::vector<ngpt::GnssObservable>> obsmap;
+    for (auto s : {SATELLITE_SYSTEM::gps, SATELLITE_SYSTEM::glonass,
+                   SATELLITE_SYSTEM::galileo, SATELLITE_SYSTEM::beidou}) {
+      obsmap[s] = std::vector<ngpt::GnssObservable>{
+        ngpt::GnssObservable(s, ngpt::ObservationCode("C1C"), 1e0)};
+    }
+    auto mmap = obs.set_read_map(obsmap, true);
+    auto satobs = obs.initialize_epoch_vector(mmap);
+    // one pass to count epochs (and so bytes per epoch)
+    long epochs=0;
+    int sats, j;
+    ngpt::modified_julian_day mjd;
+    double sec;
+    while (!(j=obs.read_next_epoch(mmap, satobs, sats, mjd, sec))) ++epochs;
+    if (j>0 || !epochs) {
+      std::cerr<<"\n[ERROR] Failed to read epochs of "<<obs_fn;
+      ++errors;
+    } else {
+      const double bytes = static_cast<double>(buf.size()-end_of_header(buf));
+      errors += run("read_next_epoch", cfg, bytes/epochs, [&]() -> long {
+        obs.rewind();
+        long n=0;
+        int k;
+        while (!(k=obs.read_next_epoch(mmap, satobs, sats, mjd, sec))) ++n;
+        return k>0 ? -1 : n;
+      }, results);
+    }
+  }
+
+  // NavDataFrame::set_from_rnx3 (on the file's data section, in memory),
+  // kepler2state and glo_ecef (via NavDataFrame::stateNclock)
+  if (nav_fn) {
+    std::vector<char> buf;
+    std::size_t start;
+    if (!read_file(nav_fn, buf) || !(start=end_of_header(buf))) {
+      std::cerr<<"\n[ERROR] Failed to read "<<nav_fn;
+      return 2;
+    }
+    const char* end = buf.data()+buf.size();
+    std::vector<NavDataFrame> frames;
+    {
+      NavigationRnx nav(nav_fn);
+      if (nav.read_all_records(frames)) {
+        std::cerr<<"\n[ERROR] Failed to read records of "<<nav_fn;
+        return 2;
+      }
+    }
+    if (!frames.empty()) {
+      NavDataFrame frame;
+      const double bytes = static_cast<double>(buf.size()-start);
+      errors += run("set_from_rnx3", cfg, bytes/frames.size(), [&]() -> long {
+        const char *p = buf.data()+start, *next;
+        long n=0;
+        while (p<end) {
+          if (frame.set_from_rnx3(p, end, next)) return -1;
+          p = next;
+          ++n;
+        }
+        return n;
+      }, results);
+    }
+
+    std::vector<const NavDataFrame*> kepler, glonass;
+    for (const auto& f : frames) {
+      if (f.system()==SATELLITE_SYSTEM::glonass) glonass.push_back(&f);
+      else if (f.system()!=SATELLITE_SYSTEM::sbas) kepler.push_back(&f);
+    }
+    double state[6], clock, sum=0e0;
+    if (!kepler.empty()) {
+      errors += run("kepler2state", cfg, 0e0, [&]() -> long {
+        for (const auto f : kepler) {
+          if (f->stateNclock(f->toe<seconds>(), state, clock, 1234.5e0))
+            return -1;
+          sum += state[0];
+        }
+        return kepler.size();
+      }, results);
+    }
+    if (!glonass.empty()) {
+      errors += run("glo_ecef", cfg, 0e0, [&]() -> long {
+        for (const auto f : glonass) {
+          if (f->stateNclock(f->toe<seconds>(), state, clock, 600e0))
+            return -1;
+          sum += state[0];
+        }
+        return glonass.size();
+      }, results);
+    }
+    if (sum==0e0) std::printf(" "); // keep the evaluations alive
+  }
+
+  // Sp3c::get_next_epoch, whole file
+  if (sp3_fn) {
+    ngpt::Sp3c sp3(sp3_fn);
+    std::vector<char> buf;
+    read_file(sp3_fn, buf);
+    auto vec = sp3.allocate_epoch_vector();
+    ngpt::datetime<ngpt::microseconds> t;
+    int sats;
+    auto pass = [&]() -> long {
+      sp3.rewind();
+      long n=0;
+      int j;
+      do {
+        j = sp3.get_next_epoch(t, vec, sats);
+        ++n;
+      } while (!j);
+      return j>0 ? -1 : n;
+    };
+    const long epochs = pass();
+    if (epochs<=0) {
+      std::cerr<<"\n[ERROR] Failed to read epochs of "<<sp3_fn;
+      ++errors;
+    } else {
+      errors += run("Sp3c::get_next_epoch", cfg,
+        static_cast<double>(buf.size())/epochs, pass, results);
+    }
+  }
+
+  // Antex::get_antenna_pco, for GPS satellites 1 to 32
+  if (atx_fn) {
+    ngpt::Antex atx(atx_fn);
+    ngpt::AntennaPcoList pco;
+    const ngpt::datetime<seconds> at(ngpt::year(2020), ngpt::month(1),
+      ngpt::day_of_month(1), seconds(0));
+    errors += run("Antex::get_antenna_pco", cfg, 0e0, [&]() -> long {
+      for (int prn=1; prn<=32; prn++)
+        atx.get_antenna_pco(prn, SATELLITE_SYSTEM::gps, at, pco);
+      return 32;
+    }, results);
+  }
+
+  // Kalman::update, 10 synthetic satellites
+  {
+    constexpr int num_sats = 10;
+    const double rx[3] = {4595212.468, 2039473.691, 3912617.891};
+    std::vector<double> obs(num_sats), w(num_sats, 1e0);
+    std::vector<std::array<double,4>> sv(num_sats);
+    for (int i=0; i<num_sats; i++) {
+      const double lon = 2e0*M_PI*i/num_sats, lat = 0.2e0+0.08e0*i;
+      const double r = 26560e3;
+      sv[i] = {r*std::cos(lat)*std::cos(lon), r*std::cos(lat)*std::sin(lon),
+        r*std::sin(lat), 1e-5*i};
+      obs[i] = std::sqrt((sv[i][0]-rx[0])*(sv[i][0]-rx[0])
+        +(sv[i][1]-rx[1])*(sv[i][1]-rx[1])+(sv[i][2]-rx[2])*(sv[i][2]-rx[2]))
+        - sv[i][3]*299792458e0 + 1.5e0*i;
+    }
+    ngpt::Kalman<5> filter{{rx[0]+1.3, rx[1]-2.9, rx[2]-1.5, 0e0, 0e0}};
+    double t=0e0;
+    errors += run("Kalman::update", cfg, 0e0, [&]() -> long {
+      for (int k=0; k<100; k++) filter.update(num_sats, &obs, &sv, t+=1e0, &w);
+      return 100;
+    }, results);
+  }
+
+  // store or check baseline
+  if (save_fn && write_baseline(save_fn, results)) {
+    std::cerr<<"\n[ERROR] Failed to write baseline "<<save_fn;
+    ++errors;
+  }
+  int regressions=0;
+  if (base_fn) {
+    std::map<std::string, BenchResult> base;
+    if (read_baseline(base_fn, base)) {
+      std::cerr<<"\n[ERROR] Failed to read baseline "<<base_fn;
+      ++errors;
+    } else {
+      regressions = check_baseline(base, results, tolerance);
+      std::printf("\n# Regressions: %d (tolerance %.1f%%)", regressions,
+        tolerance*1e2);
+    }
+  }
+
+  std::cout<<"\n";
+  return (errors || regressions) ? 1 : 0;
+}
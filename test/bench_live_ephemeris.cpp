@@ -0,0 +1,140 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "navrnx.hpp"
+#include "kepler_ephemeris.hpp"
+#include "live_ephemeris.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::KeplerEphemeris;
+using ngpt::LiveEphemerisStore;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+/// Run nreaders reader threads (evaluating orbits of all satellites in a
+/// loop) against one writer thread (republishing messages in a loop) for
+/// the given duration; report the throughput of readers and writer.
+/// Returns the number of failed reads.
+template<typename Read, typename Write>
+long run(const char* name, int nreaders, double duration,
+  const std::vector<NavDataFrame>& msgs, Read&& read, Write&& write)
+{
+  std::atomic<bool> stop{false};
+  std::atomic<long> reads{0}, errors{0};
+  long publishes = 0;
+  std::vector<std::thread> readers;
+  for (int r=0; r<nreaders; r++) {
+    readers.emplace_back([&, r]() {
+      long n=0, e=0;
+      auto state = read(r);
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (const auto& m : msgs) {
+          e += (state(m)!=0);
+          ++n;
+        }
+      }
+      reads += n;
+      errors += e;
+    });
+  }
+  std::thread writer([&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      for (const auto& m : msgs) {
+        write(m);
+        ++publishes;
+      }
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+  stop = true;
+  for (auto& t : readers) t.join();
+  writer.join();
+  std::printf("\n%-8s readers: %2d reads/sec: %12.0f (per reader: %11.0f) "
+    "publishes/sec: %10.0f errors: %ld", name, nreaders, reads/duration,
+    reads/duration/nreaders, publishes/duration, errors.load());
+  return errors.load();
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2) {
+    std::cerr<<"\n[ERROR] Run as: $>benchLiveEphemeris <Nav. RINEX> "
+             <<"[seconds per run]\n";
+    return 1;
+  }
+  const double duration = (argc>2) ? std::atof(argv[2]) : 1e0;
+
+  // the first message of every GPS/Galileo/BeiDou satellite
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  std::vector<NavDataFrame> msgs;
+  while (!nav.read_next_record(block)) {
+    auto sys = block.system();
+    if (sys!=SATELLITE_SYSTEM::gps && sys!=SATELLITE_SYSTEM::galileo
+        && sys!=SATELLITE_SYSTEM::beidou) continue;
+    bool have_it = false;
+    for (const auto& m : msgs)
+      if (m.system()==sys && m.prn()==block.prn()) have_it=true;
+    if (!have_it) msgs.push_back(block);
+  }
+  if (msgs.empty()) {
+    std::cerr<<"\n[ERROR] No navigation messages found!\n";
+    return 1;
+  }
+  std::cout<<"\n# Satellites: "<<msgs.size();
+
+  const unsigned max_threads = std::max(2u, std::thread::hardware_concurrency());
+  long total_errors = 0;
+  for (int nreaders=1; nreaders<static_cast<int>(max_threads); nreaders*=2) {
+    // lock-free store
+    {
+      LiveEphemerisStore store;
+      for (const auto& m : msgs) store.publish(m);
+      total_errors += run("rcu", nreaders, duration, msgs,
+        [&](int) {
+          auto reader = std::make_shared<LiveEphemerisStore::Reader>(store);
+          return [reader](const NavDataFrame& m) {
+            double state[6], clock;
+            return reader->stateNclock(m.system(), m.prn(),
+              m.toc<seconds>(), state, clock);
+          };
+        },
+        [&](const NavDataFrame& m) { store.publish(m); });
+      store.reclaim();
+      std::printf(" pending: %zu", store.pending_reclamation());
+    }
+    // baseline: one mutex guarding a vector of prepared ephemerides
+    {
+      std::mutex mtx;
+      std::vector<KeplerEphemeris> ephs;
+      for (const auto& m : msgs) ephs.emplace_back(m);
+      total_errors += run("mutex", nreaders, duration, msgs,
+        [&](int) {
+          return [&](const NavDataFrame& m) {
+            double state[6], clock;
+            std::lock_guard<std::mutex> lock(mtx);
+            for (const auto& e : ephs)
+              if (e.system()==m.system() && e.prn()==m.prn())
+                return e.stateNclock(m.toc<seconds>(), state, clock);
+            return -1;
+          };
+        },
+        [&](const NavDataFrame& m) {
+          std::lock_guard<std::mutex> lock(mtx);
+          for (auto& e : ephs)
+            if (e.system()==m.system() && e.prn()==m.prn()) e.set(m);
+        });
+    }
+  }
+
+  std::cout<<"\n";
+  return total_errors>0;
+}
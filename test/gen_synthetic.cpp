@@ -0,0 +1,215 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "synthetic.hpp"
+#include "navrnx.hpp"
+#include "obsrnx.hpp"
+#include "sp3c.hpp"
+#include "navcmp.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::ObservationRnx;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::Sp3c;
+using ngpt::SyntheticConfig;
+using ngpt::SyntheticGenerator;
+
+// Generate a synthetic data set (navigation RINEX, Sp3 and one observation
+// RINEX per station) and check that it reads back consistently:
+// * the navigation file holds exactly the generated messages,
+// * the Sp3 orbits/clocks match the broadcast ones (to the Sp3 resolution),
+// * every epoch of the observation files is read, at the time it was
+//   written (to the microsecond), with plausible code values.
+// By default a high rate (10 Hz), multi-day (2 days) data set is written,
+// so that epoch times are checked over day boundaries; to keep it small
+// (~100 MB), only two GPS satellites with code and phase on L1 are used.
+
+// Usage
+// ------------------------------------------------------------------------
+void usage()
+{
+  std::cerr<<"\n[ERROR] Run as: $>genSynthetic [-p <prefix>] [-y <YYYY-MM-DD>]"
+    "\n        [-d <duration sec>] [-r <obs. rate Hz>] [-i <Sp3 interval sec>]"
+    "\n        [-n <stations>] [-s <systems, e.g. GREC>] [-e <seed>]"
+    "\n        [-m <satellites per system>] [-k <observables per system>]"
+    "\n        (0 for -m or -k means the nominal constellation)"
+    "\n        Writes <prefix>.nav, <prefix>.sp3 and <prefix>_<marker>.obs\n";
+}
+
+// Check the navigation file against the generated messages
+int check_nav(const char* fn, const std::vector<NavDataFrame>& msgs)
+{
+  NavigationRnx nav(fn);
+  std::vector<NavDataFrame> frames;
+  if (int j=nav.read_all_records(frames); j) {
+    std::cerr<<"\n[ERROR] Failed to read "<<fn<<"; error: "<<j;
+    return 1;
+  }
+  if (frames.size()!=msgs.size()) {
+    std::cerr<<"\n[ERROR] Read "<<frames.size()<<" messages, expected "
+      <<msgs.size();
+    return 1;
+  }
+  int errors=0;
+  for (std::size_t i=0; i<msgs.size(); i++) {
+    const auto &a=frames[i], &b=msgs[i];
+    bool same = a.system()==b.system() && a.prn()==b.prn()
+      && a.toc()==b.toc() && a.toe<ngpt::seconds>()==b.toe<ngpt::seconds>();
+    for (int k=0; k<31 && same; k++) same = (a.data(k)==b.data(k));
+    if (!same) {
+      std::cerr<<"\n[ERROR] Message "<<i<<" ("
+        <<ngpt::satsys_to_char(b.system())<<b.prn()<<") differs";
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string prefix("synthetic"), systems("G");
+  int max_sats = 2, max_obs = 2;
+  SyntheticConfig cfg;
+  cfg.duration = 2*86400e0;
+  cfg.obs_rate = 10e0;
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0]!='-' || std::strlen(argv[i])!=2 || i+1>=argc) {
+      usage();
+      return 1;
+    }
+    const char* v = argv[++i];
+    switch (argv[i-1][1]) {
+      case 'p': prefix=v; break;
+      case 'y':
+        if (std::sscanf(v, "%d-%d-%d", &cfg.year, &cfg.month, &cfg.day)!=3) {
+          usage();
+          return 1;
+        }
+        break;
+      case 'd': cfg.duration=std::atof(v); break;
+      case 'r': cfg.obs_rate=std::atof(v); break;
+      case 'i': cfg.sp3_interval=std::atof(v); break;
+      case 'n': cfg.num_stations=std::atoi(v); break;
+      case 's': systems=v; break;
+      case 'e': cfg.seed=std::strtoul(v, nullptr, 10); break;
+      case 'm': max_sats=std::atoi(v); break;
+      case 'k': max_obs=std::atoi(v); break;
+      default: usage(); return 1;
+    }
+  }
+
+  try {
+    for (char c : systems) {
+      auto con = ngpt::nominal_constellation(ngpt::char_to_satsys(c));
+      if (max_sats>0) con.num_sats = std::min(con.num_sats, max_sats);
+      if (max_obs>0 && static_cast<std::size_t>(max_obs)<con.observables.size())
+        con.observables.resize(max_obs);
+      cfg.constellations.push_back(con);
+    }
+  } catch (std::exception& e) {
+    std::cerr<<"\n[ERROR] Invalid satellite systems: \""<<systems<<"\"\n";
+    return 1;
+  }
+
+  std::unique_ptr<SyntheticGenerator> gen;
+  try {
+    gen.reset(new SyntheticGenerator(cfg));
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 1;
+  }
+
+  // write all files
+  const std::string nav_fn = prefix+".nav", sp3_fn = prefix+".sp3";
+  std::vector<std::string> obs_fn;
+  if (int j=gen->write_nav(nav_fn.c_str()); j) {
+    std::cerr<<"\n[ERROR] Failed to write "<<nav_fn<<"; error: "<<j<<"\n";
+    return 2;
+  }
+  if (int j=gen->write_sp3(sp3_fn.c_str()); j) {
+    std::cerr<<"\n[ERROR] Failed to write "<<sp3_fn<<"; error: "<<j<<"\n";
+    return 2;
+  }
+  for (int s=0; s<gen->num_stations(); s++) {
+    obs_fn.push_back(prefix+"_"+gen->marker_name(s)+".obs");
+    if (int j=gen->write_obs(obs_fn.back().c_str(), s); j) {
+      std::cerr<<"\n[ERROR] Failed to write "<<obs_fn.back()<<"; error: "<<j
+        <<"\n";
+      return 2;
+    }
+  }
+  std::printf("\n# Wrote %s (%zu messages), %s and %d observation file(s)",
+    nav_fn.c_str(), gen->messages().size(), sp3_fn.c_str(),
+    gen->num_stations());
+
+  // navigation file holds the generated messages
+  int errors = check_nav(nav_fn.c_str(), gen->messages());
+
+  // Sp3 vs broadcast; differences are at the Sp3 resolution (mm, ps)
+  {
+    Sp3c sp3(sp3_fn.c_str());
+    std::vector<ngpt::NavCmpStats> stats;
+    if (int j=ngpt::compare_nav_sp3(gen->messages(), sp3, stats, nullptr,
+      cfg.leap_seconds); j) {
+      std::cerr<<"\n[ERROR] Failed to compare against Sp3; error: "<<j;
+      ++errors;
+    }
+    double max_orb=0e0, max_clk=0e0;
+    for (const auto& st : stats) {
+      if (st.missing || !st.epochs) {
+        std::cerr<<"\n[ERROR] Sp3 epochs missing for "
+          <<ngpt::satsys_to_char(st.sys)<<st.prn;
+        ++errors;
+      }
+      max_orb = std::max(max_orb, st.rms_3d);
+      max_clk = std::max(max_clk, st.max_abs[3]);
+    }
+    std::printf("\n# Sp3 vs broadcast: %zu satellites, max orbit RMS %.6f m, "
+      "max clock diff %.6f m", stats.size(), max_orb, max_clk);
+    if (max_orb>2e-3 || max_clk>2e-3) ++errors;
+  }
+
+  // observation files; first observable of each system is a code
+  const long expected = static_cast<long>(
+    std::ceil(cfg.duration*cfg.obs_rate-1e-9));
+  for (const auto& fn : obs_fn) {
+    ObservationRnx rnx(fn.c_str());
+    std::map<SATELLITE_SYSTEM, std::vector<ngpt::GnssObservable>> map;
+    for (const auto& con : cfg.constellations)
+      map[con.sys] = std::vector<ngpt::GnssObservable>{ngpt::GnssObservable(
+        con.sys, ngpt::ObservationCode(con.observables[0].c_str()), 1e0)};
+    auto sat_obs_map = rnx.set_read_map(map);
+    auto sat_obs_vec = rnx.initialize_epoch_vector(sat_obs_map);
+    // epoch e is written at start + llround(e*1e6/rate) microseconds (see
+    // SyntheticGenerator::write_obs); the epochs read must match exactly
+    ngpt::datetime<ngpt::microseconds> t;
+    long epochs=0, sats=0, bad=0, bad_steps=0, start=0;
+    int status, satsnum;
+    while (!(status=rnx.read_next_epoch(sat_obs_map, sat_obs_vec, satsnum,
+      t))) {
+      const long usec = t.mjd().as_underlying_type()*86400000000L
+        + t.sec().as_underlying_type();
+      if (!epochs) start = usec;
+      if (usec-start!=std::llround(epochs*1e6/cfg.obs_rate)) ++bad_steps;
+      ++epochs;
+      sats += satsnum;
+      for (auto it=sat_obs_vec.begin(); it<sat_obs_vec.begin()+satsnum; ++it)
+        if (it->second[0]<1.8e7 || it->second[0]>3.1e7) ++bad;
+    }
+    std::printf("\n# %s: %ld epochs, %.1f satellites per epoch, %ld bad code "
+      "values, %ld bad epoch steps", fn.c_str(), epochs,
+      epochs ? (double)sats/epochs : 0e0, bad, bad_steps);
+    if (status>0 || epochs!=expected || bad || bad_steps || !sats) ++errors;
+  }
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
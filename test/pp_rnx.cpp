@@ -6,9 +6,14 @@
 #include "navrnx.hpp"
 #include "antex.hpp"
 #include "ggeodesy/geodesy.hpp"
-#include "ggeodesy/car2ell.hpp"
 #include "ggdatetime/datetime_write.hpp"
 #include "gauss_newton.hpp"
+#include "arena.hpp"
+#include "pipeline.hpp"
+#include "geometry.hpp"
+#include "troposphere.hpp"
+#include "visibility.hpp"
+#include "combination.hpp"
 
 using ngpt::ObservationRnx;
 using ngpt::NavigationRnx;
@@ -22,113 +27,29 @@ using ngpt::milliseconds;
   
 typedef std::pair<std::size_t, double> id_pair;
 typedef std::vector<id_pair>           vecof_idpair;
-using svdit = std::vector<std::pair<Satellite, std::vector<double>>>::iterator;
+using svdit = std::vector<std::pair<ngpt::SatId, std::vector<double>>>::iterator;
+
+/// Everything the decoding stage hands over to the processing stage for one
+/// epoch.
+struct EpochBlock {
+  int satsnum{0};
+  ngpt::datetime<ngpt::microseconds> t;
+  std::vector<std::pair<ngpt::SatId, std::vector<double>>> sat_obs_vec;
+};
 
 constexpr int MAX_SATS = 30;
 constexpr double MIN_ELEVATION = 10e0;
 constexpr double MAX_ZENITH_ANGLE = 90 - MIN_ELEVATION;
+constexpr double PLANNING_SPAN = 86400e0;
 // constexpr std::vector<Satellite> exclude_sv;
 
-/* bernese manual, p. 188 */
-class Saastamoinen {
-public:
-  Saastamoinen(double hgt) noexcept: h(hgt) {initialize();};
-  double correction(double z) const noexcept {
-    double cosz  = std::cos(z);
-    double tanz2 = std::tan(z)*std::tan(z);
-    double facT  = 0.05e0 + 1255e0/T;
-    double faccz = 0.002277e0/cosz;
-    return faccz*(P+facT*e-tanz2);
-  }
-  auto correction(const std::vector<double>& zangles) const noexcept {
-    std::vector<double> dT;
-    dT.reserve(zangles.size());
-    std::transform(zangles.begin(), zangles.end(), std::back_inserter(dT),[this](double z)
-                                                                          {return correction(z);}
-    );
-    return dT;
-  }
-private:
-  double h,T,R,P,e;
-  
-  void
-  initialize() noexcept {
-    constexpr double pr = 1013.25e0;
-    constexpr double hr = 0e0;
-    constexpr double Tr = 18e0;
-    constexpr double Rr = 50e0;
-    T = Tr-0.0065*(h-hr);
-    R = Rr*exp(-0.0006396*(h-hr));
-    P = pr*std::pow(1e0-0.0000226*(h-hr), 5.225);
-    e = R*exp(-37.2465e0+0.213166*T-std::pow(0.000256908,2e0));
-  }
-};
-
-double
-sv_zen_angle(double sinf, double cosf, double sinl, double cosl, double x, double y, double z, const double* state)
-{
-    const double xs=state[0];
-    const double ys=state[1];
-    const double zs=state[2];
-    const double dx = xs-x;
-    const double dy = ys-y;
-    const double dz = zs-z;
-    const double n = -sinf * cosl * dx - sinf * sinl * dy + cosf * dz;
-    const double e = -sinl * dx        + cosl * dy;
-    const double u =  cosf * cosl * dx + cosf * sinl * dy + sinf * dz;
-    const double r = std::sqrt(n*n + e*e + u*u);
-    double znth = std::acos(u / r);
-    if (znth<-0.2e0 || znth>ngpt::DPI/2e0+0.2) {
-      std::cerr<<"\n[ERROR] Zenith angle out of limits! Value is "<<ngpt::rad2deg(znth);
-      throw 120;
-    }
-    return ngpt::rad2deg(znth);
-}
-
-std::vector<double>
-compute_zenith_angles(int numsats, const std::vector<std::array<double,4>>& states,
-                    double x, double y, double z,
-                    double& lat, double& lon, double& hgt) {
-  std::vector<double> zangles;
-  assert(numsats>0);
-  zangles.reserve(numsats);
-  double n,e,u,r,znth;
-
-  ngpt::car2ell<ngpt::ellipsoid::grs80>(x,y,z,lat,lon,hgt);
-  const double cosf = std::cos(lat);
-  const double sinf = std::sin(lat);
-  const double cosl = std::cos(lon);
-  const double sinl = std::sin(lon);
-
-  for (int i=0; i<numsats; i++) {
-    const double xs=states[i][0];
-    const double ys=states[i][1];
-    const double zs=states[i][2];
-    const double dx = xs-x;
-    const double dy = ys-y;
-    const double dz = zs-z;
-    n = -sinf * cosl * dx - sinf * sinl * dy + cosf * dz;
-    e = -sinl * dx        + cosl * dy;
-    u =  cosf * cosl * dx + cosf * sinl * dy + sinf * dz;
-    r = std::sqrt(n*n + e*e + u*u);
-    znth = std::acos(u / r);
-    zangles.push_back(znth);
-    if (znth<0e0 || znth>=ngpt::DPI/2e0) {
-      std::cerr<<"\n[ERROR] Zenith angle out of limits! Value is "<<znth;
-      std::cerr<<"\n[ERROR] Occured at satellite #"<<i;
-      throw i;
-    }
-  }
-
-  return zangles;
-}
-
 /*   cos(z)^2  */
-std::vector<double>
-weighting_fun(std::vector<double>& zangles) {
-  std::vector<double> v;
-  v.reserve(zangles.size());
-  std::transform(zangles.begin(), zangles.end(), std::back_inserter(v),[](double a) {
+/// Weights are placed in the (per-epoch) arena; nullptr on failure
+double*
+weighting_fun(const std::vector<double>& zangles, ngpt::EpochArena& arena) {
+  double* v = arena.allocate_array<double>(zangles.size());
+  if (!v) return v;
+  std::transform(zangles.begin(), zangles.end(), v, [](double a) {
     // return (a>80e0*ngpt::DPI/180e0)?(200e0):(1e0/std::cos(a)*std::cos(a));});
     return (1e0/std::cos(a)*std::cos(a));});
   return v;
@@ -186,14 +107,14 @@ check_nav_msg(const NavDataFrame& msg, const datetime<milliseconds>& ti)
 }
 
 std::vector<NavDataFrame>::iterator
-get_valid_msg(NavigationRnx& nav, const Satellite& sat, 
+get_valid_msg(NavigationRnx& nav, ngpt::SatId sat, 
   const datetime<milliseconds>& t, std::vector<NavDataFrame>& sat_nav_vec,
   int& status)
 {
   status=-200;
   auto nit = std::find_if(sat_nav_vec.begin(), sat_nav_vec.end(),
       [&sat, &t, &status](const NavDataFrame& p)
-      {return (sat.system()==p.system() && sat.prn()==p.prn()) 
+      {return sat==p.sat_id() 
         && !(status=check_nav_msg(p, t));}
     );
 
@@ -210,7 +131,7 @@ get_valid_msg(NavigationRnx& nav, const Satellite& sat,
     if (status>=0) {
       nit = std::find_if(sat_nav_vec.begin(), sat_nav_vec.end(),
           [&sat](const NavDataFrame& p)
-          {return sat.system()==p.system() && sat.prn()==p.prn();});
+          {return sat==p.sat_id();});
       assert(nit!=sat_nav_vec.end());
       *nit = std::move(msg);
     } else {
@@ -241,9 +162,10 @@ int main(int argc, char* argv[])
   std::vector<NavDataFrame> sat_nav_vec; sat_nav_vec.reserve(50);
 
   // use GPS C1C
+  using gps_l1l2 = ngpt::combination_traits<SATELLITE_SYSTEM::gps, 1, 2>;
   SATELLITE_SYSTEM satsys = SATELLITE_SYSTEM::glonass;
-  GnssObservable gc1c(satsys, ObservationCode("C1C"), 2.5457277801631593e0);
-                 gc1c.add(ngpt::SATELLITE_SYSTEM::gps, ObservationCode("C2W"), -1.5457277801631593e0);
+  GnssObservable gc1c(satsys, ObservationCode("C1C"), gps_l1l2::if_coef1);
+                 gc1c.add(ngpt::SATELLITE_SYSTEM::gps, ObservationCode("C2W"), gps_l1l2::if_coef2);
   
   // do we have an antex file?
   std::vector<ngpt::Satellite> sat_info_vec;
@@ -271,90 +193,133 @@ int main(int argc, char* argv[])
     for (const auto& v : m.second) std::cout<<" "<<v.to_string();
   }
 
-  // inilialize vector to hold satellite/observation pairs for every epoch
-  std::vector<std::pair<Satellite, std::vector<double>>>
-    sat_obs_vec (obsrnx.initialize_epoch_vector(sat_obs_map));
+  // the pipeline: one thread decodes RINEX epochs into a ring of EpochBlock
+  // slots while this thread processes them; every slot owns its own vector
+  // of satellite/observation pairs, allocated once here.
+  ngpt::TwoStagePipeline<EpochBlock, 8> pipeline;
+  pipeline.initialize_slots([&](EpochBlock& block){
+    block.sat_obs_vec = obsrnx.initialize_epoch_vector(sat_obs_map);
+  });
 
   // go on and collect every epoch ....
-  double lat, lon, hgt;
-  ngpt::car2ell<ngpt::ellipsoid::grs80>(obsrnx.x_approx(), obsrnx.y_approx(), 
-                                        obsrnx.z_approx(),lat,lon,hgt);
-  const double cosf = std::cos(lat);
-  const double sinf = std::sin(lat);
-  const double cosl = std::cos(lon);
-  const double sinl = std::sin(lon);
-  Saastamoinen Trop(hgt);
+  const ngpt::StationGeometry station(obsrnx.x_approx(), obsrnx.y_approx(),
+                                      obsrnx.z_approx());
+  // predict the visibility windows (above MIN_ELEVATION) of every satellite,
+  // using all healthy messages of the satellite (each one around its ToE),
+  // so that satellites below the mask are skipped before any orbit
+  // computation
+  ngpt::VisibilityPlanner planner(station, ngpt::deg2rad(MIN_ELEVATION),
+                                  obsrnx.time_of_first_obs(), PLANNING_SPAN);
+  {
+    std::vector<NavDataFrame> msgs;
+    NavDataFrame msg;
+    while (!navrnx.read_next_record(msg)) {
+      if (msg.system()==satsys && !msg.sv_health()) msgs.push_back(msg);
+    }
+    navrnx.rewind();
+    std::vector<const NavDataFrame*> sat_msgs;
+    for (int prn=1; prn<=ngpt::SatId::max_prn; prn++) {
+      sat_msgs.clear();
+      for (const auto& m : msgs) if (m.prn()==prn) sat_msgs.push_back(&m);
+      if (sat_msgs.size()
+          && planner.add_satellite(sat_msgs.data(), sat_msgs.size()))
+        std::cerr<<"\n[WARNING] Failed to plan satellite "
+          <<ngpt::satsys_to_char(satsys)<<prn;
+    }
+  }
+  const ngpt::Saastamoinen Trop(ngpt::standard_atmosphere(station.height()),
+                                station.latitude(), station.height());
   ngpt::Kalman<5> filter{{obsrnx.x_approx()+1.321, 
                           obsrnx.y_approx()-2.987, 
                           obsrnx.z_approx()-1.568, 0.5e6, .0e0}, };
   std::vector<double> Obs(MAX_SATS);
   std::vector<std::array<double,4>> States(MAX_SATS);
-  int status, j, index(0);
-  int epoch_counter=0, satsnum;
-  ngpt::modified_julian_day mjd;
-  double secday, clock, state[6];
-  do {
-    // get satellite-observations pairs, aka fill in sat_obs_vec
-    status = obsrnx.read_next_epoch(sat_obs_map, sat_obs_vec, satsnum, mjd, secday);
-    ngpt::datetime<milliseconds> epoch 
-      (mjd, milliseconds(static_cast<long>(secday*milliseconds::sec_factor<double>())));
+  std::vector<double> zenith_angles; zenith_angles.reserve(MAX_SATS);
+  std::vector<double> cos_zenith; cos_zenith.reserve(MAX_SATS);
+  std::vector<double> dT(MAX_SATS);
+  // scratch space reused for every epoch: candidate observations, the
+  // (indexes of the) navigation messages to use and their geometry
+  std::vector<double> cand_obs; cand_obs.reserve(MAX_SATS);
+  std::vector<std::size_t> cand_nav; cand_nav.reserve(MAX_SATS);
+  std::vector<const NavDataFrame*> navs; navs.reserve(MAX_SATS);
+  ngpt::EpochGeometry geo; geo.reserve(MAX_SATS);
+  // per-epoch scratch memory (e.g. weights), reset at every epoch
+  ngpt::EpochArena arena(16*1024);
+  int j, index(0);
+  int epoch_counter=0;
+
+  // producer: get satellite-observations pairs, aka fill in sat_obs_vec
+  auto decode = [&](EpochBlock& block) -> int {
+    return obsrnx.read_next_epoch(sat_obs_map, block.sat_obs_vec,
+                                  block.satsnum, block.t);
+  };
+
+  // consumer: orbits, troposphere and filter update for one epoch
+  auto solve = [&](EpochBlock& block, int status) -> int {
+    // a non-zero status means EOF or error; nothing was read
+    if (status) return status;
+    arena.reset();
+    const int satsnum = block.satsnum;
+    const double secday = block.t.sec().to_fractional_seconds();
+    auto& sat_obs_vec = block.sat_obs_vec;
+    ngpt::datetime<milliseconds> epoch(block.t.cast_to<milliseconds>());
     // std::cerr<<"\n[DEBUG] Epoch "<<ngpt::strftime_ymd_hms<milliseconds>(epoch);
     if (satsnum>4) {
+      cand_obs.clear();
+      cand_nav.clear();
       // for every sat-obs pair
       for (int i=0; i<satsnum; i++) {
         svdit oit=sat_obs_vec.begin()+i; // iterator to sat_obs_vec
-        // std::cerr<<" / SV:"<<satsys_to_char(oit->first.system())<<oit->first.prn();
         if (std::abs(oit->second[0]-ngpt::RNXOBS_MISSING_VAL)>1e-3) {
-          Satellite cursat(oit->first);    // current satellite
+          const ngpt::SatId cursat(oit->first); // current satellite
+          if (!planner.visible(cursat.system(), cursat.prn(), epoch)) continue;
           // find satellite's navigation block or read rinex untill we find one
           auto nit = get_valid_msg(navrnx, cursat, epoch, sat_nav_vec, j);
           if (!j) {
-            // get position and clock bias for satellite
             assert(nit!=sat_nav_vec.end());
-            assert(cursat.system()==nit->system() && cursat.prn()==nit->prn());
-            nit->stateNclock(epoch, state, clock);
-            if (sv_zen_angle(sinf, cosf, sinl, cosl, obsrnx.x_approx(), obsrnx.y_approx(), obsrnx.z_approx(), state) < MAX_ZENITH_ANGLE) {
-              std::cerr<< std::fixed <<"\n##SV G"<<cursat.prn()<<" Obs: "<<oit->second[0]<<" X: "<< state[0]<<" Y: "<<state[1]<<" Z: "<<state[2]<<" C: "<<clock*1e6<<" t: \""<<ngpt::strftime_ymd_hms<milliseconds>(epoch)<<"\"";
-              // assign for filter update
-              Obs[index] = oit->second[0];
-              for (int k=0; k<3; k++) {States[index][k]=state[k];} States[index][3]=clock;
-              ++index;
-              // std::cerr<<":OK";
-            } else {
-              std::cerr<<"\n[DEBUG] Too large zenith angle! observation skipped";
-            }
-          } else {
-            /*std::cerr<<"\n*** Cannot find valid message for SV "
-              <<satsys_to_char(cursat.system())<<cursat.prn()
-              <<" Epoch is "<<ngpt::strftime_ymd_hms<milliseconds>(epoch)
-              <<" status= "<<j;*/
-            // std::cerr<<":NVM";
-            ;
+            assert(cursat==nit->sat_id());
+            // store the index; sat_nav_vec may be re-allocated in the loop
+            cand_obs.push_back(oit->second[0]);
+            cand_nav.push_back(nit-sat_nav_vec.begin());
           }
-        } else {
-          // std::cerr<<":NaN";
-          ;
         }
       }
-      // compute zenith angle per observation
-      std::vector<double> zenith_angles;
-      try {
-        zenith_angles = compute_zenith_angles(index, States, obsrnx.x_approx(), 
-            obsrnx.y_approx(), obsrnx.z_approx(), lat, lon, hgt);
-      } catch (int ernum) {
-        std::cerr<<"\n[ERROR] SV with bad azimouth had obs value "<<Obs[ernum];
-        std::cerr<<"\n[ERROR] Num of sats was "<<index;
-        zenith_angles.clear();
+      // satellite positions at transmission time, range, azimuth, elevation
+      navs.clear();
+      for (auto k : cand_nav) navs.push_back(&sat_nav_vec[k]);
+      geo.compute(station, epoch, navs.data(), navs.size());
+      zenith_angles.clear();
+      cos_zenith.clear();
+      for (std::size_t i=0; i<geo.size(); i++) {
+        // a negative status is a warning (e.g. a GLONASS message used just
+        // outside its fit interval); the geometry is still valid
+        if (geo.status[i]>0) continue;
+        double zenith = geo.zenith(i);
+        if (index >= MAX_SATS) {
+          std::cerr<<"\n[DEBUG] Too many satellites (max "<<MAX_SATS
+            <<")! observation skipped";
+        } else if (ngpt::rad2deg(zenith) < MAX_ZENITH_ANGLE) {
+          std::cerr<< std::fixed <<"\n##SV G"<<navs[i]->prn()<<" Obs: "<<cand_obs[i]<<" X: "<< geo.x[i]<<" Y: "<<geo.y[i]<<" Z: "<<geo.z[i]<<" C: "<<geo.clock[i]*1e6<<" t: \""<<ngpt::strftime_ymd_hms<milliseconds>(epoch)<<"\"";
+          // assign for filter update
+          Obs[index] = cand_obs[i];
+          States[index] = {geo.x[i], geo.y[i], geo.z[i], geo.clock[i]};
+          zenith_angles.push_back(zenith);
+          cos_zenith.push_back(std::cos(zenith));
+          ++index;
+        } else {
+          std::cerr<<"\n[DEBUG] Too large zenith angle! observation skipped";
+        }
       }
       if (zenith_angles.size()) {
         // compute and apply Saastamoinen
-        auto dT = Trop.correction(zenith_angles);
+        Trop.slant_delay_cosz(cos_zenith.data(), index, dT.data());
         std::transform(Obs.begin(), Obs.begin()+index, dT.begin(), Obs.begin(), std::minus<double>());
         // compute weight per observation
-        auto W = weighting_fun(zenith_angles);
+        const double* W = weighting_fun(zenith_angles, arena);
+        if (!W) return 90;
         // Kalman update
         // for (int i=0;i<index;i++) std::cout<<"\nPseudorange["<<i<<"] = "<<Obs[i];
-        filter.update(index, &Obs, &States, secday, &W);
+        filter.update(index, Obs.data(), States.data(), secday, W);
         std::cout<<"\n\""<<ngpt::strftime_ymd_hms<milliseconds>(epoch)<<"\" Sats: "<< index<<" ";
         //if (epoch_counter>2) return 80;
         filter.print_state();
@@ -368,7 +333,8 @@ int main(int argc, char* argv[])
     }
     ++epoch_counter;
     index=0;
-  } while (!status);
+    return 0;
+  };
 
-  return status;
+  return pipeline.run(decode, solve);
 }
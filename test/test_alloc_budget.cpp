@@ -0,0 +1,195 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "synthetic.hpp"
+#include "navrnx.hpp"
+#include "obsrnx.hpp"
+#include "nav_snapshot.hpp"
+#include "gauss_newton.hpp"
+#include "alloc_counter.hpp"
+
+using ngpt::ObservationRnx;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::SyntheticConfig;
+using ngpt::SyntheticGenerator;
+
+// Allocation budget of the per-epoch processing chain. A synthetic data set
+// (navigation and observation RINEX for one station) is generated and then
+// processed epoch by epoch, as a positioning client would:
+// * ObservationRnx::read_next_epoch,
+// * an ephemeris lookup (and orbit evaluation) per observed satellite, on a
+//   navigation snapshot made from the navigation RINEX,
+// * a Kalman filter update.
+// Heap allocations are counted per stage; after the warm-up epochs (where
+// buffers may still grow), the allocations of any single epoch must not
+// exceed the budget (-b, default 0).
+
+// Allocations of one stage, over the steady-state epochs
+struct StageCount {
+  const char* name;
+  long total = 0;
+  long max = 0;
+  void add(long n) noexcept { total += n; max = std::max(max, n); }
+};
+
+void usage()
+{
+  std::cerr<<"\n[ERROR] Run as: $>testAllocBudget [-b <allocations per epoch>]"
+    "\n        [-w <warm-up epochs>] [-d <duration sec>]"
+    "\n        [-s <systems, e.g. GREC>] [-p <prefix>]"
+    "\n        Writes (and processes) <prefix>.nav, <prefix>.snap and "
+    "<prefix>.obs\n";
+}
+
+int main(int argc, char* argv[])
+{
+  std::string prefix("alloc_budget"), systems("GREC");
+  long budget = 0;
+  int warmup = 10;
+  SyntheticConfig cfg;
+  cfg.year=2020; cfg.month=10; cfg.day=7;
+  cfg.duration=900e0;
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0]!='-' || std::strlen(argv[i])!=2 || i+1>=argc) {
+      usage();
+      return 1;
+    }
+    const char* v = argv[++i];
+    switch (argv[i-1][1]) {
+      case 'b': budget=std::atol(v); break;
+      case 'w': warmup=std::atoi(v); break;
+      case 'd': cfg.duration=std::atof(v); break;
+      case 's': systems=v; break;
+      case 'p': prefix=v; break;
+      default: usage(); return 1;
+    }
+  }
+
+  // the synthetic data set and the navigation snapshot
+  std::unique_ptr<SyntheticGenerator> gen;
+  try {
+    for (char c : systems)
+      cfg.constellations.push_back(
+        ngpt::nominal_constellation(ngpt::char_to_satsys(c)));
+    gen.reset(new SyntheticGenerator(cfg));
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 1;
+  }
+  const std::string nav_fn = prefix+".nav", snap_fn = prefix+".snap",
+    obs_fn = prefix+".obs";
+  if (gen->write_nav(nav_fn.c_str()) || gen->write_obs(obs_fn.c_str(), 0)) {
+    std::cerr<<"\n[ERROR] Failed to write the synthetic data set\n";
+    return 2;
+  }
+  try {
+    ngpt::NavigationRnx nav(nav_fn.c_str());
+    if (ngpt::write_nav_snapshot(snap_fn.c_str(), nav)) {
+      std::cerr<<"\n[ERROR] Failed to write "<<snap_fn<<"\n";
+      return 2;
+    }
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 2;
+  }
+
+  int errors=0;
+  try {
+    ngpt::NavSnapshot snap(snap_fn.c_str());
+    ObservationRnx obs(obs_fn.c_str());
+
+    // one code observable per system
+    std::map<SATELLITE_SYSTEM, std::vector<ngpt::GnssObservable>> obsmap;
+    for (const auto& c : cfg.constellations)
+      obsmap[c.sys] = std::vector<ngpt::GnssObservable>{
+        ngpt::GnssObservable(c.sys, ngpt::ObservationCode(
+          c.sys==SATELLITE_SYSTEM::beidou ? "C2I" : "C1C"), 1e0)};
+    auto mmap = obs.set_read_map(obsmap, true);
+    auto satobs = obs.initialize_epoch_vector(mmap);
+
+    double rx[3];
+    gen->station_position(0, rx);
+    constexpr int max_obs = 64;
+    ngpt::Kalman<5, max_obs> filter{{rx[0]+10e0, rx[1]-10e0, rx[2]+10e0,
+      0e0, 0e0}};
+    // (zero) weights, i.e. the filter's default observation variance
+    std::array<double,max_obs> code, weight;
+    weight.fill(0e0);
+    std::array<std::array<double,4>,max_obs> states;
+
+    StageCount stages[] = {{"read_next_epoch"}, {"ephemeris lookup"},
+      {"Kalman::update"}};
+    long max_epoch = 0;
+    int epochs = 0, steady = 0, sats, j;
+    ngpt::datetime<ngpt::microseconds> t;
+    for (;;) {
+      long before = heap_allocations();
+      if ((j=obs.read_next_epoch(mmap, satobs, sats, t))) break;
+      const long n_read = heap_allocations()-before;
+
+      before = heap_allocations();
+      int n = 0;
+      for (int i=0; i<sats && n<max_obs; i++) {
+        const auto& sat = satobs[i].first;
+        const double c = satobs[i].second[0];
+        if (std::abs(c-ngpt::RNXOBS_MISSING_VAL)<1e-3) continue;
+        double state[6], clock;
+        if (!snap.stateNclock(sat.system(), sat.prn(), t, state, clock)) {
+          code[n] = c;
+          states[n] = {state[0], state[1], state[2], clock};
+          ++n;
+        }
+      }
+      const long n_lookup = heap_allocations()-before;
+
+      before = heap_allocations();
+      if (n>4
+        && filter.update(n, code.data(), states.data(), 1e0, weight.data()))
+        ++errors;
+      const long n_filter = heap_allocations()-before;
+
+      if (++epochs>warmup) {
+        ++steady;
+        stages[0].add(n_read);
+        stages[1].add(n_lookup);
+        stages[2].add(n_filter);
+        max_epoch = std::max(max_epoch, n_read+n_lookup+n_filter);
+      }
+    }
+    if (j>0) {
+      std::cerr<<"\n[ERROR] Failed to read "<<obs_fn<<"; error: "<<j;
+      ++errors;
+    }
+    if (steady<1) {
+      std::cerr<<"\n[ERROR] No epochs after the warm-up ("<<epochs<<" read)";
+      ++errors;
+    }
+
+    std::printf("\n# %d epochs (%d after warm-up); allocations per epoch:",
+      epochs, steady);
+    for (const auto& s : stages)
+      std::printf("\n# %-18s mean %8.2f max %6ld", s.name,
+        steady ? static_cast<double>(s.total)/steady : 0e0, s.max);
+    if (max_epoch>budget) {
+      std::cerr<<"\n[ERROR] Max allocations per epoch "<<max_epoch
+        <<" exceed the budget of "<<budget;
+      ++errors;
+    }
+    std::printf("\n# Max per epoch %ld, budget %ld; errors %d", max_epoch,
+      budget, errors);
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 2;
+  }
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
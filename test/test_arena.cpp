@@ -0,0 +1,131 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "arena.hpp"
+#include "gauss_newton.hpp"
+#include "eigen3/Eigen/Dense"
+#include "alloc_counter.hpp"
+
+// Check the epoch arena (alignment, O(1) reset, reuse of blocks, arena
+// vectors) and that Kalman::update matches a plain Eigen implementation
+// without allocating memory.
+
+constexpr int num_sats = 12;
+constexpr int num_epochs = 200;
+
+// the filter as formulated before (dynamic size Eigen matrices)
+struct ReferenceKalman {
+  Eigen::Matrix<double,5,1> x;
+  Eigen::Matrix<double,5,5> P, F;
+  int idx = 0;
+  void update(int n, const double* obs, const std::array<double,4>* sv,
+    double dt, const double* w)
+  {
+    F.setIdentity(); F(3,4)=dt;
+    x = F*x;
+    Eigen::VectorXd v(n), p(n);
+    Eigen::MatrixXd H(n,5);
+    for (int i=0; i<n; i++) {
+      const double dx=sv[i][0]-x(0), dy=sv[i][1]-x(1), dz=sv[i][2]-x(2);
+      const double r=std::sqrt(dx*dx+dy*dy+dz*dz);
+      p(i) = r+x(3);
+      v(i) = obs[i]+sv[i][3]*299792458e0;
+      H(i,0)=-dx/r; H(i,1)=-dy/r; H(i,2)=-dz/r; H(i,3)=1e0; H(i,4)=0e0;
+    }
+    v -= p;
+    if (!idx) {
+      P.setIdentity(); P*=50e0*50e0; P(4,4)=30e0;
+    }
+    P = F*P*F.transpose();
+    P(3,3)+=0.0114e0; P(3,4)+=0.0019e0; P(4,3)+=0.0019e0; P(4,4)+=0.0039e0;
+    Eigen::MatrixXd S = H*P*H.transpose();
+    for (int i=0; i<n; i++) S(i,i) += 100e0+w[i];
+    Eigen::MatrixXd W = P*H.transpose()*S.inverse();
+    P = P - W*S*W.transpose();
+    x = x + W*v;
+    ++idx;
+  }
+};
+
+int main()
+{
+  int errors=0;
+
+  // arena: alignment, growth and O(1) reset with block reuse
+  {
+    ngpt::EpochArena arena(1024);
+    for (int epoch=0; epoch<10; epoch++) {
+      arena.reset();
+      if (arena.used()) ++errors;
+      char* c = static_cast<char*>(arena.allocate(3, 1));
+      double* d = arena.allocate_array<double>(500);
+      void* a64 = arena.allocate(64, 64);
+      if (!c || !d || !a64) { ++errors; break; }
+      if (reinterpret_cast<std::uintptr_t>(d)%alignof(double)
+        || reinterpret_cast<std::uintptr_t>(a64)%64) ++errors;
+      for (int i=0; i<500; i++) d[i]=i;
+      ngpt::arena_vector<int> v(arena);
+      for (int i=0; i<1000; i++) v.push_back(i);
+      if (v[999]!=999 || d[499]!=499e0) ++errors;
+    }
+    const std::size_t blocks = arena.num_blocks();
+    const long before = heap_allocations();
+    for (int epoch=0; epoch<100; epoch++) {
+      arena.reset();
+      arena.allocate_array<double>(500);
+      arena.allocate(64, 64);
+      ngpt::arena_vector<int> v(arena);
+      for (int i=0; i<1000; i++) v.push_back(i);
+    }
+    if (heap_allocations()!=before || arena.num_blocks()!=blocks) ++errors;
+    std::printf("\n# Arena: %zu blocks, %zu bytes; heap allocations in 100 "
+      "epochs: %ld; errors %d", arena.num_blocks(), arena.capacity(),
+      heap_allocations()-before, errors);
+  }
+
+  // Kalman::update: same solution as the reference, no heap allocations
+  {
+    const double rx[3] = {4595212.468, 2039473.691, 3912617.891};
+    std::vector<double> obs(num_sats), w(num_sats);
+    std::vector<std::array<double,4>> sv(num_sats);
+    ngpt::Kalman<5> filter{{rx[0]+1.3, rx[1]-2.9, rx[2]-1.5, 0e0, 0e0}};
+    ReferenceKalman ref;
+    ref.x << rx[0]+1.3, rx[1]-2.9, rx[2]-1.5, 0e0, 0e0;
+    double max_diff=0e0;
+    long kalman_allocations=0;
+    for (int k=0; k<num_epochs; k++) {
+      const int n = 5+k%(num_sats-4);
+      for (int i=0; i<n; i++) {
+        const double lon = 2e0*M_PI*i/n+1e-3*k, lat = 0.2e0+0.08e0*i;
+        const double r = 26560e3;
+        sv[i] = {r*std::cos(lat)*std::cos(lon), r*std::cos(lat)*std::sin(lon),
+          r*std::sin(lat), 1e-5*i};
+        obs[i] = std::sqrt((sv[i][0]-rx[0])*(sv[i][0]-rx[0])
+          +(sv[i][1]-rx[1])*(sv[i][1]-rx[1])+(sv[i][2]-rx[2])*(sv[i][2]-rx[2]))
+          - sv[i][3]*299792458e0 + 0.3e0*std::sin(k+i);
+        w[i] = 1e0/(1e0+i);
+      }
+      const long before = heap_allocations();
+      if (filter.update(n, obs.data(), sv.data(), 1e0, w.data())) ++errors;
+      kalman_allocations += heap_allocations()-before;
+      ref.update(n, obs.data(), sv.data(), 1e0, w.data());
+    }
+    std::vector<double> too_many(65);
+    std::vector<std::array<double,4>> too_many_sv(65);
+    if (!filter.update(65, &too_many, &too_many_sv, 1e0)) ++errors;
+    // within an ulp of the coordinates (~1e-9 m); the clock states, close to
+    // zero, agree to ~1e-14 m
+    for (int i=0; i<5; i++)
+      max_diff = std::max(max_diff, std::abs(filter.state(i)-ref.x(i)));
+    if (kalman_allocations || max_diff>1e-9) ++errors;
+    std::printf("\n# Kalman: %d updates, %ld heap allocations, max difference "
+      "from reference %.3e m; errors %d", num_epochs, kalman_allocations,
+      max_diff, errors);
+  }
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
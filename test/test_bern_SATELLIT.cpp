@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include <vector>
 #include "ggdatetime/dtcalendar.hpp"
 #include "ggdatetime/datetime_write.hpp"
@@ -6,10 +7,99 @@
 
 using ngpt::BernSatellit;
 
+// Write a SATELLIT file with overlapping validity intervals, for the same svn
+// and for the same prn (open-ended records left in place after a satellite
+// or a prn was reassigned), and check that the queries match the first record
+// covering the epoch, as a top to bottom read of the file would.
+int overlap_checks()
+{
+  const char* fn = "satellit_test.i20";
+  const char* header[] = {
+    "SATELLITE-SPECIFIC INFO FOR GPS/GLONASS/GEO/LEO/SLR, BSW5.2",
+    "",
+    "PART 2: ON-BOARD SENSORS",
+    "------------------------",
+    "                                              START TIME           END TIME                 SENSOR OFFSETS (M)       SENSOR BORESIGHT VECTOR (U) SENSOR AZIMUTH VECTOR (N)",
+    "PRN  TYPE  SENSOR NAME______SVN  NUMBER  YYYY MM DD HH MM SS  YYYY MM DD HH MM SS         DX        DY        DZ         X       Y       Z          X       Y       Z      ANTEX SENSOR NAME___  IFRQ  SIGNAL LIST___________------>",
+    ""};
+  struct Record { int prn, svn; const char *start, *stop; int ifrqn; };
+  const Record records[] = {
+    {101, 730, "2009 12 14 00 00 00", "                   ",  1},
+    {101, 755, "2014 06 14 00 00 00", "2016 01 01 00 00 00",  1},
+    {102, 730, "2015 01 01 00 00 00", "2016 01 01 00 00 00", -4},
+    {103, 801, "2016 01 01 00 00 00", "                   ",  5}};
+  if (std::FILE* fp = std::fopen(fn, "w")) {
+    for (const char* h : header) std::fprintf(fp, "%s\n", h);
+    for (const auto& r : records)
+      std::fprintf(fp, "%3d  MW    %-17s%-5d%-8s%s  %s%112s%4d\n", r.prn,
+        "GLONASS", r.svn, "", r.start, r.stop, "", r.ifrqn);
+    std::fprintf(fp, "\nPART 3: ...\n");
+    std::fclose(fp);
+  } else {
+    std::cerr<<"\n[ERROR] Failed to write "<<fn<<"\n";
+    return 1;
+  }
+
+  const ngpt::datetime<ngpt::seconds> d2010(ngpt::year(2010), ngpt::month(1),
+    ngpt::day_of_month(1), ngpt::seconds(0L));
+  const ngpt::datetime<ngpt::seconds> d2015(ngpt::year(2015), ngpt::month(6),
+    ngpt::day_of_month(1), ngpt::seconds(0L));
+  const ngpt::datetime<ngpt::seconds> d2020(ngpt::year(2020), ngpt::month(1),
+    ngpt::day_of_month(20), ngpt::seconds(0L));
+  // query (svn or prn), epoch, expected status and (prn or svn), ifrqn
+  struct Query {
+    int id;
+    ngpt::datetime<ngpt::seconds> t;
+    int status, id2, ifrqn;
+  };
+  const Query by_svn[] = {
+    {730, d2010,  0, 101,  1}, {730, d2015,  0, 101,  1},
+    {730, d2020,  0, 101,  1}, {755, d2015,  0, 101,  1},
+    {755, d2020, -1,   0,  0}, {801, d2010, -1,   0,  0},
+    {801, d2020,  0, 103,  5}, {999, d2020, -1,   0,  0}};
+  const Query by_prn[] = {
+    {101, d2015,  0, 730,  1}, {101, d2020,  0, 730,  1},
+    {102, d2015,  0, 730, -4}, {102, d2020, -1,   0,  0},
+    {103, d2010, -1,   0,  0}, {103, d2020,  0, 801,  5},
+    {104, d2020, -1,   0,  0}};
+
+  int errors=0;
+  try {
+    BernSatellit sat(fn);
+    if (sat.num_records()!=4) ++errors;
+    for (const auto& q : by_svn) {
+      int prn=0, frq=0;
+      const int status = sat.get_frequency_channel(q.id, q.t, frq, prn);
+      if (status!=q.status || (!status && (prn!=q.id2 || frq!=q.ifrqn))) {
+        std::printf("\n# SVN %d at %s: status %d, PRN %d, FRQ %d", q.id,
+          ngpt::strftime_ymd_hms(q.t).c_str(), status, prn, frq);
+        ++errors;
+      }
+    }
+    for (const auto& q : by_prn) {
+      int svn=0, frq=0;
+      const int status = sat.get_svn_and_channel(q.id, q.t, svn, frq);
+      if (status!=q.status || (!status && (svn!=q.id2 || frq!=q.ifrqn))) {
+        std::printf("\n# PRN %d at %s: status %d, SVN %d, FRQ %d", q.id,
+          ngpt::strftime_ymd_hms(q.t).c_str(), status, svn, frq);
+        ++errors;
+      }
+    }
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what();
+    ++errors;
+  }
+  std::remove(fn);
+
+  std::printf("\n# Overlapping records; Errors: %d\n", errors);
+  return errors>0;
+}
+
 int main(int argc, char* argv[])
 {
+  if (argc==1) return overlap_checks();
   if (argc!=2) {
-    std::cerr<<"\nUsage: test_SATELLIT <SATELLIT file>\n";
+    std::cerr<<"\nUsage: test_SATELLIT [SATELLIT file]\n";
     return 1;
   }
 
@@ -48,6 +138,22 @@ int main(int argc, char* argv[])
     }
   }
 
+  // reverse query: GLONASS prn to svn and frequency channel
+  int svn;
+  std::cout<<"\n# Read "<<sat.num_records()<<" records";
+  for (int i=1; i<25; i++) {
+    status = sat.get_svn_and_channel(ngpt::SATELLITE_SYSTEM::glonass, i, d2, svn, frq);
+    if (status>0) {
+      std::cerr<<"\n[ERROR] Error encountered while searching for sat with prn="<<i;
+      std::cerr<<"\n[ERROR] Return status is: "<<status;
+      return 2;
+    } else if (status<0) {
+      std::cerr<<"\nSatellite with prn=R"<<i<<" for epoch "<<ngpt::strftime_ymd_hms(d2)<<" not matched!";
+    } else {
+      std::cout<<"\n"<<ngpt::strftime_ymd_hms(d2)<<" PRN: R"<<i<<" SVN: "<<svn<<" FRQ: "<<frq;
+    }
+  }
+
   std::cout<<"\n";
   return 0;
 }
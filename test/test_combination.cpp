@@ -0,0 +1,86 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include "satsys.hpp"
+#include "gnssobsrv.hpp"
+#include "combination.hpp"
+
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::ObservationCode;
+using ngpt::GnssObservable;
+using ngpt::satellite_system_traits;
+using ngpt::combination_traits;
+
+// Check the (compile-time) band frequencies and the coefficients of the
+// dual-frequency combinations.
+
+using gps12 = combination_traits<SATELLITE_SYSTEM::gps, 1, 2>;
+using gal15 = combination_traits<SATELLITE_SYSTEM::galileo, 1, 5>;
+using bds12 = combination_traits<SATELLITE_SYSTEM::beidou, 1, 2>;
+
+// frequencies and coefficients are compile-time constants
+static_assert(satellite_system_traits<SATELLITE_SYSTEM::gps>::band2frequency(1)
+  ==1575.42e0, "GPS L1");
+static_assert(satellite_system_traits<SATELLITE_SYSTEM::galileo>
+  ::band2frequency(7)==1207.140e0, "Galileo E5b");
+static_assert(satellite_system_traits<SATELLITE_SYSTEM::gps>::band2frequency(3)
+  ==0e0, "GPS has no band 3");
+static_assert(satellite_system_traits<SATELLITE_SYSTEM::glonass>
+  ::band2frequency(1, -7)==1602e0-7*0.5625e0, "GLONASS G1, channel -7");
+static_assert(gps12::if_coef1+gps12::if_coef2==1e0, "IF coefficients");
+// the (formerly hand-typed) GPS L1/L2 ionosphere-free coefficients
+static_assert(gps12::if_coef1==2.5457277801631593e0, "GPS IF coefficient");
+static_assert(gps12::if_coef2==-1.5457277801631593e0, "GPS IF coefficient");
+
+template <typename C>
+int check(const char* name)
+{
+  int errors=0;
+  const double f1=C::f1, f2=C::f2;
+  // IF: geometry preserved, first order ionosphere (~1/f^2) removed
+  if (std::abs(C::if_coef1+C::if_coef2-1e0)>1e-12
+    || std::abs(C::if_coef1/(f1*f1)+C::if_coef2/(f2*f2))>1e-18) ++errors;
+  // GF: geometry removed
+  if (C::gf_coef1+C::gf_coef2!=0e0) ++errors;
+  // WL and NL: geometry preserved; WL phase ionosphere equals NL code
+  // ionosphere (so that MW is ionosphere-free)
+  if (std::abs(C::wl_coef1+C::wl_coef2-1e0)>1e-12
+    || std::abs(C::nl_coef1+C::nl_coef2-1e0)>1e-12) ++errors;
+  const double wl_iono = -(C::wl_coef1/(f1*f1)+C::wl_coef2/(f2*f2));
+  const double nl_iono = C::nl_coef1/(f1*f1)+C::nl_coef2/(f2*f2);
+  if (std::abs(wl_iono-nl_iono)>1e-18) ++errors;
+  // wavelengths
+  if (std::abs(C::wl_wavelength-299792458e0/((f1-f2)*1e6))>1e-12
+    || C::nl_wavelength>=C::wl_wavelength) ++errors;
+  std::printf("\n# %-10s IF %+.12f %+.12f WL %6.4f m NL %6.4f m; errors %d",
+    name, C::if_coef1, C::if_coef2, C::wl_wavelength, C::nl_wavelength,
+    errors);
+  return errors;
+}
+
+int main()
+{
+  int errors=0;
+  errors += check<gps12>("GPS L1/L2");
+  errors += check<gal15>("GAL E1/E5a");
+  errors += check<bds12>("BDS B1/B2");
+
+  // observables built from the coefficients
+  const ObservationCode C1C("C1C"), C2W("C2W"), L1C("L1C"), L2W("L2W");
+  GnssObservable pc = gps12::make_iono_free(C1C, C2W);
+  GnssObservable hand(SATELLITE_SYSTEM::gps, C1C, 2.5457277801631593e0);
+  hand.add(SATELLITE_SYSTEM::gps, C2W, -1.5457277801631593e0);
+  if (pc!=hand) ++errors;
+  GnssObservable mw = gps12::make_melbourne_wubbena(L1C, L2W, C1C, C2W);
+  if (mw.size()!=4 || mw.is_of_mixed_satsys()) ++errors;
+  // f1*a1+f2*a2 of GF is f1-f2
+  if (std::abs(gps12::make_geometry_free(L1C, L2W).frequency()
+    -(1575.42e0-1227.60e0))>1e-9) ++errors;
+  // parts on bands not used by the system have a zero frequency
+  if (ngpt::__ObsPart(SATELLITE_SYSTEM::gps, ObservationCode("C7Q"))
+    .frequency(0)!=0e0) ++errors;
+  std::printf("\n# Observables: errors %d", errors);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
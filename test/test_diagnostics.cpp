@@ -0,0 +1,93 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "diagnostics.hpp"
+
+namespace diag = ngpt::diagnostics;
+
+// Check buffering, rate limiting and delivery of diagnostics, from one and
+// from several threads.
+
+constexpr int num_threads = 4;
+
+struct Collected {
+  std::vector<diag::Message> msgs;
+  long suppressed = 0;
+};
+
+// report n warnings from the same site
+void report_same(int n)
+{
+  for (int i=0; i<n; i++) diag::warning("Same site, message %d", i);
+}
+
+diag::Stats stats()
+{
+  diag::Stats s;
+  diag::stats(s);
+  return s;
+}
+
+int main()
+{
+  int errors=0;
+  Collected col;
+  diag::set_handler([&col](const diag::Message& m) {
+    col.msgs.push_back(m);
+    col.suppressed += m.suppressed;
+  });
+
+  // auto flush: messages are delivered immediately, formatted
+  diag::error("Failed to resolve \"%s\", status %d", "LEAP SECONDS", 32);
+  if (col.msgs.size()!=1 || col.msgs[0].level!=diag::Level::error
+    || std::strcmp(col.msgs[0].text,
+       "Failed to resolve \"LEAP SECONDS\", status 32")) ++errors;
+  std::printf("\n# Immediate delivery: errors %d", errors);
+
+  // rate limit: 5 per site per (long) interval; the rest are counted
+  col.msgs.clear();
+  diag::set_rate_limit(5, 3600e0);
+  report_same(100);
+  if (col.msgs.size()!=5) ++errors;
+  diag::set_rate_limit(5, 0e0);
+  report_same(1);
+  if (col.msgs.size()!=6 || col.msgs.back().suppressed!=95) ++errors;
+  std::printf("\n# Rate limit: %zu delivered, %ld suppressed; errors %d",
+    col.msgs.size(), col.suppressed, errors);
+
+  // no auto flush: messages are buffered (up to the ring size) and
+  // delivered at flush, or when the reporting thread exits
+  col.msgs.clear();
+  diag::set_rate_limit(0, 1e0);
+  diag::set_auto_flush(false);
+  report_same(10);
+  if (!col.msgs.empty()) ++errors;
+  if (diag::flush()!=10 || col.msgs.size()!=10) ++errors;
+  const diag::Stats before = stats();
+  {
+    std::vector<std::thread> threads;
+    for (int i=0; i<num_threads; i++) threads.emplace_back(report_same, 100);
+    for (auto& t : threads) t.join();
+  }
+  const diag::Stats after = stats();
+  const std::uint64_t buffered = after.reported-before.reported;
+  const std::uint64_t dropped = after.dropped-before.dropped;
+  if (buffered+dropped!=num_threads*100 || !dropped) ++errors;
+  if (col.msgs.size()!=10+buffered
+    || after.delivered-before.delivered!=buffered) ++errors;
+  std::printf("\n# %d threads: %lu buffered and delivered, %lu dropped; "
+    "errors %d", num_threads, (unsigned long)buffered, (unsigned long)dropped,
+    errors);
+
+  // previous handler is returned; the default one writes to std::cerr
+  diag::set_auto_flush(true);
+  auto prev = diag::set_handler(nullptr);
+  if (!prev) ++errors;
+  diag::warning("%s", "This one goes to stderr");
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
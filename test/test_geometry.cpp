@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "navrnx.hpp"
+#include "geometry.hpp"
+#include "ggeodesy/geodesy.hpp"
+#include "ggdatetime/datetime_write.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+int main(int argc, char* argv[])
+{
+  if (argc!=5) {
+    std::cerr<<"\n[ERROR] Run as: $>testGeometry <Nav. RINEX> <X> <Y> <Z>\n";
+    return 1;
+  }
+  const ngpt::StationGeometry station(std::atof(argv[2]), std::atof(argv[3]),
+                                      std::atof(argv[4]));
+  std::printf("\n# Station lat: %+12.6f lon: %+12.6f hgt: %10.3f",
+    ngpt::rad2deg(station.latitude()), ngpt::rad2deg(station.longitude()),
+    station.height());
+
+  // collect the first message of every GPS satellite
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  std::vector<NavDataFrame> msgs;
+  int j=0;
+  while (!(j=nav.read_next_record(block))) {
+    if (block.system()==SATELLITE_SYSTEM::gps) {
+      bool have_it = false;
+      for (const auto& m : msgs) if (m.prn()==block.prn()) have_it=true;
+      if (!have_it) msgs.push_back(block);
+    }
+  }
+  if (msgs.empty()) {
+    std::cerr<<"\n[ERROR] No GPS navigation messages found!\n";
+    return 2;
+  }
+
+  // compute geometry for all satellites at the first message's ToC
+  ngpt::datetime<seconds> t = msgs[0].toc();
+  std::vector<const NavDataFrame*> navs;
+  for (const auto& m : msgs) navs.push_back(&m);
+  ngpt::EpochGeometry geo;
+  int errors = geo.compute(station, t, navs.data(), navs.size());
+  std::cout<<"\n# Epoch: "<<ngpt::strftime_ymd_hms<seconds>(t)<<" Errors: "<<errors;
+  std::cout<<"\n# PRN Azimuth(deg) Elevation(deg) Range(km) Tau(ms) Clock(usec)";
+  for (std::size_t i=0; i<geo.size(); i++) {
+    if (geo.status[i]>0) {
+      std::printf("\nG%02d failed with status %d", navs[i]->prn(), geo.status[i]);
+      continue;
+    }
+    std::printf("\nG%02d %10.4f %+10.4f %14.3f %10.6f %+14.6f", navs[i]->prn(),
+      ngpt::rad2deg(geo.azimuth[i]), ngpt::rad2deg(geo.elevation[i]),
+      geo.range[i]*1e-3, geo.tau[i]*1e3, geo.clock[i]*1e6);
+  }
+
+  std::cout<<"\n";
+  return 0;
+}
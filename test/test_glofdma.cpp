@@ -0,0 +1,72 @@
+#include <iostream>
+#include <cstdio>
+#include <cassert>
+#include "glofdma.hpp"
+#include "bern_utils.hpp"
+
+using ngpt::GlonassFdmaTable;
+using ngpt::GnssObservable;
+using ngpt::ObservationCode;
+using ngpt::SATELLITE_SYSTEM;
+
+int main(int argc, char* argv[])
+{
+  if (argc>2) {
+    std::cerr<<"\nUsage: testGloFdma [SATELLIT file]\n";
+    return 1;
+  }
+
+  // resolve a RINEX "GLONASS SLOT / FRQ #" block
+  const char* lines[] = {
+    " 22 R01  1 R02 -4 R03  5 R04  6 R05  1 R06 -4 R07  5 R08  6 GLONASS SLOT / FRQ #",
+    "    R09 -2 R10 -7 R11  0 R12 -1 R13 -2 R14 -7 R15  0 R16 -1 GLONASS SLOT / FRQ #",
+    "    R17  4 R18 -3 R19  3 R20  2 R21  4 R22 -3                GLONASS SLOT / FRQ #"};
+  GlonassFdmaTable table;
+  for (const auto l : lines) {
+    if (table.resolve_rnx_line(l)) {
+      std::cerr<<"\n[ERROR] Failed to resolve line: \""<<l<<"\"";
+      return 2;
+    }
+  }
+  assert(table.size()==22);
+  assert(table.channel(10)==-7 && table.channel(4)==6);
+  assert(!table.has_channel(23));
+
+  // ionosphere-free combination of G1/G2; frequencies per slot
+  GnssObservable g1(SATELLITE_SYSTEM::glonass, ObservationCode("C1C"), 1e0);
+  GnssObservable g2(SATELLITE_SYSTEM::glonass, ObservationCode("C2C"), 1e0);
+  double f1[GlonassFdmaTable::max_slot+1], f2[GlonassFdmaTable::max_slot+1];
+  table.observable_frequencies(g1, f1);
+  table.observable_frequencies(g2, f2);
+  std::cout<<"\n# Slot Channel     G1(MHz)     G2(MHz)  G1/G2";
+  for (int slot=1; slot<=GlonassFdmaTable::max_slot; slot++) {
+    if (!table.has_channel(slot)) continue;
+    assert(f1[slot]==table.frequency(slot, 1));
+    std::printf("\nR%02d %+4d %12.4f %12.4f %8.6f", slot, table.channel(slot),
+      f1[slot], f2[slot], f1[slot]/f2[slot]);
+  }
+
+  // the nominal frequency of an FDMA signal is not defined
+  try {
+    g1.frequency();
+    std::cerr<<"\n[ERROR] Expected an exception for a GLONASS FDMA signal";
+    return 3;
+  } catch (std::runtime_error&) {
+    ;
+  }
+
+  // fill the table from a SATELLIT file
+  if (argc==2) {
+    ngpt::BernSatellit bern(argv[1]);
+    ngpt::datetime<ngpt::seconds> t(ngpt::year(2020), ngpt::month(1),
+      ngpt::day_of_month(20), ngpt::hours(12), ngpt::minutes(59), ngpt::seconds(3));
+    int num = table.set_from_bern(bern, t);
+    std::cout<<"\n# Resolved "<<num<<" slots from SATELLIT";
+    for (int slot=1; slot<=GlonassFdmaTable::max_slot; slot++)
+      if (table.has_channel(slot))
+        std::printf("\nR%02d %+4d", slot, table.channel(slot));
+  }
+
+  std::cout<<"\n";
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include "navrnx.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+
+// Regression test for the GLONASS orbit integration (NavDataFrame::glo_ecef),
+// in both directions from the ToE and at offsets that are not a multiple of
+// the (60 sec) Runge-Kutta step, on two messages written here:
+//  * the position must follow the velocity (the integration used to stop at
+//    the first step past the requested epoch, i.e. up to a minute late, so
+//    that neighbouring epochs gave the same state),
+//  * close to the ToE, the position must match a second order expansion.
+
+const char* records[] = {
+  "     3.04           N: GNSS NAV DATA    M: MIXED            RINEX VERSION / TYPE",
+  "test                test                20201007 000000 GPS PGM / RUN BY / DATE ",
+  "    18                                                      LEAP SECONDS        ",
+  "                                                            END OF HEADER       ",
+  "R01 2020 10 07 00 00 00 3.688388833124E-05 7.569486302284E-12 2.592000000000E+05",
+  "     2.550859090501E+04 6.662191479034E-03 0.000000000000E+00 0.000000000000E+00",
+  "     6.829183888958E+01-1.836674582230E-01 0.000000000000E+00 1.000000000000E+00",
+  "    -4.435024942849E+01 3.579892504655E+00 0.000000000000E+00 0.000000000000E+00",
+  "R02 2020 10 07 00 15 00 1.484185207014E-05 7.881739652866E-12 2.601000000000E+05",
+  "    -1.316721279800E+04 1.361787044251E+00 0.000000000000E+00 0.000000000000E+00",
+  "     4.445243120130E+03-2.596595009923E+00 0.000000000000E+00-4.000000000000E+00",
+  "     2.138880901570E+04 1.378065436916E+00 0.000000000000E+00 0.000000000000E+00"};
+
+int main()
+{
+  const char* fn = "glonav_test.rnx";
+  if (std::FILE* fp = std::fopen(fn, "w")) {
+    for (const char* r : records) std::fprintf(fp, "%s\n", r);
+    std::fclose(fp);
+  } else {
+    std::cerr<<"\n[ERROR] Failed to write "<<fn<<"\n";
+    return 1;
+  }
+
+  // offsets from ToE in seconds; the state is also computed 1 sec before and
+  // after each, so the largest stay within the 15 min fit interval
+  const long offsets[] = {-899L, -600L, -451L, -61L, -59L, -1L, 1L, 30L, 59L,
+    60L, 61L, 119L, 333L, 899L};
+  int errors=0, checks=0, messages=0;
+  double max_vel=0e0, max_exp=0e0;
+  NavigationRnx nav(fn);
+  NavDataFrame m;
+  while (!nav.read_next_record(m)) {
+    if (m.system()!=SATELLITE_SYSTEM::glonass) continue;
+    ++messages;
+    const auto toe = m.toe<ngpt::seconds>();
+    double s0[6], sm[6], sp[6], s[6], clock;
+    if (m.stateNclock(toe, s0, clock)) {
+      ++errors;
+      continue;
+    }
+    // acceleration at ToE in the (rotating) PZ-90 frame: central body,
+    // centrifugal and Coriolis terms
+    constexpr double we = 7.2921150e-5;
+    const double r = std::sqrt(s0[0]*s0[0]+s0[1]*s0[1]+s0[2]*s0[2]);
+    double acc[3];
+    for (int i=0; i<3; i++) acc[i] = -398600.44e9*s0[i]/(r*r*r);
+    acc[0] += we*we*s0[0] + 2e0*we*s0[4];
+    acc[1] += we*we*s0[1] - 2e0*we*s0[3];
+    for (long dt : offsets) {
+      auto t = toe, tm = toe, tp = toe;
+      if (dt>0) t.add_seconds(ngpt::seconds(dt));
+      else t.remove_seconds(ngpt::seconds(-dt));
+      tm = t; tm.remove_seconds(ngpt::seconds(1L));
+      tp = t; tp.add_seconds(ngpt::seconds(1L));
+      if (m.stateNclock(t, s, clock) || m.stateNclock(tm, sm, clock)
+        || m.stateNclock(tp, sp, clock)) {
+        ++errors;
+        continue;
+      }
+      ++checks;
+      // central difference of the position against the velocity (m/s)
+      double dv=0e0;
+      for (int i=0; i<3; i++) dv += std::pow((sp[i]-sm[i])/2e0-s[i+3], 2);
+      max_vel = std::max(max_vel, std::sqrt(dv));
+      if (std::sqrt(dv)>1e-3) ++errors;
+      // second order expansion around ToE (m); the neglected terms (J2,
+      // Earth rotation, luni-solar, third order) stay below a few meters
+      // within a minute
+      if (std::abs(dt)<=61L) {
+        double dp=0e0;
+        for (int i=0; i<3; i++)
+          dp += std::pow(s[i]-s0[i]-s0[i+3]*dt-acc[i]*dt*dt/2e0, 2);
+        max_exp = std::max(max_exp, std::sqrt(dp));
+        if (std::sqrt(dp)>10e0) ++errors;
+      }
+    }
+  }
+  if (messages!=2) ++errors;
+  std::remove(fn);
+  std::printf("\n# Messages %d, checks %d", messages, checks);
+  std::printf("\n# Max velocity residual %.3e m/s, max expansion residual "
+    "%.3f m", max_vel, max_exp);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
@@ -1,12 +1,26 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstdlib>
+#include <new>
 #include "gnssobs.hpp"
 #include "gnssobsrv.hpp"
 
 using ngpt::SATELLITE_SYSTEM;
 using ngpt::ObservationCode;
 using ngpt::GnssRawObservable;
+using ngpt::GnssObservable;
+
+// count global heap allocations
+static long allocations = 0;
+void* operator new(std::size_t sz)
+{
+  ++allocations;
+  if (void* p = std::malloc(sz ? sz : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
 
 int main(/*int argc, char* argv[]*/)
 {
@@ -43,6 +57,32 @@ int main(/*int argc, char* argv[]*/)
   assert(op==ngpt::__ObsPart(GnssRawObservable(SATELLITE_SYSTEM::glonass, ObservationCode("L5Q")),
     1e0));
   
+
+  // GnssObservable: terms are stored inline; constructing, copying and
+  // comparing do not allocate and the const accessor is a view
+  const ObservationCode L1C("L1C"), L2W("L2W"), C1C("C1C"), C2W("C2W");
+  long before = allocations;
+  GnssObservable mw(SATELLITE_SYSTEM::gps, L1C, 0.5e0);
+  assert(!mw.add(SATELLITE_SYSTEM::gps, L2W, -0.5e0));
+  assert(!mw.add(SATELLITE_SYSTEM::gps, C1C, -0.5e0));
+  assert(!mw.add(GnssRawObservable(SATELLITE_SYSTEM::gps, C2W), -0.5e0));
+  assert(mw.size()==GnssObservable::max_parts);
+  assert(mw.add(SATELLITE_SYSTEM::gps, C1C, 1e0)==1);
+  assert(mw.size()==GnssObservable::max_parts);
+  GnssObservable mw2(SATELLITE_SYSTEM::gps, C2W, -0.5e0);
+  mw2.add(SATELLITE_SYSTEM::gps, C1C, -0.5e0);
+  mw2.add(SATELLITE_SYSTEM::gps, L2W, -0.5e0);
+  mw2.add(SATELLITE_SYSTEM::gps, L1C, 0.5e0);
+  assert(mw==mw2);
+  GnssObservable copy(mw);
+  copy.underlying_vector()[1].__coef = 0.5e0;
+  assert(copy!=mw && !mw.is_of_mixed_satsys());
+  const auto& cmw = mw;
+  auto terms = cmw.underlying_vector();
+  assert(terms.size()==4 && &terms[0]==&*mw.underlying_vector().begin());
+  assert(terms[3].type()==GnssRawObservable(SATELLITE_SYSTEM::gps, C2W));
+  assert(allocations==before);
+
   assert(!EXIT_STATUS);
   std::cout << "\n";
   return 0;
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "instrument.hpp"
+#include "kepler.hpp"
+#include "navrnx.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::instrument::Counter;
+using ngpt::instrument::Snapshot;
+using ngpt::instrument::Stage;
+
+// Check the instrumentation counters and timers; with a navigation RINEX,
+// also check the counts of the library's hot paths. If the library is built
+// without instrumentation, all values must be zero.
+
+constexpr int num_threads = 4;
+constexpr int events_per_thread = 100000;
+
+std::uint64_t counter(const Snapshot& s, Counter c)
+{
+  return s.counters[static_cast<int>(c)];
+}
+
+std::uint64_t calls(const Snapshot& s, Stage st)
+{
+  return s.calls[static_cast<int>(st)];
+}
+
+// every thread records events_per_thread events and timed scopes
+void record(int)
+{
+  for (int i=0; i<events_per_thread; i++) {
+    NGPT_TIME_SCOPE(filter_update);
+    NGPT_COUNT(filter_updates);
+    NGPT_COUNT_N(epochs_parsed, 2);
+  }
+}
+
+// read a navigation file and compute a state for every message
+int check_nav(const char* fn, int& errors)
+{
+  NavigationRnx nav(fn);
+  std::vector<ngpt::NavDataFrame> frames;
+  if (int j=nav.read_all_records(frames); j) {
+    std::cerr<<"\n[ERROR] Failed to read "<<fn<<"; error: "<<j;
+    return 1;
+  }
+  long kepler=0, glonass=0;
+  double state[6], clock;
+  for (const auto& f : frames) {
+    if (f.system()==ngpt::SATELLITE_SYSTEM::glonass) {
+      if (f.stateNclock(f.toe<ngpt::seconds>(), state, clock, 120e0))
+        continue;
+      ++glonass;
+    } else if (f.system()==ngpt::SATELLITE_SYSTEM::gps
+        || f.system()==ngpt::SATELLITE_SYSTEM::galileo
+        || f.system()==ngpt::SATELLITE_SYSTEM::beidou) {
+      if (f.stateNclock(f.toe<ngpt::seconds>(), state, clock, 600e0))
+        continue;
+      ++kepler;
+    }
+  }
+
+  Snapshot s;
+  ngpt::instrument::snapshot(s);
+  std::printf("\n# %s: %zu messages, %ld Keplerian and %ld GLONASS states",
+    fn, frames.size(), kepler, glonass);
+  if (!s.enabled) return 0;
+  if (counter(s, Counter::nav_seeks)<1) ++errors;
+  if (calls(s, Stage::nav_record)<frames.size()) ++errors;
+  if (calls(s, Stage::kepler_state)<static_cast<std::uint64_t>(kepler)
+    || counter(s, Counter::kepler_iterations)<
+       static_cast<std::uint64_t>(kepler)) ++errors;
+  if (calls(s, Stage::glonass_state)<static_cast<std::uint64_t>(glonass)
+    || counter(s, Counter::rk4_steps)<2*static_cast<std::uint64_t>(glonass))
+    ++errors;
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc>2) {
+    std::cerr<<"\n[ERROR] Run as: $>testInstrument [<Nav. RINEX>]\n";
+    return 1;
+  }
+
+  int errors=0;
+  Snapshot s;
+
+  // events of several threads (all exited) are summed
+  {
+    std::vector<std::thread> threads;
+    for (int i=0; i<num_threads; i++) threads.emplace_back(record, i);
+    for (auto& t : threads) t.join();
+  }
+  record(num_threads);
+  ngpt::instrument::snapshot(s);
+#ifdef NGPT_INSTRUMENT
+  const std::uint64_t n = (num_threads+1)*(std::uint64_t)events_per_thread;
+  if (!s.enabled) {
+    std::cerr<<"\n[ERROR] Library built without NGPT_INSTRUMENT";
+    ++errors;
+  }
+  if (s.threads!=num_threads+1) ++errors;
+  if (counter(s, Counter::filter_updates)!=n
+    || counter(s, Counter::epochs_parsed)!=2*n) ++errors;
+  if (calls(s, Stage::filter_update)!=n
+    || !s.ticks[static_cast<int>(Stage::filter_update)]) ++errors;
+  if (s.ticks_per_second<=0e0) ++errors;
+#else
+  if (s.enabled) {
+    std::cerr<<"\n[ERROR] Library built with NGPT_INSTRUMENT, this test not";
+    ++errors;
+  }
+  for (int i=0; i<ngpt::instrument::num_counters; i++)
+    if (s.counters[i]) ++errors;
+#endif
+  std::printf("\n# After %d threads: errors %d", num_threads+1, errors);
+
+  // reset zeros everything; iterations of solve_kepler are counted
+  ngpt::instrument::reset();
+  double E;
+  int it = ngpt::solve_kepler(1e0, 0.01e0, E);
+  ngpt::instrument::snapshot(s);
+  for (int i=0; i<ngpt::instrument::num_stages; i++)
+    if (s.calls[i] || s.ticks[i]) ++errors;
+  if (counter(s, Counter::kepler_iterations)
+      !=(s.enabled ? static_cast<std::uint64_t>(it) : 0)) ++errors;
+  std::printf("\n# After reset: errors %d", errors);
+
+  if (argc==2) {
+    ngpt::instrument::reset();
+    if (check_nav(argv[1], errors)) return 2;
+    std::printf("\n# After navigation file: errors %d", errors);
+  }
+
+  ngpt::instrument::snapshot(s);
+  std::printf("\n%s", ngpt::instrument::to_json(s).c_str());
+  std::printf("# Errors: %d\n", errors);
+  return errors>0;
+}
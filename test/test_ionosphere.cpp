@@ -0,0 +1,174 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include "navrnx.hpp"
+#include "ionosphere.hpp"
+#include "ggeodesy/geodesy.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::IONO_CORR_TYPE;
+using ngpt::SATELLITE_SYSTEM;
+
+// Write a navigation RINEX header holding the given records (label in
+// columns 61-80) and return the number of errors in reading it back:
+// a stale errno must not fail a valid header, and a field with anything
+// other than blanks after the number must fail it.
+static int header_checks()
+{
+  const char* fn = "iono_header.rnx";
+  auto write = [fn](const char* const* recs, int n) {
+    std::FILE* fp = std::fopen(fn, "w");
+    if (!fp) return false;
+    std::fprintf(fp, "%-60s%-20s\n", "     3.04           N: GNSS NAV DATA    "
+      "M: MIXED", "RINEX VERSION / TYPE");
+    for (int i=0; i<n; i++) std::fprintf(fp, "%s\n", recs[i]);
+    std::fprintf(fp, "%60s%-20s\n", "", "END OF HEADER");
+    std::fclose(fp);
+    return true;
+  };
+  const char* valid[] = {
+    "GPSA   1.1176D-08  7.4506E-09 -5.9605E-08 -5.9605E-08       IONOSPHERIC CORR    ",
+    "GPUT -9.3132257462E-10-8.881784197E-16 233472 2130          TIME SYSTEM CORR    ",
+    "    18    18  2185     7                                    LEAP SECONDS        "};
+  const char* garbage[] = {
+    "GPSA   1.1176E-8x  7.4506E-09 -5.9605E-08 -5.9605E-08       IONOSPHERIC CORR    "};
+
+  int errors=0;
+  if (!write(valid, 3)) return 1;
+  errno = ERANGE;
+  try {
+    NavigationRnx nav(fn);
+    double alpha[4];
+    ngpt::TimeSystemCorrection c;
+    if (nav.ionospheric_corr(IONO_CORR_TYPE::gpsa, alpha)
+      || alpha[0]!=1.1176e-08 || alpha[3]!=-5.9605e-08) ++errors;
+    if (nav.time_system_corr("GPUT", c) || c.a0!=-9.3132257462e-10
+      || c.a1!=-8.881784197e-16 || c.t_ref!=233472L || c.week!=2130) ++errors;
+    if (!nav.has_leap_seconds() || nav.leap_seconds().delta_ls!=18
+      || nav.leap_seconds().dn!=7) ++errors;
+  } catch (std::exception&) {
+    ++errors;
+  }
+  std::printf("\n# Header with stale errno: errors %d", errors);
+  if (!write(garbage, 1)) return errors+1;
+  try {
+    NavigationRnx nav(fn);
+    ++errors;
+  } catch (std::exception&) {}
+  std::printf("\n# Header with trailing garbage in a field: errors %d",
+    errors);
+  std::remove(fn);
+  return errors;
+}
+
+// Without arguments, check the models against reference values, derived by
+// hand from IS-GPS-200 (zenith, 14h local time, where the GPS delay reduces
+// to c*F*(5e-9 + alpha0)) and the BDS-SIS-ICD (zenith and off-zenith).
+static int reference_checks()
+{
+  int errors=0;
+  auto check = [&](const char* what, double value, double ref, double tol) {
+    const bool ok = std::abs(value-ref)<=tol;
+    std::printf("\n# %-36s %14.9f ref %14.9f %s", what, value, ref,
+      ok?"ok":"FAILED");
+    if (!ok) ++errors;
+  };
+
+  // Klobuchar (GPS), station at (0, 0), zenith, t = 14h
+  {
+    const double alpha[4] = {2e-8, 0e0, 0e0, 0e0};
+    const double beta[4] = {1e5, 0e0, 0e0, 0e0};
+    ngpt::Klobuchar klb(SATELLITE_SYSTEM::gps, alpha, beta, 0e0, 0e0);
+    check("Klobuchar zenith, 14h (m)", klb.slant_delay(50400e0, 0e0,
+      ngpt::DPI/2e0), 7.498049209e0, 1e-8);
+    // night-time floor: c*F*5e-9
+    check("Klobuchar zenith, 2h (m)", klb.slant_delay(7200e0, 0e0,
+      ngpt::DPI/2e0), 1.499609842e0, 1e-8);
+  }
+
+  // Klobuchar (BeiDou), station at (0, 0); at the zenith the pierce point
+  // is the station and the delay reduces to c*(5e-9 + A2*cos(2pi(t-50400)/A4))
+  // with A2 = alpha0 and A4 = beta0
+  {
+    const double alpha[4] = {2e-8, 1e-8, 0e0, 0e0};
+    const double beta[4] = {1e5, 0e0, 0e0, 0e0};
+    ngpt::Klobuchar klb(SATELLITE_SYSTEM::beidou, alpha, beta, 0e0, 0e0);
+    check("BDS Klobuchar zenith, 14h (m)", klb.slant_delay(50400e0, 0e0,
+      ngpt::DPI/2e0), 7.494811450e0, 1e-8);
+    check("BDS Klobuchar zenith, 17h28m20s (m)", klb.slant_delay(62900e0,
+      0e0, ngpt::DPI/2e0), 5.738667890e0, 1e-8);
+    // night-time floor, |t-50400| >= A4/4: c*5e-9
+    check("BDS Klobuchar zenith, 2h (m)", klb.slant_delay(7200e0, 0e0,
+      ngpt::DPI/2e0), 1.498962290e0, 1e-8);
+    // elevation 30 deg due North: the pierce point (375 km shell) is at
+    // latitude psi = 5.1215 deg, so A2 = alpha0 + alpha1*psi/180; mapped with
+    // 1/sqrt(1-(R/(R+h)*cos(el))^2)
+    const double az[2] = {0e0, 0e0};
+    const double el[2] = {ngpt::deg2rad(30e0), ngpt::deg2rad(30e0)};
+    double delay[2];
+    klb.slant_delay(50400e0+86400e0, az, el, 2, delay);
+    check("BDS Klobuchar el 30 deg, 14h (m)", delay[1], 13.175657831e0,
+      1e-8);
+  }
+
+  errors += header_checks();
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc==1) return reference_checks();
+  if (argc!=4) {
+    std::cerr<<"\n[ERROR] Run as: $>testIonosphere [<Nav. RINEX> <lat (deg)>"
+             <<" <lon (deg)>]\n";
+    return 1;
+  }
+  const double lat = ngpt::deg2rad(std::atof(argv[2]));
+  const double lon = ngpt::deg2rad(std::atof(argv[3]));
+
+  // header records
+  NavigationRnx nav(argv[1]);
+  for (const auto& c : nav.time_system_corr())
+    std::printf("\n# TIME SYSTEM CORR %s a0=%+.10e a1=%+.9e t=%ld w=%d %s",
+      c.type, c.a0, c.a1, c.t_ref, c.week, c.source);
+  if (nav.has_leap_seconds())
+    std::printf("\n# LEAP SECONDS %d", nav.leap_seconds().delta_ls);
+
+  // evaluate for a set of azimuths/elevations, every 3 hours
+  constexpr int N = 4;
+  const double az[N] = {0e0, ngpt::DPI/2e0, ngpt::DPI, 3e0*ngpt::DPI/2e0};
+  double el[N], delay[N];
+  for (int i=0; i<N; i++) el[i] = ngpt::deg2rad(90e0 - i*25e0);
+  auto print = [&](const char* name, double t) {
+    std::printf("\n%s t=%6.0f", name, t);
+    for (int i=0; i<N; i++) std::printf(" %7.3f", delay[i]);
+  };
+
+  double alpha[4], beta[4];
+  int models = 0;
+  if (!nav.ionospheric_corr(IONO_CORR_TYPE::gpsa, alpha)
+      && !nav.ionospheric_corr(IONO_CORR_TYPE::gpsb, beta)) {
+    ngpt::Klobuchar klb(SATELLITE_SYSTEM::gps, alpha, beta, lat, lon);
+    for (double t=0e0; t<86400e0; t+=10800e0) {
+      klb.slant_delay(t, az, el, N, delay);
+      print("GPS", t);
+    }
+    ++models;
+  }
+  if (!nav.ionospheric_corr(IONO_CORR_TYPE::bdsa, alpha)
+      && !nav.ionospheric_corr(IONO_CORR_TYPE::bdsb, beta)) {
+    ngpt::Klobuchar klb(SATELLITE_SYSTEM::beidou, alpha, beta, lat, lon);
+    for (double t=0e0; t<86400e0; t+=10800e0) {
+      klb.slant_delay(t, az, el, N, delay);
+      print("BDS", t);
+    }
+    ++models;
+  }
+  std::cout<<"\n# Models evaluated: "<<models<<"\n";
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include "navrnx.hpp"
+#include "kepler_ephemeris.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::KeplerEphemeris;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+int main(int argc, char* argv[])
+{
+  if (argc!=2) {
+    std::cerr<<"\n[ERROR] Run as: $>testKeplerEphemeris <Nav. RINEX>\n";
+    return 1;
+  }
+
+  // for every GPS/Galileo/BeiDou message, compare the prepared ephemeris to
+  // NavDataFrame::stateNclock at ToE, ToE+1h and ToE+2h
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  KeplerEphemeris eph;
+  double state[6], pstate[6], clock, pclock;
+  double max_pos=0e0, max_clk=0e0;
+  int j, frames=0;
+  while (!(j=nav.read_next_record(block))) {
+    auto sys = block.system();
+    if (sys!=SATELLITE_SYSTEM::gps && sys!=SATELLITE_SYSTEM::galileo
+        && sys!=SATELLITE_SYSTEM::beidou) continue;
+    if (eph.set(block)) {
+      std::cerr<<"\n[ERROR] Failed to prepare ephemeris";
+      return 2;
+    }
+    auto t = block.toe<seconds>();
+    for (int h=0; h<3; h++) {
+      if (block.stateNclock(t, state, clock) || eph.stateNclock(t, pstate, pclock)) {
+        std::cerr<<"\n[ERROR] Failed to compute state";
+        return 3;
+      }
+      for (int k=0; k<3; k++)
+        max_pos = std::max(max_pos, std::abs(state[k]-pstate[k]));
+      max_clk = std::max(max_clk, std::abs(clock-pclock));
+      t.add_seconds(seconds(3600L));
+    }
+    ++frames;
+  }
+  std::cout<<"\n# Compared "<<frames<<" navigation frames";
+  std::printf("\n# Max position diff: %.6e m, max clock diff: %.6e s",
+    max_pos, max_clk);
+
+  std::cout<<"\n";
+  return (max_pos>1e-3);
+}
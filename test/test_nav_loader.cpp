@@ -0,0 +1,154 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "navrnx.hpp"
+#include "nvarstr.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::seconds;
+
+// Resolve a field with __fixed2double__ and with std::strtod (after
+// replacing the Fortran exponent); the two must agree bit by bit. Fields out
+// of range (strtod sets ERANGE) must be rejected, as they are by the
+// readers (see __char2double__).
+static int check_field(const char* field)
+{
+  char buf[64];
+  const int width = static_cast<int>(std::strlen(field));
+  for (int i=0; i<=width; i++)
+    buf[i] = (field[i]=='D' || field[i]=='d') ? 'E' : field[i];
+  errno = 0;
+  const double ref = std::strtod(buf, nullptr);
+  const bool range = (errno==ERANGE);
+  errno = 0;
+  double val;
+  const bool ok = ngpt::__fixed2double__(field, width, val);
+  if (range) {
+    if (ok) std::printf("\n# Field \"%s\" out of range, not rejected", field);
+    return ok;
+  }
+  if (!ok || std::memcmp(&val, &ref, sizeof(double))) {
+    std::printf("\n# Field \"%s\": %.17e, strtod %.17e", field, val, ref);
+    return 1;
+  }
+  return 0;
+}
+
+// Compare __fixed2double__ against std::strtod on a corpus of fields: hand
+// picked edge cases (exponent markers, signs, long mantissas, scales out of
+// the exact range, subnormals) and random doubles written as in RINEX
+// (D19.12) and with other precisions.
+static int check_fields()
+{
+  const char* corpus[] = {
+    " 1.234567890123D+04", "-1.234567890123D-04", " 0.000000000000D+00",
+    "-0.000000000000D+00", " 1.000000000000E+00", " 9.999999999999e-01",
+    " 4.656612873077d-10", "-2.328306436539D-09", " 2.980232238770D-08",
+    " 3.000000000000D+08", " 1.999999999999D+22", " 1.999999999999D+23",
+    " 1.234567890123D-23", " 1.234567890123D-40", " 4.940656458412D-324",
+    " 2.225073858507D-308", " 2.225073858508D-308", " 1.797693134862D+308",
+    " 1.797693134863D+308", " 1.000000000000D+309", "  .123456789012D+01",
+    " 1.23456789012345678", " 123456789012345678", "1234567890123456789",
+    " 0.1", " 1.", " 7", " +5.5D+0", " 3.0D0", " 1.0E-5   ",
+    " 9007199254740993.0", " 0.30000000000000004", "-5.000000000000D-01"};
+  int errors=0;
+  for (const char* f : corpus) errors += check_field(f);
+
+  std::mt19937_64 rng(20201007ULL);
+  std::uniform_int_distribution<int> prec(1, 15);
+  std::uniform_real_distribution<double> mant(-10e0, 10e0);
+  std::uniform_int_distribution<int> expo(-40, 40);
+  char field[64];
+  int fields=sizeof(corpus)/sizeof(corpus[0]);
+  for (int i=0; i<200000; i++, fields++) {
+    const double x = mant(rng)*std::pow(10e0, expo(rng));
+    if (i%2) {
+      std::snprintf(field, sizeof(field), "%19.12E", x);
+    } else {
+      const int p = prec(rng);
+      std::snprintf(field, sizeof(field), "%*.*E", p+8, p, x);
+    }
+    if (char* e=std::strchr(field, 'E'); e && i%3) *e = 'D';
+    errors += check_field(field);
+  }
+  std::printf("\n# Fields checked against strtod: %d, mismatches %d",
+    fields, errors);
+  return errors;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc>3) {
+    std::cerr<<"\n[ERROR] Run as: $>testNavLoader [<Nav. RINEX> [threads]]\n";
+    return 1;
+  }
+  if (int j=check_fields(); j || argc==1) {
+    std::cout<<"\n";
+    return j>0;
+  }
+  int threads = (argc==3) ? std::atoi(argv[2]) : 0;
+
+  // serial read, block by block
+  std::vector<NavDataFrame> serial;
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    NavigationRnx nav(argv[1]);
+    NavDataFrame block;
+    int j;
+    while (!(j=nav.read_next_record(block))) serial.push_back(block);
+    if (j>0) {
+      std::cerr<<"\n[ERROR] Serial read failed; error: "<<j<<"\n";
+      return 2;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // parallel read
+  std::vector<NavDataFrame> parallel;
+  {
+    NavigationRnx nav(argv[1]);
+    if (int j=nav.read_all_records(parallel, threads); j) {
+      std::cerr<<"\n[ERROR] Parallel read failed; error: "<<j<<"\n";
+      return 3;
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::printf("\n# Records: serial %zu, parallel %zu", serial.size(),
+    parallel.size());
+  std::printf("\n# Time (ms): serial %.3f, parallel %.3f",
+    std::chrono::duration<double, std::milli>(t1-t0).count(),
+    std::chrono::duration<double, std::milli>(t2-t1).count());
+  if (serial.size()!=parallel.size()) {
+    std::cerr<<"\n[ERROR] Number of records mismatch\n";
+    return 4;
+  }
+
+  // all records must be (bitwise) identical
+  int errors=0;
+  for (std::size_t i=0; i<serial.size(); i++) {
+    const auto& a = serial[i];
+    const auto& b = parallel[i];
+    bool same = a.system()==b.system() && a.prn()==b.prn()
+      && a.toc<seconds>()==b.toc<seconds>();
+    for (int k=0; k<31 && same; k++) {
+      double da=a.data(k), db=b.data(k);
+      same = !std::memcmp(&da, &db, sizeof(double));
+    }
+    if (!same) {
+      if (!errors) std::cerr<<"\n[ERROR] First mismatch at record "<<i;
+      ++errors;
+    }
+  }
+  std::printf("\n# Mismatched records: %d", errors);
+
+  std::cout<<"\n";
+  return errors>0;
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "navrnx.hpp"
+#include "nav_merge.hpp"
+#include "synthetic.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::NavMerger;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+bool identical(const NavDataFrame& a, const NavDataFrame& b)
+{
+  if (a.system()!=b.system() || a.prn()!=b.prn()
+      || a.toc<seconds>()!=b.toc<seconds>()) return false;
+  for (int k=0; k<31; k++) {
+    double da=a.data(k), db=b.data(k);
+    if (std::memcmp(&da, &db, sizeof(double))) return false;
+  }
+  return true;
+}
+
+int merge_files(char* files[], int n, bool reverse, NavMerger& merger,
+  std::vector<NavDataFrame>& merged)
+{
+  for (int i=0; i<n; i++) {
+    NavigationRnx nav(files[reverse ? n-1-i : i]);
+    if (int j=merger.add(nav); j) return j;
+  }
+  return merger.merge(merged);
+}
+
+// Two stations tracking the same (synthetic) GPS and GLONASS messages; the
+// second one decodes them from later frames, i.e. with a later transmission
+// time (GPS) or message frame time tk (GLONASS), and one of its GLONASS
+// messages has a different payload. Everything but that message must be
+// merged as duplicates, keeping the earliest transmission/frame time.
+int two_stations()
+{
+  ngpt::SyntheticConfig cfg;
+  cfg.year=2020; cfg.month=10; cfg.day=7;
+  cfg.duration=4*3600e0;
+  cfg.constellations.push_back(
+    ngpt::nominal_constellation(SATELLITE_SYSTEM::gps));
+  cfg.constellations.push_back(
+    ngpt::nominal_constellation(SATELLITE_SYSTEM::glonass));
+  std::vector<NavDataFrame> sta1;
+  try {
+    ngpt::SyntheticGenerator gen(cfg);
+    sta1 = gen.messages();
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 1;
+  }
+  std::vector<NavDataFrame> sta2(sta1);
+  std::size_t conflict = sta2.size();
+  for (std::size_t i=0; i<sta2.size(); i++) {
+    if (sta2[i].system()==SATELLITE_SYSTEM::glonass) {
+      sta2[i].data(2) += 30e0;
+      if (conflict==sta2.size()) {
+        sta2[i].data(3) += 1e-3;
+        conflict = i;
+      }
+    } else {
+      sta2[i].data(27) += 6e0;
+    }
+  }
+  const std::size_t n = sta1.size();
+
+  int errors=0;
+  std::vector<NavDataFrame> merged[2];
+  for (int order=0; order<2; order++) {
+    NavMerger merger;
+    for (const auto& f : (order ? sta2 : sta1)) merger.add(f);
+    for (const auto& f : (order ? sta1 : sta2)) merger.add(f);
+    if (merger.merge(merged[order])) return 1;
+    std::printf("\n# Two stations: input %zu, duplicates %zu, stored %zu, "
+      "conflicts %zu, merged %zu", merger.num_input(), merger.num_duplicates(),
+      merger.num_stored(), merger.num_conflicts(), merged[order].size());
+    if (merger.num_input()!=2*n || merger.num_duplicates()!=n-1
+      || merger.num_stored()!=n+1 || merger.num_conflicts()!=1
+      || merged[order].size()!=n) ++errors;
+  }
+  if (merged[0].size()!=merged[1].size()) ++errors;
+  for (std::size_t i=0; !errors && i<merged[0].size(); i++) {
+    const auto& f = merged[0][i];
+    if (!identical(f, merged[1][i])) ++errors;
+    // the earliest transmission/frame time is kept
+    const int k = (f.system()==SATELLITE_SYSTEM::glonass) ? 2 : 27;
+    for (const auto& s : sta1)
+      if (s.system()==f.system() && s.prn()==f.prn()
+        && s.toc<seconds>()==f.toc<seconds>() && s.data(k)!=f.data(k))
+        ++errors;
+  }
+  std::printf("\n# Two stations, errors: %d\n", errors);
+  return errors>0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc<2) return two_stations();
+
+  // merge all files, in the given order
+  NavMerger merger;
+  std::vector<NavDataFrame> merged;
+  if (int j=merge_files(argv+1, argc-1, false, merger, merged); j) {
+    std::cerr<<"\n[ERROR] Failed to merge files; error: "<<j<<"\n";
+    return 2;
+  }
+  std::printf("\n# Input messages: %zu, duplicates: %zu, stored: %zu, "
+    "conflicts: %zu, merged: %zu", merger.num_input(), merger.num_duplicates(),
+    merger.num_stored(), merger.num_conflicts(), merged.size());
+
+  // output must be sorted
+  int errors=0;
+  for (std::size_t i=1; i<merged.size(); i++) {
+    const auto& a = merged[i-1];
+    const auto& b = merged[i];
+    if (a.system()>b.system()
+        || (a.system()==b.system() && a.prn()>b.prn())
+        || (a.system()==b.system() && a.prn()==b.prn()
+            && a.toc<seconds>()>b.toc<seconds>()))
+      ++errors;
+  }
+  std::printf("\n# Unsorted pairs: %d", errors);
+
+  // merging in reverse order must give the same result
+  NavMerger rmerger;
+  std::vector<NavDataFrame> rmerged;
+  if (int j=merge_files(argv+1, argc-1, true, rmerger, rmerged); j) {
+    std::cerr<<"\n[ERROR] Failed to merge files; error: "<<j<<"\n";
+    return 2;
+  }
+  int diffs = (rmerged.size()!=merged.size());
+  for (std::size_t i=0; !diffs && i<merged.size(); i++)
+    if (!identical(merged[i], rmerged[i])) ++diffs;
+  std::printf("\n# Order dependent results: %d", diffs);
+
+  std::cout<<"\n";
+  return errors || diffs;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "navrnx.hpp"
+#include "nav_snapshot.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::NavSnapshot;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+int main(int argc, char* argv[])
+{
+  if (argc!=3) {
+    std::cerr<<"\n[ERROR] Run as: $>testNavSnapshot <Nav. RINEX> <snapshot>\n";
+    return 1;
+  }
+
+  // read all messages and write the snapshot
+  std::vector<NavDataFrame> frames;
+  {
+    NavigationRnx nav(argv[1]);
+    NavDataFrame block;
+    while (!nav.read_next_record(block)) frames.push_back(block);
+  }
+  if (int j=ngpt::write_nav_snapshot(argv[2], frames); j) {
+    std::cerr<<"\n[ERROR] Failed to write snapshot; error: "<<j<<"\n";
+    return 2;
+  }
+
+  // map it and compare every (GPS/Galileo/BeiDou) message at its ToC
+  NavSnapshot snap(argv[2]);
+  std::cout<<"\n# Snapshot records: "<<snap.size()<<", satellites: "
+           <<snap.num_satellites();
+  if (snap.size()!=frames.size()) {
+    std::cerr<<"\n[ERROR] Number of records mismatch\n";
+    return 3;
+  }
+  double state[6], sstate[6], clock, sclock;
+  double max_pos=0e0;
+  int compared=0, errors=0;
+  for (const auto& f : frames) {
+    auto sys = f.system();
+    if (sys!=SATELLITE_SYSTEM::gps && sys!=SATELLITE_SYSTEM::galileo
+        && sys!=SATELLITE_SYSTEM::beidou) continue;
+    auto t = f.toc<seconds>();
+    const auto* rec = snap.find(sys, f.prn(), t);
+    if (!rec || rec->toc_sec!=t.sec().as_underlying_type()) {
+      ++errors;
+      continue;
+    }
+    if (f.stateNclock(t, state, clock)
+        || snap.stateNclock(sys, f.prn(), t, sstate, sclock)) {
+      ++errors;
+      continue;
+    }
+    for (int k=0; k<3; k++)
+      max_pos = std::max(max_pos, std::abs(state[k]-sstate[k]));
+    ++compared;
+  }
+  std::printf("\n# Compared %d messages, lookup errors: %d, max position "
+    "diff: %.6e m", compared, errors, max_pos);
+
+  std::cout<<"\n";
+  return (max_pos>1e-3);
+}
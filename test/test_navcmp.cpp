@@ -0,0 +1,62 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "navrnx.hpp"
+#include "sp3c.hpp"
+#include "navcmp.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::Sp3c;
+using ngpt::NavCmpStats;
+using ngpt::NavCmpRecord;
+
+// Compare broadcast orbits/clocks against an Sp3 file; print per-satellite
+// statistics and optionally write them (and the per-epoch differences) to
+// CSV files.
+int main(int argc, char* argv[])
+{
+  if (argc<3 || argc>5) {
+    std::cerr<<"\n[ERROR] Run as: $>testNavCmp <Nav. RINEX> <Sp3> "
+      "[stats.csv [diffs.csv]]\n";
+    return 1;
+  }
+
+  std::vector<NavDataFrame> frames;
+  NavigationRnx nav(argv[1]);
+  if (int j=nav.read_all_records(frames); j) {
+    std::cerr<<"\n[ERROR] Failed to read navigation file; error: "<<j<<"\n";
+    return 2;
+  }
+
+  Sp3c sp3(argv[2]);
+  std::vector<NavCmpStats> stats;
+  std::vector<NavCmpRecord> records;
+  if (int j=ngpt::compare_nav_sp3(frames, sp3, stats, &records); j) {
+    std::cerr<<"\n[ERROR] Comparison failed; error: "<<j<<"\n";
+    return 3;
+  }
+
+  std::printf("\n#Sat Epochs Missing     Radial      Along      Cross"
+    "      Clock    Aligned (RMS, m)");
+  for (const auto& st : stats) {
+    std::printf("\n %c%02d %6d %7d %10.3f %10.3f %10.3f %10.3f %10.3f",
+      ngpt::satsys_to_char(st.sys), st.prn, st.epochs, st.missing,
+      st.rms[0], st.rms[1], st.rms[2], st.rms[3], st.clock_rms_aligned);
+  }
+  std::printf("\n# Satellites: %zu, differences: %zu", stats.size(),
+    records.size());
+
+  if (argc>3 && ngpt::write_navcmp_csv(argv[3], stats)) {
+    std::cerr<<"\n[ERROR] Failed to write "<<argv[3]<<"\n";
+    return 4;
+  }
+  if (argc>4 && ngpt::write_navcmp_csv(argv[4], records)) {
+    std::cerr<<"\n[ERROR] Failed to write "<<argv[4]<<"\n";
+    return 4;
+  }
+
+  std::cout<<"\n";
+  return 0;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include "navrnx.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+// Evaluate every message of a (mixed) navigation RINEX at ToE, via the
+// runtime-dispatched NavDataFrame::stateNclock; no system is filtered out.
+int main(int argc, char* argv[])
+{
+  if (argc!=2) {
+    std::cerr<<"\n[ERROR] Run as: $>testNavRnxMixed <Nav. RINEX>\n";
+    return 1;
+  }
+
+  constexpr int num_systems = 7;
+  int messages[num_systems]={}, failed[num_systems]={},
+      unhealthy[num_systems]={};
+  double rmin[num_systems], rmax[num_systems];
+  for (int i=0; i<num_systems; i++) {
+    rmin[i] = 1e20;
+    rmax[i] = 0e0;
+  }
+
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  int j;
+  double state[6], clock;
+  while (!(j=nav.read_next_record(block))) {
+    int s = static_cast<int>(block.system());
+    ++messages[s];
+    if (block.sv_health()) ++unhealthy[s];
+    if (block.fit_interval()<=0
+        || block.stateNclock(block.toe<seconds>(), state, clock)) {
+      ++failed[s];
+      continue;
+    }
+    double r = std::sqrt(state[0]*state[0]+state[1]*state[1]
+      +state[2]*state[2]);
+    rmin[s] = std::min(rmin[s], r);
+    rmax[s] = std::max(rmax[s], r);
+  }
+  if (j>0) {
+    std::cerr<<"\n[ERROR] Failed to read navigation file; error: "<<j<<"\n";
+    return 2;
+  }
+
+  int errors = 0;
+  std::printf("\n#Sys Messages Unhealthy Failed Min Radius(km) Max Radius(km)");
+  for (int s=0; s<num_systems; s++) {
+    if (!messages[s]) continue;
+    std::printf("\n  %c  %8d %9d %6d %14.3f %14.3f",
+      ngpt::satsys_to_char(static_cast<SATELLITE_SYSTEM>(s)), messages[s],
+      unhealthy[s], failed[s], rmin[s]*1e-3, rmax[s]*1e-3);
+    errors += failed[s];
+  }
+
+  std::cout<<"\n";
+  return errors>0;
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "obsrnx.hpp"
+
+using ngpt::ObservationRnx;
+using ngpt::SATELLITE_SYSTEM;
+
+// Check the resolution of epoch header lines (ObservationRnx::
+// __resolve_epoch_304__, via read_next_epoch) on a small observation RINEX
+// written here, holding lines that the fixed column parser resolves and
+// lines that it rejects and are resolved via the (strtol/strtod) fallback.
+// The file has a single observable, so that the record lines are shorter
+// than the epoch lines.
+
+struct EpochLine {
+  const char* line;  // epoch header line
+  const char* sat;   // a satellite record, or nullptr
+  long mjd;          // expected MJD
+  long ticks;        // expected time of day, in 1e-7 sec
+};
+
+const EpochLine epochs[] = {
+  // fixed columns
+  {"> 2020 01 01 00 00  0.0000000  0  0", nullptr, 58849L, 0L},
+  {"> 2020 01 01 00 00  0.1000000  0  1", "G01  20000000.123 5", 58849L,
+    1000000L},
+  {"> 2020 01 01 23 59 59.9999999  0  0", nullptr, 58849L, 863999999999L},
+  // fixed columns, with receiver clock offset
+  {"> 2020 01 02 00 00  0.0000001  0  0        0.000123456789", nullptr,
+    58850L, 1L},
+  // fallback: fraction of seconds not in F11.7
+  {"> 2020 01 02 12 30 30.25       0  0", nullptr, 58850L, 450302500000L},
+  // fallback: date fields not in their columns
+  {"> 2020 1 2 12 30 45.5000000    0  1", "G01  20000001.000 5", 58850L,
+    450455000000L},
+  // fixed columns, new year (the cached date changes)
+  {"> 2021 01 01 00 00  1.2345678  0  0", nullptr, 59215L, 12345678L},
+  // fallback again, back to the previous year
+  {"> 2020 12 31 23 59 59.5        0  0", nullptr, 59214L, 863995000000L}};
+
+int main()
+{
+  const char* fn = "obsrnx_epoch.obs";
+  const char* header[] = {
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE",
+    "test                test                20200101 000000 GPS PGM / RUN BY / DATE ",
+    "TEST                                                        MARKER NAME         ",
+    "        0.0000        0.0000        0.0000                  APPROX POSITION XYZ ",
+    "G    1 C1C                                                  SYS / # / OBS TYPES ",
+    "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS   ",
+    "                                                            END OF HEADER       "};
+  if (std::FILE* fp = std::fopen(fn, "w")) {
+    for (const char* h : header) std::fprintf(fp, "%s\n", h);
+    for (const auto& e : epochs) {
+      std::fprintf(fp, "%s\n", e.line);
+      if (e.sat) std::fprintf(fp, "%s\n", e.sat);
+    }
+    std::fclose(fp);
+  } else {
+    std::cerr<<"\n[ERROR] Failed to write "<<fn<<"\n";
+    return 1;
+  }
+
+  int errors=0, read=0;
+  ObservationRnx rnx(fn);
+  std::map<SATELLITE_SYSTEM, std::vector<ngpt::GnssObservable>> map;
+  map[SATELLITE_SYSTEM::gps] = std::vector<ngpt::GnssObservable>{
+    ngpt::GnssObservable(SATELLITE_SYSTEM::gps, ngpt::ObservationCode("C1C"),
+    1e0)};
+  auto sat_obs_map = rnx.set_read_map(map);
+  auto sat_obs_vec = rnx.initialize_epoch_vector(sat_obs_map);
+  ngpt::modified_julian_day mjd;
+  double sec;
+  int sats;
+  for (const auto& e : epochs) {
+    const int status = rnx.read_next_epoch(sat_obs_map, sat_obs_vec, sats,
+      mjd, sec);
+    const long ticks = std::lround(sec*1e7);
+    const bool ok = !status && mjd.as_underlying_type()==e.mjd
+      && ticks==e.ticks && sats==(e.sat ? 1 : 0);
+    std::printf("\n# \"%s\": status %d, MJD %ld, ticks %ld, sats %d %s",
+      e.line, status, mjd.as_underlying_type(), ticks, sats,
+      ok ? "ok" : "FAILED");
+    if (!ok) ++errors;
+    if (!status) ++read;
+  }
+  if (rnx.read_next_epoch(sat_obs_map, sat_obs_vec, sats, mjd, sec)>=0)
+    ++errors;
+  std::printf("\n# Epochs read %d of %zu", read,
+    sizeof(epochs)/sizeof(epochs[0]));
+  std::remove(fn);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include <map>
 #include "obsrnx.hpp"
 #include "ggdatetime/datetime_write.hpp"
@@ -38,8 +39,54 @@ print_map(std::map<SATELLITE_SYSTEM, std::vector<GnssObservable>>& map,
   }
 }
 
+// Write a RINEX whose header holds two codes that cannot be packed to a
+// SignalId (attributes 'x' and 'y') and check the columns collected: both
+// must be reported as missing, rather than resolved to each other's column.
+int invalid_code_checks()
+{
+  const char* fn = "obsrnx_init.obs";
+  const char* header[] = {
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE",
+    "test                test                20200101 000000 GPS PGM / RUN BY / DATE ",
+    "TEST                                                        MARKER NAME         ",
+    "        0.0000        0.0000        0.0000                  APPROX POSITION XYZ ",
+    "G    4 C1C C1x L2y C2W                                      SYS / # / OBS TYPES ",
+    "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS   ",
+    "                                                            END OF HEADER       "};
+  if (std::FILE* fp = std::fopen(fn, "w")) {
+    for (const char* h : header) std::fprintf(fp, "%s\n", h);
+    std::fclose(fp);
+  } else {
+    std::cerr<<"\n[ERROR] Failed to write "<<fn<<"\n";
+    return 1;
+  }
+
+  int errors=0;
+  {
+    ObservationRnx rnx(fn);
+    std::map<SATELLITE_SYSTEM, std::vector<GnssObservable>> map;
+    map[SATELLITE_SYSTEM::gps] = std::vector<GnssObservable>{
+      GnssObservable(SATELLITE_SYSTEM::gps, ObservationCode("C1C"), 1e0),
+      GnssObservable(SATELLITE_SYSTEM::gps, ObservationCode("L2y"), 1e0),
+      GnssObservable(SATELLITE_SYSTEM::gps, ObservationCode("C2W"), 1e0)};
+    // L2y is missing: an error, or a warning if missing ones are skipped
+    if (!rnx.set_read_map(map).empty()) ++errors;
+    auto result = rnx.set_read_map(map, true);
+    const auto& cols = result[SATELLITE_SYSTEM::gps];
+    if (map[SATELLITE_SYSTEM::gps].size()!=2 || cols.size()!=2
+      || cols[0].size()!=1 || cols[0][0].first!=0
+      || cols[1].size()!=1 || cols[1][0].first!=3) ++errors;
+    print_map(map, result);
+  }
+  std::remove(fn);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
+
 int main(int argc, char* argv[])
 {
+  if (argc == 1) return invalid_code_checks();
   if (argc != 2) {
     std::cerr<<"\n[ERROR] Run as: $>testObsRnx [Obs. RINEX]\n";
     return 1;
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "navrnx.hpp"
+#include "kepler_ephemeris.hpp"
+#include "geometry.hpp"
+#include "orbit_cache.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::KeplerEphemeris;
+using ngpt::OrbitGridCache;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::microseconds;
+
+int main(int argc, char* argv[])
+{
+  if (argc!=2) {
+    std::cerr<<"\n[ERROR] Run as: $>testOrbitCache <Nav. RINEX>\n";
+    return 1;
+  }
+
+  // collect the first message of every GPS/Galileo/BeiDou satellite
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  std::vector<NavDataFrame> msgs;
+  std::vector<KeplerEphemeris> ephs;
+  while (!nav.read_next_record(block)) {
+    auto sys = block.system();
+    if (sys!=SATELLITE_SYSTEM::gps && sys!=SATELLITE_SYSTEM::galileo
+        && sys!=SATELLITE_SYSTEM::beidou) continue;
+    bool have_it = false;
+    for (const auto& m : msgs)
+      if (m.system()==sys && m.prn()==block.prn()) have_it=true;
+    if (!have_it) {
+      msgs.push_back(block);
+      ephs.emplace_back(block);
+    }
+  }
+  if (msgs.empty()) {
+    std::cerr<<"\n[ERROR] No navigation messages found!\n";
+    return 1;
+  }
+  std::cout<<"\n# Number of satellites: "<<msgs.size();
+
+  // fill the cache for a number of epochs (30 sec apart), starting at the
+  // ToE of the first message
+  const int num_epochs = 10;
+  OrbitGridCache cache(num_epochs);
+  std::vector<OrbitGridCache::epoch_type> epochs;
+  auto t = msgs[0].toe<microseconds>();
+  for (int i=0; i<num_epochs; i++) {
+    epochs.push_back(t);
+    if (cache.fill(t, ephs.cbegin(), ephs.cend())) {
+      std::cerr<<"\n[ERROR] Failed to fill cache";
+      return 2;
+    }
+    t.add_seconds(microseconds(30000000L));
+  }
+
+  // a number of stations (on the equator and at mid latitudes) read the
+  // cache concurrently; compare against the full light-time iteration
+  const double stations[][3] = {{6378137e0, 0e0, 0e0},
+                                {0e0, 6378137e0, 0e0},
+                                {4595220e0, 2039434e0, 3912626e0},
+                                {-2430697e0, -4704189e0, 3544329e0}};
+  const int num_stations = sizeof(stations)/sizeof(stations[0]);
+  std::vector<double> max_diff(num_stations, 0e0);
+  std::vector<int> errors(num_stations, 0);
+  std::vector<std::thread> workers;
+  for (int s=0; s<num_stations; s++) {
+    workers.emplace_back([&, s]() {
+      ngpt::StationGeometry sta(stations[s][0], stations[s][1],
+                                stations[s][2]);
+      double state[6], cstate[6], clock, cclock, tau, ctau;
+      for (const auto& epoch : epochs) {
+        auto view = cache.view(epoch);
+        if (!view) {
+          ++errors[s];
+          continue;
+        }
+        for (const auto& m : msgs) {
+          if (sta.transmit_state(m, epoch, state, clock, tau)
+              || view.transmit_state(m.system(), m.prn(), sta, cstate,
+                                     cclock, ctau)) {
+            ++errors[s];
+            continue;
+          }
+          for (int k=0; k<3; k++)
+            max_diff[s] = std::max(max_diff[s], std::abs(state[k]-cstate[k]));
+        }
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+
+  int status = 0;
+  for (int s=0; s<num_stations; s++) {
+    std::printf("\n# Station %d: max position diff: %.6e m, errors: %d",
+      s, max_diff[s], errors[s]);
+    status += (errors[s] || max_diff[s]>1e-3);
+  }
+
+  std::cout<<"\n";
+  return status;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <cstdio>
+#include <unordered_set>
+#include "satid.hpp"
+#include "satellite.hpp"
+#include "gnssobs.hpp"
+
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::SatId;
+using ngpt::SignalId;
+using ngpt::ObservationCode;
+
+// Check the compact satellite/signal identifiers: round trips to and from
+// the rich types, dense indexing and hashing.
+
+static_assert(sizeof(SatId)==2 && sizeof(SignalId)==2, "compact ids");
+static_assert(SatId(SATELLITE_SYSTEM::galileo, 11).prn()==11
+  && SatId(SATELLITE_SYSTEM::galileo, 11).system()==SATELLITE_SYSTEM::galileo,
+  "SatId components");
+static_assert(SatId::index(SATELLITE_SYSTEM::gps, 1)==0
+  && SatId::index(SATELLITE_SYSTEM::gps, 65)==-1
+  && SatId::index(SATELLITE_SYSTEM::mixed, 1)==-1, "SatId dense index");
+
+int main()
+{
+  int errors=0;
+
+  // satellites: every (system, prn) in the dense range round-trips
+  {
+    std::unordered_set<SatId> set;
+    for (int s=0; s<SatId::num_systems; s++) {
+      for (int prn=1; prn<=SatId::max_prn; prn++) {
+        const auto sys = static_cast<SATELLITE_SYSTEM>(s);
+        const SatId id(sys, prn);
+        const int idx = id.index();
+        if (!id.valid() || id.system()!=sys || id.prn()!=prn) ++errors;
+        if (idx<0 || idx>=SatId::max_sats || SatId::from_index(idx)!=id)
+          ++errors;
+        if (ngpt::Satellite(id).id()!=id || SatId::from_raw(id.raw())!=id)
+          ++errors;
+        set.insert(id);
+      }
+    }
+    if (set.size()!=static_cast<std::size_t>(SatId::max_sats)) ++errors;
+    // out of the dense range, but still a valid id
+    const SatId qzs(SATELLITE_SYSTEM::qzss, 193);
+    if (!qzs.valid() || qzs.prn()!=193 || qzs.index()!=-1) ++errors;
+    if (SatId().valid() || SatId(SATELLITE_SYSTEM::gps, 256).valid()
+      || SatId::from_index(SatId::max_sats).valid()) ++errors;
+    if (!(SatId(SATELLITE_SYSTEM::gps, 2)<SatId(SATELLITE_SYSTEM::glonass, 1)))
+      ++errors;
+    std::printf("\n# SatId: %zu distinct ids; errors %d", set.size(), errors);
+  }
+
+  // signals: round-trip through ObservationCode
+  {
+    const char* codes[] = {"C1C", "L1C", "C2W", "L2W", "D5Q", "S7X", "C1?",
+      "L8I", "C6Z", "L2S"};
+    const SATELLITE_SYSTEM systems[] = {SATELLITE_SYSTEM::gps,
+      SATELLITE_SYSTEM::galileo, SATELLITE_SYSTEM::beidou};
+    std::unordered_set<SignalId> sigs;
+    for (auto sys : systems) {
+      for (const char* c : codes) {
+        const ObservationCode code(c);
+        const SignalId sig(sys, code);
+        if (!sig.valid() || sig.system()!=sys || sig.code()!=code
+          || sig.index()<0 || sig.index()>=SignalId::max_signals) {
+          std::printf("\n# Failed to round-trip %s", c);
+          ++errors;
+        }
+        sigs.insert(sig);
+      }
+    }
+    if (sigs.size()!=30) ++errors;
+    // strict equality, as ObservationCode::operator==
+    if (SignalId(SATELLITE_SYSTEM::gps, ObservationCode("C1C"))
+      ==SignalId(SATELLITE_SYSTEM::gps, ObservationCode("C1W"))
+      || SignalId(SATELLITE_SYSTEM::gps, ObservationCode("C1C"))
+      ==SignalId(SATELLITE_SYSTEM::galileo, ObservationCode("C1C"))) ++errors;
+    // attributes other than A-Z or '?' cannot be packed
+    if (SignalId(SATELLITE_SYSTEM::gps, ObservationCode(
+      ngpt::OBSERVABLE_TYPE::pseudorange, 1, ngpt::ObservationAttribute('1')))
+      .valid()) ++errors;
+    std::printf("\n# SignalId: %zu signals; errors %d", sigs.size(), errors);
+  }
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
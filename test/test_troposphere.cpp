@@ -0,0 +1,113 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "troposphere.hpp"
+#include "ggeodesy/geodesy.hpp"
+
+constexpr int NUM_ELEVATIONS = 9;
+
+// Without arguments, check the models against reference values:
+//  * the standard atmosphere against its defining formulas (Bernese GNSS
+//    Software manual, p. 188) and, loosely, against the ICAO pressure at
+//    1000 m (898.76 hPa) and the Magnus saturation pressure at 18 C,
+//  * the Saastamoinen ZHD at sea level (2.3 m),
+//  * NMF and VMF1 at the zenith (exactly 1) and at 5 deg elevation,
+//    computed from the coefficients of Niell (1996), table 3, at 45 deg
+//    latitude and doy 28 (so that no interpolation is involved), and of
+//    Boehm et al (2006).
+static int reference_checks()
+{
+  int errors=0;
+  auto check = [&](const char* what, double value, double ref, double tol) {
+    const bool ok = std::abs(value-ref)<=tol;
+    std::printf("\n# %-36s %14.9f ref %14.9f %s", what, value, ref,
+      ok?"ok":"FAILED");
+    if (!ok) ++errors;
+  };
+
+  // standard atmosphere
+  const auto sa0 = ngpt::standard_atmosphere(0e0);
+  check("Std. atmosphere P at 0 m (hPa)", sa0.pressure, 1013.25e0, 1e-9);
+  check("Std. atmosphere T at 0 m (K)", sa0.temperature, 291.15e0, 1e-9);
+  check("Std. atmosphere e at 0 m (hPa)", sa0.wvp, 10.443434700e0, 1e-8);
+  check("e at 0 m vs Magnus, RH 50% (hPa)", sa0.wvp, 10.30e0, 0.2e0);
+  const auto sa1 = ngpt::standard_atmosphere(1000e0);
+  check("Std. atmosphere P at 1000 m (hPa)", sa1.pressure, 899.175698959e0,
+    1e-8);
+  check("P at 1000 m vs ICAO (hPa)", sa1.pressure, 898.76e0, 0.5e0);
+  check("Std. atmosphere T at 1000 m (K)", sa1.temperature, 284.65e0, 1e-9);
+  check("Std. atmosphere e at 1000 m (hPa)", sa1.wvp, 3.605008376e0, 1e-8);
+
+  // Saastamoinen zenith hydrostatic delay, sea level
+  const double lat45 = ngpt::deg2rad(45e0);
+  check("Saastamoinen ZHD, 45 deg, 0 m (m)",
+    ngpt::Saastamoinen(sa0, lat45, 0e0).zhd(), 2.306967600e0, 1e-9);
+  check("Saastamoinen ZHD, equator, 0 m (m)",
+    ngpt::Saastamoinen(sa0, 0e0, 0e0).zhd(), 2.313120501e0, 1e-9);
+
+  // mapping functions
+  const double s5 = std::sin(ngpt::deg2rad(5e0));
+  const auto nmf = ngpt::niell_mapping(lat45, 0e0, 28e0);
+  check("NMF hydrostatic, zenith", nmf.hydrostatic(1e0), 1e0, 1e-15);
+  check("NMF wet, zenith", nmf.wet(1e0), 1e0, 1e-15);
+  check("NMF hydrostatic, 5 deg", nmf.hydrostatic(s5), 10.151761745e0,
+    1e-8);
+  check("NMF wet, 5 deg", nmf.wet(s5), 10.750884210e0, 1e-8);
+  check("NMF hydrostatic, 5 deg, 1000 m", ngpt::niell_mapping(lat45, 1000e0,
+    28e0).hydrostatic(s5), 10.173733795e0, 1e-8);
+  const auto vmf = ngpt::vmf1_mapping(0.00127e0, 0.00058e0, lat45, 0e0,
+    28e0);
+  check("VMF1 hydrostatic, zenith", vmf.hydrostatic(1e0), 1e0, 1e-15);
+  check("VMF1 wet, zenith", vmf.wet(1e0), 1e0, 1e-15);
+  check("VMF1 hydrostatic, 5 deg", vmf.hydrostatic(s5), 10.104111346e0,
+    1e-8);
+  check("VMF1 wet, 5 deg", vmf.wet(s5), 10.752402536e0, 1e-8);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc==1) return reference_checks();
+  if (argc!=4) {
+    std::cerr<<"\n[ERROR] Run as: $>testTroposphere [<lat (deg)> <hgt (m)> <doy>]\n";
+    return 1;
+  }
+  const double lat = ngpt::deg2rad(std::atof(argv[1]));
+  const double hgt = std::atof(argv[2]);
+  const double doy = std::atof(argv[3]);
+
+  // meteorological parameters
+  auto sa = ngpt::standard_atmosphere(hgt);
+  auto ea = ngpt::empirical_atmosphere(lat, hgt, doy);
+  std::printf("\n# Standard  atmosphere: P=%9.3f hPa T=%7.3f K e=%7.3f hPa",
+    sa.pressure, sa.temperature, sa.wvp);
+  std::printf("\n# Empirical atmosphere: P=%9.3f hPa T=%7.3f K e=%7.3f hPa",
+    ea.pressure, ea.temperature, ea.wvp);
+
+  // site terms
+  const ngpt::Saastamoinen saast(sa, lat, hgt);
+  const auto nmf = ngpt::niell_mapping(lat, hgt, doy);
+  std::printf("\n# Saastamoinen ZHD=%7.4f m ZWD=%7.4f m", saast.zhd(), saast.zwd());
+
+  // batch evaluation for a set of elevation angles
+  double sinel[NUM_ELEVATIONS], direct[NUM_ELEVATIONS], mapped[NUM_ELEVATIONS],
+    mh[NUM_ELEVATIONS], mw[NUM_ELEVATIONS];
+  const double elevations[NUM_ELEVATIONS] = {90e0, 75e0, 60e0, 45e0, 30e0,
+    20e0, 15e0, 10e0, 5e0};
+  for (int i=0; i<NUM_ELEVATIONS; i++)
+    sinel[i] = std::sin(ngpt::deg2rad(elevations[i]));
+  saast.slant_delay_cosz(sinel, NUM_ELEVATIONS, direct);
+  nmf.map(sinel, NUM_ELEVATIONS, mh, mw);
+  nmf.slant_delay(sinel, NUM_ELEVATIONS, saast.zhd(), saast.zwd(), mapped);
+
+  std::cout<<"\n# Elev.(deg) Saast.(m) NMF-h    NMF-w    ZHD*mh+ZWD*mw(m)";
+  for (int i=0; i<NUM_ELEVATIONS; i++)
+    std::printf("\n%6.1f %12.4f %8.4f %8.4f %12.4f", elevations[i], direct[i],
+      mh[i], mw[i], mapped[i]);
+
+  std::cout<<"\n";
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "navrnx.hpp"
+#include "geometry.hpp"
+#include "visibility.hpp"
+#include "ggeodesy/geodesy.hpp"
+
+using ngpt::NavigationRnx;
+using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::seconds;
+
+int main(int argc, char* argv[])
+{
+  if (argc!=6) {
+    std::cerr<<"\n[ERROR] Run as: $>testVisibility <Nav. RINEX> <X> <Y> <Z>"
+             <<" <mask (deg)>\n";
+    return 1;
+  }
+  const ngpt::StationGeometry station(std::atof(argv[2]), std::atof(argv[3]),
+                                      std::atof(argv[4]));
+  const double mask = ngpt::deg2rad(std::atof(argv[5]));
+
+  // collect the first healthy message of every GPS satellite
+  NavigationRnx nav(argv[1]);
+  NavDataFrame block;
+  std::vector<NavDataFrame> msgs;
+  while (!nav.read_next_record(block)) {
+    if (block.system()==SATELLITE_SYSTEM::gps && !block.sv_health()) {
+      bool have_it = false;
+      for (const auto& m : msgs) if (m.prn()==block.prn()) have_it=true;
+      if (!have_it) msgs.push_back(block);
+    }
+  }
+  if (msgs.empty()) {
+    std::cerr<<"\n[ERROR] No GPS navigation messages found!\n";
+    return 1;
+  }
+
+  // plan a 12 hour session starting at the ToE of the first message
+  const auto start = msgs[0].toe<seconds>();
+  const double duration = 43200e0;
+  ngpt::VisibilityPlanner planner(station, mask, start, duration);
+  for (const auto& m : msgs) {
+    if (planner.add_satellite(m)) {
+      std::cerr<<"\n[ERROR] Failed to plan satellite G"<<m.prn();
+      return 2;
+    }
+    std::printf("\nG%02d", m.prn());
+    for (const auto& w : planner.windows(m.system(), m.prn()))
+      std::printf(" [%8.1f, %8.1f]", w.rise, w.set);
+  }
+
+  // check the plan against the elevation every 30 seconds; a satellite
+  // above the mask must never be reported as not visible
+  int misses = 0, skipped = 0;
+  double state[6], clock, unit[3], az, el;
+  for (const auto& m : msgs) {
+    for (double t=0e0; t<=duration; t+=30e0) {
+      if (m.stateNclock(start, state, clock, t)) continue;
+      station.line_of_sight(state, unit, az, el);
+      const bool vis = planner.visible(m.system(), m.prn(), t);
+      if (el>=mask && !vis) ++misses;
+      if (!vis) ++skipped;
+    }
+  }
+  std::printf("\n# Samples skipped: %d, missed: %d", skipped, misses);
+
+  std::cout<<"\n";
+  return misses;
+}
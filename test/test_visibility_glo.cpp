@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include "synthetic.hpp"
+#include "geometry.hpp"
+#include "visibility.hpp"
+#include "ggeodesy/geodesy.hpp"
+
+using ngpt::NavDataFrame;
+using ngpt::SATELLITE_SYSTEM;
+using ngpt::SyntheticConfig;
+using ngpt::SyntheticGenerator;
+
+// Plan GLONASS satellites over a synthetic session much longer than the fit
+// interval of a single message (15 min either side of ToE). Every satellite
+// must be planned (from all of its messages), some samples must be filtered
+// out and no sample above the mask may be reported as not visible.
+
+int main()
+{
+  SyntheticConfig cfg;
+  cfg.year=2020; cfg.month=10; cfg.day=7;
+  cfg.duration=6*3600e0;
+  cfg.constellations.push_back(
+    ngpt::nominal_constellation(SATELLITE_SYSTEM::glonass));
+  std::vector<NavDataFrame> msgs;
+  double rx[3];
+  try {
+    SyntheticGenerator gen(cfg);
+    msgs = gen.messages();
+    gen.station_position(0, rx);
+  } catch (std::exception& e) {
+    std::cerr<<"\n"<<e.what()<<"\n";
+    return 1;
+  }
+  const ngpt::StationGeometry station(rx[0], rx[1], rx[2]);
+  const double mask = ngpt::deg2rad(10e0);
+  const ngpt::datetime<ngpt::seconds> start(ngpt::year(cfg.year),
+    ngpt::month(cfg.month), ngpt::day_of_month(cfg.day), ngpt::seconds(0L));
+
+  int errors=0, planned=0, satellites=0;
+  ngpt::VisibilityPlanner planner(station, mask, start, cfg.duration);
+  std::vector<std::vector<const NavDataFrame*>> sat_msgs(
+    ngpt::SatId::max_prn+1);
+  for (const auto& m : msgs) sat_msgs[m.prn()].push_back(&m);
+  for (int prn=1; prn<=ngpt::SatId::max_prn; prn++) {
+    if (sat_msgs[prn].empty()) continue;
+    ++satellites;
+    const int j = planner.add_satellite(sat_msgs[prn].data(),
+      sat_msgs[prn].size());
+    if (j || !planner.is_planned(SATELLITE_SYSTEM::glonass, prn)) {
+      std::printf("\n# R%02d not planned; status %d", prn, j);
+      ++errors;
+    } else {
+      ++planned;
+    }
+  }
+  std::printf("\n# Planned %d of %d satellites; errors %d", planned,
+    satellites, errors);
+
+  // check the plan every 30 sec, against the message with the closest ToE
+  long samples=0, skipped=0, misses=0;
+  double state[6], clock, unit[3], az, el;
+  for (int prn=1; prn<=ngpt::SatId::max_prn; prn++) {
+    for (double t=0e0; t<=cfg.duration; t+=30e0) {
+      const NavDataFrame* nav = nullptr;
+      double best = 1e10;
+      for (const auto* m : sat_msgs[prn]) {
+        const auto toe = m->toe<ngpt::seconds>();
+        const double dt = std::abs(t-(toe.sec().to_fractional_seconds()
+          +86400e0*(toe.mjd().as_underlying_type()
+          -start.mjd().as_underlying_type())));
+        if (dt<best) { best=dt; nav=m; }
+      }
+      if (!nav || nav->stateNclock(start, state, clock, t)>0) continue;
+      station.line_of_sight(state, unit, az, el);
+      const bool vis = planner.visible(SATELLITE_SYSTEM::glonass, prn, t);
+      ++samples;
+      if (el>=mask && !vis) ++misses;
+      if (!vis) ++skipped;
+    }
+  }
+  // at any time, well over half of the constellation is below the mask
+  if (misses || skipped<samples/3) ++errors;
+  std::printf("\n# Samples %ld, skipped %ld, missed %ld; errors %d", samples,
+    skipped, misses, errors);
+
+  std::printf("\n# Errors: %d\n", errors);
+  return errors>0;
+}